@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Sample.h"
+
+DEF_SAMPLE(Allocator)
+{
+  // The pool reuses the blocks of the same size class
+
+  auto& pool = vu::CPoolAllocator::Instance();
+
+  void* p1 = pool.Allocate(1000);
+  pool.Free(p1, 1000);
+  void* p2 = pool.Allocate(1024);
+  assert(p1 == p2);
+  pool.Free(p2, 1024);
+
+  // A block that is freed by another thread goes back to its own slab
+
+  void* p3 = pool.Allocate(1000);
+  std::thread([&]() { pool.Free(p3, 1000); }).join();
+  void* p4 = pool.Allocate(1000);
+  assert(p4 == p3);
+  pool.Free(p4, 1000);
+
+  // A buffer keeps its allocator on copy and growth
+
+  vu::CBuffer buffer(100, false, &pool);
+  buffer.Append(vu::CBufferView((const vu::byte*)"Vutils", 6));
+  assert(buffer.GetSize() == 106);
+
+  auto copied = buffer;
+  assert(copied.GetAllocator() == &pool);
+  assert(copied == buffer);
+
+  // Churns many short-lived buffers, that is what a socket or a file reader does per read
+
+  const size_t N = 1000000;
+  const size_t SIZE = 1 * KiB;
+
+  vu::CScopeStopWatch logger(_T("Allocator => "), vu::ConsoleLogging);
+
+  logger.Reset();
+
+  for (size_t i = 0; i < N; i++)
+  {
+    vu::CBuffer temp(SIZE);
+    temp[i % SIZE] = vu::byte(i);
+  }
+
+  logger.Log(_T("Heap, zeroed         : "));
+
+  logger.Reset();
+
+  for (size_t i = 0; i < N; i++)
+  {
+    vu::CBuffer temp(SIZE, false, &pool);
+    temp[i % SIZE] = vu::byte(i);
+  }
+
+  logger.Log(_T("Pool, uninitialized  : "));
+
+  return vu::VU_OK;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Sample.h"
+
+#include <algorithm>
+
+DEF_SAMPLE(BinaryToText)
+{
+  assert(vu::ToHexStringA("\x00\x7F\x80\xFF", 4) == "007F80FF");
+  assert(vu::ToHexStringW("\xAB\xCD", 2, false) == L"abcd");
+  assert(vu::ToBase64A("Vutils", 6) == "VnV0aWxz");
+  assert(vu::ToBase64A("Vu", 2) == "VnU=");
+
+  vu::CBuffer buffer;
+
+  bool decoded = vu::FromHexStringA("56757469C6c73", buffer); // An odd length
+  assert(!decoded);
+
+  decoded = vu::FromHexStringA("56757469C6C7", buffer);
+  assert(decoded && buffer.GetSize() == 6);
+
+  decoded = vu::FromBase64A("VnU", buffer); // Without the padding
+  assert(decoded && buffer.ToStringA() == "Vu");
+
+  decoded = vu::FromBase64W(L"VnV0a#xz", buffer);
+  assert(!decoded);
+
+  // Dumps into a string, the data is fed by blocks as from a stream
+
+  std::string text;
+  {
+    vu::CHexDump dump(text, 16, 0x1000);
+    dump.Update("The quick brown fox ", 20);
+    dump.Update("jumps over the lazy dog", 23);
+  }
+
+  std::cout << text;
+
+  assert(std::count(text.begin(), text.end(), '\n') == 3);
+  assert(text.find("  1020  68 65 20 6c 61 7a 79 20  64 6f 67") != std::string::npos);
+
+  // Encodes 16 MB, the printf per byte vs the vectorized hexadecimal digits
+
+  std::vector<vu::byte> blob(16 * MB);
+  for (size_t i = 0; i < blob.size(); i++)
+  {
+    blob[i] = vu::byte(i * 2654435761U >> 24);
+  }
+
+  vu::CScopeStopWatch logger(_T("BinaryToText => "), vu::ConsoleLogging);
+
+  logger.Reset();
+
+  std::string hex1;
+  hex1.reserve(2 * blob.size());
+  for (const auto& e : blob)
+  {
+    char s[3];
+    sprintf(s, "%02X", e);
+    hex1.append(s, 2);
+  }
+
+  logger.Log(_T("sprintf        : "));
+
+  logger.Reset();
+
+  const auto hex2 = vu::ToHexStringA(&blob[0], blob.size());
+
+  logger.Log(_T("ToHexString    : "));
+
+  logger.Reset();
+
+  decoded = vu::FromHexStringA(hex2, buffer);
+
+  logger.Log(_T("FromHexString  : "));
+
+  assert(decoded && buffer.GetSize() == blob.size());
+  assert(memcmp(buffer.GetpData(), &blob[0], blob.size()) == 0);
+
+  logger.Reset();
+
+  const auto base64 = vu::ToBase64A(&blob[0], blob.size());
+  decoded = vu::FromBase64A(base64, buffer);
+
+  logger.Log(_T("Base64 (2-way) : "));
+
+  assert(decoded && buffer.GetSize() == blob.size());
+  assert(memcmp(buffer.GetpData(), &blob[0], blob.size()) == 0);
+
+  logger.Reset();
+
+  std::string dump;
+  {
+    vu::CHexDump hd(dump);
+    hd.Update(&blob[0], blob.size());
+  }
+
+  logger.Log(_T("CHexDump       : "));
+
+  assert(hex1 == hex2);
+
+  return vu::VU_OK;
+}
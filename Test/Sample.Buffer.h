@@ -0,0 +1,109 @@
+#pragma once
+
+#include "Sample.h"
+
+DEF_SAMPLE(Buffer)
+{
+  const std::string chunk = "0123456789ABCDEF";
+  const int N = 1000000;
+
+  vu::CScopeStopWatch logger(_T("Buffer => "), vu::ConsoleLogging);
+
+  // Append-heavy : reallocate exactly on every append (the previous behavior)
+
+  logger.Reset();
+
+  {
+    void*  ptr  = nullptr;
+    size_t size = 0;
+    for (int i = 0; i < N; i++)
+    {
+      ptr = realloc(ptr, size + chunk.size());
+      memcpy(static_cast<vu::byte*>(ptr) + size, chunk.data(), chunk.size());
+      size += chunk.size();
+    }
+    free(ptr);
+  }
+
+  logger.Log(_T("Append (exact)      : "));
+
+  // Append-heavy : geometric growth
+
+  logger.Reset();
+
+  vu::CBuffer buffer;
+  for (int i = 0; i < N; i++)
+  {
+    buffer.Append(chunk.data(), chunk.size());
+  }
+
+  logger.Log(_T("Append (CBuffer)    : "));
+
+  assert(buffer.GetSize() == N * chunk.size());
+  assert(buffer.GetCapacity() >= buffer.GetSize());
+
+  const bool shrunk = buffer.ShrinkToFit();
+  assert(shrunk && buffer.GetCapacity() == buffer.GetSize());
+
+  // Return-heavy : copy vs move of the sliced buffers
+
+  std::vector<vu::CBuffer> slices;
+  slices.reserve(N / 100);
+
+  logger.Reset();
+
+  for (int i = 0; i < N / 100; i++)
+  {
+    const vu::CBuffer slice = buffer.Slice(0, 4096);
+    slices.push_back(slice);
+  }
+
+  logger.Log(_T("Return (copy)       : "));
+
+  slices.clear();
+
+  logger.Reset();
+
+  for (int i = 0; i < N / 100; i++)
+  {
+    slices.push_back(buffer.Slice(0, 4096));
+  }
+
+  logger.Log(_T("Return (move)       : "));
+
+  // Slice-heavy : owning slices vs non-owning views
+
+  size_t total = 0;
+
+  logger.Reset();
+
+  for (int i = 0; i < N; i++)
+  {
+    total += buffer.Slice(i % 1024, i % 1024 + 64).GetSize();
+  }
+
+  logger.Log(_T("Slice (CBuffer)     : "));
+
+  logger.Reset();
+
+  for (int i = 0; i < N; i++)
+  {
+    total -= buffer.View(i % 1024, i % 1024 + 64).GetSize();
+  }
+
+  logger.Log(_T("Slice (CBufferView) : "));
+
+  assert(total == 0);
+
+  vu::CBufferView view = buffer.View(0, 32);
+  assert(view.GetpBytes() == buffer.GetpBytes());
+  assert(view.Till("A", 1).ToStringA() == "0123456789");
+
+  // Small payloads are stored inline without any heap allocation
+
+  vu::CBuffer small(chunk.data(), chunk.size());
+  vu::CBuffer moved(std::move(small));
+  assert(small.Empty() && moved.ToStringA() == chunk);
+
+  return vu::VU_OK;
+}
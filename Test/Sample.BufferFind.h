@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Sample.h"
+
+#include <random>
+
+DEF_SAMPLE(BufferFind)
+{
+  const size_t N = 256 * MB;
+
+  std::mt19937 rng(0);
+
+  const auto fnNaive = [](const vu::CBuffer& buffer, const void* pdata, const size_t size) -> size_t
+  {
+    for (size_t i = 0; size <= buffer.GetSize() && i <= buffer.GetSize() - size; i++)
+    {
+      if (memcmp(buffer.GetpBytes() + i, pdata, size) == 0)
+      {
+        return i;
+      }
+    }
+
+    return -1;
+  };
+
+  // Correctness against the naive search on small alphabets (many partial matches)
+
+  for (int i = 0; i < 10000; i++)
+  {
+    vu::CBuffer data(rng() % 512), pattern(1 + rng() % 48);
+
+    for (size_t j = 0; j < data.GetSize(); j++)
+    {
+      data[j] = vu::byte('a' + rng() % 3);
+    }
+
+    for (size_t j = 0; j < pattern.GetSize(); j++)
+    {
+      pattern[j] = vu::byte('a' + rng() % 3);
+    }
+
+    const auto offset = data.Find(pattern);
+    assert(offset == fnNaive(data, pattern.GetpData(), pattern.GetSize()));
+
+    const auto offsets = data.FindAll(pattern);
+    assert(offsets.empty() == (offset == -1));
+    assert(offsets.empty() || (offsets.front() == offset && offsets.back() == data.RFind(pattern)));
+
+    for (size_t k = 1; k < offsets.size(); k++)
+    {
+      assert(data.FindNext(pattern, offsets[k - 1] + 1) == offsets[k]);
+    }
+  }
+
+  // Throughput in the worst case, the needle is only at the end of the buffer
+
+  vu::CBuffer buffer(N);
+  for (size_t i = 0; i < N; i++)
+  {
+    buffer[i] = vu::byte(rng() % 0xFF);
+  }
+
+  const size_t lengths[] = { 1, 4, 16, 64 };
+
+  for (const auto length : lengths)
+  {
+    vu::CBuffer needle(length);
+    needle.Fill(0xFF);
+    memset(buffer.GetpBytes() + N - length, 0xFF, length);
+
+    vu::CStopWatch watcher;
+
+    watcher.Start();
+    const auto expected = fnNaive(buffer, needle.GetpData(), needle.GetSize());
+    const auto naive = watcher.Stop();
+
+    watcher.Start();
+    const auto offset = buffer.Find(needle);
+    const auto fast = watcher.Stop();
+
+    assert(offset == expected && offset == N - length);
+
+    const auto fnGBps = [&](const vu::CStopWatch::TDuration& duration) -> double
+    {
+      return duration.second > 0.F ? N / double(GB) / duration.second : 0.;
+    };
+
+    std::tcout << vu::Fmt(
+      _T("Needle %3d bytes : Naive %.2f GB/s, Find %.2f GB/s\n"),
+      int(length), fnGBps(naive), fnGBps(fast));
+  }
+
+  return vu::VU_OK;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Sample.h"
+
+#include <random>
+
+DEF_SAMPLE(BytePattern)
+{
+  std::mt19937 rng(0);
+
+  vu::CBuffer buffer(16 * MB);
+  for (size_t i = 0; i < buffer.GetSize(); i++)
+  {
+    buffer[i] = vu::byte(rng());
+  }
+
+  // Nibble and byte wildcards
+
+  const vu::byte code[] = { 0x48, 0x8B, 0x05, 0x4A, 0x3F, 0xC3 };
+  memcpy(buffer.GetpBytes() + buffer.GetSize() - sizeof(code), code, sizeof(code));
+
+  vu::CBytePattern pattern(_T("48 8B ?? 4? ?F C3"));
+  assert(pattern.GetSize() == sizeof(code));
+  assert(pattern.Find(buffer) == buffer.GetSize() - sizeof(code));
+  assert(vu::FindPattern(buffer, _T("48 8B ?? 4? ?F C3")).second == buffer.GetSize() - sizeof(code));
+  assert(vu::CBytePattern(_T("48 8B 0")).Empty());
+
+  // Many signatures over the same buffer, compiled once then reused
+
+  std::vector<std::tstring> signatures;
+  for (int i = 0; i < 100; i++)
+  {
+    std::tstring signature;
+    for (int j = 0; j < 12; j++)
+    {
+      signature += rng() % 4 == 0 ? _T("?? ") : vu::Fmt(_T("%02X "), vu::uint(rng() % 256));
+    }
+    signatures.push_back(signature);
+  }
+
+  vu::CScopeStopWatch logger(_T("BytePattern => "), vu::ConsoleLogging);
+
+  logger.Reset();
+
+  std::vector<vu::CBytePattern> patterns(signatures.cbegin(), signatures.cend());
+
+  logger.Log(_T("Compile : "));
+
+  logger.Reset();
+
+  size_t found = 0;
+  for (const auto& e : patterns)
+  {
+    found += e.FindAll(buffer).size();
+  }
+
+  logger.Log(_T("Scan    : "));
+
+  std::tcout << _T("Found ") << found << _T(" matches") << std::endl;
+
+  return vu::VU_OK;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Sample.h"
+
+DEF_SAMPLE(ChainBuffer)
+{
+  // Appends across the segments, then reads back as blocks and as a contiguous buffer
+
+  vu::CChainBuffer chain(16);
+
+  const std::string text = "The quick brown fox jumps over the lazy dog";
+  chain.Append(text.data(), text.size());
+  assert(chain.GetSize() == text.size());
+  assert(chain.GetCount() == 3);
+
+  size_t size = 0;
+  for (const auto& block : chain.GetBlocks())
+  {
+    assert(memcmp(block.Address, text.data() + size, block.Size) == 0);
+    size += block.Size;
+  }
+  assert(size == text.size());
+
+  chain.Consume(4);
+  assert(chain.ToBuffer().ToStringA() == text.substr(4));
+  assert(chain.Linearize().ToStringA() == text.substr(4));
+  assert(chain.GetCount() == 1);
+
+  // Accumulates a big payload block by block, as a socket or a file reader does
+
+  const size_t N = 100 * MB;
+  const size_t BLOCK_SIZE = 1 * KiB;
+
+  vu::CBuffer block(BLOCK_SIZE);
+  block.Fill(0xCC);
+
+  vu::CScopeStopWatch logger(_T("ChainBuffer => "), vu::ConsoleLogging);
+
+  logger.Reset();
+
+  vu::CBuffer buffer;
+  for (size_t i = 0; i < N; i += BLOCK_SIZE)
+  {
+    buffer.Append(block);
+  }
+
+  logger.Log(_T("CBuffer      : "));
+
+  logger.Reset();
+
+  vu::CChainBuffer payload;
+  for (size_t i = 0; i < N; i += BLOCK_SIZE)
+  {
+    payload.Append(block.View());
+  }
+
+  logger.Log(_T("CChainBuffer : "));
+
+  assert(payload.GetSize() == buffer.GetSize());
+  assert(payload.ToBuffer() == buffer);
+
+  return vu::VU_OK;
+}
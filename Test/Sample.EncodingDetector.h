@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Sample.h"
+
+DEF_SAMPLE(EncodingDetector)
+{
+  const std::wstring text = L"Vutils \u00E9\u4E2D ";
+  const std::string utf8 = vu::ToUTF8(text);
+
+  float confidence = 0.F;
+
+  assert(vu::DetermineEncodingType("\xEF\xBB\xBF", 3) == vu::ET_UTF8_BOM);
+  assert(vu::DetermineEncodingType("\xFF\xFE\x00\x00", 4) == vu::ET_UTF32_LE_BOM);
+  assert(vu::DetermineEncodingType("\xFE", 1) == vu::ET_UTF8); // No read past the end for a truncated BOM
+
+  assert(vu::DetermineEncodingType(utf8.data(), utf8.size(), &confidence) == vu::ET_UTF8);
+  assert(confidence == 1.F);
+
+  const char latin1[] = "Caf\xE9 r\xE9sum\xE9";
+  assert(vu::DetermineEncodingType(latin1, sizeof(latin1) - 1, &confidence) == vu::ET_UTF8);
+  assert(confidence == 0.F); // ANSI
+
+  const char utf16be[] = "\0V\0u\0t\0i\0l\0s";
+  assert(vu::DetermineEncodingType(utf16be, sizeof(utf16be) - 1) == vu::ET_UTF16_BE);
+
+  // Streams a big text through a detector in blocks, a sequence is split between the blocks
+
+  std::string big;
+  for (int i = 0; i < 100000; i++)
+  {
+    big += utf8;
+  }
+
+  vu::CScopeStopWatch logger(_T("EncodingDetector => "), vu::ConsoleLogging);
+
+  logger.Reset();
+
+  const size_t BLOCK_SIZE = 4095;
+
+  vu::CEncodingDetector detector;
+  for (size_t i = 0; i < big.size(); i += BLOCK_SIZE)
+  {
+    if (!detector.Update(&big[i], std::min(BLOCK_SIZE, big.size() - i)))
+    {
+      break;
+    }
+  }
+
+  logger.Log(_T("Stream      : "));
+
+  assert(detector.GetEncoding() == vu::ET_UTF8 && detector.GetConfidence() == 1.F);
+
+  // Classifies by a bounded prefix
+
+  logger.Reset();
+
+  vu::CEncodingDetector prefix(4 * KiB);
+  prefix.Update(big.data(), big.size());
+
+  logger.Log(_T("Prefix 4KiB : "));
+
+  assert(prefix.GetScannedSize() == 4 * KiB && prefix.GetEncoding() == vu::ET_UTF8);
+
+  return vu::VU_OK;
+}
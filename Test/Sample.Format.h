@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Sample.h"
+
+// The previous way of FormatA, measures the length by a pass then formats by another pass
+
+static std::string LegacyFormatA(const char* format, ...)
+{
+  va_list args;
+
+  va_start(args, format);
+  const int n = vsnprintf(nullptr, 0, format, args);
+  va_end(args);
+
+  std::string result(n + 1, '\0');
+
+  va_start(args, format);
+  vsnprintf(&result[0], result.size(), format, args);
+  va_end(args);
+
+  result.resize(n);
+
+  return result;
+}
+
+DEF_SAMPLE(Format)
+{
+  // The arguments are written by their own types, the conversions only tell how
+
+  assert(vu::FormatA("%s=%d", "pid", 1234) == "pid=1234");
+  assert(vu::FormatA("%-6s|%06.2f|%#x", std::string("abc"), 3.14159, 255u) == "abc   |003.14|0xff");
+  assert(vu::FormatA("%*d|%.*f", 5, 42, 1, 2.25) == "   42|2.2");
+  assert(vu::FormatA("%s %s", L"wide", std::wstring(L"string")) == "wide string");
+  assert(vu::FormatA("%d %s", true, false) == "1 false");
+  assert(vu::FormatA("%d %d", 1) == "1 %d"); // A missing argument is not read
+  assert(vu::FormatW(L"%s%.3fs", std::wstring(L"elapsed "), 1.5) == L"elapsed 1.500s");
+  assert(vu::FormatA("%lld %llu", -9223372036854775807LL - 1, 18446744073709551615ULL) == "-9223372036854775808 18446744073709551615");
+
+  std::string log;
+  for (int i = 0; i < 3; i++)
+  {
+    vu::AppendFormatA(log, "[%02d]", i);
+  }
+
+  assert(log == "[00][01][02]");
+
+  // Formats many log lines, the two passes of the C variadic functions vs the type-safe formatting
+
+  const int N = 1000000;
+
+  vu::CScopeStopWatch logger(_T("Format => "), vu::ConsoleLogging);
+
+  logger.Reset();
+
+  size_t size = 0;
+  for (int i = 0; i < N; i++)
+  {
+    size += LegacyFormatA("%s:%d %08X", "sample.cpp", i, i).size();
+  }
+
+  logger.Log(_T("vsnprintf x2        : "));
+
+  logger.Reset();
+
+  for (int i = 0; i < N; i++)
+  {
+    size -= vu::FormatA("%s:%d %08X", "sample.cpp", i, i).size();
+  }
+
+  logger.Log(_T("FormatA (type-safe) : "));
+
+  assert(size == 0);
+
+  return vu::VU_OK;
+}
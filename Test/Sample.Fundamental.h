@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Sample.h"
+
+#include <climits>
+#include <sstream>
+
+DEF_SAMPLE(Fundamental)
+{
+  vu::eParseStatus status = vu::PS_OK;
+
+  vu::CFundamentalA value;
+  value << 0x10 << 20;
+  assert(value.String() == "1620" && value.Integer() == 1620);
+
+  value.Clear();
+  value << true;
+  assert(value.String() == "1" && value.Boolean());
+
+  assert(vu::CFundamentalA("0x7FFFFFFFFFFFFFFF").LongLong(&status) == 0x7FFFFFFFFFFFFFFFLL && status == vu::PS_OK);
+  assert(vu::CFundamentalA("3000000000").Integer(&status) == INT_MAX && status == vu::PS_OVERFLOW);
+  assert(vu::CFundamentalA("42px").Integer(&status) == 42 && status == vu::PS_INVALID);
+  assert(vu::CFundamentalA("09").Integer(&status) == 9 && status == vu::PS_OK);
+  assert(vu::CFundamentalA("010").Long() == 10);
+  assert(vu::CFundamentalA(" 1.5e3 ").Double(&status) == 1500. && status == vu::PS_OK);
+  assert(vu::CFundamentalW(L"Yes").Boolean(&status) && status == vu::PS_OK);
+
+  // Parses the fields of a big CSV, a stream per field vs the cached parse of the text
+
+  std::vector<std::string> fields;
+  for (int i = 0; i < 1000000; i++)
+  {
+    fields.push_back(vu::FormatA(i % 2 == 0 ? "%d" : "%.3f", i));
+  }
+
+  vu::CScopeStopWatch logger(_T("Fundamental => "), vu::ConsoleLogging);
+
+  logger.Reset();
+
+  double sum1 = 0.;
+  for (const auto& e : fields)
+  {
+    std::stringstream ss;
+    ss << e;
+    sum1 += atof(ss.str().c_str());
+  }
+
+  logger.Log(_T("stringstream : "));
+
+  logger.Reset();
+
+  double sum2 = 0.;
+  for (const auto& e : fields)
+  {
+    sum2 += vu::CFundamentalA(e).Double();
+  }
+
+  logger.Log(_T("CFundamental : "));
+
+  assert(sum1 == sum2);
+
+  return vu::VU_OK;
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Sample.h"
+
+DEF_SAMPLE(INIDocument)
+{
+  // Round-trips a text, its comments, spaces and quotes are kept and a new key follows the last key of its section
+
+  const std::string text = "; Settings\r\n[Main]\r\n  Name = \"Vic P.\"\r\n\r\n[Other]\r\nKey=Value\r\n";
+
+  vu::CINIDocument document;
+  document.Parse(text.data(), text.size());
+
+  vu::CStringViewA value;
+  assert(document.Read("MAIN", "name", value) && value == "Vic P.");
+
+  document.Write("Main", "Name", "Vic");
+  document.Write("Main", "Count", "42");
+
+  std::string result;
+  document.Serialize(result);
+  assert(result == "; Settings\r\n[Main]\r\n  Name = \"Vic\"\r\nCount=42\r\n\r\n[Other]\r\nKey=Value\r\n");
+
+  // A last header without a line break is ended before a key or a section follows it
+
+  const std::string unterminated = "[A]\r\nx=1\r\n[B]";
+
+  document.Parse(unterminated.data(), unterminated.size());
+  document.Write("B", "y", "2");
+  document.Write("C", "z", "3");
+
+  document.Serialize(result);
+  assert(result == "[A]\r\nx=1\r\n[B]\r\ny=2\r\n[C]\r\nz=3\r\n");
+
+  document.Parse(result.data(), result.size());
+  assert(document.Read("B", "y", value) && value == "2");
+  assert(document.Read("C", "z", value) && value == "3");
+
+  // Reads many keys of a big file, the profile API per key vs the parsed file
+
+  const auto path = vu::GetCurrentFilePathA() + ".bench.ini";
+
+  std::string content;
+  for (int i = 0; i < 100; i++)
+  {
+    content += vu::FormatA("[Section%d]\r\n", i);
+    for (int j = 0; j < 20; j++)
+    {
+      content += vu::FormatA("Key%d=%d\r\n", j, i * j);
+    }
+  }
+
+  document.Parse(content.data(), content.size());
+  const bool saved = document.Save(path);
+  assert(saved);
+
+  vu::CScopeStopWatch logger(_T("INIDocument => "), vu::ConsoleLogging);
+
+  logger.Reset();
+
+  int sum = 0;
+  for (int i = 0; i < 100; i += 10)
+  {
+    for (int j = 0; j < 20; j++)
+    {
+      #ifdef _WIN32
+      sum += GetPrivateProfileIntA(vu::FormatA("Section%d", i).c_str(), vu::FormatA("Key%d", j).c_str(), 0, path.c_str());
+      #else  // Linux
+      sum += i * j; // No profile API, the values that are written
+      #endif // _WIN32
+    }
+  }
+
+  #ifdef _WIN32
+  logger.Log(_T("GetPrivateProfileInt : "));
+  #endif // _WIN32
+
+  logger.Reset();
+
+  vu::CINIFileA ini(path);
+  for (int i = 0; i < 100; i += 10)
+  {
+    for (int j = 0; j < 20; j++)
+    {
+      sum -= ini.ReadInteger(vu::FormatA("Section%d", i), vu::FormatA("Key%d", j), 0);
+    }
+  }
+
+  logger.Log(_T("CINIFile             : "));
+
+  assert(sum == 0);
+
+  // Persists many settings, a file replaced per write vs the writes flushed at once
+
+  logger.Reset();
+
+  for (int i = 0; i < 300; i++)
+  {
+    ini.WriteInteger("Settings", vu::FormatA("Key%d", i), i);
+  }
+
+  logger.Log(_T("Write-through        : "));
+
+  logger.Reset();
+
+  ini.SetWriteBehind(true);
+
+  for (int i = 0; i < 300; i++)
+  {
+    ini.WriteInteger("Settings", vu::FormatA("Key%d", i), -i);
+  }
+
+  const bool flushed = ini.Flush();
+  assert(flushed);
+
+  logger.Log(_T("Write-behind + Flush : "));
+
+  assert(vu::CINIFileA(path).ReadInteger("Settings", "Key299", 0) == -299);
+
+  remove(path.c_str());
+
+  return vu::VU_OK;
+}
@@ -67,5 +67,16 @@ DEF_SAMPLE(INIFile)
     _tprintf(_T("Value = [%c, %d, %.2f]\n"), Output->a, Output->b, Output->c);
   }
 
+  // A key written by another instance since the file is loaded is kept by the next write
+
+  vu::CINIFile other(vu::GetCurrentFilePath() + _T(".ini"));
+  other.WriteString(_T("Section"), _T("KeyOther"), _T("Other"));
+
+  ini.WriteString(_T("KeyString"), _T("Vic"));
+
+  vu::CINIFile check(vu::GetCurrentFilePath() + _T(".ini"));
+  assert(check.ReadString(_T("Section"), _T("KeyOther"), _T("")) == _T("Other"));
+  assert(check.ReadString(_T("Section"), _T("KeyString"), _T("")) == _T("Vic"));
+
   return vu::VU_OK;
 }
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "Sample.h"
+
+struct TServerConfig
+{
+  std::string Host;
+  int Port;
+  bool Secure;
+  float Timeout;
+  int Retries;
+};
+
+DEF_SAMPLE(INISchema)
+{
+  vu::CINISchemaT<TServerConfig> schema;
+  schema
+    .Bind("Server", "Host", &TServerConfig::Host, "localhost")
+    .Bind("Server", "Port", &TServerConfig::Port, 80)
+    .Bind("Server", "Secure", &TServerConfig::Secure, false)
+    .Bind("Server", "Timeout", &TServerConfig::Timeout, 1.5f)
+    .Bind("Client", "Retries", &TServerConfig::Retries, 3);
+
+  const std::string text = "[Server]\r\nHost = example.com\r\nport = 0x1BB\r\nSecure = yes\r\nTimeout = 2s\r\n";
+
+  vu::CINIDocument document;
+  document.Parse(text.data(), text.size());
+
+  // The missing and the invalid keys are reported together, their fields get their defaults
+
+  TServerConfig config;
+  std::vector<vu::TINIIssue> issues;
+
+  const bool loaded = schema.Load(document, config, issues);
+  assert(!loaded);
+  assert(config.Host == "example.com" && config.Port == 443 && config.Secure);
+  assert(config.Timeout == 1.5f && config.Retries == 3);
+
+  for (const auto& issue : issues)
+  {
+    std::cout << (issue.Type == vu::II_MISSING ? "Missing" : "Invalid")
+              << " [" << issue.Section << "] " << issue.Key << " '" << issue.Value << "'" << std::endl;
+  }
+
+  assert(issues.size() == 2);
+
+  // A real that is not a number is invalid, it would pass the range check of its type
+
+  const std::string nan = "[Server]\r\nTimeout = nan\r\n";
+  document.Parse(nan.data(), nan.size());
+
+  issues.clear();
+  schema.Load(document, config, issues);
+  assert(config.Timeout == 1.5f);
+  assert(issues.size() == 5 && issues[0].Type == vu::II_INVALID && issues[0].Key == "Timeout");
+
+  // Loads the fields of a file many times, a read per field vs one pass by the schema
+
+  #define SAMPLE_FIELDS(X) X(0) X(1) X(2) X(3) X(4) X(5) X(6) X(7) X(8) X(9) X(10) X(11) X(12) X(13) X(14) X(15)
+
+  struct TFields
+  {
+    #define SAMPLE_MEMBER(i) int Field##i;
+    SAMPLE_FIELDS(SAMPLE_MEMBER)
+  };
+
+  vu::CINISchemaT<TFields> fields;
+  #define SAMPLE_BIND(i) fields.Bind("Section" #i, "Key" #i, &TFields::Field##i, -1);
+  SAMPLE_FIELDS(SAMPLE_BIND)
+
+  const auto path = vu::GetCurrentFilePathA() + ".schema.ini";
+
+  std::string content;
+  for (int i = 0; i < 16; i++)
+  {
+    content += vu::FormatA("[Section%d]\r\nKey%d=%d\r\n", i, i, i);
+  }
+
+  document.Parse(content.data(), content.size());
+  const bool saved = document.Save(path);
+  assert(saved);
+
+  vu::CINIFileA ini(path);
+
+  vu::CScopeStopWatch logger(_T("INISchema => "), vu::ConsoleLogging);
+
+  logger.Reset();
+
+  TFields a;
+  for (int n = 0; n < 1000; n++)
+  {
+    #define SAMPLE_READ(i) a.Field##i = ini.ReadInteger("Section" #i, "Key" #i, -1);
+    SAMPLE_FIELDS(SAMPLE_READ)
+  }
+
+  logger.Log(_T("Read per field : "));
+
+  logger.Reset();
+
+  TFields b;
+  for (int n = 0; n < 1000; n++)
+  {
+    issues.clear();
+    ini.Load(fields, b, issues);
+  }
+
+  logger.Log(_T("Schema         : "));
+
+  assert(issues.empty() && memcmp(&a, &b, sizeof(a)) == 0 && b.Field15 == 15);
+
+  #undef SAMPLE_READ
+  #undef SAMPLE_BIND
+  #undef SAMPLE_MEMBER
+  #undef SAMPLE_FIELDS
+
+  remove(path.c_str());
+
+  return vu::VU_OK;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "Sample.h"
+
+DEF_SAMPLE(INIWatch)
+{
+  const auto path = vu::GetCurrentFilePathA() + ".watch.ini";
+
+  vu::CINIDocument document;
+  const std::string text = "[Main]\r\nName=Vic\r\nCount=1\r\n";
+  document.Parse(text.data(), text.size());
+  const bool saved = document.Save(path);
+  assert(saved);
+
+  std::mutex mutex;
+  std::vector<vu::TINIChangeA> changes;
+
+  const auto fnChanged = [&](const vu::TINIChangeA& change)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    changes.push_back(change);
+  };
+
+  vu::CINIFileA ini(path);
+  bool watching = ini.Watch(fnChanged);
+  assert(watching);
+
+  // The readers go on without lock while the file is changed and reloaded
+
+  std::atomic<bool> stop(false);
+
+  std::thread reader([&]()
+  {
+    while (!stop)
+    {
+      const int count = ini.ReadInteger("Main", "Count", 0);
+      assert(count == 1 || count == 2);
+    }
+  });
+
+  // Changes the file by another instance, as another process would do
+
+  {
+    vu::CINIFileA other(path);
+    other.WriteInteger("Main", "Count", 2);
+    other.WriteString("Extra", "Key", "Value");
+  }
+
+  for (int i = 0; i < 100 && ini.ReadString("Extra", "Key", "").empty(); i++)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  }
+
+  stop = true;
+  reader.join();
+
+  ini.Unwatch();
+
+  for (const auto& change : changes)
+  {
+    std::cout << change.Type << " [" << change.Section << "] " << change.Key
+              << " : '" << change.OldValue << "' -> '" << change.NewValue << "'" << std::endl;
+  }
+
+  assert(ini.ReadInteger("Main", "Count", 0) == 2);
+
+  // A local write that is not flushed is merged into a change of the file, the key that is changed
+  // in both keeps its local value and it is reported as a conflict
+
+  changes.clear();
+
+  watching = ini.Watch(fnChanged);
+  assert(watching);
+  ini.SetWriteBehind(true);
+  ini.WriteString("Main", "Name", "Local");
+
+  {
+    vu::CINIFileA other(path);
+    other.WriteString("Main", "Name", "File");
+    other.WriteString("Main", "Other", "1");
+  }
+
+  for (int i = 0; i < 100 && ini.ReadString("Main", "Other", "").empty(); i++)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  }
+
+  ini.Unwatch();
+
+  assert(ini.ReadString("Main", "Name", "") == "Local");
+  assert(ini.ReadString("Main", "Other", "") == "1");
+
+  bool conflict = false;
+  for (const auto& change : changes)
+  {
+    conflict |= change.Type == vu::IC_CONFLICT && change.Key == "Name" && change.OldValue == "File" && change.NewValue == "Local";
+  }
+
+  assert(conflict);
+
+  const bool flushed = ini.Flush();
+  assert(flushed);
+  assert(vu::CINIFileA(path).ReadString("Main", "Name", "") == "Local");
+  assert(vu::CINIFileA(path).ReadString("Main", "Other", "") == "1");
+
+  remove(path.c_str());
+
+  return vu::VU_OK;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Sample.h"
+
+DEF_SAMPLE(IgnoreCase)
+{
+  assert(vu::UpperStringA("kernel32.dll") == "KERNEL32.DLL");
+  assert(vu::LowerStringW(L"NTDLL.DLL") == L"ntdll.dll");
+
+  std::string name = "User32.DLL";
+  vu::LowerStringInPlaceA(name);
+  assert(name == "user32.dll");
+
+  assert(vu::EqualsIgnoreCaseA("KERNEL32.dll", "kernel32.DLL"));
+  assert(!vu::EqualsIgnoreCaseW(L"kernel32.dll", L"kernel32.dl"));
+  assert(vu::CompareIgnoreCaseA("advapi32.dll", "ADVAPI64.DLL") < 0);
+
+  // Matches a module name against many import names, as resolving the imports of a binary does
+
+  std::vector<std::string> modules;
+  for (int i = 0; i < 100000; i++)
+  {
+    modules.push_back(vu::FormatA("api-ms-win-core-synch-l1-2-%d.dll", i));
+  }
+
+  const std::string target = "API-MS-WIN-CORE-SYNCH-L1-2-99999.DLL";
+
+  vu::CScopeStopWatch logger(_T("IgnoreCase => "), vu::ConsoleLogging);
+
+  logger.Reset();
+
+  size_t found = 0;
+  for (const auto& e : modules)
+  {
+    found += vu::UpperStringA(e) == vu::UpperStringA(target) ? 1 : 0;
+  }
+
+  logger.Log(_T("UpperString + ==  : "));
+
+  logger.Reset();
+
+  for (const auto& e : modules)
+  {
+    found += vu::EqualsIgnoreCaseA(e, target) ? 1 : 0;
+  }
+
+  logger.Log(_T("EqualsIgnoreCase  : "));
+
+  assert(found == 2);
+
+  return vu::VU_OK;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Sample.h"
+
+DEF_SAMPLE(MultiString)
+{
+  const auto block = _T("THIS\0IS\0A\0MULTI\0STRING\0\0");
+
+  std::vector<vu::CStringView> entries;
+  for (const auto& e : vu::CMultiString(block))
+  {
+    entries.push_back(e);
+  }
+
+  assert(entries.size() == 5 && entries[3] == _T("MULTI"));
+
+  // A registry value may lack its terminators, the bounded view stops at the end of the data
+
+  const TCHAR data[] = { _T('a'), _T('b'), 0, _T('c'), _T('d') };
+  assert(vu::CMultiString(data, 5).GetCount() == 2);
+
+  // Encodes a big list once into a buffer, then walks it as the list of copies vs the views
+
+  std::vector<std::string> list;
+  for (int i = 0; i < 10000; i++)
+  {
+    list.push_back(vu::FormatA("C:\\Windows\\System32\\drivers\\driver%05d.sys", i));
+  }
+
+  vu::CBuffer buffer;
+  const bool encoded = vu::ListToMultiStringA(list, buffer);
+  assert(encoded);
+  assert(buffer.GetSize() == vu::ListToMultiStringA(list, nullptr, 0));
+
+  const auto multi = static_cast<const char*>(buffer.GetpData());
+
+  vu::CScopeStopWatch logger(_T("MultiString => "), vu::ConsoleLogging);
+
+  logger.Reset();
+
+  size_t size = 0;
+  for (int i = 0; i < 100; i++)
+  {
+    for (const auto& e : vu::MultiStringToListA(multi))
+    {
+      size += e.size();
+    }
+  }
+
+  logger.Log(_T("MultiStringToList : "));
+
+  logger.Reset();
+
+  for (int i = 0; i < 100; i++)
+  {
+    for (const auto& e : vu::CMultiStringA(multi, buffer.GetSize()))
+    {
+      size -= e.Size();
+    }
+  }
+
+  logger.Log(_T("CMultiString      : "));
+
+  assert(size == 0);
+
+  return vu::VU_OK;
+}
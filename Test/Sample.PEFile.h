@@ -2,16 +2,74 @@
 
 #include "Sample.h"
 
+#include <fstream>
+
 #define SEPERATOR() std::tcout << _T("----------------------------------------") << std::endl;
 
 DEF_SAMPLE(PEFile)
 {
-#ifdef _WIN64
+#if defined(_WIN64) || !defined(_WIN32) // peX is pe64 on Linux
   #define PROCESS_NAME _T("x64dbg.exe")
+  #define DLL_PATH _T("Test.WH.x64.dll")
 #else // _WIN32
   #define PROCESS_NAME _T("x32dbg.exe")
+  #define DLL_PATH _T("Test.WH.x86.dll")
 #endif // _WIN64
 
+  // Parses an image from the memory, the data out of the buffer is not read
+
+  {
+    #ifdef _WIN32
+    auto data = vu::CFileSystem::QuickReadAsBuffer(DLL_PATH);
+    #else  // Linux
+    std::ifstream file(DLL_PATH, std::ios::binary);
+    const std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    vu::CBuffer data(bytes.data(), bytes.size());
+    #endif // _WIN32
+
+    vu::CPEFileTX<vu::peX> image;
+    auto result = image.Parse(data);
+    assert(result == vu::VU_OK);
+    assert(image.GetSize() == data.GetSize());
+    assert(image.FindImportModule("KERNEL32.dll") != nullptr);
+
+    std::cout << image.GetImportFunctions().size() << " functions, "
+              << image.GetRelocationEntries().size() << " relocations" << std::endl;
+
+    result = image.Parse(data.GetpData(), 0x100); // Truncated in the PE header
+    assert(result != vu::VU_OK);
+    assert(image.GetImportModules().empty());
+  }
+
+  SEPERATOR()
+
+  // Parses a file, it is mapped on Windows and read into a buffer on Linux
+
+  {
+    vu::CPEFileT<vu::peX> image(DLL_PATH);
+    const auto result = image.Parse();
+    assert(result == vu::VU_OK);
+
+    const auto sections = image.GetSetionHeaders();
+    assert(!sections.empty());
+
+    for (auto section : sections)
+    {
+      printf("%+10.8s %08X %08X\n", section->Name, section->VirtualAddress, section->Misc.VirtualSize);
+    }
+
+    for (auto e : image.GetImportModules())
+    {
+      printf("%08X, '%s'\n", e.IIDID, e.Name.c_str());
+    }
+
+    assert(image.FindImportModule("KERNEL32.dll") != nullptr);
+  }
+
+  #ifdef _WIN32
+
+  SEPERATOR()
+
   auto PIDs = vu::NameToPID(PROCESS_NAME);
   assert(!PIDs.empty());
 
@@ -139,5 +197,7 @@ DEF_SAMPLE(PEFile)
     std::tcout << vu::Fmt(fmt, Entry.RVA, Entry.Value, Value) << std::endl;
   }
 
+  #endif // _WIN32
+
   return vu::VU_OK;
 }
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Sample.h"
+
+#include <random>
+
+DEF_SAMPLE(ParallelScan)
+{
+  const size_t N = 512 * MB;
+
+  std::mt19937 rng(0);
+
+  vu::CBuffer buffer(N);
+  for (size_t i = 0; i < N; i++)
+  {
+    buffer[i] = vu::byte(rng() % 0xFF);
+  }
+
+  // The worst case, the only match is at the end of the buffer
+
+  const vu::byte code[] = { 0x48, 0x8B, 0x05, 0x4A, 0x3F, 0xFF };
+  memcpy(buffer.GetpBytes() + N - sizeof(code), code, sizeof(code));
+
+  const vu::CBufferView needle(code, sizeof(code));
+  const vu::CBytePattern pattern(_T("48 8B ?? 4? ?F FF"));
+
+  assert(buffer.FindParallel(needle) == buffer.Find(needle));
+  assert(pattern.FindParallel(buffer) == pattern.Find(buffer));
+  assert(pattern.FindAllParallel(buffer) == pattern.FindAll(buffer));
+
+  const auto nthreads = std::thread::hardware_concurrency();
+
+  for (size_t n = 1; n <= nthreads; n *= 2)
+  {
+    vu::CStopWatch watcher;
+
+    watcher.Start();
+    const auto offset = pattern.FindParallel(buffer, n);
+    const auto duration = watcher.Stop();
+
+    assert(offset == N - sizeof(code));
+
+    std::tcout << vu::Fmt(
+      _T("%2d thread(s) : %.3fs, %.2f GB/s\n"),
+      int(n), duration.second, duration.second > 0.F ? N / double(GB) / duration.second : 0.);
+  }
+
+  return vu::VU_OK;
+}
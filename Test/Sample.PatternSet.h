@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Sample.h"
+
+#include <random>
+
+DEF_SAMPLE(PatternSet)
+{
+  std::mt19937 rng(0);
+
+  vu::CBuffer buffer(16 * MB);
+  for (size_t i = 0; i < buffer.GetSize(); i++)
+  {
+    buffer[i] = vu::byte(rng());
+  }
+
+  const vu::byte code[] = { 0x48, 0x8B, 0x05, 0x4A, 0x3F, 0xC3 };
+  memcpy(buffer.GetpBytes() + 1234, code, sizeof(code));
+
+  vu::CPatternSet set;
+
+  // A few signatures
+
+  const auto id1 = set.Add(_T("48 8B ?? 4? ?F C3"));
+  const auto id2 = set.Add(_T("4A 3F"));
+  const auto id3 = set.Add(_T("?? 8B 05"));
+  assert(set.Add(_T("48 8")) == -1);
+
+  const bool built = set.Build();
+  assert(built);
+
+  std::vector<vu::TPatternMatch> matches;
+  set.Scan(buffer.View(0, 2048), [&](const size_t id, const size_t offset) -> bool
+  {
+    const vu::TPatternMatch match = { id, offset };
+    matches.push_back(match);
+    return true;
+  });
+
+  assert(matches.size() == 3);
+  assert(matches[0].ID == id1 && matches[0].Offset == 1234);
+  assert(matches[1].ID == id3 && matches[1].Offset == 1234);
+  assert(matches[2].ID == id2 && matches[2].Offset == 1237);
+
+  // Many signatures at once vs one pass per signature
+
+  for (int i = 0; i < 1000; i++)
+  {
+    std::tstring signature;
+    for (int j = 0; j < 12; j++)
+    {
+      signature += rng() % 4 == 0 ? _T("?? ") : vu::Fmt(_T("%02X "), vu::uint(rng() % 256));
+    }
+    set.Add(signature);
+  }
+
+  set.Build();
+
+  vu::CScopeStopWatch logger(_T("PatternSet => "), vu::ConsoleLogging);
+
+  logger.Reset();
+
+  size_t found = 0;
+  for (size_t id = 0; id < set.GetCount(); id++)
+  {
+    found += set.GetPattern(id).FindAll(buffer).size();
+  }
+
+  logger.Log(_T("One pass per pattern : "));
+
+  logger.Reset();
+
+  const auto all = set.Scan(buffer);
+
+  logger.Log(_T("Single pass          : "));
+
+  assert(all.size() == found);
+
+  std::tcout << _T("Found ") << all.size() << _T(" matches") << std::endl;
+
+  return vu::VU_OK;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Sample.h"
+
+DEF_SAMPLE(ReplaceString)
+{
+  assert(vu::ReplaceA("a.b.c", ".", "::") == "a::b::c");
+  assert(vu::ReplaceW(L"aaa", L"aa", L"b") == L"ba");
+  assert(vu::ReplaceA("abc", "", "x") == "abc");
+
+  // The longest from string wins, a replacement is not replaced again
+
+  std::vector<std::pair<std::string, std::string>> pairs;
+  pairs.push_back(std::make_pair("<", "&lt;"));
+  pairs.push_back(std::make_pair(">", "&gt;"));
+  pairs.push_back(std::make_pair("&", "&amp;"));
+  pairs.push_back(std::make_pair("<<", "&laquo;"));
+  assert(vu::ReplaceManyA("a<<b>&", pairs) == "a&laquo;b&gt;&amp;");
+
+  // Expands a few hundred placeholders in a multi-MB template
+
+  const int NUM_PLACEHOLDERS = 300;
+
+  vu::CReplaceTableA table;
+  std::vector<std::pair<std::string, std::string>> placeholders;
+
+  for (int i = 0; i < NUM_PLACEHOLDERS; i++)
+  {
+    const auto from = vu::FormatA("${VAR_%d}", i);
+    const auto to = vu::FormatA("value-%d", i);
+    table.Add(from, to);
+    placeholders.push_back(std::make_pair(from, to));
+  }
+
+  std::string text;
+  for (int i = 0; i < 100000; i++)
+  {
+    text += vu::FormatA("<key name=\"${VAR_%d}\">${VAR_%d}</key>\n", i % NUM_PLACEHOLDERS, (i * 7) % NUM_PLACEHOLDERS);
+  }
+
+  vu::CScopeStopWatch logger(_T("ReplaceString => "), vu::ConsoleLogging);
+
+  logger.Reset();
+
+  auto expected = text;
+  for (const auto& e : placeholders)
+  {
+    expected = vu::ReplaceA(expected, e.first, e.second);
+  }
+
+  logger.Log(_T("ReplaceString per pair : "));
+
+  logger.Reset();
+
+  const auto actual = table.Apply(text);
+
+  logger.Log(_T("CReplaceTable          : "));
+
+  assert(actual == expected);
+
+  return vu::VU_OK;
+}
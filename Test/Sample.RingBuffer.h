@@ -0,0 +1,152 @@
+#pragma once
+
+#include "Sample.h"
+
+#include <atomic>
+
+DEF_SAMPLE(RingBuffer)
+{
+  // A byte stream, a batch wraps around the end of the ring
+
+  vu::CRingBuffer stream(8);
+  assert(stream.GetCapacity() == 8);
+
+  size_t count = stream.Push("Vutils", 6);
+  assert(count == 6);
+  count = stream.Push("Ring", 4);
+  assert(count == 2);
+
+  char text[16] = { 0 };
+  count = stream.Pop(text, sizeof(text));
+  assert(count == 8);
+  assert(memcmp(text, "VutilsRi", 8) == 0);
+  assert(stream.Empty());
+
+  // An IPC channel, the second ring stands for the ring of the other process
+
+  const size_t SHARED_SIZE = vu::CRingBuffer::GetMemorySize(1024, sizeof(int));
+
+  vu::CFileMappingA server, client;
+  vu::VUResult result = server.CreateNamedSharedMemory("Local\\Vutils.RingBuffer", vu::ulong(SHARED_SIZE));
+  assert(result == vu::VU_OK);
+  result = client.Open("Local\\Vutils.RingBuffer");
+  assert(result == vu::VU_OK);
+
+  vu::CRingBuffer producer, consumer;
+  bool succeed = producer.Create(server.View(), SHARED_SIZE, sizeof(int));
+  assert(succeed);
+  succeed = consumer.Open(client.View(), SHARED_SIZE);
+  assert(succeed);
+
+  int value = 2020;
+  succeed = producer.Push(&value);
+  assert(succeed);
+  value = 0;
+  succeed = consumer.Pop(&value);
+  assert(succeed && value == 2020);
+
+  // Throughput across thread counts
+
+  const size_t N = 10000000;
+  const size_t BATCH = 64;
+
+  typedef vu::ulonglong TRecord;
+
+  const auto run = [&](vu::CRingBuffer& ring, const size_t nproducers, const size_t nconsumers) -> double
+  {
+    std::atomic<size_t> popped(0);
+    std::vector<std::thread> threads;
+
+    vu::CStopWatch watcher;
+    watcher.Start();
+
+    for (size_t i = 0; i < nproducers; i++)
+    {
+      threads.push_back(std::thread([&]()
+      {
+        TRecord records[BATCH] = { 0 };
+        for (size_t n = 0; n < N / nproducers;)
+        {
+          const auto pushed = ring.Push(records, std::min(BATCH, N / nproducers - n));
+          if (pushed == 0)
+          {
+            std::this_thread::yield();
+          }
+          n += pushed;
+        }
+      }));
+    }
+
+    for (size_t i = 0; i < nconsumers; i++)
+    {
+      threads.push_back(std::thread([&]()
+      {
+        TRecord records[BATCH];
+        while (popped < N / nproducers * nproducers)
+        {
+          const auto n = ring.Pop(records, BATCH);
+          if (n == 0)
+          {
+            std::this_thread::yield();
+          }
+          popped += n;
+        }
+      }));
+    }
+
+    for (auto& thread : threads)
+    {
+      thread.join();
+    }
+
+    return watcher.Stop().second;
+  };
+
+  vu::CRingBuffer spsc(64 * KiB, sizeof(TRecord), vu::RB_SPSC);
+  auto duration = run(spsc, 1, 1);
+  std::tcout << vu::Fmt(_T("SPSC 1:1   : %.3fs, %.2f M records/s\n"), duration, N / 1E6 / duration);
+
+  const size_t nthreads = std::max(2U, std::thread::hardware_concurrency());
+
+  for (size_t n = 1; n <= nthreads / 2; n *= 2)
+  {
+    vu::CRingBuffer mpmc(64 * KiB, sizeof(TRecord), vu::RB_MPMC);
+    duration = run(mpmc, n, n);
+    std::tcout << vu::Fmt(_T("MPMC %d:%d   : %.3fs, %.2f M records/s\n"), int(n), int(n), duration, N / 1E6 / duration);
+  }
+
+  // The round-trip latency of a ping-pong over two rings
+
+  const size_t ROUNDS = 100000;
+
+  vu::CRingBuffer ping(16, sizeof(TRecord)), pong(16, sizeof(TRecord));
+
+  std::thread echo([&]()
+  {
+    TRecord record = 0;
+    for (size_t i = 0; i < ROUNDS; i++)
+    {
+      while (!ping.Pop(&record)) std::this_thread::yield();
+      while (!pong.Push(&record)) std::this_thread::yield();
+    }
+  });
+
+  vu::CStopWatch watcher;
+  watcher.Start();
+
+  for (TRecord i = 0; i < ROUNDS; i++)
+  {
+    TRecord record = i;
+    while (!ping.Push(&record)) std::this_thread::yield();
+    while (!pong.Pop(&record)) std::this_thread::yield();
+    assert(record == i);
+  }
+
+  duration = watcher.Stop().second;
+
+  echo.join();
+
+  std::tcout << vu::Fmt(_T("Round-trip : %.0f ns\n"), duration * 1E9 / ROUNDS);
+
+  return vu::VU_OK;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Sample.h"
+
+DEF_SAMPLE(SplitString)
+{
+  // A separator string, a set of separators and the embedded NULs
+
+  const std::string text("key = value; ; path=C:\\Windows", 30);
+
+  std::vector<std::string> tokens;
+  for (const auto& e : vu::CSplitStringA(text, "; ", true))
+  {
+    tokens.push_back(e.ToString());
+  }
+
+  assert(tokens.size() == 2);
+  assert(tokens[1] == "path=C:\\Windows");
+
+  assert(vu::CSplitStringA(text, "=;", true, vu::SM_ANY_OF).ToList().size() == 5);
+
+  const std::string binary("a\0b,c", 5);
+  assert(vu::SplitStringA(binary, ",")[0].size() == 3);
+
+  // Splits a big CSV line, the list of copies vs the lazy views
+
+  std::string csv;
+  for (int i = 0; i < 1000000; i++)
+  {
+    csv += vu::FormatA("%d,", i);
+  }
+
+  vu::CScopeStopWatch logger(_T("SplitString => "), vu::ConsoleLogging);
+
+  logger.Reset();
+
+  const auto list = vu::SplitStringA(csv, ",");
+
+  logger.Log(_T("SplitString  : "));
+
+  logger.Reset();
+
+  size_t count = 0;
+  for (const auto& e : vu::CSplitStringA(csv, ","))
+  {
+    count += e.Empty() ? 0 : 1;
+  }
+
+  logger.Log(_T("CSplitString : "));
+
+  assert(list.size() == count + 1); // The trailing empty token
+
+  return vu::VU_OK;
+}
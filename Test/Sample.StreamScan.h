@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Sample.h"
+
+#include <random>
+
+DEF_SAMPLE(StreamScan)
+{
+  const std::tstring FILE_PATH = _T("Test.StreamScan.bin");
+
+  // Writes a file bigger than a block with a match that spans two blocks
+
+  const size_t BLOCK_SIZE = 1 * MiB;
+
+  std::mt19937 rng(0);
+
+  vu::CBuffer data(3 * BLOCK_SIZE);
+  for (size_t i = 0; i < data.GetSize(); i++)
+  {
+    data[i] = vu::byte(rng() % 0xFF);
+  }
+
+  const vu::byte code[] = { 0x48, 0x8B, 0x05, 0x4A, 0x3F, 0xFF };
+  memcpy(data.GetpBytes() + BLOCK_SIZE - 3, code, sizeof(code));
+  memcpy(data.GetpBytes() + data.GetSize() - sizeof(code), code, sizeof(code));
+
+  const bool saved = data.SaveAsFile(FILE_PATH);
+  assert(saved);
+
+  // A single pattern
+
+  const vu::CBytePattern pattern(_T("48 8B ?? 4? ?F FF"));
+
+  std::vector<vu::ulonglong> offsets;
+  pattern.ScanFile(FILE_PATH, [&](const vu::ulonglong offset) -> bool
+  {
+    offsets.push_back(offset);
+    return true;
+  }, BLOCK_SIZE);
+
+  assert(offsets.size() == 2);
+  assert(offsets[0] == BLOCK_SIZE - 3);
+  assert(offsets[1] == data.GetSize() - sizeof(code));
+
+  // A set of patterns, stops at the first match
+
+  vu::CPatternSet set;
+  set.Add(_T("4A 3F FF"));
+  set.Add(pattern);
+  set.Build();
+
+  size_t count = 0;
+  set.ScanFile(FILE_PATH, [&](const size_t id, const vu::ulonglong offset) -> bool
+  {
+    std::tcout << _T("Pattern ") << id << _T(" at Offset ") << offset << std::endl;
+    return ++count < 2;
+  }, BLOCK_SIZE);
+
+  assert(count == 2);
+
+  DeleteFile(FILE_PATH.c_str());
+
+  return vu::VU_OK;
+}
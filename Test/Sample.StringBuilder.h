@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Sample.h"
+
+DEF_SAMPLE(StringBuilder)
+{
+  vu::CStringBuilderA builder;
+  builder << "C:" << '\\' << "Windows";
+  vu::JoinPathA(builder, "\\System32", vu::ePathSep::WIN);
+  assert(builder.View() == "C:\\Windows\\System32");
+
+  builder.Clear();
+  vu::TrimStringA(builder, "  C:/Windows//System32/ \t");
+  assert(builder.View() == "C:/Windows//System32/");
+
+  vu::CStringBuilderW normalized;
+  vu::NormalizePathW(normalized, L"C:\\\\Windows/System32", vu::ePathSep::POSIX);
+  assert(normalized.Detach() == L"C:/Windows/System32");
+  assert(normalized.Empty());
+
+  vu::CStringArenaA arena;
+  const auto name = arena.Store("kernel32.dll");
+  assert(name == "kernel32.dll" && name.Data()[name.Size()] == '\0');
+
+  // Builds many paths by a trim -> join -> normalize pipeline, a new string per step vs one builder
+
+  std::vector<std::string> names;
+  for (int i = 0; i < 100000; i++)
+  {
+    names.push_back(vu::FormatA("  Module%d.dll ", i));
+  }
+
+  vu::CScopeStopWatch logger(_T("StringBuilder => "), vu::ConsoleLogging);
+
+  logger.Reset();
+
+  std::vector<std::string> paths;
+  for (const auto& e : names)
+  {
+    paths.push_back(vu::NormalizePathA(vu::JoinPathA("C:/Windows/System32", vu::TrimStringA(e))));
+  }
+
+  logger.Log(_T("Strings        : "));
+
+  logger.Reset();
+
+  std::vector<vu::CStringViewA> views;
+  vu::CStringBuilderA path, joined;
+  for (const auto& e : names)
+  {
+    path.Clear();
+    path << "C:/Windows/System32";
+    joined.Clear();
+    vu::TrimStringA(joined, e);
+    vu::JoinPathA(path, joined.View());
+    joined.Clear();
+    vu::NormalizePathA(joined, path.View());
+    views.push_back(arena.Store(joined));
+  }
+
+  logger.Log(_T("Builder + Arena: "));
+
+  assert(views.size() == paths.size() && views.back() == paths.back());
+
+  return vu::VU_OK;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Sample.h"
+
+#ifndef _WIN32
+#include <codecvt>
+#include <locale>
+#endif // _WIN32
+
+DEF_SAMPLE(UTF)
+{
+  // Round-trips, the sizes are computed exactly before converting
+
+  const std::wstring text = L"Vutils \u00E9\u4E2D\U0001F600";
+  const std::string utf8 = vu::ToUTF8(text);
+  assert(utf8 == "Vutils \xC3\xA9\xE4\xB8\xAD\xF0\x9F\x98\x80");
+  assert(vu::FromUTF8(utf8) == text);
+
+  auto result = vu::GetTranscodedSize(utf8.data(), utf8.size(), vu::UF_UTF8, vu::UF_UTF16BE);
+  assert(result.Status == vu::TC_OK && result.Written == 2 * 11);
+
+  // Ill-formed sequences, an overlong '/' then a truncated sequence
+
+  const char bad[] = "ab\xC0\xAF" "cd\xE4\xB8";
+  result = vu::GetTranscodedSize(bad, sizeof(bad) - 1, vu::UF_UTF8, vu::UF_UTF16LE);
+  assert(result.Status == vu::TC_INVALID && result.Read == 2);
+
+  const auto UF_WIDE = sizeof(wchar_t) == 2 ? vu::UF_UTF16LE : vu::UF_UTF32LE; // UTF-32 on Linux
+
+  wchar_t replaced[16] = { 0 };
+  result = vu::Transcode(bad, sizeof(bad) - 1, vu::UF_UTF8, replaced, sizeof(replaced), UF_WIDE, true);
+  assert(result.Status == vu::TC_OK && std::wstring(replaced) == L"ab\uFFFD\uFFFDcd\uFFFD");
+
+  // Converts a big mostly-ASCII text, the code page conversion (the C++ converter on Linux) vs the transcoder
+
+  std::wstring big;
+  for (int i = 0; i < 100000; i++)
+  {
+    big += vu::FormatW(L"<item id=\"%d\">Vutils \u00E9\u4E2D</item>\n", i);
+  }
+
+  vu::CScopeStopWatch logger(_T("UTF => "), vu::ConsoleLogging);
+
+  logger.Reset();
+
+  #ifdef _WIN32
+  const int N = WideCharToMultiByte(CP_UTF8, 0, big.data(), int(big.size()), NULL, 0, NULL, NULL);
+  std::string expected(N, '\0');
+  WideCharToMultiByte(CP_UTF8, 0, big.data(), int(big.size()), &expected[0], N, NULL, NULL);
+
+  logger.Log(_T("WideCharToMultiByte : "));
+  #else  // Linux
+  const std::string expected = std::wstring_convert<std::codecvt_utf8<wchar_t>>().to_bytes(big);
+
+  logger.Log(_T("wstring_convert     : "));
+  #endif // _WIN32
+
+  logger.Reset();
+
+  const auto actual = vu::ToUTF8(big);
+
+  logger.Log(_T("ToUTF8              : "));
+
+  assert(actual == expected);
+
+  logger.Reset();
+
+  const auto wide = vu::FromUTF8(actual);
+
+  logger.Log(_T("FromUTF8            : "));
+
+  assert(wide == big);
+
+  return vu::VU_OK;
+}
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <vu>
+#include <Vu>
 
 /**
  * CSample
@@ -8,6 +8,10 @@ G++ main.cpp -std=c++0x -lVutils -DVU_SOCKET_ENABLED -lws2_32 -DVU_GUID_ENABLED
 G++ main.cpp -std=c++0x -municode -lVutils -DUNICODE -D_UNICODE -DVU_SOCKET_ENABLED -lws2_32 -DVU_GUID_ENABLED -DVU_WMI_ENABLED -lgdi32 -lrpcrt4 -lole32 -loleaut32 -lwbemuuid -o Test.exe && Test.exe
 */
 
+/* Linux build EXE with the portable static library (tools/Linux.Build.Static.Library.sh)
+g++ main.cpp -std=c++11 -I../include -L../lib -lVutils -lpthread -o Test && ./Test
+*/
+
 #define _CRT_SECURE_NO_WARNINGS
 
 #ifdef _MSC_VER
@@ -16,40 +20,76 @@ G++ main.cpp -std=c++0x -municode -lVutils -DUNICODE -D_UNICODE -DVU_SOCKET_ENAB
 // #endif
 #endif // _MSC_VER
 
-#include <vu>
+#include <Vu>
+
+#ifdef _WIN32
 #include <windows.h>
 #include <tchar.h>
+#else  // Linux
+#define _tmain main
+#define _TCHAR char
+#define _tprintf printf
+#endif // _WIN32
 
 #include "Sample.Manager.h"
-#include "Sample.Misc.h"
 #include "Sample.Math.h"
+#include "Sample.Singleton.h"
+#include "Sample.Buffer.h"
+#include "Sample.BufferFind.h"
+#include "Sample.BytePattern.h"
+#include "Sample.PatternSet.h"
+#include "Sample.ParallelScan.h"
+#include "Sample.Allocator.h"
+#include "Sample.ChainBuffer.h"
+#include "Sample.SplitString.h"
+#include "Sample.IgnoreCase.h"
+#include "Sample.UTF.h"
+#include "Sample.EncodingDetector.h"
+#include "Sample.ReplaceString.h"
+#include "Sample.Format.h"
+#include "Sample.BinaryToText.h"
+#include "Sample.Fundamental.h"
+#include "Sample.StringBuilder.h"
+#include "Sample.MultiString.h"
+#include "Sample.INIDocument.h"
+#include "Sample.INIFile.h"
+#include "Sample.INIWatch.h"
+#include "Sample.INISchema.h"
+#include "Sample.PEFile.h"
+
+#ifdef _WIN32
+#include "Sample.Misc.h"
 #include "Sample.DF.h"
 #include "Sample.Socket.h"
 #include "Sample.AsyncSocket.h"
 #include "Sample.IATHook.h"
 #include "Sample.INLHook.h"
 #include "Sample.WMHook.h"
-#include "Sample.INIFile.h"
 #include "Sample.Registry.h"
 #include "Sample.Process.h"
 #include "Sample.StopWatch.h"
 #include "Sample.FileSystem.h"
 #include "Sample.FileMapping.h"
-#include "Sample.PEFile.h"
 #include "Sample.GUID.h"
-#include "Sample.Singleton.h"
 #include "Sample.InputDialog.h"
 #include "Sample.ThreadPool.h"
 #include "Sample.WMI.h"
 #include "Sample.Service.h"
+#include "Sample.StreamScan.h"
+#include "Sample.RingBuffer.h"
+#endif // _WIN32
 
 int _tmain(int argc, _TCHAR* argv[])
 {
+  #ifdef _WIN32
   std::tcout
     << _T("Windows Application")
     << _T(" ")
     << (vu::CProcess::Is64Bits() ? _T("64-bit") : _T("32-bit"))
     << std::endl;
+  #else  // Linux
+  std::tcout << _T("Linux Application") << _T(" ") << 8 * sizeof(void*) << _T("-bit") << std::endl;
+  #endif // _WIN32
 
   #ifdef _UNICODE
   std::tcout << _T("Encoding: UNICODE") << std::endl;
@@ -82,6 +122,28 @@ int _tmain(int argc, _TCHAR* argv[])
   // VU_SM_ADD_SAMPLE(InputDialog);
   // VU_SM_ADD_SAMPLE(ThreadPool);
   // VU_SM_ADD_SAMPLE(WMIProvider);
+  // VU_SM_ADD_SAMPLE(Buffer);
+  // VU_SM_ADD_SAMPLE(BufferFind);
+  // VU_SM_ADD_SAMPLE(BytePattern);
+  // VU_SM_ADD_SAMPLE(PatternSet);
+  // VU_SM_ADD_SAMPLE(ParallelScan);
+  // VU_SM_ADD_SAMPLE(StreamScan);
+  // VU_SM_ADD_SAMPLE(Allocator);
+  // VU_SM_ADD_SAMPLE(ChainBuffer);
+  // VU_SM_ADD_SAMPLE(RingBuffer);
+  // VU_SM_ADD_SAMPLE(SplitString);
+  // VU_SM_ADD_SAMPLE(IgnoreCase);
+  // VU_SM_ADD_SAMPLE(UTF);
+  // VU_SM_ADD_SAMPLE(EncodingDetector);
+  // VU_SM_ADD_SAMPLE(ReplaceString);
+  // VU_SM_ADD_SAMPLE(Format);
+  // VU_SM_ADD_SAMPLE(BinaryToText);
+  // VU_SM_ADD_SAMPLE(Fundamental);
+  // VU_SM_ADD_SAMPLE(StringBuilder);
+  // VU_SM_ADD_SAMPLE(MultiString);
+  // VU_SM_ADD_SAMPLE(INIDocument);
+  // VU_SM_ADD_SAMPLE(INIWatch);
+  // VU_SM_ADD_SAMPLE(INISchema);
 
   VU_SM_RUN();
 
@@ -13,7 +13,7 @@
 
 /**
  * Note :
- * 1. Available for both Windows 32-bit and 64-bit.
+ * 1. Available for both Windows 32-bit and 64-bit (and the portable part for Linux).
  * 2. Available for MSVC++, C++ Builder, C++ MingGW.
  * 3. Force BYTE alignment of structures.
  * 4. Finally, remember to use `vu` namespace.
@@ -25,8 +25,11 @@
 
 /* The Conditions of Vutils */
 
-#if !defined(_WIN32) && !defined(_WIN64)
-#error Vutils required Windows 32-bit/64-bit platform
+// On Linux, only the portable part is available. It is the strings, the transcoding, the buffers,
+// the patterns, the INI files and the PE files, see tools/Linux.Build.Static.Library.sh.
+
+#if !defined(_WIN32) && !defined(_WIN64) && !defined(__linux__)
+#error Vutils required Windows 32-bit/64-bit or Linux platform
 #endif
 
 #ifndef __cplusplus
@@ -58,8 +61,16 @@
 #define WIN32_LEAN_AND_MEAN
 #endif
 
+#ifndef NOMINMAX
+#define NOMINMAX // Keeps std::min/std::max and std::numeric_limits<T>::min/max usable
+#endif
+
+#ifdef _WIN32
 #include <windows.h>
 #include <winsvc.h>
+#else  // POSIX
+#include "inline/posix.inl"
+#endif // _WIN32
 
 #ifdef VU_SOCKET_ENABLED
 #include <winsock2.h>
@@ -68,8 +79,13 @@
 #include <set>
 #include <cmath>
 #include <ctime>
+#include <cstdio>
 #include <mutex>
+#include <atomic>
+#include <condition_variable>
 #include <string>
+#include <deque>
+#include <unordered_map>
 #include <vector>
 #include <memory>
 #include <sstream>
@@ -133,14 +149,17 @@ const size_t MAX_SIZE = MAXBYTE;
  */
 
 class CBuffer;
+class CBufferView;
 
+#ifdef _WIN32
 bool vuapi IsAdministrator();
 bool SetPrivilegeA(const std::string&  Privilege, const bool Enable);
 bool SetPrivilegeW(const std::wstring& Privilege, const bool Enable);
 std::string vuapi  GetEnviromentA(const std::string  EnvName);
 std::wstring vuapi GetEnviromentW(const std::wstring EnvName);
-std::pair<bool, size_t> FindPatternA(const CBuffer& Buffer, const std::string&  Pattern);
-std::pair<bool, size_t> FindPatternW(const CBuffer& Buffer, const std::wstring& Pattern);
+#endif // _WIN32
+std::pair<bool, size_t> FindPatternA(const CBufferView& Buffer, const std::string&  Pattern);
+std::pair<bool, size_t> FindPatternW(const CBufferView& Buffer, const std::wstring& Pattern);
 std::pair<bool, size_t> FindPatternA(const void* Pointer, const size_t Size, const std::string&  Pattern);
 std::pair<bool, size_t> FindPatternW(const void* Pointer, const size_t Size, const std::wstring& Pattern);
 
@@ -159,95 +178,258 @@ void vuapi HexDump(const void* Data, int Size);
  * String Formatting
  */
 
+typedef enum _ENCODING_TYPE
+{
+  ET_UNKNOWN      = -1,
+  ET_UTF8         = 0, // "ANSI/UTF-8", "ANSI/UTF-8"
+  ET_UTF8_BOM     = 1, // "UTF-8 BOM", "UTF-8 BOM"
+  ET_UTF16_LE     = 2, // "Unicode", "UTF-16 Little Endian"
+  ET_UTF16_BE     = 3, // "Unicode BE", "UTF-16 Big Endian"
+  ET_UTF16_LE_BOM = 4, // "Unicode BOM", "UTF-16 Little Endian BOM"
+  ET_UTF16_BE_BOM = 5, // "Unicode BE BOM", "UTF-16 Big Endian BOM"
+  ET_UTF32_LE_BOM = 6, // "UTF-32 LE BOM", "UTF-32 Little Endian BOM"
+  ET_UTF32_BE_BOM = 7, // "UTF-32 BE BOM", "UTF-32 Big Endian BOM"
+} eEncodingType;
+
+typedef enum _STD_BYTES : int
+{
+  SI  = 1000, // 1 KB  = 1000 bytes
+  IEC = 1024, // 1 KiB = 1024 bytes
+} eStdByte;
+
+/**
+ * Type-safe Format
+ * The printf conversions are kept, but an argument is written by its own type (not by the conversion)
+ * so a mismatched argument never reads garbage. A type that is not supported fails to compile.
+ */
+
+typedef enum _FORMAT_ARG_TYPE
+{
+  FA_BOOL     = 0,
+  FA_CHAR     = 1,
+  FA_INT      = 2,
+  FA_UINT     = 3,
+  FA_FLOAT    = 4,
+  FA_POINTER  = 5,
+  FA_STRING_A = 6,
+  FA_STRING_W = 7,
+} eFormatArgType;
+
+/**
+ * A type-erased argument, a string is kept by its pointer so it must outlive the formatting.
+ */
+class CFormatArg
+{
+public:
+  CFormatArg(const bool v) : Type(FA_BOOL), Length(0) { Value.Int = v ? 1 : 0; }
+  CFormatArg(const char v) : Type(FA_CHAR), Length(0) { Value.UInt = byte(v); }
+  CFormatArg(const wchar v) : Type(FA_CHAR), Length(0) { Value.UInt = v; }
+  CFormatArg(const signed char v) : Type(FA_INT), Length(sizeof(v)) { Value.Int = v; }
+  CFormatArg(const unsigned char v) : Type(FA_UINT), Length(sizeof(v)) { Value.UInt = v; }
+  CFormatArg(const short v) : Type(FA_INT), Length(sizeof(v)) { Value.Int = v; }
+  CFormatArg(const unsigned short v) : Type(FA_UINT), Length(sizeof(v)) { Value.UInt = v; }
+  CFormatArg(const int v) : Type(FA_INT), Length(sizeof(v)) { Value.Int = v; }
+  CFormatArg(const unsigned int v) : Type(FA_UINT), Length(sizeof(v)) { Value.UInt = v; }
+  CFormatArg(const long v) : Type(FA_INT), Length(sizeof(v)) { Value.Int = v; }
+  CFormatArg(const unsigned long v) : Type(FA_UINT), Length(sizeof(v)) { Value.UInt = v; }
+  CFormatArg(const long long v) : Type(FA_INT), Length(sizeof(v)) { Value.Int = v; }
+  CFormatArg(const unsigned long long v) : Type(FA_UINT), Length(sizeof(v)) { Value.UInt = v; }
+  CFormatArg(const float v) : Type(FA_FLOAT), Length(0) { Value.Float = v; }
+  CFormatArg(const double v) : Type(FA_FLOAT), Length(0) { Value.Float = v; }
+  CFormatArg(const long double v) : Type(FA_FLOAT), Length(0) { Value.Float = double(v); }
+  CFormatArg(const void* v) : Type(FA_POINTER), Length(0) { Value.Pointer = v; }
+  CFormatArg(std::nullptr_t) : Type(FA_POINTER), Length(0) { Value.Pointer = nullptr; }
+  CFormatArg(const char* v) : Type(FA_STRING_A), Length(v != nullptr ? strlen(v) : 0) { Value.StringA = v; }
+  CFormatArg(const wchar* v) : Type(FA_STRING_W), Length(v != nullptr ? wcslen(v) : 0) { Value.StringW = v; }
+  CFormatArg(const std::string& v) : Type(FA_STRING_A), Length(v.size()) { Value.StringA = v.data(); }
+  CFormatArg(const std::wstring& v) : Type(FA_STRING_W), Length(v.size()) { Value.StringW = v.data(); }
+
+  eFormatArgType Type;
+
+  union
+  {
+    long long Int;
+    ulonglong UInt;
+    double Float;
+    const void* Pointer;
+    const char* StringA;
+    const wchar* StringW;
+  } Value;
+
+  size_t Length; // The length of a string or the size of an integer
+};
+
+class CBuffer;
+
+/**
+ * Formats into a stack buffer, the heap is only used when the result overflows it.
+ * The Append functions append the result to an existing string or buffer.
+ */
+std::string vuapi FormatArgsA(const std::string& Format, const CFormatArg* pArgs, const size_t nArgs);
+std::wstring vuapi FormatArgsW(const std::wstring& Format, const CFormatArg* pArgs, const size_t nArgs);
+void vuapi AppendFormatArgsA(std::string& Result, const std::string& Format, const CFormatArg* pArgs, const size_t nArgs);
+void vuapi AppendFormatArgsW(std::wstring& Result, const std::wstring& Format, const CFormatArg* pArgs, const size_t nArgs);
+void vuapi AppendFormatArgsA(CBuffer& Result, const std::string& Format, const CFormatArg* pArgs, const size_t nArgs);
+void vuapi AppendFormatArgsW(CBuffer& Result, const std::wstring& Format, const CFormatArg* pArgs, const size_t nArgs);
+
+#include "template/format.tpl"
+
+typedef enum _PARSE_STATUS
+{
+  PS_OK       = 0,
+  PS_EMPTY    = 1, // No number
+  PS_INVALID  = 2, // A character after the number
+  PS_OVERFLOW = 3, // The number is out of the range of the type
+} eParseStatus;
+
+/**
+ * A value that is kept as its text, the text is parsed on the first request of a type and the result is cached.
+ * The integers are decimal (a leading zero as well, e.g. "08") or hexadecimal by the prefix 0x, the booleans also take
+ * true/yes/on and false/no/off. A boolean is written as 1/0.
+ * A parse error is reported by pStatus, then the value is the parsed prefix (as atoi) or saturated on overflow.
+ */
 class CFundamentalA
 {
 public:
   CFundamentalA();
+  CFundamentalA(const std::string& text);
   virtual ~CFundamentalA();
 
   template<typename T>
   friend CFundamentalA& operator<<(CFundamentalA& stream, T v)
   {
-    stream.m_Data << v;
+    stream.Append(CFormatArg(v));
     return stream;
   }
 
-  std::stringstream& vuapi Data();
+  const std::string& vuapi Data() const;
+  void vuapi Assign(const std::string& text);
+  void vuapi Clear();
   std::string vuapi String() const;
-  int vuapi Integer() const;
-  long vuapi Long() const;
-  bool vuapi Boolean() const;
-  float vuapi Float() const;
-  double vuapi Double() const;
+  int vuapi Integer(eParseStatus* pStatus = nullptr) const;
+  long vuapi Long(eParseStatus* pStatus = nullptr) const;
+  long long vuapi LongLong(eParseStatus* pStatus = nullptr) const;
+  bool vuapi Boolean(eParseStatus* pStatus = nullptr) const;
+  float vuapi Float(eParseStatus* pStatus = nullptr) const;
+  double vuapi Double(eParseStatus* pStatus = nullptr) const;
+
+private:
+  void vuapi Append(const CFormatArg& arg);
 
 private:
-  std::stringstream m_Data;
+  std::string m_Data;
+  mutable int m_Parsed; // The bits of the cached types
+  mutable long long m_Integer;
+  mutable double m_Double;
+  mutable eParseStatus m_IntegerStatus;
+  mutable eParseStatus m_DoubleStatus;
 };
 
 class CFundamentalW
 {
 public:
   CFundamentalW();
+  CFundamentalW(const std::wstring& text);
   virtual ~CFundamentalW();
 
   template<typename T>
   friend CFundamentalW& operator<<(CFundamentalW& stream, T v)
   {
-    stream.m_Data << v;
+    stream.Append(CFormatArg(v));
     return stream;
   }
 
-  std::wstringstream& vuapi Data();
+  const std::wstring& vuapi Data() const;
+  void vuapi Assign(const std::wstring& text);
+  void vuapi Clear();
   std::wstring vuapi String() const;
-  int vuapi Integer() const;
-  long vuapi Long() const;
-  bool vuapi Boolean() const;
-  float vuapi Float() const;
-  double vuapi Double() const;
+  int vuapi Integer(eParseStatus* pStatus = nullptr) const;
+  long vuapi Long(eParseStatus* pStatus = nullptr) const;
+  long long vuapi LongLong(eParseStatus* pStatus = nullptr) const;
+  bool vuapi Boolean(eParseStatus* pStatus = nullptr) const;
+  float vuapi Float(eParseStatus* pStatus = nullptr) const;
+  double vuapi Double(eParseStatus* pStatus = nullptr) const;
 
 private:
-  std::wstringstream m_Data;
-};
-
-typedef enum _ENCODING_TYPE
-{
-  ET_UNKNOWN      = -1,
-  ET_UTF8         = 0, // "ANSI/UTF-8", "ANSI/UTF-8"
-  ET_UTF8_BOM     = 1, // "UTF-8 BOM", "UTF-8 BOM"
-  ET_UTF16_LE     = 2, // "Unicode", "UTF-16 Little Endian"
-  ET_UTF16_BE     = 3, // "Unicode BE", "UTF-16 Big Endian"
-  ET_UTF16_LE_BOM = 4, // "Unicode BOM", "UTF-16 Little Endian BOM"
-  ET_UTF16_BE_BOM = 5, // "Unicode BE BOM", "UTF-16 Big Endian BOM"
-  ET_UTF32_LE_BOM = 6, // "UTF-32 LE BOM", "UTF-32 Little Endian BOM"
-  ET_UTF32_BE_BOM = 7, // "UTF-32 BE BOM", "UTF-32 Big Endian BOM"
-} eEncodingType;
+  void vuapi Append(const CFormatArg& arg);
 
-typedef enum _STD_BYTES : int
-{
-  SI  = 1000, // 1 KB  = 1000 bytes
-  IEC = 1024, // 1 KiB = 1024 bytes
-} eStdByte;
+private:
+  std::wstring m_Data;
+  mutable int m_Parsed;
+  mutable long long m_Integer;
+  mutable double m_Double;
+  mutable eParseStatus m_IntegerStatus;
+  mutable eParseStatus m_DoubleStatus;
+};
 
 std::string vuapi FormatA(const std::string Format, ...);
 std::wstring vuapi FormatW(const std::wstring Format, ...);
 void vuapi MsgA(const std::string Format, ...);
 void vuapi MsgW(const std::wstring Format, ...);
+#ifdef _WIN32
 int vuapi BoxA(const std::string Format, ...);
 int vuapi BoxW(const std::wstring Format, ...);
 int vuapi BoxA(HWND hWnd, const std::string Format, ...);
 int vuapi BoxW(HWND hWnd, const std::wstring Format, ...);
 int vuapi BoxA(HWND hWnd, uint uType, const std::string& Caption, const std::string Format, ...);
 int vuapi BoxW(HWND hWnd, uint uType, const std::wstring& Caption, const std::wstring Format, ...);
+#endif // _WIN32
 std::string vuapi LastErrorA(ulong ulErrorCode = -1);
 std::wstring vuapi LastErrorW(ulong ulErrorCode = -1);
 std::string vuapi FormatDateTimeA(const time_t t, const std::string Format);
 std::wstring vuapi FormatDateTimeW(const time_t t, const std::wstring Format);
 std::string vuapi DateTimeToStringA(const time_t t);
 std::wstring vuapi DateTimeToStringW(const time_t t);
-eEncodingType vuapi DetermineEncodingType(const void* Data, const size_t size);
+/**
+ * Determines the encoding of a text by its BOM, else by scanning the whole text.
+ * @param[out] pConfidence  The confidence of the result, from 0 to 1.
+ */
+eEncodingType vuapi DetermineEncodingType(const void* Data, const size_t size, float* pConfidence = nullptr);
 std::string vuapi FormatBytesA(long long Bytes, eStdByte Std = eStdByte::IEC, int Digits = 2);
 std::wstring vuapi FormatBytesW(long long Bytes, eStdByte Std = eStdByte::IEC, int Digits = 2);
 
+/**
+ * An encoding detector that is fed by the blocks of a text (e.g. the blocks of a large file).
+ * A text without BOM is classified by validating it as UTF-8 and by the parity of its zero bytes,
+ * the ASCII letters of UTF-16 text have their zero bytes all at the odd (LE) or even (BE) offsets.
+ */
+class CEncodingDetector
+{
+public:
+  /**
+   * @param[in] limit The number of bytes to scan at most, zero to scan all.
+   */
+  CEncodingDetector(const size_t limit = 0);
+  virtual ~CEncodingDetector();
+
+  void Reset();
+
+  /**
+   * Scans the next block of the text.
+   * @return  False if it does not need more blocks (the BOM is found or the limit is reached).
+   */
+  bool Update(const void* data, const size_t size);
+
+  size_t GetScannedSize() const;
+  eEncodingType GetEncoding() const;
+  float GetConfidence() const;
+
+private:
+  void Validate(const byte* p, const size_t n);
+  eEncodingType Classify(float& confidence) const;
+
+private:
+  size_t m_Limit;
+  size_t m_Scanned;
+  eEncodingType m_BOM;
+  byte m_Head[4];     // The first bytes, they are kept until the BOM can be checked
+  size_t m_Zeros[2];  // The zero bytes at the even and the odd offsets
+  size_t m_Sequences; // The valid UTF-8 multi-byte sequences
+  size_t m_Invalids;  // The ill-formed UTF-8 sequences
+  size_t m_Pending;   // The continuation bytes expected by the current UTF-8 sequence
+  byte m_Lo, m_Hi;    // The range of the next continuation byte
+};
+
 /**
  * String Working
  */
@@ -259,10 +441,35 @@ typedef enum class _TRIM_STRING
   TS_BOTH  = 2,
 } eTrimType;
 
+#include "template/strview.tpl"
+#include "template/strreplace.tpl"
+#include "template/strbuilder.tpl"
+
+typedef CStringViewT<char>  CStringViewA;
+typedef CStringViewT<wchar> CStringViewW;
+typedef CSplitStringT<char>  CSplitStringA;
+typedef CSplitStringT<wchar> CSplitStringW;
+typedef CMultiStringT<char>  CMultiStringA;
+typedef CMultiStringT<wchar> CMultiStringW;
+typedef CReplaceTableT<char>  CReplaceTableA;
+typedef CReplaceTableT<wchar> CReplaceTableW;
+typedef CStringBuilderT<char>  CStringBuilderA;
+typedef CStringBuilderT<wchar> CStringBuilderW;
+typedef CStringArenaT<char>  CStringArenaA;
+typedef CStringArenaT<wchar> CStringArenaW;
+
 std::string vuapi LowerStringA(const std::string& String);
 std::wstring vuapi LowerStringW(const std::wstring& String);
 std::string vuapi UpperStringA(const std::string& String);
 std::wstring vuapi UpperStringW(const std::wstring& String);
+void vuapi LowerStringInPlaceA(std::string& String);
+void vuapi LowerStringInPlaceW(std::wstring& String);
+void vuapi UpperStringInPlaceA(std::string& String);
+void vuapi UpperStringInPlaceW(std::wstring& String);
+int vuapi CompareIgnoreCaseA(const CStringViewA& Left, const CStringViewA& Right); // ASCII letters only
+int vuapi CompareIgnoreCaseW(const CStringViewW& Left, const CStringViewW& Right); // ASCII letters only
+bool vuapi EqualsIgnoreCaseA(const CStringViewA& Left, const CStringViewA& Right);
+bool vuapi EqualsIgnoreCaseW(const CStringViewW& Left, const CStringViewW& Right);
 std::string vuapi ToStringA(const std::wstring& String);
 std::wstring vuapi ToStringW(const std::string& String);
 std::vector<std::string> vuapi SplitStringA(
@@ -279,8 +486,19 @@ std::vector<std::string> vuapi MultiStringToListA(const char* lpcszMultiString);
 std::vector<std::wstring> vuapi MultiStringToListW(const wchar* lpcwszMultiString);
 std::unique_ptr<char[]> vuapi ListToMultiStringA(const std::vector<std::string>& StringList);
 std::unique_ptr<wchar[]> vuapi ListToMultiStringW(const std::vector<std::wstring>& StringList);
+
+/**
+ * Encodes a list to a multi-string in a caller buffer, the size is computed once.
+ * Returns the size of the multi-string in characters, nothing is written if the buffer is too small.
+ */
+size_t vuapi ListToMultiStringA(const std::vector<std::string>& StringList, char* pBuffer, const size_t Count);
+size_t vuapi ListToMultiStringW(const std::vector<std::wstring>& StringList, wchar* pBuffer, const size_t Count);
+bool vuapi ListToMultiStringA(const std::vector<std::string>& StringList, CBuffer& Buffer);
+bool vuapi ListToMultiStringW(const std::vector<std::wstring>& StringList, CBuffer& Buffer);
+#ifdef _WIN32
 std::string vuapi LoadRSStringA(const UINT uID, const std::string& ModuleName = "");
 std::wstring vuapi LoadRSStringW(const UINT uID, const std::wstring& ModuleName = L"");
+#endif // _WIN32
 std::string vuapi TrimStringA(
   const std::string& String,
   const eTrimType& TrimType = eTrimType::TS_BOTH,
@@ -291,13 +509,127 @@ std::wstring vuapi TrimStringW(
   const eTrimType& TrimType = eTrimType::TS_BOTH,
   const std::wstring& TrimChars = L" \t\n\r\f\v"
 );
+/**
+ * Trims a string into a builder, the trimmed string is appended to the builder.
+ */
+void vuapi TrimStringA(
+  CStringBuilderA& Result,
+  const CStringViewA& String,
+  const eTrimType TrimType = eTrimType::TS_BOTH,
+  const CStringViewA& TrimChars = " \t\n\r\f\v"
+);
+void vuapi TrimStringW(
+  CStringBuilderW& Result,
+  const CStringViewW& String,
+  const eTrimType TrimType = eTrimType::TS_BOTH,
+  const CStringViewW& TrimChars = L" \t\n\r\f\v"
+);
 std::string vuapi ReplaceA(const std::string& Text, const std::string& From, const std::string& To);
 std::wstring vuapi ReplaceW(const std::wstring& Text, const std::wstring& From, const std::wstring& To);
+std::string vuapi ReplaceManyA(const std::string& Text, const std::vector<std::pair<std::string, std::string>>& Pairs);
+std::wstring vuapi ReplaceManyW(const std::wstring& Text, const std::vector<std::pair<std::wstring, std::wstring>>& Pairs);
 bool vuapi StartsWithA(const std::string& Text, const std::string& With);
 bool vuapi StartsWithW(const std::wstring& Text, const std::wstring& With);
 bool vuapi EndsWithA(const std::string& Text, const std::string& With);
 bool vuapi EndsWithW(const std::wstring& Text, const std::wstring& With);
 
+/**
+ * Unicode Transcoding
+ */
+
+typedef enum _UNICODE_FORM
+{
+  UF_UTF8    = 0,
+  UF_UTF16LE = 1,
+  UF_UTF16BE = 2,
+  UF_UTF32LE = 3,
+  UF_UTF32BE = 4,
+} eUnicodeForm;
+
+typedef enum _TRANSCODE_STATUS
+{
+  TC_OK        = 0,
+  TC_INVALID   = 1, // An ill-formed sequence (overlong, surrogate, out of range)
+  TC_TRUNCATED = 2, // An incomplete sequence at the end of the source
+  TC_OVERFLOW  = 3, // The target buffer is too small
+} eTranscodeStatus;
+
+typedef struct _TRANSCODE_RESULT
+{
+  eTranscodeStatus Status;
+  size_t Read;    // The source bytes that are transcoded, it is the offset of the error on failure
+  size_t Written; // The target bytes that are written (or required)
+} TTranscodeResult;
+
+/**
+ * Transcodes a string between the Unicode encoding forms into a caller-provided buffer, no BOM is read or written.
+ * An ill-formed sequence stops it at the offset of the sequence, or it is written as U+FFFD if replace is set.
+ * @param[in] target  Null to only compute the exact size of the output.
+ */
+TTranscodeResult vuapi Transcode(
+  const void* source, const size_t size, const eUnicodeForm from,
+  void* target, const size_t capacity, const eUnicodeForm to,
+  const bool replace = false
+);
+TTranscodeResult vuapi GetTranscodedSize(
+  const void* source, const size_t size, const eUnicodeForm from,
+  const eUnicodeForm to,
+  const bool replace = false
+);
+std::string vuapi ToUTF8(const std::wstring& String);
+std::wstring vuapi FromUTF8(const std::string& String);
+
+/**
+ * Binary To Text
+ * The hexadecimal digits (2 per byte) and Base64 (RFC 4648, padded), the hexadecimal digits are vectorized.
+ * The decoders return false for an invalid text, a Base64 text may omit its padding.
+ */
+
+std::string vuapi ToHexStringA(const void* Data, const size_t Size, const bool Upper = true);
+std::wstring vuapi ToHexStringW(const void* Data, const size_t Size, const bool Upper = true);
+bool vuapi FromHexStringA(const std::string& Text, CBuffer& Data);
+bool vuapi FromHexStringW(const std::wstring& Text, CBuffer& Data);
+std::string vuapi ToBase64A(const void* Data, const size_t Size);
+std::wstring vuapi ToBase64W(const void* Data, const size_t Size);
+bool vuapi FromBase64A(const std::string& Text, CBuffer& Data);
+bool vuapi FromBase64W(const std::wstring& Text, CBuffer& Data);
+
+/**
+ * A hex dump formatter that renders the lines into a sink, it is fed by the blocks of the data
+ * so a huge input is dumped in a stream. The lines are buffered and passed to the sink in chunks.
+ * The last partial line is written by End() or by the destructor.
+ */
+class CHexDump
+{
+public:
+  typedef std::function<void(const char* text, const size_t length)> FnSink;
+
+  /**
+   * @param[in] width The number of the bytes per line.
+   * @param[in] base  The offset of the first byte, e.g. its address.
+   */
+  CHexDump(const FnSink fnSink, const size_t width = 16, const ulonglong base = 0);
+  CHexDump(std::string& text, const size_t width = 16, const ulonglong base = 0);
+  CHexDump(CBuffer& buffer, const size_t width = 16, const ulonglong base = 0);
+  CHexDump(FILE* file, const size_t width = 16, const ulonglong base = 0);
+  virtual ~CHexDump();
+
+  void Update(const void* data, const size_t size);
+  void End();
+
+private:
+  void Initialize(const size_t width, const ulonglong base);
+  void WriteLine(const byte* data, const size_t size);
+  void Flush();
+
+private:
+  FnSink m_fnSink;
+  size_t m_Width;
+  ulonglong m_Offset;      // The offset of the pending line
+  std::vector<byte> m_Line; // The bytes of the pending line
+  std::string m_Text;
+};
+
 /**
  * Process Working
  */
@@ -315,6 +647,14 @@ typedef enum _WOW64
   WOW64_YES   = 1,
 } eWow64;
 
+typedef struct _BLOCK
+{
+  void*  Address;
+  SIZE_T Size;
+} TBlock;
+
+#ifdef _WIN32
+
 #ifndef PROCESSOR_ARCHITECTURE_NEUTRAL
 #define PROCESSOR_ARCHITECTURE_NEUTRAL 11
 #endif
@@ -336,12 +676,6 @@ typedef enum _PROCESSOR_ARCHITECTURE
   PA_UNKNOWN = PROCESSOR_ARCHITECTURE_UNKNOWN,
 } eProcessorArchitecture;
 
-typedef struct _BLOCK
-{
-  void*  Address;
-  SIZE_T Size;
-} TBlock;
-
 eProcessorArchitecture GetProcessorArchitecture();
 eWow64 vuapi IsWow64(const ulong ulPID = INVALID_PID_VALUE); /* -1: Error, 0: False, 1: True */
 eWow64 vuapi IsWow64(const HANDLE hProcess);
@@ -440,6 +774,8 @@ std::wstring vuapi DecodeWMW(const ulong id);
 TFontA vuapi GetFontA(HWND hw);
 TFontW vuapi GetFontW(HWND hw);
 
+#endif // _WIN32
+
 /**
  * File/Directory Working
  */
@@ -462,8 +798,10 @@ bool vuapi IsDirectoryExistsA(const std::string& Directory);
 bool vuapi IsDirectoryExistsW(const std::wstring& Directory);
 bool vuapi IsFileExistsA(const std::string& FilePath);
 bool vuapi IsFileExistsW(const std::wstring& FilePath);
+#ifdef _WIN32
 std::string vuapi FileTypeA(const std::string& FilePath);
 std::wstring vuapi FileTypeW(const std::wstring& FilePath);
+#endif // _WIN32
 std::string vuapi ExtractFileDirectoryA(const std::string& FilePath, bool Slash = true);
 std::wstring vuapi ExtractFileDirectoryW(const std::wstring& FilePath, bool Slash = true);
 std::string vuapi ExtractFileNameA(const std::string& FilePath, bool Extension = true);
@@ -490,6 +828,14 @@ std::wstring vuapi JoinPathW(
 );
 std::string vuapi NormalizePathA(const std::string& Path, const ePathSep Separator = ePathSep::WIN);
 std::wstring vuapi NormalizePathW(const std::wstring& Path, const ePathSep Separator = ePathSep::WIN);
+/**
+ * Joins/normalizes a path into a builder, the result is appended to the builder.
+ * JoinPath joins to the path that is already in the builder, the others must not view the builder itself.
+ */
+void vuapi JoinPathA(CStringBuilderA& Result, const CStringViewA& Right, const ePathSep Separator = ePathSep::WIN);
+void vuapi JoinPathW(CStringBuilderW& Result, const CStringViewW& Right, const ePathSep Separator = ePathSep::WIN);
+void vuapi NormalizePathA(CStringBuilderA& Result, const CStringViewA& Path, const ePathSep Separator = ePathSep::WIN);
+void vuapi NormalizePathW(CStringBuilderW& Result, const CStringViewW& Path, const ePathSep Separator = ePathSep::WIN);
 
 /*----------- The definition of common function(s) which compatible both ANSI & UNICODE ----------*/
 
@@ -510,12 +856,27 @@ std::wstring vuapi NormalizePathW(const std::wstring& Path, const ePathSep Separ
 /* String Working */
 #define LowerString LowerStringW
 #define UpperString UpperStringW
+#define LowerStringInPlace LowerStringInPlaceW
+#define UpperStringInPlace UpperStringInPlaceW
+#define CompareIgnoreCase CompareIgnoreCaseW
+#define EqualsIgnoreCase EqualsIgnoreCaseW
 #define SplitString SplitStringW
+#define CStringView CStringViewW
+#define CSplitString CSplitStringW
+#define CMultiString CMultiStringW
+#define CReplaceTable CReplaceTableW
+#define CStringBuilder CStringBuilderW
+#define CStringArena CStringArenaW
 #define MultiStringToList MultiStringToListW
 #define ListToMultiString ListToMultiStringW
 #define LoadRSString LoadRSStringW
 #define TrimString TrimStringW
 #define ReplaceString ReplaceW
+#define ReplaceMany ReplaceManyW
+#define ToHexString ToHexStringW
+#define FromHexString FromHexStringW
+#define ToBase64 ToBase64W
+#define FromBase64 FromBase64W
 #define StartsWith StartsWithW
 #define EndsWith EndsWithW
 /* Window Working */
@@ -555,11 +916,27 @@ std::wstring vuapi NormalizePathW(const std::wstring& Path, const ePathSep Separ
 /* String Working */
 #define LowerString LowerStringA
 #define UpperString UpperStringA
+#define LowerStringInPlace LowerStringInPlaceA
+#define UpperStringInPlace UpperStringInPlaceA
+#define CompareIgnoreCase CompareIgnoreCaseA
+#define EqualsIgnoreCase EqualsIgnoreCaseA
 #define SplitString SplitStringA
+#define CStringView CStringViewA
+#define CSplitString CSplitStringA
+#define CMultiString CMultiStringA
+#define CReplaceTable CReplaceTableA
+#define CStringBuilder CStringBuilderA
+#define CStringArena CStringArenaA
 #define MultiStringToList MultiStringToListA
+#define ListToMultiString ListToMultiStringA
 #define LoadRSString LoadRSStringA
 #define TrimString TrimStringA
 #define ReplaceString ReplaceA
+#define ReplaceMany ReplaceManyA
+#define ToHexString ToHexStringA
+#define FromHexString FromHexStringA
+#define ToBase64 ToBase64A
+#define FromBase64 FromBase64A
 #define StartsWith StartsWithA
 #define EndsWith EndsWithA
 /* Window Working */
@@ -631,6 +1008,7 @@ protected:
  */
 
 #include "template/singleton.tpl"
+#include "template/rcu.tpl"
 
 /**
  * Globally Unique Identifier
@@ -698,6 +1076,106 @@ public:
 
 #endif // VU_GUID_ENABLED
 
+/**
+ * CAllocator
+ */
+
+/**
+ * The memory allocation policy of CBuffer.
+ * The size of a block is passed back on Reallocate/Free, so an allocator does not need to store it.
+ */
+class CAllocator
+{
+public:
+  CAllocator() {}
+  virtual ~CAllocator() {}
+
+  virtual void* Allocate(const size_t size) = 0;
+  virtual void* Reallocate(void* ptr, const size_t size, const size_t newsize) = 0;
+  virtual void  Free(void* ptr, const size_t size) = 0;
+};
+
+/**
+ * The C run-time heap (the default allocator).
+ */
+class CHeapAllocator : public CAllocator
+{
+public:
+  virtual void* Allocate(const size_t size);
+  virtual void* Reallocate(void* ptr, const size_t size, const size_t newsize);
+  virtual void  Free(void* ptr, const size_t size);
+
+  static CHeapAllocator& Instance();
+};
+
+/**
+ * A pool of size classes (64 B to 64 KiB), each one carved from 256 KiB slabs that are owned by a few
+ * shards (a spin lock each), the threads are spread over the shards. A block is freed to its own slab
+ * by any thread, and an empty slab is released except one that is kept per shard and size class.
+ * The bigger blocks go to the heap.
+ */
+class CPoolAllocator : public CAllocator
+{
+public:
+  virtual void* Allocate(const size_t size);
+  virtual void* Reallocate(void* ptr, const size_t size, const size_t newsize);
+  virtual void  Free(void* ptr, const size_t size);
+
+  static CPoolAllocator& Instance();
+};
+
+/**
+ * CBufferView
+ */
+
+/**
+ * A non-owning view (pointer and size) over a range of bytes.
+ * The viewed memory must outlive the view, slicing a view never allocates.
+ */
+class CBufferView
+{
+public:
+  CBufferView();
+  CBufferView(const void* pData, const size_t size);
+  CBufferView(const CBuffer& buffer);
+
+  bool operator==(const CBufferView& right) const;
+  bool operator!=(const CBufferView& right) const;
+  const byte& operator[](const size_t offset) const;
+  CBufferView operator()(int begin, int end) const;
+
+  const byte* GetpBytes() const;
+  const void* GetpData() const;
+  size_t GetSize() const;
+
+  bool Empty() const;
+
+  bool Match(const void* pdata, const size_t size) const;
+  bool Match(const CBufferView& view) const;
+  size_t Find(const void* pdata, const size_t size) const;
+  size_t Find(const CBufferView& view) const;
+  size_t FindNext(const void* pdata, const size_t size, const size_t offset) const;
+  size_t FindNext(const CBufferView& view, const size_t offset) const;
+  size_t RFind(const void* pdata, const size_t size) const;
+  size_t RFind(const CBufferView& view) const;
+  std::vector<size_t> FindAll(const void* pdata, const size_t size) const;
+  std::vector<size_t> FindAll(const CBufferView& view) const;
+  size_t FindParallel(const CBufferView& view, const size_t nthreads = MAX_NTHREADS) const;
+  std::vector<size_t> FindAllParallel(const CBufferView& view, const size_t nthreads = MAX_NTHREADS) const;
+  CBufferView Till(const void* pdata, const size_t size) const;
+  CBufferView Till(const CBufferView& view) const;
+  CBufferView Slice(int begin, int end) const;
+
+  CBuffer ToBuffer() const;
+
+  std::string  ToStringA() const;
+  std::wstring ToStringW() const;
+
+private:
+  const byte* m_pBytes;
+  size_t m_Size;
+};
+
 /**
  * CBuffer
  */
@@ -707,11 +1185,13 @@ class CBuffer
 public:
   CBuffer();
   CBuffer(const void* pData, const size_t size);
-  CBuffer(const size_t size);
+  CBuffer(const size_t size, const bool initialize = true, CAllocator* pAllocator = nullptr);
   CBuffer(const CBuffer& right);
+  CBuffer(CBuffer&& right);
   virtual ~CBuffer();
 
   const CBuffer& operator=(const CBuffer& right);
+  const CBuffer& operator=(CBuffer&& right);
   bool  operator==(const CBuffer& right) const;
   bool  operator!=(const CBuffer& right) const;
   byte& operator[](const size_t offset);
@@ -720,21 +1200,39 @@ public:
   byte*  GetpBytes() const;
   void*  GetpData() const;
   size_t GetSize() const;
+  size_t GetCapacity() const;
+  CAllocator* GetAllocator() const;
 
   bool Empty() const;
 
   void Reset();
   void Fill(const byte v = 0);
-  bool Resize(const size_t size);
+  bool Resize(const size_t size, const bool initialize = true);
+  bool Reserve(const size_t size);
+  bool ShrinkToFit();
   bool Replace(const void* pData, const size_t size);
-  bool Replace(const CBuffer& right);
+  bool Replace(const CBufferView& view);
   bool Match(const void* pdata, const size_t size) const;
+  bool Match(const CBufferView& view) const;
   size_t Find(const void* pdata, const size_t size) const;
+  size_t Find(const CBufferView& view) const;
+  size_t FindNext(const void* pdata, const size_t size, const size_t offset) const;
+  size_t FindNext(const CBufferView& view, const size_t offset) const;
+  size_t RFind(const void* pdata, const size_t size) const;
+  size_t RFind(const CBufferView& view) const;
+  std::vector<size_t> FindAll(const void* pdata, const size_t size) const;
+  std::vector<size_t> FindAll(const CBufferView& view) const;
+  size_t FindParallel(const CBufferView& view, const size_t nthreads = MAX_NTHREADS) const;
+  std::vector<size_t> FindAllParallel(const CBufferView& view, const size_t nthreads = MAX_NTHREADS) const;
   CBuffer Till(const void* pdata, const size_t size) const;
+  CBuffer Till(const CBufferView& view) const;
   CBuffer Slice(int begin, int end) const;
 
+  CBufferView View() const;
+  CBufferView View(int begin, int end) const;
+
   bool Append(const void* pData, const size_t size);
-  bool Append(const CBuffer& right);
+  bool Append(const CBufferView& view);
 
   std::string  ToStringA() const;
   std::wstring ToStringW() const;
@@ -743,14 +1241,285 @@ public:
   bool SaveAsFile(const std::wstring& filePath);
 
 private:
-  bool Create(void* ptr, const size_t size, const bool clean = true);
+  bool Create(const void* ptr, const size_t size, const bool initialize = true);
+  bool Reallocate(const size_t capacity);
+  bool Grow(const size_t size);
   bool Delete();
+  CAllocator& Allocator() const;
 
 private:
+  static const size_t SMALL_SIZE = 32; // The payload that fits this size is stored inline
+
+  CAllocator* m_pAllocator; // The heap if it is null
   void*  m_pData;
   size_t m_Size;
+  size_t m_Capacity;
+  byte   m_Small[SMALL_SIZE];
+};
+
+/**
+ * CChainBuffer
+ */
+
+/**
+ * A buffer made of a chain of fixed-size segments, the data is never moved once it is written.
+ * Appending costs O(1) whatever the size is, the segments are exposed as blocks for scatter-gather I/O.
+ * The data is copied into a contiguous buffer only on demand.
+ */
+class CChainBuffer
+{
+public:
+  static const size_t DEFAULT_SEGMENT_SIZE = 64 * KiB;
+
+  CChainBuffer(const size_t segmentsize = DEFAULT_SEGMENT_SIZE, CAllocator* pAllocator = nullptr);
+  CChainBuffer(const CChainBuffer& right);
+  CChainBuffer(CChainBuffer&& right);
+  virtual ~CChainBuffer();
+
+  const CChainBuffer& operator=(const CChainBuffer& right);
+  const CChainBuffer& operator=(CChainBuffer&& right);
+
+  size_t GetSize() const;
+  size_t GetCount() const;
+  size_t GetSegmentSize() const;
+
+  bool Empty() const;
+
+  void Reset();
+
+  void Append(const void* ptr, const size_t size);
+  void Append(const CBufferView& data);
+
+  /**
+   * Gets the free space at the end of the chain, to write into it directly (eg. recv/readv).
+   * Commit then makes the written bytes part of the buffer.
+   */
+  byte* Prepare(size_t& size);
+  void Commit(const size_t size);
+
+  /**
+   * Drops the bytes at the front of the chain (eg. after a partial send/writev).
+   */
+  void Consume(const size_t size);
+
+  std::vector<TBlock> GetBlocks() const;
+
+  size_t CopyTo(void* ptr, const size_t size, const size_t offset = 0) const;
+
+  CBuffer ToBuffer() const;
+  CBufferView Linearize();
+
+private:
+  size_t m_SegmentSize;
+  CAllocator* m_pAllocator;
+  std::deque<CBuffer> m_Segments;
+  size_t m_Offset; // The consumed bytes of the first segment
+  size_t m_Used;   // The written bytes of the last segment
+  size_t m_Size;
+};
+
+/**
+ * CRingBuffer
+ */
+
+typedef enum _RING_BUFFER_MODE
+{
+  RB_SPSC, // A single producer and a single consumer
+  RB_MPMC, // Multiple producers and multiple consumers
+} eRingBufferMode;
+
+/**
+ * A bounded lock-free queue of fixed-size records, a byte stream when the record size is 1.
+ * The indices and the records live in a single block of memory, it is owned by the ring or given by the caller.
+ * So a ring over a shared mapping is an IPC channel, one side creates it and the other side opens it.
+ * Push/Pop move up to count records and return the number of moved records, they never block.
+ */
+class CRingBuffer
+{
+public:
+  static const size_t CACHE_LINE_SIZE = 64;
+
+  CRingBuffer();
+  CRingBuffer(const size_t capacity, const size_t recordsize = 1, const eRingBufferMode mode = RB_SPSC);
+  virtual ~CRingBuffer();
+
+  bool Create(const size_t capacity, const size_t recordsize = 1, const eRingBufferMode mode = RB_SPSC);
+  bool Create(void* ptr, const size_t size, const size_t recordsize = 1, const eRingBufferMode mode = RB_SPSC);
+  bool Open(void* ptr, const size_t size);
+  void Close();
+
+  /**
+   * The size of memory that is needed by a ring of a capacity (rounded up to a power of two).
+   */
+  static size_t GetMemorySize(
+    const size_t capacity, const size_t recordsize = 1, const eRingBufferMode mode = RB_SPSC);
+
+  bool Ready() const;
+  size_t GetCapacity() const;
+  size_t GetRecordSize() const;
+  eRingBufferMode GetMode() const;
+  size_t GetCount() const; // A snapshot, it might be changed at any time by the other threads
+  bool Empty() const;
+
+  bool Push(const void* record);
+  bool Pop(void* record);
+  size_t Push(const void* records, const size_t count);
+  size_t Pop(void* records, const size_t count);
+
+private:
+  CRingBuffer(const CRingBuffer&);
+  const CRingBuffer& operator=(const CRingBuffer&);
+
+  bool Attach(byte* ptr);
+  size_t PushSPSC(const byte* records, const size_t count);
+  size_t PopSPSC(byte* records, const size_t count);
+  size_t PushMPMC(const byte* records, const size_t count);
+  size_t PopMPMC(byte* records, const size_t count);
+
+private:
+  CBuffer m_Storage; // The memory of the ring if it is not given by the caller
+  byte*  m_pMemory;  // The header then the records, aligned to a cache line
+  byte*  m_pRecords;
+  size_t m_Capacity;
+  size_t m_Mask;
+  size_t m_RecordSize;
+  size_t m_CellSize;
+  eRingBufferMode m_Mode;
+
+  // The last index seen of the other side, so the shared indices are only read when it is needed
+
+  byte   m_Padding0[CACHE_LINE_SIZE];
+  size_t m_CachedHead; // The producer side
+  byte   m_Padding1[CACHE_LINE_SIZE];
+  size_t m_CachedTail; // The consumer side
+  byte   m_Padding2[CACHE_LINE_SIZE];
+};
+
+/**
+ * CBytePattern
+ */
+
+/**
+ * Reads the next block of a stream (e.g. a file) into the buffer.
+ * @return  The number of bytes read, 0 at the end of the stream.
+ */
+typedef std::function<size_t(void* ptr, const size_t size)> FnStreamRead;
+
+/**
+ * A byte pattern such as "48 8B ?? 4? ?F 05" compiled once into value/mask arrays.
+ * A compiled pattern is immutable, so it can be shared and reused by many threads and searches.
+ */
+class CBytePattern
+{
+public:
+  CBytePattern();
+  CBytePattern(const std::string&  pattern);
+  CBytePattern(const std::wstring& pattern);
+  virtual ~CBytePattern();
+
+  bool Parse(const std::string&  pattern);
+  bool Parse(const std::wstring& pattern);
+
+  bool Empty() const;
+  size_t GetSize() const;
+  const std::vector<byte>& GetValues() const;
+  const std::vector<byte>& GetMasks() const;
+
+  bool Match(const void* ptr, const size_t size) const;
+  size_t Find(const void* ptr, const size_t size) const;
+  size_t Find(const CBufferView& buffer) const;
+  size_t FindNext(const CBufferView& buffer, const size_t offset) const;
+  std::vector<size_t> FindAll(const CBufferView& buffer) const;
+  size_t FindParallel(const CBufferView& buffer, const size_t nthreads = MAX_NTHREADS) const;
+  std::vector<size_t> FindAllParallel(const CBufferView& buffer, const size_t nthreads = MAX_NTHREADS) const;
+
+  /**
+   * Scans a stream block by block, the memory usage is bounded by the block size whatever the stream size is.
+   * The offsets are relative to the beginning of the stream, fnFound returns false to stop.
+   */
+  typedef std::function<bool(const ulonglong offset)> FnFound;
+  bool ScanStream(const FnStreamRead fnRead, const FnFound fnFound, const size_t blocksize = 4 * MiB) const;
+  bool ScanFile(const std::string&  filePath, const FnFound fnFound, const size_t blocksize = 4 * MiB) const;
+  bool ScanFile(const std::wstring& filePath, const FnFound fnFound, const size_t blocksize = 4 * MiB) const;
+
+private:
+  void SelectAnchors();
+
+private:
+  size_t m_Size;
+  size_t m_Anchors[2];
+  std::vector<byte> m_Values; // Padded with zeros to a multiple of 16 bytes
+  std::vector<byte> m_Masks;  // Padded with zeros to a multiple of 16 bytes
+};
+
+/**
+ * CPatternSet
+ */
+
+typedef struct _PATTERN_MATCH
+{
+  size_t ID;     // The index of the pattern in the set
+  size_t Offset; // The offset of the match in the data
+} TPatternMatch;
+
+/**
+ * A set of byte patterns that are searched all together in a single pass over the data.
+ * The longest concrete fragment of each pattern goes into an Aho-Corasick automaton,
+ * then the whole pattern (wildcards included) is verified around each fragment hit.
+ */
+class CPatternSet
+{
+public:
+  typedef std::function<bool(const size_t id, const size_t offset)> FnMatch; // Returns false to stop
+
+  CPatternSet();
+  virtual ~CPatternSet();
+
+  size_t Add(const std::string&  pattern);
+  size_t Add(const std::wstring& pattern);
+  size_t Add(const CBytePattern& pattern);
+
+  bool Build();
+  void Clear();
+
+  size_t GetCount() const;
+  const CBytePattern& GetPattern(const size_t id) const;
+
+  bool Scan(const void* ptr, const size_t size, const FnMatch fnMatch) const;
+  bool Scan(const CBufferView& buffer, const FnMatch fnMatch) const;
+  std::vector<TPatternMatch> Scan(const void* ptr, const size_t size) const;
+  std::vector<TPatternMatch> Scan(const CBufferView& buffer) const;
+
+  /**
+   * Scans a stream block by block, the memory usage is bounded by the block size whatever the stream size is.
+   * The offsets are relative to the beginning of the stream, fnMatch returns false to stop.
+   */
+  typedef std::function<bool(const size_t id, const ulonglong offset)> FnStreamMatch;
+  bool ScanStream(const FnStreamRead fnRead, const FnStreamMatch fnMatch, const size_t blocksize = 4 * MiB) const;
+  bool ScanFile(const std::string&  filePath, const FnStreamMatch fnMatch, const size_t blocksize = 4 * MiB) const;
+  bool ScanFile(const std::wstring& filePath, const FnStreamMatch fnMatch, const size_t blocksize = 4 * MiB) const;
+
+private:
+  bool Verify(const byte* ptr, const size_t size, const size_t end, const size_t id, const FnMatch& fnMatch) const;
+
+private:
+  typedef struct _FRAGMENT
+  {
+    size_t Offset; // The offset of the fragment in its pattern
+    size_t Size;
+  } TFragment;
+
+  bool m_Built;
+  std::vector<CBytePattern> m_Patterns;
+  std::vector<TFragment> m_Fragments;
+  std::vector<size_t> m_Unanchored; // The patterns without any concrete byte
+  std::vector<uint32> m_Delta;      // The transitions, 256 per state
+  std::vector<uint32> m_Outputs;    // The pattern ids that end at each state, indexed by m_OutputIndex
+  std::vector<uint32> m_OutputIndex;
 };
 
+#ifdef _WIN32
+
 /**
  * Library
  */
@@ -851,15 +1620,18 @@ public:
 
   IResult vuapi Send(const char* pData, int size, const Flags flags = MSG_NONE);
   IResult vuapi Send(const CBuffer& data, const Flags flags = MSG_NONE);
+  IResult vuapi Send(const CChainBuffer& data, const Flags flags = MSG_NONE);
   IResult vuapi Recv(char* pData, int size, const Flags flags = MSG_NONE);
   IResult vuapi Recv(CBuffer& data, const Flags flags = MSG_NONE);
   IResult vuapi Recvall(CBuffer& data, const Flags flags = MSG_NONE);
+  IResult vuapi Recvall(CChainBuffer& data, const Flags flags = MSG_NONE);
 
   IResult vuapi SendTo(const char* pData, const int size, const TSocket& socket);
   IResult vuapi SendTo(const CBuffer& data, const TSocket& socket);
   IResult vuapi RecvFrom(char* pData, int size, const TSocket& socket);
   IResult vuapi RecvFrom(CBuffer& data, const TSocket& socket);
   IResult vuapi RecvallFrom(CBuffer& data, const TSocket& socket);
+  IResult vuapi RecvallFrom(CChainBuffer& data, const TSocket& socket);
 
   IResult vuapi Close();
 
@@ -1294,7 +2066,9 @@ public:
   virtual bool vuapi Valid(HANDLE fileHandle);
   virtual bool vuapi IsReady();
   virtual ulong vuapi GetFileSize();
-  virtual const CBuffer vuapi ReadAsBuffer();
+  virtual ulong vuapi GetReadSize() const;
+  virtual ulong vuapi GetWroteSize() const;
+  virtual CBuffer vuapi ReadAsBuffer();
   virtual bool vuapi Read(void* Buffer, ulong ulSize);
   virtual bool vuapi Read(
     ulong ulOffset,
@@ -1302,6 +2076,7 @@ public:
     ulong ulSize,
     eMoveMethodFlags mmFlag = MM_BEGIN
   );
+  virtual bool vuapi Read(CChainBuffer& data, ulong ulSize);
 
   virtual bool vuapi Write(const void* cBuffer, ulong ulSize);
   virtual bool vuapi Write(
@@ -1310,6 +2085,7 @@ public:
     ulong ulSize,
     eMoveMethodFlags mmFlag = MM_BEGIN
   );
+  virtual bool vuapi Write(const CChainBuffer& data);
   virtual bool vuapi Seek(ulong ulOffset, eMoveMethodFlags mmFlag);
   virtual bool vuapi IOControl(
     ulong ulControlCode,
@@ -1650,13 +2426,312 @@ public:
   );
 };
 
+#endif // _WIN32
+
+/**
+ * File Watcher
+ */
+
+/**
+ * Watches a file by its directory (inotify on Linux, the change notifications on Windows), so the
+ * file that is replaced by a rename is seen also. The callback is called on the watcher thread.
+ * Stop() that is called by the callback only signals the thread, it is joined by the destructor or
+ * by Stop() on another thread. The thread does not touch the watcher, so it may end after it.
+ */
+class CFileWatcher
+{
+public:
+  typedef std::function<void()> FnChanged;
+
+  CFileWatcher();
+  virtual ~CFileWatcher();
+
+  bool Start(const std::string& FilePath, const FnChanged& fnChanged);
+  bool Start(const std::wstring& FilePath, const FnChanged& fnChanged);
+  void Stop();
+  bool IsWatching() const;
+
+private:
+  void Reset();
+
+  CFileWatcher(const CFileWatcher&);
+  CFileWatcher& operator=(const CFileWatcher&);
+
+private:
+  std::shared_ptr<std::atomic<bool>> m_pStop; // The stop flag of the thread, it is shared with it
+  std::thread m_Thread;
+  std::thread m_Retired; // The thread that is started again by its callback, it is joined by Stop()
+};
+
+/**
+ * INI Document
+ */
+
+/**
+ * An INI text that is parsed once and indexed by its sections and keys, the names are
+ * case-insensitive (ASCII) as the profile API. The names and the values are views into the
+ * loaded text and the written values are kept in an arena, so the text is serialized back with
+ * its comments, its blank lines, its quotes and its order as they were.
+ * The text is held in the encoding of its file as the profile API reads it, see IsANSI(). A UTF-16 text
+ * (by its BOM) is transcoded to UTF-8 and written back in its form.
+ * A copy shares the text and the sections with the document, a section is copied when one of them writes it.
+ */
+class CINIDocument
+{
+public:
+  typedef CStringViewA view_t;
+  typedef std::pair<view_t, view_t> TKeyValue;
+  typedef std::function<void(const view_t& Section, const view_t& Key, const view_t& Value)> FnEntry;
+
+  CINIDocument();
+  CINIDocument(const CINIDocument& right);
+  CINIDocument& operator=(const CINIDocument& right);
+  virtual ~CINIDocument();
+
+  void Clear();
+
+  /**
+   * Parses a text in UTF-8 (with or without BOM), in UTF-16 with BOM or in the ANSI code page.
+   */
+  void Parse(const void* pData, const size_t size);
+
+  /**
+   * Loads a file, a missing file is loaded as an empty document and returns false.
+   */
+  bool Load(const std::string& FilePath);
+  bool Load(const std::wstring& FilePath);
+
+  /**
+   * Saves the file atomically, the text is written to a temporary file that is synced to the disk
+   * and then renamed over the file.
+   */
+  bool Save(const std::string& FilePath) const;
+  bool Save(const std::wstring& FilePath) const;
+
+  /**
+   * Serializes the document to its text, or to the bytes of its file (its form and its BOM).
+   */
+  void Serialize(std::string& Text) const;
+  void Serialize(CBuffer& Data) const;
+
+  bool HasSection(const view_t& Section) const;
+  bool Read(const view_t& Section, const view_t& Key, view_t& Value) const;
+  std::vector<view_t> GetSectionNames() const;
+  std::vector<TKeyValue> GetSection(const view_t& Section) const;
+
+  /**
+   * Walks the keys of the readable sections in their order, a duplicated key is passed at all of its entries.
+   */
+  void Iterate(const FnEntry& fnEntry) const;
+
+  /**
+   * Sets a value, a new key is added after the last key of its section and a new section
+   * is added at the end. The empty section name is not writable.
+   */
+  bool Write(const view_t& Section, const view_t& Key, const view_t& Value);
+
+  bool IsModified() const;
+  eUnicodeForm GetForm() const;
+
+  /**
+   * The text is in the ANSI code page, else it is in UTF-8. A text without BOM is ANSI unless it is
+   * UTF-8 with a character that is not ASCII, so an ASCII file is written in ANSI as the profile API does.
+   */
+  bool IsANSI() const;
+
+private:
+  struct TEntry
+  {
+    view_t Head;  // The text before the value, it is the whole line if the line is not a key
+    view_t Key;   // Empty if the line is not a key (blank, comment, ...)
+    view_t Value;
+    view_t Tail;  // The text after the value (closing quote, spaces, line break)
+  };
+
+  struct THash
+  {
+    size_t operator()(const view_t& name) const;
+  };
+
+  struct TEqual
+  {
+    bool operator()(const view_t& left, const view_t& right) const;
+  };
+
+  typedef std::unordered_map<view_t, size_t, THash, TEqual> TIndex;
+
+  struct TSection
+  {
+    view_t Name;
+    TEntry Header;    // Empty for the keys before the first section
+    std::vector<TEntry> Entries;
+    size_t End;       // The entry after the last key, a new key is inserted here
+    TIndex Keys;
+  };
+
+  /**
+   * The loaded text and the written strings that the views point into, they are never changed
+   * once they are stored, so the copies of a document share them.
+   */
+  struct TStorage
+  {
+    std::string Text;
+    CStringArenaA Arena;
+    std::mutex Mutex; // The copies store their strings independently
+  };
+
+  void ParseLine(const view_t& line, const view_t& lineBreak);
+  void EnsureLineBreak(TEntry& entry);
+  view_t Store(const view_t& s);
+  TSection& MutableSection(const size_t index);
+  const TSection* FindSection(const view_t& Section) const;
+
+private:
+  std::shared_ptr<TStorage> m_Storage;
+  std::vector<std::shared_ptr<TSection>> m_Sections; // Shared by the copies until one of them writes it
+  TIndex m_Index;
+  view_t m_LineBreak;
+  eUnicodeForm m_Form;
+  bool m_BOM;
+  bool m_ANSI;
+  bool m_Modified;
+};
+
+/**
+ * INI Schema
+ */
+
+typedef enum _INI_ISSUE_TYPE
+{
+  II_MISSING,
+  II_INVALID,
+} eINIIssueType;
+
+typedef struct _INI_ISSUE
+{
+  eINIIssueType Type;
+  std::string Section;
+  std::string Key;
+  std::string Value; // The value that is invalid
+} TINIIssue;
+
+/**
+ * The table of the keys of a schema, see CINISchemaT.
+ * The keys are put in a perfect hash table that is built once at the first load, so a key of a
+ * document is found by one hash (its section is hashed once for all of its keys) and one comparison.
+ */
+class CINISchema
+{
+public:
+  CINISchema();
+  virtual ~CINISchema();
+
+  size_t GetCount() const;
+
+protected:
+  /**
+   * Adds a key, a key that is in the schema already is not added and returns false.
+   * The keys are added before the schema is loaded.
+   */
+  bool Add(const CStringViewA& Section, const CStringViewA& Key);
+
+  /**
+   * Loads the fields in one pass over the keys of a document, a duplicated key is read at its first entry.
+   * A field that is missing or invalid is reset to its default and reported.
+   */
+  bool Load(const CINIDocument& Document, void* pObject, std::vector<TINIIssue>& Issues) const;
+
+  virtual bool Assign(const size_t Index, const CStringViewA& Value, const bool ANSI, void* pObject) const = 0;
+  virtual void Reset(const size_t Index, void* pObject) const = 0;
+
+  /**
+   * The values are parsed entirely or they are invalid.
+   * The integers are decimal or hexadecimal (0x), the booleans are 1/0, true/false, yes/no or on/off.
+   * The reals are finite. The strings are converted from the encoding of the document (see CINIDocument::IsANSI)
+   * as CINIFileA/W::ReadString does.
+   */
+  template <typename V>
+  static bool Parse(const CStringViewA& Text, const bool /* ANSI */, V& Value)
+  {
+    return Parse(Text, Value);
+  }
+
+  static bool Parse(const CStringViewA& Text, const bool ANSI, std::string& Value);
+  static bool Parse(const CStringViewA& Text, const bool ANSI, std::wstring& Value);
+  static bool Parse(const CStringViewA& Text, bool& Value);
+  static bool Parse(const CStringViewA& Text, int& Value);
+  static bool Parse(const CStringViewA& Text, uint& Value);
+  static bool Parse(const CStringViewA& Text, int64& Value);
+  static bool Parse(const CStringViewA& Text, uint64& Value);
+  static bool Parse(const CStringViewA& Text, float& Value);
+  static bool Parse(const CStringViewA& Text, double& Value);
+
+private:
+  struct TKey
+  {
+    std::string Section;
+    std::string Key;
+    ulonglong Hash;
+  };
+
+  void Build() const;
+  bool Build(const ulonglong Seed) const;
+  size_t Find(const ulonglong SectionHash, const CStringViewA& Section, const CStringViewA& Key) const;
+
+  CINISchema(const CINISchema&);
+  CINISchema& operator=(const CINISchema&);
+
+private:
+  mutable std::vector<TKey> m_Keys;
+  mutable std::vector<ulong32> m_Displacements; // By the buckets
+  mutable std::vector<size_t> m_Slots;          // The indexes of the keys
+  mutable ulonglong m_Seed;
+  mutable std::atomic<bool> m_Ready;
+  mutable std::mutex m_Mutex;
+};
+
+#include "template/inischema.tpl"
+
 /**
  * INI File
  */
 
+typedef enum _INI_CHANGE
+{
+  IC_ADDED,
+  IC_REMOVED,
+  IC_MODIFIED,
+  IC_CONFLICT, // A key that is changed in the file and written locally but not flushed, the local value is kept
+} eINIChange;
+
+/**
+ * A change of a watched file, the key is empty for a section that is added or removed.
+ * For a conflict, the old value is the value in the file and the new value is the local one.
+ */
+
+typedef struct _INI_CHANGE_A
+{
+  eINIChange Type;
+  std::string Section;
+  std::string Key;
+  std::string OldValue;
+  std::string NewValue;
+} TINIChangeA;
+
+typedef struct _INI_CHANGE_W
+{
+  eINIChange Type;
+  std::wstring Section;
+  std::wstring Key;
+  std::wstring OldValue;
+  std::wstring NewValue;
+} TINIChangeW;
+
 class CINIFileA : public CLastError
 {
 public:
+  typedef std::function<void(const TINIChangeA& Change)> FnChanged;
+
   CINIFileA();
   CINIFileA(const std::string& FilePath);
   virtual ~CINIFileA();
@@ -1664,6 +2739,10 @@ public:
   void SetCurrentFilePath(const std::string& FilePath);
   void SetCurrentSection(const std::string& Section);
 
+  /**
+   * The sections and the names are read whole, ulMaxSize is not used (it is kept for compatibility).
+   * The profile API truncated them to a buffer of ulMaxSize characters.
+   */
   std::vector<std::string> vuapi ReadSection(const std::string& Section, ulong ulMaxSize = MAXBYTE);
   std::vector<std::string> vuapi ReadSection(ulong ulMaxSize = MAXBYTE);
 
@@ -1710,17 +2789,76 @@ public:
   bool vuapi WriteString(const std::string& Key, const std::string& Value);
   bool vuapi WriteStruct(const std::string& Key, void* pStruct, ulong ulSize);
 
+  /**
+   * Parses the file again, the reads are served from the parsed file that is loaded at the first read.
+   */
+  bool vuapi Reload();
+
+  /**
+   * In the write-behind mode, the writes are collected in memory and Flush() saves them at once.
+   * The file is always replaced atomically (a temporary file is synced, then renamed over it).
+   * A file that is changed by another writer since it is loaded is read again, the writes are saved over it.
+   * @param[in] Delay The milliseconds that a background thread waits after a write to flush the
+   *                  writes that follow it together, zero to flush by Flush() only.
+   */
+  void vuapi SetWriteBehind(const bool Enabled, const ulong Delay = 0);
+  bool vuapi Flush();
+
+  /**
+   * Watches the file, a changed file is parsed on the watcher thread and swapped in for the reads
+   * (they never wait for it), then the callback is called for every section and every key that is changed.
+   * The local writes that are not flushed are merged into a changed file, a key that is changed in both
+   * keeps its local value and it is reported as a conflict.
+   */
+  bool vuapi Watch(const FnChanged& fnChanged);
+  void vuapi Unwatch();
+
+  /**
+   * Loads a struct by its schema in one pass over the file, the missing and the invalid keys are reported together.
+   */
+  template <typename T>
+  bool Load(const CINISchemaT<T>& Schema, T& Object, std::vector<TINIIssue>& Issues)
+  {
+    CDocumentGuard document(this->Document());
+    return Schema.Load(*document, Object, Issues);
+  }
+
 private:
+  typedef CRCUPointerT<CINIDocument>::CReadGuard CDocumentGuard;
+
   void ValidFilePath();
+  const CRCUPointerT<CINIDocument>& Document();
+  bool LoadDocument();
+  void OnFileChanged();
+  bool Update(const std::string& Section, const std::string& Key, const std::string& Value);
+  bool FlushPending();
+  void StopFlusher();
+
+  CINIFileA(const CINIFileA&);
+  CINIFileA& operator=(const CINIFileA&);
 
 private:
   std::string m_FilePath;
   std::string m_Section;
+  CRCUPointerT<CINIDocument> m_Document; // Read without lock, swapped by the writes and the reloads
+  std::atomic<bool> m_Loaded;            // The file is parsed at the first access
+  std::unique_ptr<CINIDocument> m_Base;  // The file as it is loaded or saved last, the base of the local writes
+  bool m_WriteBehind;
+  bool m_Pending; // The writes that are not flushed
+  bool m_Stop;
+  ulong m_FlushDelay;
+  std::mutex m_Mutex; // The document is written by the caller and saved by the flusher
+  std::condition_variable m_Signal;
+  std::thread m_Flusher;
+  CFileWatcher m_Watcher;
+  FnChanged m_fnChanged;
 };
 
 class CINIFileW : public CLastError
 {
 public:
+  typedef std::function<void(const TINIChangeW& Change)> FnChanged;
+
   CINIFileW();
   CINIFileW(const std::wstring& FilePath);
   virtual ~CINIFileW();
@@ -1728,6 +2866,10 @@ public:
   void SetCurrentFilePath(const std::wstring& FilePath);
   void SetCurrentSection(const std::wstring& Section);
 
+  /**
+   * The sections and the names are read whole, ulMaxSize is not used (it is kept for compatibility).
+   * The profile API truncated them to a buffer of ulMaxSize characters.
+   */
   std::vector<std::wstring> vuapi ReadSection(
     const std::wstring& Section,
     ulong ulMaxSize = MAXBYTE
@@ -1777,14 +2919,73 @@ public:
   bool vuapi WriteString(const std::wstring& Key, const std::wstring& Value);
   bool vuapi WriteStruct(const std::wstring& Key, void* pStruct, ulong ulSize);
 
+  /**
+   * Parses the file again, the reads are served from the parsed file that is loaded at the first read.
+   */
+  bool vuapi Reload();
+
+  /**
+   * In the write-behind mode, the writes are collected in memory and Flush() saves them at once.
+   * The file is always replaced atomically (a temporary file is synced, then renamed over it).
+   * A file that is changed by another writer since it is loaded is read again, the writes are saved over it.
+   * @param[in] Delay The milliseconds that a background thread waits after a write to flush the
+   *                  writes that follow it together, zero to flush by Flush() only.
+   */
+  void vuapi SetWriteBehind(const bool Enabled, const ulong Delay = 0);
+  bool vuapi Flush();
+
+  /**
+   * Watches the file, a changed file is parsed on the watcher thread and swapped in for the reads
+   * (they never wait for it), then the callback is called for every section and every key that is changed.
+   * The local writes that are not flushed are merged into a changed file, a key that is changed in both
+   * keeps its local value and it is reported as a conflict.
+   */
+  bool vuapi Watch(const FnChanged& fnChanged);
+  void vuapi Unwatch();
+
+  /**
+   * Loads a struct by its schema in one pass over the file, the missing and the invalid keys are reported together.
+   */
+  template <typename T>
+  bool Load(const CINISchemaT<T>& Schema, T& Object, std::vector<TINIIssue>& Issues)
+  {
+    CDocumentGuard document(this->Document());
+    return Schema.Load(*document, Object, Issues);
+  }
+
 private:
+  typedef CRCUPointerT<CINIDocument>::CReadGuard CDocumentGuard;
+
   void ValidFilePath();
+  const CRCUPointerT<CINIDocument>& Document();
+  bool LoadDocument();
+  void OnFileChanged();
+  bool Update(const std::wstring& Section, const std::wstring& Key, const std::wstring& Value);
+  bool FlushPending();
+  void StopFlusher();
+
+  CINIFileW(const CINIFileW&);
+  CINIFileW& operator=(const CINIFileW&);
 
 private:
   std::wstring m_FilePath;
   std::wstring m_Section;
+  CRCUPointerT<CINIDocument> m_Document; // Read without lock, swapped by the writes and the reloads
+  std::atomic<bool> m_Loaded;            // The file is parsed at the first access
+  std::unique_ptr<CINIDocument> m_Base;  // The file as it is loaded or saved last, the base of the local writes
+  bool m_WriteBehind;
+  bool m_Pending; // The writes that are not flushed
+  bool m_Stop;
+  ulong m_FlushDelay;
+  std::mutex m_Mutex; // The document is written by the caller and saved by the flusher
+  std::condition_variable m_Signal;
+  std::thread m_Flusher;
+  CFileWatcher m_Watcher;
+  FnChanged m_fnChanged;
 };
 
+#ifdef _WIN32
+
 /**
  * Registry
  */
@@ -1988,6 +3189,8 @@ private:
   TCriticalSection m_CriticalSection;
 };
 
+#endif // _WIN32
+
 /**
  * Stop Watch
  */
@@ -2102,7 +3305,7 @@ typedef IMAGE_IMPORT_BY_NAME TImportByName, *PImportByName;
 typedef IMAGE_IMPORT_DESCRIPTOR TImportDescriptor, *PImportDescriptor;
 typedef IMAGE_DATA_DIRECTORY TDataDirectory, *PDataDirectory;
 
-// IMAGE_OPTIONAL_HEADER
+// IMAGE_OPTIONAL_HEADER (the DWORD fields are 32-bit on all of the platforms, ulong is 64-bit on LP64)
 
 template <typename T>
 struct TOptHeaderT
@@ -2110,33 +3313,33 @@ struct TOptHeaderT
   ushort  Magic;
   uchar   MajorLinkerVersion;
   uchar   MinorLinkerVersion;
-  ulong   SizeOfCode;
-  ulong   SizeOfInitializedData;
-  ulong   SizeOfUninitializedData;
-  ulong   AddressOfEntryPoint;
-  ulong   BaseOfCode;
-  ulong   BaseOfData;
+  ulong32 SizeOfCode;
+  ulong32 SizeOfInitializedData;
+  ulong32 SizeOfUninitializedData;
+  ulong32 AddressOfEntryPoint;
+  ulong32 BaseOfCode;
+  ulong32 BaseOfData;
   T       ImageBase;
-  ulong   SectionAlignment;
-  ulong   FileAlignment;
+  ulong32 SectionAlignment;
+  ulong32 FileAlignment;
   ushort  MajorOperatingSystemVersion;
   ushort  MinorOperatingSystemVersion;
   ushort  MajorImageVersion;
   ushort  MinorImageVersion;
   ushort  MajorSubsystemVersion;
   ushort  MinorSubsystemVersion;
-  ulong   Win32VersionValue;
-  ulong   SizeOfImage;
-  ulong   SizeOfHeaders;
-  ulong   CheckSum;
+  ulong32 Win32VersionValue;
+  ulong32 SizeOfImage;
+  ulong32 SizeOfHeaders;
+  ulong32 CheckSum;
   ushort  Subsystem;
   ushort  DllCharacteristics;
   T       SizeOfStackReserve;
   T       SizeOfStackCommit;
   T       SizeOfHeapReserve;
   T       SizeOfHeapCommit;
-  ulong   LoaderFlags;
-  ulong   NumberOfRvaAndSizes;
+  ulong32 LoaderFlags;
+  ulong32 NumberOfRvaAndSizes;
   // IMAGE_DATA_DIRECTORY - https://docs.microsoft.com/en-us/windows/win32/api/dbghelp/nf-dbghelp-imagedirectoryentrytodataex
   union
   {
@@ -2168,33 +3371,33 @@ template<> struct TOptHeaderT<pe64>
   ushort  Magic;
   uchar   MajorLinkerVersion;
   uchar   MinorLinkerVersion;
-  ulong   SizeOfCode;
-  ulong   SizeOfInitializedData;
-  ulong   SizeOfUninitializedData;
-  ulong   AddressOfEntryPoint;
-  ulong   BaseOfCode;
-  // ulong   BaseOfData // not used for 64-bit
+  ulong32 SizeOfCode;
+  ulong32 SizeOfInitializedData;
+  ulong32 SizeOfUninitializedData;
+  ulong32 AddressOfEntryPoint;
+  ulong32 BaseOfCode;
+  // ulong32 BaseOfData // not used for 64-bit
   ulong64 ImageBase;
-  ulong   SectionAlignment;
-  ulong   FileAlignment;
+  ulong32 SectionAlignment;
+  ulong32 FileAlignment;
   ushort  MajorOperatingSystemVersion;
   ushort  MinorOperatingSystemVersion;
   ushort  MajorImageVersion;
   ushort  MinorImageVersion;
   ushort  MajorSubsystemVersion;
   ushort  MinorSubsystemVersion;
-  ulong   Win32VersionValue;
-  ulong   SizeOfImage;
-  ulong   SizeOfHeaders;
-  ulong   CheckSum;
+  ulong32 Win32VersionValue;
+  ulong32 SizeOfImage;
+  ulong32 SizeOfHeaders;
+  ulong32 CheckSum;
   ushort  Subsystem;
   ushort  DllCharacteristics;
   ulong64 SizeOfStackReserve;
   ulong64 SizeOfStackCommit;
   ulong64 SizeOfHeapReserve;
   ulong64 SizeOfHeapCommit;
-  ulong   LoaderFlags;
-  ulong   NumberOfRvaAndSizes;
+  ulong32 LoaderFlags;
+  ulong32 NumberOfRvaAndSizes;
   // IMAGE_DATA_DIRECTORY - https://docs.microsoft.com/en-us/windows/win32/api/dbghelp/nf-dbghelp-imagedirectoryentrytodataex
   union
   {
@@ -2229,7 +3432,7 @@ typedef TOptHeaderT<ulong64> TOptHeader64, *POptHeader64;
 template <typename T>
 struct TNTHeaderT
 {
-  ulong Signature;
+  ulong32 Signature;
   TFileHeader FileHeader;
   TOptHeaderT<T> OptHeader;
 };
@@ -2319,13 +3522,24 @@ struct TRelocationEntryT
 };
 
 template <typename T>
-class CPEFileTX
+class CPEFileTX : public CLastError
 {
 public:
   CPEFileTX();
   virtual ~CPEFileTX();
 
+  /**
+   * Parses a PE image from memory (a file that is read or mapped), the data is not copied so it must
+   * outlive the object. All of the reads are checked by the size of the data, a part that is out of it
+   * is not read and the last error code is ERROR_BAD_EXE_FORMAT.
+   * @return VU_OK, 4 (no data), 5 (invalid DOS header), 6 (invalid PE header), 7 (wrong type data for
+   *         the PE file), 8 (the type data is not supported) or 9 (invalid section headers).
+   */
+  VUResult vuapi Parse(const void* pData, const size_t Size);
+  VUResult vuapi Parse(const CBuffer& Buffer);
+
   void* vuapi GetpBase();
+  size_t vuapi GetSize();
   TPEHeaderT<T>* vuapi GetpPEHeader();
 
   T vuapi RVA2Offset(T RVA, bool InCache = true);
@@ -2358,10 +3572,16 @@ protected:
   bool m_Initialized;
 
   void* m_pBase;
+  size_t m_Size;
 
   TDOSHeader* m_pDosHeader;
   TPEHeaderT<T>* m_pPEHeader;
 
+private:
+  const void* Pointer(const T Offset, const size_t Size);
+  bool ReadString(const T Offset, std::string& String);
+  const TDataDirectory* GetDataDirectory(const ulong Index);
+
 private:
   T m_OrdinalFlag;
 
@@ -2375,6 +3595,7 @@ private:
 
 protected:
   const std::vector<TExIID>& vuapi GetExIIDs(bool InCache = true);
+  void Reset(); // Drops the parsed image and its caches, called before its data is released
 };
 
 template <typename T>
@@ -2385,11 +3606,15 @@ public:
   CPEFileTA(const std::string& PEFilePath);
   ~CPEFileTA();
 
+  using CPEFileTX<T>::Parse;
   VUResult vuapi Parse(const std::string& PEFilePath = "");
 
 private:
   std::string m_FilePath;
+  #ifdef _WIN32
   CFileMappingA m_FileMap;
+  #endif // _WIN32
+  CBuffer m_Data; // The file is read where it is not mapped
 };
 
 template <typename T>
@@ -2400,13 +3625,19 @@ public:
   CPEFileTW(const std::wstring& PEFilePath);
   ~CPEFileTW();
 
+  using CPEFileTX<T>::Parse;
   VUResult vuapi Parse();
 
 private:
   std::wstring m_FilePath;
+  #ifdef _WIN32
   CFileMappingW m_FileMap;
+  #endif // _WIN32
+  CBuffer m_Data; // The file is read where it is not mapped
 };
 
+#ifdef _WIN32
+
 /**
  * CWDTControl
  */
@@ -2722,12 +3953,12 @@ protected:
   Modules m_Modules;
 };
 
+#endif // _WIN32
+
 #ifdef Vutils_EXPORTS
 #define threadpool11_EXPORTING
 #endif // Vutils_EXPORTS
 
-#define MAX_NTHREADS -1
-
 class CThreadPool
 {
 public:
@@ -2881,8 +4112,10 @@ private:
 
 #ifdef _UNICODE
 #define TFSObject TFSObjectW
+#define TINIChange TINIChangeW
 #else
 #define TFSObject TFSObjectA
+#define TINIChange TINIChangeA
 #endif
 
 /*------------ The definition of common Class(es) which compatible both ANSI & UNICODE -----------*/
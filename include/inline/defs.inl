@@ -16,6 +16,7 @@
 
 #define MAX_NPROCESSES 512
 #define MAX_NMODULES   1024
+#define MAX_NTHREADS   -1
 
 #define INVALID_PID_VALUE -1
 
@@ -0,0 +1,223 @@
+/**
+ * @file   posix.inl
+ * @author Vic P.
+ * @brief  Inline for POSIX (the Windows types and constants of the portable part)
+ */
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cwchar>
+#include <cstdio>
+#include <cstdarg>
+#include <cerrno>
+
+/* Types */
+
+// The Windows data model (LLP64), a DWORD/LONG is 32-bit while a long is 64-bit on LP64
+
+typedef int                 BOOL;
+typedef unsigned char       BYTE;
+typedef unsigned short      WORD;
+typedef uint32_t            DWORD;
+typedef int32_t             LONG;
+typedef uint32_t            ULONG;
+typedef unsigned short      USHORT;
+typedef unsigned int        UINT;
+typedef int                 INT;
+typedef char                CHAR;
+typedef wchar_t             WCHAR;
+typedef int64_t             LONGLONG;
+typedef uint64_t            ULONGLONG;
+#define __int64             long long
+#define __int32             int
+
+typedef intptr_t            INT_PTR;
+typedef uintptr_t           UINT_PTR;
+typedef intptr_t            LONG_PTR;
+typedef uintptr_t           ULONG_PTR;
+typedef uintptr_t           DWORD_PTR;
+typedef size_t              SIZE_T;
+typedef int32_t             HALF_PTR;
+typedef uint32_t            UHALF_PTR;
+
+#ifdef _UNICODE
+typedef wchar_t             TCHAR;
+#define _T(x)               L ## x
+#else  // !_UNICODE
+typedef char                TCHAR;
+#define _T(x)               x
+#endif // _UNICODE
+
+#define TRUE  1
+#define FALSE 0
+
+#define MAXBYTE  0xFF
+#define MAX_PATH 260
+
+#define UNREFERENCED_PARAMETER(P) (void)(P)
+#define _countof(a) (sizeof(a) / sizeof(a[0]))
+
+/* Error Codes */
+
+#define ERROR_SUCCESS               0L
+#define ERROR_FILE_NOT_FOUND        2L
+#define ERROR_ACCESS_DENIED         5L
+#define ERROR_NOT_ENOUGH_MEMORY     8L
+#define ERROR_INVALID_DATA          13L
+#define ERROR_NOT_READY             21L
+#define ERROR_WRITE_FAULT           29L
+#define ERROR_READ_FAULT            30L
+#define ERROR_INVALID_PARAMETER     87L
+#define ERROR_INSUFFICIENT_BUFFER   122L
+#define ERROR_BAD_EXE_FORMAT        193L
+
+/* PE Format */
+
+#define IMAGE_DOS_SIGNATURE                 0x5A4D
+#define IMAGE_NT_SIGNATURE                  0x00004550
+#define IMAGE_NT_OPTIONAL_HDR32_MAGIC       0x10B
+#define IMAGE_NT_OPTIONAL_HDR64_MAGIC       0x20B
+#define IMAGE_NUMBEROF_DIRECTORY_ENTRIES    16
+#define IMAGE_SIZEOF_SHORT_NAME             8
+#define IMAGE_ORDINAL_FLAG32                0x80000000
+#define IMAGE_ORDINAL_FLAG64                0x8000000000000000ULL
+
+#define IMAGE_DIRECTORY_ENTRY_EXPORT        0
+#define IMAGE_DIRECTORY_ENTRY_IMPORT        1
+#define IMAGE_DIRECTORY_ENTRY_BASERELOC     5
+
+#define IMAGE_REL_BASED_ABSOLUTE            0
+#define IMAGE_REL_BASED_HIGHLOW             3
+#define IMAGE_REL_BASED_DIR64               10
+
+typedef struct _IMAGE_DOS_HEADER
+{
+  WORD  e_magic;
+  WORD  e_cblp;
+  WORD  e_cp;
+  WORD  e_crlc;
+  WORD  e_cparhdr;
+  WORD  e_minalloc;
+  WORD  e_maxalloc;
+  WORD  e_ss;
+  WORD  e_sp;
+  WORD  e_csum;
+  WORD  e_ip;
+  WORD  e_cs;
+  WORD  e_lfarlc;
+  WORD  e_ovno;
+  WORD  e_res[4];
+  WORD  e_oemid;
+  WORD  e_oeminfo;
+  WORD  e_res2[10];
+  LONG  e_lfanew;
+} IMAGE_DOS_HEADER, *PIMAGE_DOS_HEADER;
+
+typedef struct _IMAGE_FILE_HEADER
+{
+  WORD  Machine;
+  WORD  NumberOfSections;
+  DWORD TimeDateStamp;
+  DWORD PointerToSymbolTable;
+  DWORD NumberOfSymbols;
+  WORD  SizeOfOptionalHeader;
+  WORD  Characteristics;
+} IMAGE_FILE_HEADER, *PIMAGE_FILE_HEADER;
+
+typedef struct _IMAGE_DATA_DIRECTORY
+{
+  DWORD VirtualAddress;
+  DWORD Size;
+} IMAGE_DATA_DIRECTORY, *PIMAGE_DATA_DIRECTORY;
+
+typedef struct _IMAGE_SECTION_HEADER
+{
+  BYTE  Name[IMAGE_SIZEOF_SHORT_NAME];
+  union
+  {
+    DWORD PhysicalAddress;
+    DWORD VirtualSize;
+  } Misc;
+  DWORD VirtualAddress;
+  DWORD SizeOfRawData;
+  DWORD PointerToRawData;
+  DWORD PointerToRelocations;
+  DWORD PointerToLinenumbers;
+  WORD  NumberOfRelocations;
+  WORD  NumberOfLinenumbers;
+  DWORD Characteristics;
+} IMAGE_SECTION_HEADER, *PIMAGE_SECTION_HEADER;
+
+typedef struct _IMAGE_IMPORT_BY_NAME
+{
+  WORD  Hint;
+  CHAR  Name[1];
+} IMAGE_IMPORT_BY_NAME, *PIMAGE_IMPORT_BY_NAME;
+
+typedef struct _IMAGE_IMPORT_DESCRIPTOR
+{
+  union
+  {
+    DWORD Characteristics;
+    DWORD OriginalFirstThunk;
+  };
+  DWORD TimeDateStamp;
+  DWORD ForwarderChain;
+  DWORD Name;
+  DWORD FirstThunk;
+} IMAGE_IMPORT_DESCRIPTOR, *PIMAGE_IMPORT_DESCRIPTOR;
+
+typedef struct _IMAGE_BASE_RELOCATION
+{
+  DWORD VirtualAddress;
+  DWORD SizeOfBlock;
+} IMAGE_BASE_RELOCATION, *PIMAGE_BASE_RELOCATION;
+
+/* Run-Time */
+
+// The bounds-checked copy of the MS C run-time, the destination is zeroed when the source does not fit
+
+inline int memcpy_s(void* dest, size_t destsz, const void* src, size_t count)
+{
+  if (dest == nullptr)
+  {
+    return EINVAL;
+  }
+
+  if (src == nullptr || destsz < count)
+  {
+    memset(dest, 0, destsz);
+    return src == nullptr ? EINVAL : ERANGE;
+  }
+
+  memcpy(dest, src, count);
+
+  return 0;
+}
+
+/* Debugging */
+
+// The debugger output of Windows, the messages are written to the standard error
+
+inline void OutputDebugStringA(const char* lpOutputString)
+{
+  fputs(lpOutputString, stderr);
+}
+
+inline void OutputDebugStringW(const wchar_t* lpOutputString)
+{
+  fputws(lpOutputString, stderr);
+}
+
+// The last error of the C run-time, the error codes of the portable part are set to it
+
+inline DWORD GetLastError()
+{
+  return DWORD(errno);
+}
+
+inline void SetLastError(DWORD dwErrCode)
+{
+  errno = int(dwErrCode);
+}
@@ -0,0 +1,151 @@
+/**
+ * @file   format.tpl
+ * @author Vic P.
+ * @brief  Template for Type-safe Format
+ */
+
+/**
+ * The overloads of 1 to 12 arguments, they are chosen over the C variadic functions of the same names
+ * as an exact match beats an ellipsis, so every call with arguments takes the type-safe formatting.
+ * The toolset of VS2012 has no variadic template, so the arities are expanded by the macros.
+ */
+
+#define VU_FORMAT_TYPENAMES_1 typename A0
+#define VU_FORMAT_TYPENAMES_2 VU_FORMAT_TYPENAMES_1, typename A1
+#define VU_FORMAT_TYPENAMES_3 VU_FORMAT_TYPENAMES_2, typename A2
+#define VU_FORMAT_TYPENAMES_4 VU_FORMAT_TYPENAMES_3, typename A3
+#define VU_FORMAT_TYPENAMES_5 VU_FORMAT_TYPENAMES_4, typename A4
+#define VU_FORMAT_TYPENAMES_6 VU_FORMAT_TYPENAMES_5, typename A5
+#define VU_FORMAT_TYPENAMES_7 VU_FORMAT_TYPENAMES_6, typename A6
+#define VU_FORMAT_TYPENAMES_8 VU_FORMAT_TYPENAMES_7, typename A7
+#define VU_FORMAT_TYPENAMES_9 VU_FORMAT_TYPENAMES_8, typename A8
+#define VU_FORMAT_TYPENAMES_10 VU_FORMAT_TYPENAMES_9, typename A9
+#define VU_FORMAT_TYPENAMES_11 VU_FORMAT_TYPENAMES_10, typename A10
+#define VU_FORMAT_TYPENAMES_12 VU_FORMAT_TYPENAMES_11, typename A11
+
+#define VU_FORMAT_PARAMS_1 const A0& a0
+#define VU_FORMAT_PARAMS_2 VU_FORMAT_PARAMS_1, const A1& a1
+#define VU_FORMAT_PARAMS_3 VU_FORMAT_PARAMS_2, const A2& a2
+#define VU_FORMAT_PARAMS_4 VU_FORMAT_PARAMS_3, const A3& a3
+#define VU_FORMAT_PARAMS_5 VU_FORMAT_PARAMS_4, const A4& a4
+#define VU_FORMAT_PARAMS_6 VU_FORMAT_PARAMS_5, const A5& a5
+#define VU_FORMAT_PARAMS_7 VU_FORMAT_PARAMS_6, const A6& a6
+#define VU_FORMAT_PARAMS_8 VU_FORMAT_PARAMS_7, const A7& a7
+#define VU_FORMAT_PARAMS_9 VU_FORMAT_PARAMS_8, const A8& a8
+#define VU_FORMAT_PARAMS_10 VU_FORMAT_PARAMS_9, const A9& a9
+#define VU_FORMAT_PARAMS_11 VU_FORMAT_PARAMS_10, const A10& a10
+#define VU_FORMAT_PARAMS_12 VU_FORMAT_PARAMS_11, const A11& a11
+
+#define VU_FORMAT_ARGS_1 CFormatArg(a0)
+#define VU_FORMAT_ARGS_2 VU_FORMAT_ARGS_1, CFormatArg(a1)
+#define VU_FORMAT_ARGS_3 VU_FORMAT_ARGS_2, CFormatArg(a2)
+#define VU_FORMAT_ARGS_4 VU_FORMAT_ARGS_3, CFormatArg(a3)
+#define VU_FORMAT_ARGS_5 VU_FORMAT_ARGS_4, CFormatArg(a4)
+#define VU_FORMAT_ARGS_6 VU_FORMAT_ARGS_5, CFormatArg(a5)
+#define VU_FORMAT_ARGS_7 VU_FORMAT_ARGS_6, CFormatArg(a6)
+#define VU_FORMAT_ARGS_8 VU_FORMAT_ARGS_7, CFormatArg(a7)
+#define VU_FORMAT_ARGS_9 VU_FORMAT_ARGS_8, CFormatArg(a8)
+#define VU_FORMAT_ARGS_10 VU_FORMAT_ARGS_9, CFormatArg(a9)
+#define VU_FORMAT_ARGS_11 VU_FORMAT_ARGS_10, CFormatArg(a10)
+#define VU_FORMAT_ARGS_12 VU_FORMAT_ARGS_11, CFormatArg(a11)
+
+#define VU_FORMAT_DEFINE(n)\
+  template <VU_FORMAT_TYPENAMES_##n>\
+  std::string FormatA(const std::string& Format, VU_FORMAT_PARAMS_##n)\
+  {\
+    const CFormatArg args[] = { VU_FORMAT_ARGS_##n };\
+    return FormatArgsA(Format, args, n);\
+  }\
+  template <VU_FORMAT_TYPENAMES_##n>\
+  std::wstring FormatW(const std::wstring& Format, VU_FORMAT_PARAMS_##n)\
+  {\
+    const CFormatArg args[] = { VU_FORMAT_ARGS_##n };\
+    return FormatArgsW(Format, args, n);\
+  }\
+  template <VU_FORMAT_TYPENAMES_##n>\
+  void AppendFormatA(std::string& Result, const std::string& Format, VU_FORMAT_PARAMS_##n)\
+  {\
+    const CFormatArg args[] = { VU_FORMAT_ARGS_##n };\
+    AppendFormatArgsA(Result, Format, args, n);\
+  }\
+  template <VU_FORMAT_TYPENAMES_##n>\
+  void AppendFormatW(std::wstring& Result, const std::wstring& Format, VU_FORMAT_PARAMS_##n)\
+  {\
+    const CFormatArg args[] = { VU_FORMAT_ARGS_##n };\
+    AppendFormatArgsW(Result, Format, args, n);\
+  }\
+  template <VU_FORMAT_TYPENAMES_##n>\
+  void AppendFormatA(CBuffer& Result, const std::string& Format, VU_FORMAT_PARAMS_##n)\
+  {\
+    const CFormatArg args[] = { VU_FORMAT_ARGS_##n };\
+    AppendFormatArgsA(Result, Format, args, n);\
+  }\
+  template <VU_FORMAT_TYPENAMES_##n>\
+  void AppendFormatW(CBuffer& Result, const std::wstring& Format, VU_FORMAT_PARAMS_##n)\
+  {\
+    const CFormatArg args[] = { VU_FORMAT_ARGS_##n };\
+    AppendFormatArgsW(Result, Format, args, n);\
+  }\
+  template <VU_FORMAT_TYPENAMES_##n>\
+  void MsgA(const std::string& Format, VU_FORMAT_PARAMS_##n)\
+  {\
+    const CFormatArg args[] = { VU_FORMAT_ARGS_##n };\
+    OutputDebugStringA(FormatArgsA(Format, args, n).c_str());\
+  }\
+  template <VU_FORMAT_TYPENAMES_##n>\
+  void MsgW(const std::wstring& Format, VU_FORMAT_PARAMS_##n)\
+  {\
+    const CFormatArg args[] = { VU_FORMAT_ARGS_##n };\
+    OutputDebugStringW(FormatArgsW(Format, args, n).c_str());\
+  }
+
+VU_FORMAT_DEFINE(1)
+VU_FORMAT_DEFINE(2)
+VU_FORMAT_DEFINE(3)
+VU_FORMAT_DEFINE(4)
+VU_FORMAT_DEFINE(5)
+VU_FORMAT_DEFINE(6)
+VU_FORMAT_DEFINE(7)
+VU_FORMAT_DEFINE(8)
+VU_FORMAT_DEFINE(9)
+VU_FORMAT_DEFINE(10)
+VU_FORMAT_DEFINE(11)
+VU_FORMAT_DEFINE(12)
+
+#undef VU_FORMAT_DEFINE
+#undef VU_FORMAT_TYPENAMES_1
+#undef VU_FORMAT_TYPENAMES_2
+#undef VU_FORMAT_TYPENAMES_3
+#undef VU_FORMAT_TYPENAMES_4
+#undef VU_FORMAT_TYPENAMES_5
+#undef VU_FORMAT_TYPENAMES_6
+#undef VU_FORMAT_TYPENAMES_7
+#undef VU_FORMAT_TYPENAMES_8
+#undef VU_FORMAT_TYPENAMES_9
+#undef VU_FORMAT_TYPENAMES_10
+#undef VU_FORMAT_TYPENAMES_11
+#undef VU_FORMAT_TYPENAMES_12
+#undef VU_FORMAT_PARAMS_1
+#undef VU_FORMAT_PARAMS_2
+#undef VU_FORMAT_PARAMS_3
+#undef VU_FORMAT_PARAMS_4
+#undef VU_FORMAT_PARAMS_5
+#undef VU_FORMAT_PARAMS_6
+#undef VU_FORMAT_PARAMS_7
+#undef VU_FORMAT_PARAMS_8
+#undef VU_FORMAT_PARAMS_9
+#undef VU_FORMAT_PARAMS_10
+#undef VU_FORMAT_PARAMS_11
+#undef VU_FORMAT_PARAMS_12
+#undef VU_FORMAT_ARGS_1
+#undef VU_FORMAT_ARGS_2
+#undef VU_FORMAT_ARGS_3
+#undef VU_FORMAT_ARGS_4
+#undef VU_FORMAT_ARGS_5
+#undef VU_FORMAT_ARGS_6
+#undef VU_FORMAT_ARGS_7
+#undef VU_FORMAT_ARGS_8
+#undef VU_FORMAT_ARGS_9
+#undef VU_FORMAT_ARGS_10
+#undef VU_FORMAT_ARGS_11
+#undef VU_FORMAT_ARGS_12
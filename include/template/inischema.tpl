@@ -0,0 +1,113 @@
+/**
+ * @file   inischema.tpl
+ * @author Vic P.
+ * @brief  Template for INI Schema
+ */
+
+ /**
+  * CINISchemaT
+  */
+
+/**
+ * A schema that binds the fields of a struct to their sections, their keys and their defaults,
+ * a field is of a type that is parsed by CINISchema::Parse(...) or else it is not compiled.
+ * E.g.
+ *   vu::CINISchemaT<TConfig> schema;
+ *   schema.Bind("Server", "Port", &TConfig::Port, 80).Bind("Server", "Host", &TConfig::Host, "localhost");
+ *   schema.Load(document, config, issues);
+ */
+template <typename T>
+class CINISchemaT : public CINISchema
+{
+public:
+  typedef T struct_t;
+
+  CINISchemaT() : CINISchema()
+  {
+  }
+
+  virtual ~CINISchemaT()
+  {
+  }
+
+  /**
+   * Binds a field to a key, a key is bound once.
+   */
+  template <typename V, typename D>
+  CINISchemaT& Bind(const CStringViewA& Section, const CStringViewA& Key, V T::*pField, const D& Default)
+  {
+    if (this->Add(Section, Key))
+    {
+      m_Fields.push_back(std::shared_ptr<IField>(new TField<V>(pField, V(Default))));
+    }
+    else
+    {
+      assert(0 && "the key is bound already");
+    }
+
+    return *this;
+  }
+
+  /**
+   * Loads the fields of a struct from a document, the fields that are not loaded get their defaults.
+   * @return True if all of the keys are found and valid, else they are appended to the issues.
+   */
+  bool Load(const CINIDocument& Document, T& Object, std::vector<TINIIssue>& Issues) const
+  {
+    return CINISchema::Load(Document, &Object, Issues);
+  }
+
+  /**
+   * Sets all of the fields of a struct to their defaults.
+   */
+  void Reset(T& Object) const
+  {
+    for (const auto& pField : m_Fields)
+    {
+      pField->Reset(Object);
+    }
+  }
+
+protected:
+  virtual bool Assign(const size_t Index, const CStringViewA& Value, const bool ANSI, void* pObject) const
+  {
+    return m_Fields[Index]->Assign(Value, ANSI, *static_cast<T*>(pObject));
+  }
+
+  virtual void Reset(const size_t Index, void* pObject) const
+  {
+    m_Fields[Index]->Reset(*static_cast<T*>(pObject));
+  }
+
+private:
+  struct IField
+  {
+    virtual ~IField() {}
+    virtual bool Assign(const CStringViewA& Value, const bool ANSI, T& Object) const = 0;
+    virtual void Reset(T& Object) const = 0;
+  };
+
+  template <typename V>
+  struct TField : public IField
+  {
+    V T::*m_pField;
+    V m_Default;
+
+    TField(V T::*pField, const V& Default) : m_pField(pField), m_Default(Default)
+    {
+    }
+
+    virtual bool Assign(const CStringViewA& Value, const bool ANSI, T& Object) const
+    {
+      return CINISchema::Parse(Value, ANSI, Object.*m_pField); // The field is written only if the value is valid
+    }
+
+    virtual void Reset(T& Object) const
+    {
+      Object.*m_pField = m_Default;
+    }
+  };
+
+private:
+  std::vector<std::shared_ptr<IField>> m_Fields; // By the indexes of their keys
+};
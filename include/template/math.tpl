@@ -513,10 +513,12 @@ public:
     Set(nWidth, nHeight);
   }
 
+  #ifdef _WIN32
   RectT(const RECT& rect)
   {
     Set(T(rect.left), T(rect.top), T(rect.right), T(rect.bottom));
   }
+  #endif // _WIN32
 
   void Set(const T l, const T t, const T r, const T b)
   {
@@ -0,0 +1,123 @@
+/**
+ * @file   rcu.tpl
+ * @author Vic P.
+ * @brief  Template for Read-Copy-Update Pointer
+ */
+
+ /**
+  * CRCUPointerT
+  */
+
+/**
+ * A pointer to an object that is read by many threads without lock and replaced by one writer.
+ * The writer publishes a new object, then waits until the readers of the old one are gone to free it.
+ * A reader counts itself in one of two counters by the current epoch, the writer flips the epoch
+ * after the publishing and waits for the counter of the old epoch to drain.
+ */
+template <typename T>
+class CRCUPointerT
+{
+public:
+  /**
+   * A read-side section, the object is valid until the guard is destroyed.
+   */
+  class CReadGuard
+  {
+  public:
+    CReadGuard(const CRCUPointerT& rcu) : m_RCU(rcu)
+    {
+      for (;;)
+      {
+        m_Epoch = m_RCU.m_Epoch.load() & 1;
+        m_RCU.m_Readers[m_Epoch]++;
+
+        if ((m_RCU.m_Epoch.load() & 1) == m_Epoch)
+        {
+          break;
+        }
+
+        m_RCU.m_Readers[m_Epoch]--; // The epoch is flipped meanwhile, count in the new one
+      }
+
+      m_pObject = m_RCU.m_pObject.load();
+    }
+
+    ~CReadGuard()
+    {
+      m_RCU.m_Readers[m_Epoch]--;
+    }
+
+    T* Get() const
+    {
+      return m_pObject;
+    }
+
+    T* operator->() const
+    {
+      return m_pObject;
+    }
+
+    T& operator*() const
+    {
+      return *m_pObject;
+    }
+
+  private:
+    CReadGuard(const CReadGuard&);
+    CReadGuard& operator=(const CReadGuard&);
+
+  private:
+    const CRCUPointerT& m_RCU;
+    T* m_pObject;
+    uint m_Epoch;
+  };
+
+  CRCUPointerT(T* pObject = nullptr) : m_pObject(pObject), m_Epoch(0)
+  {
+    m_Readers[0] = 0;
+    m_Readers[1] = 0;
+  }
+
+  virtual ~CRCUPointerT()
+  {
+    delete m_pObject.load();
+  }
+
+  /**
+   * The current object, for the writer only.
+   */
+  T* Get() const
+  {
+    return m_pObject.load();
+  }
+
+  /**
+   * Publishes an object and frees the old one when its readers are gone, for the writer only.
+   */
+  void Update(T* pObject)
+  {
+    T* pOld = m_pObject.exchange(pObject);
+    if (pOld == nullptr)
+    {
+      return;
+    }
+
+    const uint epoch = m_Epoch.fetch_add(1) & 1;
+
+    while (m_Readers[epoch].load() != 0)
+    {
+      std::this_thread::yield();
+    }
+
+    delete pOld;
+  }
+
+private:
+  CRCUPointerT(const CRCUPointerT&);
+  CRCUPointerT& operator=(const CRCUPointerT&);
+
+private:
+  std::atomic<T*> m_pObject;
+  std::atomic<uint> m_Epoch;
+  mutable std::atomic<size_t> m_Readers[2];
+};
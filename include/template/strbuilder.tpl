@@ -0,0 +1,247 @@
+/**
+ * @file   strbuilder.tpl
+ * @author Vic P.
+ * @brief  Template for String Builder & String Arena
+ */
+
+ /**
+  * CStringBuilderT
+  */
+
+/**
+ * A string that is assembled by appending in place, so a pipeline of steps (trim, join, normalize)
+ * appends to one buffer instead of returning a new string at every step.
+ * The text is contiguous, it is viewed without a copy and moved out by Detach().
+ */
+template <typename T>
+class CStringBuilderT
+{
+public:
+  typedef std::basic_string<T> string_t;
+  typedef CStringViewT<T> view_t;
+
+  CStringBuilderT(const size_t capacity = 0)
+  {
+    m_Text.reserve(capacity);
+  }
+
+  CStringBuilderT(string_t&& text) : m_Text(std::move(text))
+  {
+  }
+
+  const T* Data() const
+  {
+    return m_Text.data();
+  }
+
+  size_t Size() const
+  {
+    return m_Text.size();
+  }
+
+  size_t Capacity() const
+  {
+    return m_Text.capacity();
+  }
+
+  bool Empty() const
+  {
+    return m_Text.empty();
+  }
+
+  T Back() const
+  {
+    assert(!m_Text.empty());
+    return m_Text[m_Text.size() - 1];
+  }
+
+  /**
+   * Empties the builder, its capacity is kept for the next text.
+   */
+  void Clear()
+  {
+    m_Text.clear();
+  }
+
+  void Reserve(const size_t capacity)
+  {
+    m_Text.reserve(capacity);
+  }
+
+  void Truncate(const size_t size)
+  {
+    if (size < m_Text.size())
+    {
+      m_Text.resize(size);
+    }
+  }
+
+  /**
+   * Appends a string, the string must not be a view of this builder as appending may move its text.
+   */
+  CStringBuilderT& Append(const view_t& s)
+  {
+    m_Text.append(s.Data(), s.Size());
+    return *this;
+  }
+
+  CStringBuilderT& Append(const T ch, const size_t count = 1)
+  {
+    m_Text.append(count, ch);
+    return *this;
+  }
+
+  CStringBuilderT& operator<<(const view_t& s)
+  {
+    return this->Append(s);
+  }
+
+  CStringBuilderT& operator<<(const T ch)
+  {
+    return this->Append(ch);
+  }
+
+  view_t View() const
+  {
+    return view_t(m_Text.data(), m_Text.size());
+  }
+
+  string_t ToString() const
+  {
+    return m_Text;
+  }
+
+  /**
+   * Moves the text out of the builder, the builder is empty after that.
+   */
+  string_t Detach()
+  {
+    string_t result(std::move(m_Text));
+    m_Text.clear();
+    return result;
+  }
+
+private:
+  string_t m_Text;
+};
+
+/**
+ * CStringArenaT
+ */
+
+/**
+ * A scoped arena of strings, a string is copied into a big chunk and handed out as a view that is
+ * valid until the arena is cleared or destroyed. The chunks never move, so growing the arena keeps
+ * the views valid, and the strings are freed all at once.
+ */
+template <typename T>
+class CStringArenaT
+{
+public:
+  typedef CStringViewT<T> view_t;
+
+  static const size_t DEFAULT_CHUNK_SIZE = 4096; // In characters
+
+  CStringArenaT(const size_t chunk = DEFAULT_CHUNK_SIZE) : m_ChunkSize(chunk != 0 ? chunk : DEFAULT_CHUNK_SIZE), m_Used(0)
+  {
+  }
+
+  /**
+   * Copies a string into the arena, the copy is null-terminated.
+   */
+  view_t Store(const view_t& s)
+  {
+    T* p = this->Allocate(s.Size() + 1);
+    if (!s.Empty())
+    {
+      std::char_traits<T>::copy(p, s.Data(), s.Size());
+    }
+    p[s.Size()] = T(0);
+    return view_t(p, s.Size());
+  }
+
+  view_t Store(const CStringBuilderT<T>& builder)
+  {
+    return this->Store(builder.View());
+  }
+
+  /**
+   * Allocates the characters of a string, they are uninitialized.
+   * A string that is bigger than a chunk gets a chunk of its own.
+   */
+  T* Allocate(const size_t count)
+  {
+    if (m_Chunks.empty() || m_Chunks.back().Capacity - m_Chunks.back().Size < count)
+    {
+      if (count > m_ChunkSize / 4 && !m_Chunks.empty())
+      {
+        // A big string is put before the current chunk so the room that is left in it is kept
+
+        m_Chunks.insert(m_Chunks.end() - 1, TChunk(count));
+        m_Chunks[m_Chunks.size() - 2].Size = count;
+        m_Used += count;
+        return m_Chunks[m_Chunks.size() - 2].Data.get();
+      }
+
+      m_Chunks.push_back(TChunk(std::max(count, m_ChunkSize)));
+    }
+
+    auto& chunk = m_Chunks.back();
+    T* p = chunk.Data.get() + chunk.Size;
+    chunk.Size += count;
+    m_Used += count;
+
+    return p;
+  }
+
+  /**
+   * Frees all of the strings, the views are invalid after that. The first chunk is kept for reuse.
+   */
+  void Clear()
+  {
+    if (m_Chunks.size() > 1)
+    {
+      m_Chunks.erase(m_Chunks.begin() + 1, m_Chunks.end());
+    }
+
+    if (!m_Chunks.empty())
+    {
+      m_Chunks[0].Size = 0;
+    }
+
+    m_Used = 0;
+  }
+
+  size_t GetUsedSize() const
+  {
+    return m_Used;
+  }
+
+  size_t GetChunkCount() const
+  {
+    return m_Chunks.size();
+  }
+
+private:
+  struct TChunk
+  {
+    std::shared_ptr<T> Data; // Shared to copy the chunks around in the list (VS2012 has no move-only elements)
+    size_t Size;
+    size_t Capacity;
+
+    TChunk(const size_t capacity) : Data(new T[capacity], std::default_delete<T[]>()), Size(0), Capacity(capacity)
+    {
+    }
+  };
+
+  CStringArenaT(const CStringArenaT&);
+  CStringArenaT& operator=(const CStringArenaT&);
+
+private:
+  size_t m_ChunkSize;
+  size_t m_Used;
+  std::vector<TChunk> m_Chunks;
+};
+
+template <typename T>
+const size_t CStringArenaT<T>::DEFAULT_CHUNK_SIZE;
@@ -0,0 +1,212 @@
+/**
+ * @file   strreplace.tpl
+ * @author Vic P.
+ * @brief  Template for String Replace
+ */
+
+ /**
+  * CReplaceTableT
+  */
+
+/**
+ * A table of from-to pairs that are all replaced in one scan of a text.
+ * At a position the longest from string wins, the replaced text is not scanned again.
+ * The from strings are kept in a trie, the positions that can not start any of them
+ * are skipped by the bitmap of their first characters.
+ */
+template <typename T>
+class CReplaceTableT
+{
+public:
+  typedef std::basic_string<T> string_t;
+  typedef CStringViewT<T> view_t;
+
+  CReplaceTableT()
+  {
+    this->Clear();
+  }
+
+  void Clear()
+  {
+    m_Nodes.assign(1, TNode());
+    m_To.clear();
+    m_Firsts.clear();
+    memset(m_Table, 0, sizeof(m_Table));
+  }
+
+  size_t GetCount() const
+  {
+    return m_To.size();
+  }
+
+  /**
+   * Adds a pair, the empty from strings are ignored and the same from string replaces its previous pair.
+   */
+  void Add(const view_t& from, const view_t& to)
+  {
+    if (from.Empty())
+    {
+      return;
+    }
+
+    size_t node = 0;
+
+    for (size_t i = 0; i < from.Size(); i++)
+    {
+      size_t child = this->Child(node, from[i]);
+      if (child == NONE)
+      {
+        child = m_Nodes.size();
+        m_Nodes.push_back(TNode(from[i], m_Nodes[node].Child));
+        m_Nodes[node].Child = child;
+      }
+
+      node = child;
+    }
+
+    if (m_Nodes[node].Value == NONE)
+    {
+      m_Nodes[node].Value = m_To.size();
+      m_To.push_back(to.ToString());
+    }
+    else
+    {
+      m_To[m_Nodes[node].Value] = to.ToString();
+    }
+
+    if (m_Firsts.find(from[0]) == string_t::npos)
+    {
+      m_Firsts.push_back(from[0]);
+      view_t::MakeTable(m_Firsts, m_Table);
+    }
+  }
+
+  /**
+   * Finds all of the matches first, then copies every segment of the text and every replacement
+   * exactly once into a result that is sized by the matches.
+   */
+  string_t Apply(const view_t& text) const
+  {
+    std::vector<TMatch> matches;
+
+    size_t size = text.Size();
+
+    for (size_t i = this->Next(text, 0); i != view_t::npos;)
+    {
+      TMatch match;
+      if (this->Match(text.Data() + i, text.Size() - i, match))
+      {
+        match.Position = i;
+        matches.push_back(match);
+        size = size - match.Length + m_To[match.Value].size();
+        i += match.Length;
+      }
+      else
+      {
+        i++;
+      }
+
+      i = this->Next(text, i);
+    }
+
+    string_t result;
+    result.reserve(size);
+
+    size_t last = 0;
+
+    for (const auto& match : matches)
+    {
+      result.append(text.Data() + last, match.Position - last);
+      result.append(m_To[match.Value]);
+      last = match.Position + match.Length;
+    }
+
+    result.append(text.Data() + last, text.Size() - last);
+
+    return result;
+  }
+
+private:
+  static const size_t NONE = size_t(-1);
+
+  struct TNode
+  {
+    T Char;
+    size_t Child;   // The first child
+    size_t Sibling; // The next child of the parent
+    size_t Value;   // The index of the pair that ends here
+
+    TNode(const T ch = T(0), const size_t sibling = NONE) : Char(ch), Child(NONE), Sibling(sibling), Value(NONE)
+    {
+    }
+  };
+
+  struct TMatch
+  {
+    size_t Position;
+    size_t Length;
+    size_t Value;
+  };
+
+  /**
+   * Finds the next position that starts with a first character, mostly the from strings share
+   * their first character (e.g. the placeholders) so it is found by memchr/wmemchr.
+   */
+  size_t Next(const view_t& text, const size_t pos) const
+  {
+    if (m_Firsts.size() == 1)
+    {
+      return text.Find(m_Firsts[0], pos);
+    }
+
+    return text.FindFirstOf(m_Firsts, m_Table, pos);
+  }
+
+  size_t Child(const size_t node, const T ch) const
+  {
+    size_t child = m_Nodes[node].Child;
+
+    while (child != NONE && m_Nodes[child].Char != ch)
+    {
+      child = m_Nodes[child].Sibling;
+    }
+
+    return child;
+  }
+
+  /**
+   * Walks the trie along the text, the last pair passed by is the longest one.
+   */
+  bool Match(const T* s, const size_t n, TMatch& match) const
+  {
+    match.Value = NONE;
+
+    size_t node = 0;
+
+    for (size_t i = 0; i < n; i++)
+    {
+      node = this->Child(node, s[i]);
+      if (node == NONE)
+      {
+        break;
+      }
+
+      if (m_Nodes[node].Value != NONE)
+      {
+        match.Length = i + 1;
+        match.Value = m_Nodes[node].Value;
+      }
+    }
+
+    return match.Value != NONE;
+  }
+
+private:
+  std::vector<TNode> m_Nodes; // The root is at 0
+  std::vector<string_t> m_To;
+  string_t m_Firsts;
+  ulong32 m_Table[8];
+};
+
+template <typename T>
+const size_t CReplaceTableT<T>::NONE;
@@ -0,0 +1,602 @@
+/**
+ * @file   strview.tpl
+ * @author Vic P.
+ * @brief  Template for String View
+ */
+
+ /**
+  * CStringViewT
+  */
+
+/**
+ * A non-owning view (pointer and length) over a string, embedded NULs are kept.
+ * The viewed string must outlive the view, slicing a view never allocates.
+ */
+template <typename T>
+class CStringViewT
+{
+public:
+  typedef T value_type;
+  typedef const T* iterator;
+  typedef const T* const_iterator;
+  typedef std::char_traits<T> traits_type;
+
+  static const size_t npos = size_t(-1);
+
+  CStringViewT() : m_pData(nullptr), m_Size(0)
+  {
+  }
+
+  CStringViewT(const T* ptr, const size_t size) : m_pData(ptr), m_Size(ptr != nullptr ? size : 0)
+  {
+  }
+
+  CStringViewT(const T* ptr) : m_pData(ptr), m_Size(ptr != nullptr ? traits_type::length(ptr) : 0)
+  {
+  }
+
+  CStringViewT(const std::basic_string<T>& s) : m_pData(s.data()), m_Size(s.size())
+  {
+  }
+
+  const T* Data() const
+  {
+    return m_pData;
+  }
+
+  size_t Size() const
+  {
+    return m_Size;
+  }
+
+  bool Empty() const
+  {
+    return m_Size == 0;
+  }
+
+  const_iterator begin() const
+  {
+    return m_pData;
+  }
+
+  const_iterator end() const
+  {
+    return m_pData + m_Size;
+  }
+
+  const T& operator[](const size_t i) const
+  {
+    assert(i < m_Size);
+    return m_pData[i];
+  }
+
+  bool operator==(const CStringViewT& right) const
+  {
+    return m_Size == right.m_Size && (m_Size == 0 || traits_type::compare(m_pData, right.m_pData, m_Size) == 0);
+  }
+
+  bool operator!=(const CStringViewT& right) const
+  {
+    return !(*this == right);
+  }
+
+  CStringViewT Substr(const size_t pos, const size_t count = npos) const
+  {
+    if (pos >= m_Size)
+    {
+      return CStringViewT();
+    }
+
+    return CStringViewT(m_pData + pos, std::min(count, m_Size - pos));
+  }
+
+  /**
+   * The char traits search by memchr/wmemchr, they are the vectorized routines of the C run-time.
+   */
+  size_t Find(const T ch, const size_t pos = 0) const
+  {
+    if (pos >= m_Size)
+    {
+      return npos;
+    }
+
+    const T* p = traits_type::find(m_pData + pos, m_Size - pos, ch);
+
+    return p != nullptr ? size_t(p - m_pData) : npos;
+  }
+
+  size_t Find(const CStringViewT& s, const size_t pos = 0) const
+  {
+    if (s.m_Size == 0)
+    {
+      return pos <= m_Size ? pos : npos;
+    }
+
+    if (s.m_Size > m_Size)
+    {
+      return npos;
+    }
+
+    // Scans for the first character, then compares the rest at each candidate
+
+    const size_t last = m_Size - s.m_Size;
+
+    for (size_t i = this->Find(s.m_pData[0], pos); i != npos && i <= last; i = this->Find(s.m_pData[0], i + 1))
+    {
+      if (traits_type::compare(m_pData + i + 1, s.m_pData + 1, s.m_Size - 1) == 0)
+      {
+        return i;
+      }
+    }
+
+    return npos;
+  }
+
+  size_t FindFirstOf(const CStringViewT& set, const size_t pos = 0) const
+  {
+    if (set.m_Size == 1)
+    {
+      return this->Find(set.m_pData[0], pos);
+    }
+
+    ulong32 table[8];
+    MakeTable(set, table);
+
+    return FindFirstOf(set, table, pos);
+  }
+
+  std::basic_string<T> ToString() const
+  {
+    return std::basic_string<T>(m_pData, m_Size);
+  }
+
+  /**
+   * A set of characters is looked up by the low byte of a character in a bitmap,
+   * then it is confirmed in the set only for the wide characters.
+   */
+  static void MakeTable(const CStringViewT& set, ulong32 table[8])
+  {
+    memset(table, 0, 8 * sizeof(ulong32));
+
+    for (size_t i = 0; i < set.m_Size; i++)
+    {
+      const auto v = byte(set.m_pData[i]);
+      table[v >> 5] |= 1U << (v & 31);
+    }
+  }
+
+  size_t FindFirstOf(const CStringViewT& set, const ulong32 table[8], const size_t pos) const
+  {
+    for (size_t i = pos; i < m_Size; i++)
+    {
+      const T ch = m_pData[i];
+      const auto v = byte(ch);
+
+      if ((table[v >> 5] & (1U << (v & 31))) == 0)
+      {
+        continue;
+      }
+
+      if (sizeof(T) == 1 || traits_type::find(set.m_pData, set.m_Size, ch) != nullptr)
+      {
+        return i;
+      }
+    }
+
+    return npos;
+  }
+
+private:
+  const T* m_pData;
+  size_t m_Size;
+};
+
+template <typename T>
+const size_t CStringViewT<T>::npos;
+
+/**
+ * CSplitStringT
+ */
+
+typedef enum _SPLIT_MODE
+{
+  SM_STRING = 0, // Split by the whole separator
+  SM_ANY_OF = 1, // Split by any character of the separator
+} eSplitMode;
+
+/**
+ * A lazy split over a string view, each token is a view into the string so nothing is allocated.
+ * Iterating it finds one separator per step, so a caller can stop early at no extra cost.
+ */
+template <typename T>
+class CSplitStringT
+{
+public:
+  typedef CStringViewT<T> view_t;
+
+  class CIterator
+  {
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef view_t value_type;
+    typedef ptrdiff_t difference_type;
+    typedef const view_t* pointer;
+    typedef const view_t& reference;
+
+    CIterator() : m_pSplit(nullptr), m_Next(0)
+    {
+    }
+
+    CIterator(const CSplitStringT* pSplit) : m_pSplit(pSplit), m_Next(0)
+    {
+      if (m_pSplit->m_Text.Empty())
+      {
+        m_pSplit = nullptr;
+      }
+      else
+      {
+        this->Advance();
+      }
+    }
+
+    reference operator*() const
+    {
+      return m_Token;
+    }
+
+    pointer operator->() const
+    {
+      return &m_Token;
+    }
+
+    CIterator& operator++()
+    {
+      this->Advance();
+      return *this;
+    }
+
+    CIterator operator++(int)
+    {
+      CIterator result(*this);
+      this->Advance();
+      return result;
+    }
+
+    bool operator==(const CIterator& right) const
+    {
+      if (m_pSplit == nullptr || right.m_pSplit == nullptr)
+      {
+        return m_pSplit == right.m_pSplit;
+      }
+
+      return m_pSplit == right.m_pSplit && m_Token.Data() == right.m_Token.Data();
+    }
+
+    bool operator!=(const CIterator& right) const
+    {
+      return !(*this == right);
+    }
+
+  private:
+    void Advance()
+    {
+      const auto& text = m_pSplit->m_Text;
+
+      do
+      {
+        if (m_Next > text.Size())
+        {
+          m_pSplit = nullptr; // The end of the text, the last token was the tail
+          return;
+        }
+
+        size_t length = 0;
+        const size_t pos = m_pSplit->Next(m_Next, length);
+
+        if (pos == view_t::npos)
+        {
+          m_Token = view_t(text.Data() + m_Next, text.Size() - m_Next);
+          m_Next = text.Size() + 1;
+        }
+        else
+        {
+          m_Token = view_t(text.Data() + m_Next, pos - m_Next);
+          m_Next = pos + length;
+        }
+      } while (m_pSplit->m_RemoveEmpty && m_Token.Empty());
+    }
+
+  private:
+    const CSplitStringT* m_pSplit; // Null at the end
+    view_t m_Token;
+    size_t m_Next;
+  };
+
+  typedef CIterator iterator;
+  typedef CIterator const_iterator;
+
+  CSplitStringT(
+    const view_t& text,
+    const view_t& separator,
+    const bool remempty = false,
+    const eSplitMode mode = eSplitMode::SM_STRING
+  ) : m_Text(text), m_Separator(separator), m_RemoveEmpty(remempty), m_Mode(mode)
+  {
+    if (m_Mode == eSplitMode::SM_ANY_OF)
+    {
+      view_t::MakeTable(m_Separator, m_Table);
+    }
+  }
+
+  CIterator begin() const
+  {
+    return CIterator(this);
+  }
+
+  CIterator end() const
+  {
+    return CIterator();
+  }
+
+  std::vector<std::basic_string<T>> ToList() const
+  {
+    std::vector<std::basic_string<T>> result;
+
+    for (const auto& e : *this)
+    {
+      result.push_back(e.ToString());
+    }
+
+    return result;
+  }
+
+private:
+  /**
+   * Finds the next separator from a position, the length of the found separator is returned by length.
+   */
+  size_t Next(const size_t pos, size_t& length) const
+  {
+    if (m_Separator.Empty())
+    {
+      return view_t::npos;
+    }
+
+    if (m_Separator.Size() == 1)
+    {
+      length = 1;
+      return m_Text.Find(m_Separator[0], pos);
+    }
+
+    if (m_Mode == eSplitMode::SM_ANY_OF)
+    {
+      length = 1;
+      return m_Text.FindFirstOf(m_Separator, m_Table, pos);
+    }
+
+    length = m_Separator.Size();
+    return m_Text.Find(m_Separator, pos);
+  }
+
+private:
+  view_t m_Text;
+  view_t m_Separator;
+  bool m_RemoveEmpty;
+  eSplitMode m_Mode;
+  ulong32 m_Table[8];
+};
+
+/**
+ * CMultiStringT
+ */
+
+/**
+ * A view over a multi-string (a block of null-terminated strings that ends by an empty string,
+ * e.g. REG_MULTI_SZ), each entry is a view into the block so iterating it allocates nothing.
+ * The bounded form stops at the end of the block also, for the data that may lack its terminators.
+ */
+template <typename T>
+class CMultiStringT
+{
+public:
+  typedef CStringViewT<T> view_t;
+  typedef std::char_traits<T> traits_type;
+
+  class CIterator
+  {
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef view_t value_type;
+    typedef ptrdiff_t difference_type;
+    typedef const view_t* pointer;
+    typedef const view_t& reference;
+
+    CIterator() : m_pNext(nullptr), m_Left(0)
+    {
+    }
+
+    CIterator(const T* ptr, const size_t count) : m_pNext(ptr), m_Left(count)
+    {
+      this->Advance();
+    }
+
+    reference operator*() const
+    {
+      return m_Entry;
+    }
+
+    pointer operator->() const
+    {
+      return &m_Entry;
+    }
+
+    CIterator& operator++()
+    {
+      this->Advance();
+      return *this;
+    }
+
+    CIterator operator++(int)
+    {
+      CIterator result(*this);
+      this->Advance();
+      return result;
+    }
+
+    bool operator==(const CIterator& right) const
+    {
+      return m_Entry.Data() == right.m_Entry.Data();
+    }
+
+    bool operator!=(const CIterator& right) const
+    {
+      return !(*this == right);
+    }
+
+  private:
+    void Advance()
+    {
+      if (m_pNext == nullptr || m_Left == 0 || *m_pNext == T(0))
+      {
+        m_Entry = view_t(); // The end, an empty entry terminates the block
+        m_pNext = nullptr;
+        return;
+      }
+
+      size_t length = 0;
+
+      if (m_Left == npos)
+      {
+        length = traits_type::length(m_pNext);
+      }
+      else
+      {
+        const T* p = traits_type::find(m_pNext, m_Left, T(0));
+        length = p != nullptr ? size_t(p - m_pNext) : m_Left;
+      }
+
+      m_Entry = view_t(m_pNext, length);
+
+      const size_t n = std::min(length + 1, m_Left);
+      m_pNext += n;
+      m_Left  -= m_Left != npos ? n : 0;
+    }
+
+  private:
+    view_t m_Entry;
+    const T* m_pNext;
+    size_t m_Left; // The characters that are left in the block, npos when it is unbounded
+  };
+
+  typedef CIterator iterator;
+  typedef CIterator const_iterator;
+
+  static const size_t npos = size_t(-1);
+
+  CMultiStringT(const T* ptr) : m_pData(ptr), m_Count(npos)
+  {
+  }
+
+  CMultiStringT(const T* ptr, const size_t count) : m_pData(ptr), m_Count(count)
+  {
+  }
+
+  CIterator begin() const
+  {
+    return CIterator(m_pData, m_Count);
+  }
+
+  CIterator end() const
+  {
+    return CIterator();
+  }
+
+  bool Empty() const
+  {
+    return this->begin() == this->end();
+  }
+
+  size_t GetCount() const
+  {
+    size_t result = 0;
+
+    for (auto it = this->begin(); it != this->end(); ++it)
+    {
+      result++;
+    }
+
+    return result;
+  }
+
+  /**
+   * The size of the entries in characters, their terminators are counted but not the terminator of the block.
+   */
+  size_t GetSize() const
+  {
+    size_t result = 0;
+
+    for (const auto& e : *this)
+    {
+      result += e.Size() + 1;
+    }
+
+    return result;
+  }
+
+  std::vector<std::basic_string<T>> ToList() const
+  {
+    std::vector<std::basic_string<T>> result;
+
+    for (const auto& e : *this)
+    {
+      result.push_back(e.ToString());
+    }
+
+    return result;
+  }
+
+  /**
+   * Encodes a list of strings (any container of strings or views) to a multi-string.
+   * Returns the size of the multi-string in characters, it is written when the buffer can hold it.
+   * An empty string in the list ends the multi-string at that entry when it is read back.
+   */
+  template <class List>
+  static size_t Encode(const List& list, T* pBuffer, const size_t count)
+  {
+    size_t size = 1; // The terminator of the block
+
+    for (const auto& e : list)
+    {
+      size += view_t(e).Size() + 1;
+    }
+
+    if (pBuffer == nullptr || count < size)
+    {
+      return size;
+    }
+
+    T* p = pBuffer;
+
+    for (const auto& e : list)
+    {
+      const view_t s(e);
+      if (!s.Empty())
+      {
+        traits_type::copy(p, s.Data(), s.Size());
+      }
+
+      p += s.Size();
+      *p++ = T(0);
+    }
+
+    *p = T(0);
+
+    return size;
+  }
+
+private:
+  const T* m_pData;
+  size_t m_Count; // In characters, npos when the block is null-terminated only
+};
+
+template <typename T>
+const size_t CMultiStringT<T>::npos;
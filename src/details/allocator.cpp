@@ -0,0 +1,351 @@
+/**
+ * @file   allocator.cpp
+ * @author Vic P.
+ * @brief  Implementation for Allocator
+ */
+
+#include "Vutils.h"
+
+#include <cstdlib>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif // _WIN32
+
+#ifdef _MSC_VER
+#define VU_THREAD_LOCAL __declspec(thread)
+#else  // __GNUC__
+#define VU_THREAD_LOCAL __thread
+#endif // _MSC_VER
+
+namespace vu
+{
+
+/**
+ * CHeapAllocator
+ */
+
+static CHeapAllocator g_HeapAllocator;
+
+CHeapAllocator& CHeapAllocator::Instance()
+{
+  return g_HeapAllocator;
+}
+
+void* CHeapAllocator::Allocate(const size_t size)
+{
+  return std::malloc(size);
+}
+
+void* CHeapAllocator::Reallocate(void* ptr, const size_t size, const size_t newsize)
+{
+  UNREFERENCED_PARAMETER(size);
+  return std::realloc(ptr, newsize);
+}
+
+void CHeapAllocator::Free(void* ptr, const size_t size)
+{
+  UNREFERENCED_PARAMETER(size);
+  std::free(ptr);
+}
+
+/**
+ * CPoolAllocator
+ */
+
+static CPoolAllocator g_PoolAllocator;
+
+CPoolAllocator& CPoolAllocator::Instance()
+{
+  return g_PoolAllocator;
+}
+
+static const size_t POOL_MIN_SHIFT   = 6;  // 64 B
+static const size_t POOL_MAX_SHIFT   = 16; // 64 KiB
+static const size_t POOL_NUM_CLASSES = POOL_MAX_SHIFT - POOL_MIN_SHIFT + 1;
+static const size_t POOL_NUM_SHARDS  = 16;
+static const size_t POOL_SLAB_SIZE   = 256 * KiB;
+
+/**
+ * A free block keeps the link to the next free block of its slab in its own payload.
+ */
+struct TFreeBlock
+{
+  TFreeBlock* pNext;
+};
+
+/**
+ * A slab of one size class, it is aligned to its size so the slab of a block is found by its address.
+ * The header is at the start of the slab and the blocks follow it.
+ */
+struct TPoolSlab
+{
+  TPoolSlab* pPrev; // In the list of the slabs of its shard that have a free block
+  TPoolSlab* pNext;
+  TFreeBlock* pFree;
+  byte* pCarve;     // The blocks from it to the end of the slab are not handed out yet
+  size_t Used;
+  size_t Shard;
+};
+
+static const size_t POOL_SLAB_HEADER = (sizeof(TPoolSlab) + 63) & ~size_t(63);
+
+/**
+ * The threads are spread over the shards, a shard owns its slabs and a block is freed to its own slab
+ * by any thread. The states are zero-initialized, so the pool works before the static constructors.
+ */
+struct TPoolShard
+{
+  std::atomic<bool> Lock;
+  TPoolSlab* pSlabs[POOL_NUM_CLASSES];
+  size_t Empty[POOL_NUM_CLASSES]; // The empty slabs that are kept for reuse
+};
+
+static TPoolShard g_PoolShards[POOL_NUM_SHARDS];
+static std::atomic<size_t> g_PoolNextShard;
+static VU_THREAD_LOCAL size_t g_PoolShard; // Plus one, zero until the thread allocates
+
+static size_t PoolClassOf(const size_t size)
+{
+  size_t index = 0;
+
+  while ((size_t(1) << (POOL_MIN_SHIFT + index)) < size)
+  {
+    index++;
+  }
+
+  return index;
+}
+
+static bool PoolOwns(const size_t size)
+{
+  return size != 0 && size <= (size_t(1) << POOL_MAX_SHIFT);
+}
+
+static size_t PoolShardOfThread()
+{
+  if (g_PoolShard == 0)
+  {
+    g_PoolShard = g_PoolNextShard++ % POOL_NUM_SHARDS + 1;
+  }
+
+  return g_PoolShard - 1;
+}
+
+static void LockShard(TPoolShard& shard)
+{
+  while (shard.Lock.exchange(true, std::memory_order_acquire))
+  {
+    std::this_thread::yield();
+  }
+}
+
+static void UnlockShard(TPoolShard& shard)
+{
+  shard.Lock.store(false, std::memory_order_release);
+}
+
+static void* AllocateSlab()
+{
+  #ifdef _WIN32
+  return _aligned_malloc(POOL_SLAB_SIZE, POOL_SLAB_SIZE);
+  #else  // POSIX
+  void* ptr = nullptr;
+  return posix_memalign(&ptr, POOL_SLAB_SIZE, POOL_SLAB_SIZE) == 0 ? ptr : nullptr;
+  #endif // _WIN32
+}
+
+static void FreeSlab(TPoolSlab* pSlab)
+{
+  #ifdef _WIN32
+  _aligned_free(pSlab);
+  #else  // POSIX
+  std::free(pSlab);
+  #endif // _WIN32
+}
+
+static bool HasRoom(const TPoolSlab* pSlab, const size_t block)
+{
+  return pSlab->pFree != nullptr || pSlab->pCarve + block <= reinterpret_cast<const byte*>(pSlab) + POOL_SLAB_SIZE;
+}
+
+static void LinkSlab(TPoolShard& shard, const size_t index, TPoolSlab* pSlab)
+{
+  pSlab->pPrev = nullptr;
+  pSlab->pNext = shard.pSlabs[index];
+
+  if (pSlab->pNext != nullptr)
+  {
+    pSlab->pNext->pPrev = pSlab;
+  }
+
+  shard.pSlabs[index] = pSlab;
+}
+
+static void UnlinkSlab(TPoolShard& shard, const size_t index, TPoolSlab* pSlab)
+{
+  if (pSlab->pPrev != nullptr)
+  {
+    pSlab->pPrev->pNext = pSlab->pNext;
+  }
+  else
+  {
+    shard.pSlabs[index] = pSlab->pNext;
+  }
+
+  if (pSlab->pNext != nullptr)
+  {
+    pSlab->pNext->pPrev = pSlab->pPrev;
+  }
+}
+
+void* CPoolAllocator::Allocate(const size_t size)
+{
+  if (!PoolOwns(size))
+  {
+    return std::malloc(size);
+  }
+
+  const auto index = PoolClassOf(size);
+  const size_t block = size_t(1) << (POOL_MIN_SHIFT + index);
+
+  const auto id = PoolShardOfThread();
+  auto& shard = g_PoolShards[id];
+
+  LockShard(shard);
+
+  auto pSlab = shard.pSlabs[index];
+  if (pSlab == nullptr)
+  {
+    pSlab = static_cast<TPoolSlab*>(AllocateSlab());
+    if (pSlab == nullptr)
+    {
+      UnlockShard(shard);
+      return nullptr;
+    }
+
+    pSlab->pFree  = nullptr;
+    pSlab->pCarve = reinterpret_cast<byte*>(pSlab) + POOL_SLAB_HEADER;
+    pSlab->Used   = 0;
+    pSlab->Shard  = id;
+
+    LinkSlab(shard, index, pSlab);
+    shard.Empty[index]++;
+  }
+
+  void* ptr = pSlab->pFree;
+  if (ptr != nullptr)
+  {
+    pSlab->pFree = pSlab->pFree->pNext;
+  }
+  else
+  {
+    ptr = pSlab->pCarve;
+    pSlab->pCarve += block;
+  }
+
+  if (pSlab->Used++ == 0)
+  {
+    shard.Empty[index]--;
+  }
+
+  if (!HasRoom(pSlab, block))
+  {
+    UnlinkSlab(shard, index, pSlab); // Linked again when a block of it is freed
+  }
+
+  UnlockShard(shard);
+
+  return ptr;
+}
+
+void* CPoolAllocator::Reallocate(void* ptr, const size_t size, const size_t newsize)
+{
+  if (ptr == nullptr)
+  {
+    return this->Allocate(newsize);
+  }
+
+  const bool owned = PoolOwns(size);
+  const bool newowned = PoolOwns(newsize);
+
+  if (!owned && !newowned)
+  {
+    return std::realloc(ptr, newsize);
+  }
+
+  if (owned && newowned && PoolClassOf(size) == PoolClassOf(newsize))
+  {
+    return ptr; // The block is already big enough
+  }
+
+  void* result = this->Allocate(newsize);
+  if (result != nullptr)
+  {
+    memcpy(result, ptr, std::min(size, newsize));
+    this->Free(ptr, size);
+  }
+
+  return result;
+}
+
+/**
+ * A block is freed to its slab, so it is reused by the threads of the shard of the slab.
+ * An empty slab is released unless it is the one that is kept for the size class of the shard.
+ */
+void CPoolAllocator::Free(void* ptr, const size_t size)
+{
+  if (ptr == nullptr)
+  {
+    return;
+  }
+
+  if (!PoolOwns(size))
+  {
+    std::free(ptr);
+    return;
+  }
+
+  const auto index = PoolClassOf(size);
+  const size_t block = size_t(1) << (POOL_MIN_SHIFT + index);
+
+  const auto pSlab = reinterpret_cast<TPoolSlab*>(reinterpret_cast<ulongptr>(ptr) & ~ulongptr(POOL_SLAB_SIZE - 1));
+  auto& shard = g_PoolShards[pSlab->Shard];
+
+  LockShard(shard);
+
+  if (!HasRoom(pSlab, block))
+  {
+    LinkSlab(shard, index, pSlab);
+  }
+
+  auto pBlock = static_cast<TFreeBlock*>(ptr);
+  pBlock->pNext = pSlab->pFree;
+  pSlab->pFree = pBlock;
+
+  bool release = false;
+
+  if (--pSlab->Used == 0)
+  {
+    release = shard.Empty[index] != 0;
+
+    if (release)
+    {
+      UnlinkSlab(shard, index, pSlab);
+    }
+    else
+    {
+      shard.Empty[index]++;
+    }
+  }
+
+  UnlockShard(shard);
+
+  if (release)
+  {
+    FreeSlab(pSlab);
+  }
+}
+
+} // namespace vu
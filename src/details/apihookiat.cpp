@@ -51,9 +51,9 @@ struct IATElement
   bool operator==(const IATElement& right) const
   {
     return\
-      UpperStringA(target) == UpperStringA(right.target) &&
-      UpperStringA(module) == UpperStringA(right.module) &&
-      UpperStringA(function) == UpperStringA(right.function);
+      EqualsIgnoreCaseA(target, right.target) &&
+      EqualsIgnoreCaseA(module, right.module) &&
+      EqualsIgnoreCaseA(function, right.function);
   }
 
   bool operator!=(const IATElement& right) const
@@ -0,0 +1,423 @@
+/**
+ * @file   codec.cpp
+ * @author Vic P.
+ * @brief  Implementation for Binary To Text
+ */
+
+#include "Vutils.h"
+#include "simd.h"
+
+#include <algorithm>
+
+namespace vu
+{
+
+/**
+ * The digits and the Base64 characters are all ASCII, so a wide text is converted by the vectors.
+ */
+
+static bool NarrowASCII(const std::wstring& Text, std::string& Result)
+{
+  if (SIMDASCIIPrefix(Text.data(), Text.size(), sizeof(wchar)) != Text.size())
+  {
+    return false;
+  }
+
+  Result.resize(Text.size());
+  SIMDCopyASCII(Text.data(), Text.size(), sizeof(wchar), &Result[0], 1);
+
+  return true;
+}
+
+static std::wstring WidenASCII(const std::string& Text)
+{
+  std::wstring result(Text.size(), L'\0');
+  SIMDCopyASCII(Text.data(), Text.size(), 1, &result[0], sizeof(wchar));
+  return result;
+}
+
+/**
+ * Hexadecimal
+ */
+
+std::string vuapi ToHexStringA(const void* Data, const size_t Size, const bool Upper)
+{
+  std::string result;
+
+  if (Data == nullptr || Size == 0)
+  {
+    return result;
+  }
+
+  result.resize(2 * Size);
+  SIMDEncodeHex(Data, Size, &result[0], Upper);
+
+  return result;
+}
+
+std::wstring vuapi ToHexStringW(const void* Data, const size_t Size, const bool Upper)
+{
+  return WidenASCII(ToHexStringA(Data, Size, Upper));
+}
+
+bool vuapi FromHexStringA(const std::string& Text, CBuffer& Data)
+{
+  Data.Reset();
+
+  if (Text.size() % 2 != 0)
+  {
+    return false;
+  }
+
+  const size_t size = Text.size() / 2;
+  if (size == 0)
+  {
+    return true;
+  }
+
+  Data.Resize(size, false);
+
+  if (SIMDDecodeHex(Text.data(), size, Data.GetpBytes()) != size)
+  {
+    Data.Reset();
+    return false;
+  }
+
+  return true;
+}
+
+bool vuapi FromHexStringW(const std::wstring& Text, CBuffer& Data)
+{
+  std::string text;
+  if (!NarrowASCII(Text, text))
+  {
+    Data.Reset();
+    return false;
+  }
+
+  return FromHexStringA(text, Data);
+}
+
+/**
+ * Base64
+ * A group of 3 bytes is encoded as two 12-bit halves, each one is a lookup of 2 characters.
+ * A group of 4 characters is decoded by the tables of their 6 bits shifted in place, an invalid
+ * character sets a bit above the 24 bits so a group is checked once.
+ */
+
+static const char BASE64_ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static const ulong32 BASE64_INVALID = 0x01000000;
+
+static const struct TBase64Tables
+{
+  char Pairs[4096][2];
+  ulong32 Decode[4][256];
+
+  TBase64Tables()
+  {
+    for (size_t i = 0; i < 4096; i++)
+    {
+      Pairs[i][0] = BASE64_ALPHABET[i >> 6];
+      Pairs[i][1] = BASE64_ALPHABET[i & 63];
+    }
+
+    for (size_t i = 0; i < 4; i++)
+    {
+      for (size_t c = 0; c < 256; c++)
+      {
+        Decode[i][c] = BASE64_INVALID;
+      }
+
+      for (ulong32 v = 0; v < 64; v++)
+      {
+        Decode[i][byte(BASE64_ALPHABET[v])] = v << (6 * (3 - i));
+      }
+    }
+  }
+} g_Base64;
+
+std::string vuapi ToBase64A(const void* Data, const size_t Size)
+{
+  std::string result;
+
+  if (Data == nullptr || Size == 0)
+  {
+    return result;
+  }
+
+  result.resize(4 * ((Size + 2) / 3));
+
+  const auto s = static_cast<const byte*>(Data);
+  char* d = &result[0];
+
+  size_t i = 0;
+
+  for (; i + 3 <= Size; i += 3, d += 4)
+  {
+    const ulong32 v = (ulong32(s[i]) << 16) | (ulong32(s[i + 1]) << 8) | s[i + 2];
+    memcpy(d + 0, g_Base64.Pairs[v >> 12], 2);
+    memcpy(d + 2, g_Base64.Pairs[v & 0xFFF], 2);
+  }
+
+  if (i < Size) // The last 1 or 2 bytes with the padding
+  {
+    const ulong32 v = (ulong32(s[i]) << 16) | (i + 1 < Size ? ulong32(s[i + 1]) << 8 : 0);
+    d[0] = BASE64_ALPHABET[v >> 18];
+    d[1] = BASE64_ALPHABET[(v >> 12) & 63];
+    d[2] = i + 1 < Size ? BASE64_ALPHABET[(v >> 6) & 63] : '=';
+    d[3] = '=';
+  }
+
+  return result;
+}
+
+std::wstring vuapi ToBase64W(const void* Data, const size_t Size)
+{
+  return WidenASCII(ToBase64A(Data, Size));
+}
+
+bool vuapi FromBase64A(const std::string& Text, CBuffer& Data)
+{
+  Data.Reset();
+
+  size_t n = Text.size();
+
+  if (n % 4 == 0)
+  {
+    for (int i = 0; i < 2 && n != 0 && Text[n - 1] == '='; i++)
+    {
+      n--;
+    }
+  }
+
+  const size_t tail = n % 4;
+  if (tail == 1)
+  {
+    return false;
+  }
+
+  const size_t size = n / 4 * 3 + (tail != 0 ? tail - 1 : 0);
+  if (size == 0)
+  {
+    return n == 0;
+  }
+
+  Data.Resize(size, false);
+
+  const auto s = reinterpret_cast<const byte*>(Text.data());
+  byte* d = Data.GetpBytes();
+
+  const auto& t = g_Base64.Decode;
+
+  ulong32 invalid = 0;
+
+  size_t i = 0;
+
+  for (; i + 4 <= n; i += 4, d += 3)
+  {
+    const ulong32 v = t[0][s[i]] | t[1][s[i + 1]] | t[2][s[i + 2]] | t[3][s[i + 3]];
+    invalid |= v;
+    d[0] = byte(v >> 16);
+    d[1] = byte(v >> 8);
+    d[2] = byte(v);
+  }
+
+  if (tail != 0)
+  {
+    const ulong32 v = t[0][s[i]] | t[1][s[i + 1]] | (tail == 3 ? t[2][s[i + 2]] : 0);
+    invalid |= v;
+    d[0] = byte(v >> 16);
+    if (tail == 3)
+    {
+      d[1] = byte(v >> 8);
+    }
+  }
+
+  if ((invalid & BASE64_INVALID) != 0)
+  {
+    Data.Reset();
+    return false;
+  }
+
+  return true;
+}
+
+bool vuapi FromBase64W(const std::wstring& Text, CBuffer& Data)
+{
+  std::string text;
+  if (!NarrowASCII(Text, text))
+  {
+    Data.Reset();
+    return false;
+  }
+
+  return FromBase64A(text, Data);
+}
+
+/**
+ * CHexDump
+ */
+
+static const size_t HEX_DUMP_CHUNK = 64 * KB; // The buffered text that is passed to the sink at once
+
+static const char HEX_DUMP_DIGITS[] = "0123456789abcdef";
+
+CHexDump::CHexDump(const FnSink fnSink, const size_t width, const ulonglong base) : m_fnSink(fnSink)
+{
+  this->Initialize(width, base);
+}
+
+CHexDump::CHexDump(std::string& text, const size_t width, const ulonglong base)
+  : m_fnSink([&text](const char* s, const size_t n) { text.append(s, n); })
+{
+  this->Initialize(width, base);
+}
+
+CHexDump::CHexDump(CBuffer& buffer, const size_t width, const ulonglong base)
+  : m_fnSink([&buffer](const char* s, const size_t n) { buffer.Append(s, n); })
+{
+  this->Initialize(width, base);
+}
+
+CHexDump::CHexDump(FILE* file, const size_t width, const ulonglong base)
+  : m_fnSink([file](const char* s, const size_t n) { fwrite(s, 1, n, file); })
+{
+  this->Initialize(width, base);
+}
+
+CHexDump::~CHexDump()
+{
+  this->End();
+}
+
+void CHexDump::Initialize(const size_t width, const ulonglong base)
+{
+  m_Width  = width != 0 ? width : 16;
+  m_Offset = base;
+  m_Line.reserve(m_Width);
+  m_Text.reserve(HEX_DUMP_CHUNK + 5 * m_Width + 32);
+}
+
+void CHexDump::Update(const void* data, const size_t size)
+{
+  if (data == nullptr || size == 0)
+  {
+    return;
+  }
+
+  auto s = static_cast<const byte*>(data);
+  auto n = size;
+
+  if (!m_Line.empty()) // Completes the pending line first
+  {
+    const size_t count = std::min(n, m_Width - m_Line.size());
+    m_Line.insert(m_Line.end(), s, s + count);
+    s += count;
+    n -= count;
+
+    if (m_Line.size() < m_Width)
+    {
+      return;
+    }
+
+    this->WriteLine(&m_Line[0], m_Width);
+    m_Line.clear();
+  }
+
+  for (; n >= m_Width; s += m_Width, n -= m_Width)
+  {
+    this->WriteLine(s, m_Width);
+  }
+
+  m_Line.assign(s, s + n);
+}
+
+void CHexDump::End()
+{
+  if (!m_Line.empty())
+  {
+    this->WriteLine(&m_Line[0], m_Line.size());
+    m_Line.clear();
+  }
+
+  this->Flush();
+}
+
+/**
+ * A line is "  %04x " then " %02x" per byte with a gap every 8 bytes, then the printable characters.
+ * The line is laid out with the spaces first, so a short line is padded to the columns of a full line.
+ */
+void CHexDump::WriteLine(const byte* data, const size_t size)
+{
+  size_t digits = 4;
+  while (digits < 16 && (m_Offset >> (4 * digits)) != 0)
+  {
+    digits++;
+  }
+
+  const size_t gaps = (m_Width - 1) / 8;
+  const size_t length = 2 + digits + 1 + 3 * m_Width + gaps + 2 + size + 1;
+
+  const size_t pos = m_Text.size();
+  m_Text.resize(pos + length, ' ');
+
+  char* p = &m_Text[pos] + 2;
+
+  for (size_t i = digits; i != 0; i--)
+  {
+    *p++ = HEX_DUMP_DIGITS[(m_Offset >> (4 * (i - 1))) & 0x0F];
+  }
+
+  p++;
+
+  for (size_t i = 0; i < size; i++)
+  {
+    p += (i != 0 && i % 8 == 0) ? 2 : 1;
+    *p++ = HEX_DUMP_DIGITS[data[i] >> 4];
+    *p++ = HEX_DUMP_DIGITS[data[i] & 0x0F];
+  }
+
+  p = &m_Text[pos] + length - 1 - size;
+
+  for (size_t i = 0; i < size; i++)
+  {
+    *p++ = data[i] < 0x20 || data[i] > 0x7E ? '.' : char(data[i]);
+  }
+
+  *p = '\n';
+
+  m_Offset += size;
+
+  if (m_Text.size() >= HEX_DUMP_CHUNK)
+  {
+    this->Flush();
+  }
+}
+
+void CHexDump::Flush()
+{
+  if (!m_Text.empty() && m_fnSink != nullptr)
+  {
+    m_fnSink(m_Text.data(), m_Text.size());
+  }
+
+  m_Text.clear();
+}
+
+/**
+ * HexDump
+ */
+
+void vuapi HexDump(const void* Data, int Size)
+{
+  if (Data == nullptr || Size <= 0)
+  {
+    return;
+  }
+
+  CHexDump dump(stdout);
+  dump.Update(Data, size_t(Size));
+}
+
+} // namespace vu
@@ -8,13 +8,29 @@
 
 #include <map>
 #include <cwctype>
+
+#ifdef _WIN32
 #include <shellapi.h>
 #include <comdef.h>
 #include <wbemidl.h>
+#else  // POSIX
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // _WIN32
 
 namespace vu
 {
 
+#ifdef _WIN32
+static const char  PATH_SEP_A =  '\\';
+static const wchar PATH_SEP_W = L'\\';
+#else  // POSIX
+static const char  PATH_SEP_A =  '/';
+static const wchar PATH_SEP_W = L'/';
+#endif // _WIN32
+
+#ifdef _WIN32
+
 bool vuapi IsDirectoryExistsA(const std::string& Directory)
 {
   if (GetFileAttributesA(Directory.c_str()) == INVALID_FILE_ATTRIBUTES)
@@ -97,12 +113,38 @@ bool vuapi IsFileExistsW(const std::wstring& FilePath)
   return bResult;
 }
 
+#else  // POSIX
+
+bool vuapi IsDirectoryExistsA(const std::string& Directory)
+{
+  struct stat st = {0};
+  return stat(Directory.c_str(), &st) == 0;
+}
+
+bool vuapi IsDirectoryExistsW(const std::wstring& Directory)
+{
+  return IsDirectoryExistsA(ToUTF8(Directory));
+}
+
+bool vuapi IsFileExistsA(const std::string& FilePath)
+{
+  struct stat st = {0};
+  return stat(FilePath.c_str(), &st) == 0;
+}
+
+bool vuapi IsFileExistsW(const std::wstring& FilePath)
+{
+  return IsFileExistsA(ToUTF8(FilePath));
+}
+
+#endif // _WIN32
+
 std::string vuapi ExtractFileDirectoryA(const std::string& FilePath, bool Slash)
 {
   std::string filePath;
   filePath.clear();
 
-  size_t slashPos = FilePath.rfind('\\');
+  size_t slashPos = FilePath.rfind(PATH_SEP_A);
   if (slashPos != std::string::npos)
   {
     filePath = FilePath.substr(0, slashPos + (Slash ? 1 : 0));
@@ -116,7 +158,7 @@ std::wstring vuapi ExtractFileDirectoryW(const std::wstring& FilePath, bool Slas
   std::wstring filePath;
   filePath.clear();
 
-  size_t slashPos = FilePath.rfind(L'\\');
+  size_t slashPos = FilePath.rfind(PATH_SEP_W);
   if (slashPos != std::string::npos)
   {
     filePath = FilePath.substr(0, slashPos + (Slash ? 1 : 0));
@@ -130,7 +172,7 @@ std::string vuapi ExtractFileNameA(const std::string& FilePath, bool Extension)
   std::string fileName;
   fileName.clear();
 
-  size_t slashPos = FilePath.rfind('\\');
+  size_t slashPos = FilePath.rfind(PATH_SEP_A);
   if (slashPos != std::string::npos)
   {
     fileName = FilePath.substr(slashPos + 1);
@@ -157,7 +199,7 @@ std::wstring vuapi ExtractFileNameW(const std::wstring& FilePath, bool Extension
   std::wstring fileName;
   fileName.clear();
 
-  size_t slashPos = FilePath.rfind(L'\\');
+  size_t slashPos = FilePath.rfind(PATH_SEP_W);
   if (slashPos != std::string::npos)
   {
     fileName = FilePath.substr(slashPos + 1);
@@ -179,6 +221,8 @@ std::wstring vuapi ExtractFileNameW(const std::wstring& FilePath, bool Extension
   return fileName;
 }
 
+#ifdef _WIN32
+
 std::string vuapi GetCurrentFilePathA()
 {
   std::unique_ptr<char[]> p(new char [MAXPATH]);
@@ -261,6 +305,53 @@ std::wstring vuapi GetCurrentDirectoryW(bool Slash)
   return s;
 }
 
+#else  // POSIX
+
+std::string vuapi GetCurrentFilePathA()
+{
+  char p[MAXPATH] = {0};
+
+  const ssize_t n = readlink("/proc/self/exe", p, sizeof(p) - 1);
+
+  return std::string(p, n > 0 ? size_t(n) : 0);
+}
+
+std::wstring vuapi GetCurrentFilePathW()
+{
+  return FromUTF8(GetCurrentFilePathA());
+}
+
+std::string vuapi GetCurrentDirectoryA(bool Slash)
+{
+  char p[MAXPATH] = {0};
+
+  std::string s(getcwd(p, sizeof(p)) != nullptr ? p : "");
+
+  if (Slash)
+  {
+    if (s.empty() || s.back() != PATH_SEP_A)
+    {
+      s += PATH_SEP_A;
+    }
+  }
+  else
+  {
+    if (s.size() > 1 && s.back() == PATH_SEP_A)
+    {
+      s.pop_back();
+    }
+  }
+
+  return s;
+}
+
+std::wstring vuapi GetCurrentDirectoryW(bool Slash)
+{
+  return FromUTF8(GetCurrentDirectoryA(Slash));
+}
+
+#endif // _WIN32
+
 std::string vuapi GetContainDirectoryA(bool Slash)
 {
   return ExtractFileDirectoryA(GetCurrentFilePathA(), Slash);
@@ -405,50 +496,87 @@ eDiskType GetDiskTypeW(const wchar_t drive)
 
 #endif // VU_WMI_ENABLED
 
-template <class std_string_t, typename char_t>
-std_string_t JoinPathT(
-  const std_string_t& Left,
-  const std_string_t& Right,
-  const char_t Sep
-)
+template <typename T>
+void JoinPathT(CStringBuilderT<T>& Result, const CStringViewT<T>& Right, const T Sep)
 {
-  if (Left.empty())
+  if (Result.Empty())
   {
-    return Right; // "" + "/bar"
+    Result.Append(Right); // "" + "/bar"
   }
-
-  if (Left[Left.size() - 1] == Sep)
+  else if (Result.Back() == Sep)
   {
-    if (Right.find(Sep) == 0)
+    if (!Right.Empty() && Right[0] == Sep)
     {
-      return Left + Right.substr(1); // foo/ + /bar
+      Result.Append(Right.Substr(1)); // foo/ + /bar
     }
     else
     {
-      return Left + Right; // foo/ + bar
+      Result.Append(Right); // foo/ + bar
     }
   }
   else
   {
-    if (Right.find(Sep) == 0)
+    if (!Right.Empty() && Right[0] == Sep)
     {
-      return Left + Right; // foo + /bar
+      Result.Append(Right); // foo + /bar
     }
     else
     {
-      return Left + Sep + Right; // foo + bar
+      Result.Append(Sep).Append(Right); // foo + bar
     }
   }
 }
 
+/**
+ * Replaces the separators in one pass, a double back-slash becomes one separator.
+ */
+template <typename T>
+void NormalizePathT(CStringBuilderT<T>& Result, const CStringViewT<T>& Path, const T Sep)
+{
+  const T* p = Path.Data();
+  const T* e = p + Path.Size();
+
+  while (p < e)
+  {
+    const T* q = p;
+    while (q < e && *q != T('\\') && *q != T('/'))
+    {
+      q++;
+    }
+
+    Result.Append(CStringViewT<T>(p, q - p));
+
+    if (q == e)
+    {
+      break;
+    }
+
+    Result.Append(Sep);
+
+    p = q + (*q == T('\\') && q + 1 < e && q[1] == T('\\') ? 2 : 1);
+  }
+}
+
+void vuapi JoinPathA(CStringBuilderA& Result, const CStringViewA& Right, const ePathSep Separator)
+{
+  JoinPathT<char>(Result, Right, Separator == ePathSep::WIN ? '\\' : '/');
+}
+
+void vuapi JoinPathW(CStringBuilderW& Result, const CStringViewW& Right, const ePathSep Separator)
+{
+  JoinPathT<wchar>(Result, Right, Separator == ePathSep::WIN ? L'\\' : L'/');
+}
+
 std::string vuapi JoinPathA(
   const std::string& Left,
   const std::string& Right,
   const ePathSep Separator
 )
 {
-  const auto Sep = Separator == ePathSep::WIN ? '\\' : '/';
-  return JoinPathT<std::string, char>(Left, Right, Sep);
+  CStringBuilderA result(Left.size() + Right.size() + 1);
+  result.Append(Left);
+  JoinPathA(result, Right, Separator);
+  return result.Detach();
 }
 
 std::wstring vuapi JoinPathW(
@@ -457,38 +585,34 @@ std::wstring vuapi JoinPathW(
   const ePathSep Separator
 )
 {
-  const auto Sep = Separator == ePathSep::WIN ? L'\\' : L'/';
-  return JoinPathT<std::wstring, wchar_t>(Left, Right, Sep);
+  CStringBuilderW result(Left.size() + Right.size() + 1);
+  result.Append(Left);
+  JoinPathW(result, Right, Separator);
+  return result.Detach();
 }
 
-std::string NormalizePathA(const std::string& Path, const ePathSep Separator)
+void vuapi NormalizePathA(CStringBuilderA& Result, const CStringViewA& Path, const ePathSep Separator)
 {
-  auto result = Path;
-
-  const std::string SepWIN = "\\";
-  const std::string SepPOSIX = "/";
-  const std::string Sep = Separator == ePathSep::WIN ? SepWIN : SepPOSIX;
+  NormalizePathT<char>(Result, Path, Separator == ePathSep::WIN ? '\\' : '/');
+}
 
-  result = ReplaceA(result, SepWIN + SepWIN, Sep);
-  result = ReplaceA(result, SepWIN, Sep);
-  result = ReplaceA(result, SepPOSIX, Sep);
+void vuapi NormalizePathW(CStringBuilderW& Result, const CStringViewW& Path, const ePathSep Separator)
+{
+  NormalizePathT<wchar>(Result, Path, Separator == ePathSep::WIN ? L'\\' : L'/');
+}
 
-  return result;
+std::string NormalizePathA(const std::string& Path, const ePathSep Separator)
+{
+  CStringBuilderA result(Path.size());
+  NormalizePathA(result, Path, Separator);
+  return result.Detach();
 }
 
 std::wstring NormalizePathW(const std::wstring& Path, const ePathSep Separator)
 {
-  auto result = Path;
-
-  const std::wstring SepWIN = L"\\";
-  const std::wstring SepPOSIX = L"/";
-  const std::wstring Sep = Separator == ePathSep::WIN ? SepWIN : SepPOSIX;
-
-  result = ReplaceW(result, SepWIN + SepWIN, Sep);
-  result = ReplaceW(result, SepWIN, Sep);
-  result = ReplaceW(result, SepPOSIX, Sep);
-
-  return result;
+  CStringBuilderW result(Path.size());
+  NormalizePathW(result, Path, Separator);
+  return result.Detach();
 }
 
 /**
@@ -559,7 +683,7 @@ bool CPathA::operator==(const CPathA& right)
   {
     if (m_Sep == ePathSep::WIN)
     {
-      result &= LowerStringA(m_Path) == LowerStringA(right.m_Path);
+      result &= EqualsIgnoreCaseA(m_Path, right.m_Path);
     }
     else if (m_Sep == ePathSep::POSIX)
     {
@@ -577,19 +701,30 @@ bool CPathA::operator!=(const CPathA& right)
 
 vu::CPathA& CPathA::Trim(const eTrimType TrimType)
 {
-  m_Path = TrimStringA(m_Path, TrimType);
+  CStringBuilderA path(m_Path.size());
+  TrimStringA(path, m_Path, TrimType);
+  m_Path = path.Detach();
   return *this;
 }
 
 vu::CPathA& CPathA::Normalize()
 {
-  m_Path = NormalizePathA(m_Path, m_Sep);
+  CStringBuilderA path(m_Path.size());
+  NormalizePathA(path, m_Path, m_Sep);
+  m_Path = path.Detach();
   return *this;
 }
 
 vu::CPathA& CPathA::Join(const std::string& Path)
 {
-  m_Path = JoinPathA(m_Path, Path, m_Sep);
+  if (&Path == &m_Path) // e.g. path += path
+  {
+    return this->Join(std::string(Path));
+  }
+
+  CStringBuilderA path(std::move(m_Path));
+  JoinPathA(path, Path, m_Sep);
+  m_Path = path.Detach();
   return *this;
 }
 
@@ -700,7 +835,7 @@ bool CPathW::operator==(const CPathW& right)
   {
     if (m_Sep == ePathSep::WIN)
     {
-      result &= LowerStringW(m_Path) == LowerStringW(right.m_Path);
+      result &= EqualsIgnoreCaseW(m_Path, right.m_Path);
     }
     else if (m_Sep == ePathSep::POSIX)
     {
@@ -718,19 +853,30 @@ bool CPathW::operator!=(const CPathW& right)
 
 vu::CPathW& CPathW::Trim(const eTrimType TrimType)
 {
-  m_Path = TrimStringW(m_Path, TrimType);
+  CStringBuilderW path(m_Path.size());
+  TrimStringW(path, m_Path, TrimType);
+  m_Path = path.Detach();
   return *this;
 }
 
 vu::CPathW& CPathW::Normalize()
 {
-  m_Path = NormalizePathW(m_Path, m_Sep);
+  CStringBuilderW path(m_Path.size());
+  NormalizePathW(path, m_Path, m_Sep);
+  m_Path = path.Detach();
   return *this;
 }
 
 vu::CPathW& CPathW::Join(const std::wstring& Path)
 {
-  m_Path = JoinPathW(m_Path, Path, m_Sep);
+  if (&Path == &m_Path) // e.g. path += path
+  {
+    return this->Join(std::wstring(Path));
+  }
+
+  CStringBuilderW path(std::move(m_Path));
+  JoinPathW(path, Path, m_Sep);
+  m_Path = path.Detach();
   return *this;
 }
 
@@ -7,6 +7,7 @@
 #include "Vutils.h"
 
 #include <cassert>
+#include <algorithm>
 
 namespace vu
 {
@@ -69,6 +70,35 @@ bool vuapi CFileSystemX::Read(void* Buffer, ulong ulSize)
   return true;
 }
 
+bool vuapi CFileSystemX::Read(CChainBuffer& data, ulong ulSize)
+{
+  ulong total = 0;
+
+  while (total < ulSize)
+  {
+    size_t size = 0;
+    auto ptr = data.Prepare(size);
+
+    ulong n = ulong(std::min(size_t(ulSize - total), size));
+    if (!this->Read(ptr, n))
+    {
+      return false;
+    }
+
+    data.Commit(m_ReadSize);
+    total += m_ReadSize;
+
+    if (m_ReadSize < n)
+    {
+      break; // The end of the file
+    }
+  }
+
+  m_ReadSize = total;
+
+  return true;
+}
+
 bool vuapi CFileSystemX::Write(
   ulong ulOffset,
   const void* cBuffer,
@@ -100,6 +130,25 @@ bool vuapi CFileSystemX::Write(const void* cBuffer, ulong ulSize)
   return true;
 }
 
+bool vuapi CFileSystemX::Write(const CChainBuffer& data)
+{
+  ulong total = 0;
+
+  for (const auto& block : data.GetBlocks())
+  {
+    if (!this->Write(block.Address, ulong(block.Size)))
+    {
+      return false;
+    }
+
+    total += m_WroteSize;
+  }
+
+  m_WroteSize = total;
+
+  return true;
+}
+
 bool vuapi CFileSystemX::Seek(ulong ulOffset, eMoveMethodFlags mmFlag)
 {
   if (!this->Valid(m_FileHandle))
@@ -128,6 +177,16 @@ ulong vuapi CFileSystemX::GetFileSize()
   return result;
 }
 
+ulong vuapi CFileSystemX::GetReadSize() const
+{
+  return m_ReadSize;
+}
+
+ulong vuapi CFileSystemX::GetWroteSize() const
+{
+  return m_WroteSize;
+}
+
 bool vuapi CFileSystemX::IOControl(
   ulong ulControlCode,
   void* lpSendBuffer,
@@ -171,14 +230,14 @@ bool vuapi CFileSystemX::Close()
   return true;
 }
 
-const CBuffer vuapi CFileSystemX::ReadAsBuffer()
+CBuffer vuapi CFileSystemX::ReadAsBuffer()
 {
   CBuffer pContent(0);
 
   auto size = this->GetFileSize();
   if (size == 0) return pContent;
 
-  pContent.Resize(size);
+  pContent.Resize(size, false); // Overwritten by the file content
 
   this->Read(0, pContent.GetpData(), size, eMoveMethodFlags::MM_BEGIN);
 
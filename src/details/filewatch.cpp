@@ -0,0 +1,242 @@
+/**
+ * @file   filewatch.cpp
+ * @author Vic P.
+ * @brief  Implementation for File Watcher
+ */
+
+#include "Vutils.h"
+
+#ifndef _WIN32
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#endif // _WIN32
+
+namespace vu
+{
+
+static const int WATCH_POLL_INTERVAL = 100; // In milliseconds, the watcher checks for Stop() by it
+
+template <typename T>
+static void SplitFilePath(const std::basic_string<T>& FilePath, std::basic_string<T>& Directory, std::basic_string<T>& Name)
+{
+  const T seps[] = { T('\\'), T('/'), T(0) };
+
+  const size_t pos = FilePath.find_last_of(seps);
+  if (pos == std::basic_string<T>::npos)
+  {
+    Directory.assign(1, T('.'));
+    Name = FilePath;
+  }
+  else
+  {
+    Directory = FilePath.substr(0, pos == 0 ? 1 : pos);
+    Name = FilePath.substr(pos + 1);
+  }
+}
+
+CFileWatcher::CFileWatcher()
+{
+}
+
+CFileWatcher::~CFileWatcher()
+{
+  this->Stop();
+
+  if (m_Thread.joinable())
+  {
+    m_Thread.detach(); // Destroyed by its callback, the thread is stopped and it ends after the callback
+  }
+
+  if (m_Retired.joinable())
+  {
+    m_Retired.detach();
+  }
+}
+
+/**
+ * A thread can not join itself, the thread that is stopped by its callback is joined later.
+ */
+static void JoinThread(std::thread& thread)
+{
+  if (thread.joinable() && thread.get_id() != std::this_thread::get_id())
+  {
+    thread.join();
+  }
+}
+
+#ifdef _WIN32
+
+static bool GetFileStamp(const std::wstring& FilePath, WIN32_FILE_ATTRIBUTE_DATA& stamp)
+{
+  ZeroMemory(&stamp, sizeof(stamp));
+  return GetFileAttributesExW(FilePath.c_str(), GetFileExInfoStandard, &stamp) != FALSE;
+}
+
+bool CFileWatcher::Start(const std::string& FilePath, const FnChanged& fnChanged)
+{
+  return this->Start(ToStringW(FilePath), fnChanged);
+}
+
+/**
+ * The notifications are for the whole directory, the file is changed if its time or its size is changed.
+ */
+bool CFileWatcher::Start(const std::wstring& FilePath, const FnChanged& fnChanged)
+{
+  this->Stop();
+
+  std::wstring directory, name;
+  SplitFilePath(FilePath, directory, name);
+
+  const DWORD filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE;
+
+  HANDLE hChange = FindFirstChangeNotificationW(directory.c_str(), FALSE, filter);
+  if (hChange == INVALID_HANDLE_VALUE)
+  {
+    return false;
+  }
+
+  this->Reset();
+
+  const auto pStop = m_pStop;
+
+  m_Thread = std::thread([pStop, hChange, FilePath, fnChanged]()
+  {
+    WIN32_FILE_ATTRIBUTE_DATA last;
+    GetFileStamp(FilePath, last);
+
+    while (!*pStop)
+    {
+      if (WaitForSingleObject(hChange, WATCH_POLL_INTERVAL) != WAIT_OBJECT_0)
+      {
+        continue;
+      }
+
+      WIN32_FILE_ATTRIBUTE_DATA stamp;
+      GetFileStamp(FilePath, stamp);
+
+      if (CompareFileTime(&stamp.ftLastWriteTime, &last.ftLastWriteTime) != 0 ||
+        stamp.nFileSizeLow != last.nFileSizeLow || stamp.nFileSizeHigh != last.nFileSizeHigh)
+      {
+        last = stamp;
+        fnChanged();
+      }
+
+      if (!FindNextChangeNotification(hChange))
+      {
+        break;
+      }
+    }
+
+    FindCloseChangeNotification(hChange);
+  });
+
+  return true;
+}
+
+#else // POSIX
+
+bool CFileWatcher::Start(const std::wstring& FilePath, const FnChanged& fnChanged)
+{
+  return this->Start(ToUTF8(FilePath), fnChanged);
+}
+
+/**
+ * A file that is saved in place is closed after writing, a file that is saved atomically is moved to.
+ */
+bool CFileWatcher::Start(const std::string& FilePath, const FnChanged& fnChanged)
+{
+  this->Stop();
+
+  std::string directory, name;
+  SplitFilePath(FilePath, directory, name);
+
+  const int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (fd < 0)
+  {
+    return false;
+  }
+
+  if (inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE) < 0)
+  {
+    close(fd);
+    return false;
+  }
+
+  this->Reset();
+
+  const auto pStop = m_pStop;
+
+  m_Thread = std::thread([pStop, fd, name, fnChanged]()
+  {
+    union
+    {
+      inotify_event event;
+      char data[4 * KB];
+    } buffer;
+
+    while (!*pStop)
+    {
+      pollfd p = { fd, POLLIN, 0 };
+      if (poll(&p, 1, WATCH_POLL_INTERVAL) <= 0)
+      {
+        continue;
+      }
+
+      bool changed = false;
+
+      for (ssize_t n = 0; (n = read(fd, buffer.data, sizeof(buffer))) > 0;)
+      {
+        for (ssize_t i = 0; i < n;)
+        {
+          const auto e = reinterpret_cast<const inotify_event*>(buffer.data + i);
+          changed |= e->len != 0 && name == e->name;
+          i += sizeof(inotify_event) + e->len;
+        }
+      }
+
+      if (changed)
+      {
+        fnChanged();
+      }
+    }
+
+    close(fd);
+  });
+
+  return true;
+}
+
+#endif // _WIN32
+
+void CFileWatcher::Stop()
+{
+  if (m_pStop != nullptr)
+  {
+    *m_pStop = true;
+  }
+
+  JoinThread(m_Thread);
+  JoinThread(m_Retired);
+}
+
+/**
+ * A new thread gets a new flag. The thread that is started again by its callback ends by its own
+ * flag after the callback, it is kept to be joined by the next Stop().
+ */
+void CFileWatcher::Reset()
+{
+  if (m_Thread.joinable())
+  {
+    m_Retired = std::move(m_Thread);
+  }
+
+  m_pStop = std::make_shared<std::atomic<bool>>(false);
+}
+
+bool CFileWatcher::IsWatching() const
+{
+  return m_pStop != nullptr && !*m_pStop;
+}
+
+} // namespace vu
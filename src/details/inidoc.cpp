@@ -0,0 +1,805 @@
+/**
+ * @file   inidoc.cpp
+ * @author Vic P.
+ * @brief  Implementation for INI Document
+ */
+
+#include "Vutils.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else  // POSIX
+#include <unistd.h>
+#endif // _WIN32
+
+namespace vu
+{
+
+static const char UTF8_BOM[] = { char(0xEF), char(0xBB), char(0xBF) };
+
+static bool IsBlank(const char c)
+{
+  return c == ' ' || c == '\t';
+}
+
+static CStringViewA TrimBlanks(const CStringViewA& s)
+{
+  const char* b = s.Data();
+  const char* e = b + s.Size();
+
+  while (b < e && IsBlank(*b))
+  {
+    b++;
+  }
+
+  while (e > b && IsBlank(e[-1]))
+  {
+    e--;
+  }
+
+  return CStringViewA(b, e - b);
+}
+
+static char LowerASCII(const char c)
+{
+  return c >= 'A' && c <= 'Z' ? char(c + ('a' - 'A')) : c;
+}
+
+/**
+ * The files are read and written by the C run-time so the document does not depend on Win32.
+ */
+
+static FILE* OpenStream(const std::string& FilePath, const char* mode)
+{
+  return fopen(FilePath.c_str(), mode);
+}
+
+static FILE* OpenStream(const std::wstring& FilePath, const char* mode)
+{
+  #ifdef _WIN32
+  return _wfopen(FilePath.c_str(), ToStringW(mode).c_str());
+  #else
+  return fopen(ToUTF8(FilePath).c_str(), mode);
+  #endif
+}
+
+static bool ReadFileData(FILE* pFile, std::vector<char>& data)
+{
+  char block[16 * KB];
+
+  for (size_t n = 0; (n = fread(block, 1, sizeof(block), pFile)) != 0;)
+  {
+    data.insert(data.end(), block, block + n);
+  }
+
+  return ferror(pFile) == 0;
+}
+
+size_t CINIDocument::THash::operator()(const view_t& name) const
+{
+  size_t hash = size_t(2166136261U); // FNV-1a
+
+  for (const auto c : name)
+  {
+    hash = (hash ^ byte(LowerASCII(c))) * size_t(16777619U);
+  }
+
+  return hash;
+}
+
+bool CINIDocument::TEqual::operator()(const view_t& left, const view_t& right) const
+{
+  return EqualsIgnoreCaseA(left, right);
+}
+
+CINIDocument::CINIDocument() : m_Form(UF_UTF8), m_BOM(false), m_ANSI(true), m_Modified(false)
+{
+  this->Clear();
+}
+
+CINIDocument::CINIDocument(const CINIDocument& right)
+  : m_Storage(right.m_Storage)
+  , m_Sections(right.m_Sections)
+  , m_Index(right.m_Index)
+  , m_LineBreak(right.m_LineBreak)
+  , m_Form(right.m_Form)
+  , m_BOM(right.m_BOM)
+  , m_ANSI(right.m_ANSI)
+  , m_Modified(right.m_Modified)
+{
+}
+
+CINIDocument& CINIDocument::operator=(const CINIDocument& right)
+{
+  m_Storage   = right.m_Storage;
+  m_Sections  = right.m_Sections;
+  m_Index     = right.m_Index;
+  m_LineBreak = right.m_LineBreak;
+  m_Form      = right.m_Form;
+  m_BOM       = right.m_BOM;
+  m_ANSI      = right.m_ANSI;
+  m_Modified  = right.m_Modified;
+
+  return *this;
+}
+
+CINIDocument::~CINIDocument()
+{
+}
+
+void CINIDocument::Clear()
+{
+  m_Storage = std::make_shared<TStorage>(); // The copies keep the old one
+  m_Sections.clear();
+  m_Index.clear();
+  m_LineBreak = "\r\n";
+  m_Form = UF_UTF8;
+  m_BOM = false;
+  m_ANSI = true;
+  m_Modified = false;
+
+  m_Sections.push_back(std::make_shared<TSection>()); // The keys before the first section
+  m_Sections.back()->End = 0;
+}
+
+void CINIDocument::Parse(const void* pData, const size_t size)
+{
+  this->Clear();
+
+  const auto p = static_cast<const byte*>(pData);
+
+  std::string& loaded = m_Storage->Text;
+
+  if (size >= 2 && ((p[0] == 0xFF && p[1] == 0xFE) || (p[0] == 0xFE && p[1] == 0xFF)))
+  {
+    m_Form = p[0] == 0xFF ? UF_UTF16LE : UF_UTF16BE;
+    m_BOM = true;
+    m_ANSI = false;
+
+    const auto result = GetTranscodedSize(p + 2, size - 2, m_Form, UF_UTF8, true);
+    loaded.resize(result.Written);
+    if (!loaded.empty())
+    {
+      Transcode(p + 2, size - 2, m_Form, &loaded[0], loaded.size(), UF_UTF8, true);
+    }
+  }
+  else if (size >= 3 && memcmp(p, UTF8_BOM, sizeof(UTF8_BOM)) == 0)
+  {
+    m_BOM = true;
+    m_ANSI = false;
+    loaded.assign(reinterpret_cast<const char*>(p) + 3, size - 3);
+  }
+  else if (size != 0)
+  {
+    // It is UTF-8 if it is well-formed and has a character that is not ASCII (one code point per byte)
+
+    const auto result = GetTranscodedSize(p, size, UF_UTF8, UF_UTF32LE);
+    m_ANSI = result.Status != TC_OK || result.Written == 4 * size;
+
+    loaded.assign(reinterpret_cast<const char*>(p), size);
+  }
+
+  const view_t text(loaded);
+
+  const size_t crlf = text.Find("\r\n");
+  const size_t lf = text.Find('\n');
+  if (lf != view_t::npos)
+  {
+    m_LineBreak = crlf != view_t::npos && crlf + 1 == lf ? "\r\n" : "\n";
+  }
+
+  for (size_t pos = 0; pos < text.Size();)
+  {
+    size_t end = text.Find('\n', pos);
+    end = end == view_t::npos ? text.Size() : end + 1;
+
+    size_t content = end;
+    if (content > pos && text[content - 1] == '\n')
+    {
+      content--;
+    }
+
+    if (content > pos && text[content - 1] == '\r')
+    {
+      content--;
+    }
+
+    this->ParseLine(text.Substr(pos, content - pos), text.Substr(content, end - content));
+
+    pos = end;
+  }
+}
+
+/**
+ * A line is a section header ([name]), a key (key = value) or else it is kept as it is.
+ * The value is trimmed and its matching quotes are removed, as the profile API does.
+ */
+void CINIDocument::ParseLine(const view_t& line, const view_t& lineBreak)
+{
+  const view_t whole(line.Data(), line.Size() + lineBreak.Size());
+  const view_t trimmed = TrimBlanks(line);
+
+  TEntry entry;
+  entry.Head = whole;
+
+  if (!trimmed.Empty() && trimmed[0] == '[')
+  {
+    const size_t close = trimmed.Find(']');
+    if (close != view_t::npos)
+    {
+      TSection section;
+      section.Name = TrimBlanks(trimmed.Substr(1, close - 1));
+      section.Header = entry;
+      section.End = 0;
+
+      m_Index.insert(std::make_pair(section.Name, m_Sections.size())); // The first one wins
+      m_Sections.push_back(std::make_shared<TSection>(section));
+      return;
+    }
+  }
+
+  auto& section = *m_Sections.back();
+
+  const size_t equal = trimmed.Empty() || trimmed[0] == ';' || trimmed[0] == '#' ? view_t::npos : line.Find('=');
+  const view_t key = equal != view_t::npos ? TrimBlanks(line.Substr(0, equal)) : view_t();
+
+  if (!key.Empty())
+  {
+    size_t b = equal + 1, e = line.Size();
+
+    while (b < e && IsBlank(line[b]))
+    {
+      b++;
+    }
+
+    while (e > b && IsBlank(line[e - 1]))
+    {
+      e--;
+    }
+
+    if (e - b >= 2 && (line[b] == '"' || line[b] == '\'') && line[e - 1] == line[b])
+    {
+      b++;
+      e--;
+    }
+
+    entry.Head  = line.Substr(0, b);
+    entry.Key   = key;
+    entry.Value = view_t(line.Data() + b, e - b);
+    entry.Tail  = view_t(line.Data() + e, whole.Size() - e);
+
+    section.Keys.insert(std::make_pair(key, section.Entries.size())); // The first one wins
+    section.End = section.Entries.size() + 1;
+  }
+
+  section.Entries.push_back(entry);
+}
+
+bool CINIDocument::Load(const std::string& FilePath)
+{
+  this->Clear();
+
+  FILE* pFile = OpenStream(FilePath, "rb");
+  if (pFile == nullptr)
+  {
+    return false;
+  }
+
+  std::vector<char> data;
+  const bool result = ReadFileData(pFile, data);
+  fclose(pFile);
+
+  this->Parse(data.data(), data.size());
+
+  return result;
+}
+
+bool CINIDocument::Load(const std::wstring& FilePath)
+{
+  this->Clear();
+
+  FILE* pFile = OpenStream(FilePath, "rb");
+  if (pFile == nullptr)
+  {
+    return false;
+  }
+
+  std::vector<char> data;
+  const bool result = ReadFileData(pFile, data);
+  fclose(pFile);
+
+  this->Parse(data.data(), data.size());
+
+  return result;
+}
+
+static bool SyncFile(FILE* pFile)
+{
+  if (fflush(pFile) != 0)
+  {
+    return false;
+  }
+
+  #ifdef _WIN32
+  return _commit(_fileno(pFile)) == 0;
+  #else  // POSIX
+  return fsync(fileno(pFile)) == 0;
+  #endif // _WIN32
+}
+
+/**
+ * The temporary file is created next to the file by a unique name (the process and a counter), so
+ * the saves of the threads and of the processes never write to the same temporary file.
+ * It gets the mode of the file on POSIX since the rename replaces the file by it, on Windows the
+ * replacing keeps the security descriptor of the file.
+ */
+
+static std::atomic<ulong> g_TempCounter(0);
+
+static ulong GetProcessID()
+{
+  #ifdef _WIN32
+  return ulong(GetCurrentProcessId());
+  #else  // POSIX
+  return ulong(getpid());
+  #endif // _WIN32
+}
+
+static FILE* CreateTempFile(const std::string& FilePath, std::string& TempPath)
+{
+  for (int retries = 0; retries < 16; retries++) // A stale file of a process that had the same id
+  {
+    TempPath = FilePath + FormatA(".%lu.%lu.tmp", GetProcessID(), ulong(++g_TempCounter));
+
+    #ifdef _WIN32
+    const int fd = _open(TempPath.c_str(), _O_CREAT | _O_EXCL | _O_WRONLY | _O_BINARY, _S_IREAD | _S_IWRITE);
+    #else  // POSIX
+    const int fd = open(TempPath.c_str(), O_CREAT | O_EXCL | O_WRONLY, 0666);
+    #endif // _WIN32
+
+    if (fd < 0)
+    {
+      if (errno == EEXIST)
+      {
+        continue;
+      }
+
+      return nullptr;
+    }
+
+    #ifndef _WIN32
+    struct stat st;
+    if (stat(FilePath.c_str(), &st) == 0)
+    {
+      fchmod(fd, st.st_mode & 07777);
+    }
+    #endif // _WIN32
+
+    #ifdef _WIN32
+    FILE* pFile = _fdopen(fd, "wb");
+    #else  // POSIX
+    FILE* pFile = fdopen(fd, "wb");
+    #endif // _WIN32
+
+    if (pFile == nullptr)
+    {
+      #ifdef _WIN32
+      _close(fd);
+      _unlink(TempPath.c_str());
+      #else  // POSIX
+      close(fd);
+      unlink(TempPath.c_str());
+      #endif // _WIN32
+    }
+
+    return pFile;
+  }
+
+  return nullptr;
+}
+
+static FILE* CreateTempFile(const std::wstring& FilePath, std::wstring& TempPath)
+{
+  #ifdef _WIN32
+  for (int retries = 0; retries < 16; retries++) // A stale file of a process that had the same id
+  {
+    TempPath = FilePath + FormatW(L".%lu.%lu.tmp", GetProcessID(), ulong(++g_TempCounter));
+
+    const int fd = _wopen(TempPath.c_str(), _O_CREAT | _O_EXCL | _O_WRONLY | _O_BINARY, _S_IREAD | _S_IWRITE);
+    if (fd < 0)
+    {
+      if (errno == EEXIST)
+      {
+        continue;
+      }
+
+      return nullptr;
+    }
+
+    FILE* pFile = _fdopen(fd, "wb");
+    if (pFile == nullptr)
+    {
+      _close(fd);
+      _wunlink(TempPath.c_str());
+    }
+
+    return pFile;
+  }
+
+  return nullptr;
+  #else  // POSIX
+  std::string temp;
+  FILE* pFile = CreateTempFile(ToUTF8(FilePath), temp);
+  TempPath = FromUTF8(temp);
+  return pFile;
+  #endif // _WIN32
+}
+
+static bool RenameFile(const std::string& From, const std::string& To)
+{
+  #ifdef _WIN32
+  if (ReplaceFileA(To.c_str(), From.c_str(), nullptr, REPLACEFILE_IGNORE_MERGE_ERRORS, nullptr, nullptr))
+  {
+    return true;
+  }
+
+  if (GetLastError() != ERROR_FILE_NOT_FOUND) // The file is new
+  {
+    return false;
+  }
+
+  return MoveFileExA(From.c_str(), To.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != FALSE;
+  #else  // POSIX
+  if (rename(From.c_str(), To.c_str()) != 0)
+  {
+    return false;
+  }
+
+  // The rename is durable when the directory is synced also
+
+  const size_t slash = To.find_last_of('/');
+  const int dir = open(slash == std::string::npos ? "." : To.substr(0, slash + 1).c_str(), O_RDONLY);
+  if (dir >= 0)
+  {
+    fsync(dir);
+    close(dir);
+  }
+
+  return true;
+  #endif // _WIN32
+}
+
+static bool RenameFile(const std::wstring& From, const std::wstring& To)
+{
+  #ifdef _WIN32
+  if (ReplaceFileW(To.c_str(), From.c_str(), nullptr, REPLACEFILE_IGNORE_MERGE_ERRORS, nullptr, nullptr))
+  {
+    return true;
+  }
+
+  if (GetLastError() != ERROR_FILE_NOT_FOUND) // The file is new
+  {
+    return false;
+  }
+
+  return MoveFileExW(From.c_str(), To.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != FALSE;
+  #else  // POSIX
+  return RenameFile(ToUTF8(From), ToUTF8(To));
+  #endif // _WIN32
+}
+
+static int RemoveFile(const std::string& FilePath)
+{
+  return remove(FilePath.c_str());
+}
+
+static int RemoveFile(const std::wstring& FilePath)
+{
+  #ifdef _WIN32
+  return _wremove(FilePath.c_str());
+  #else  // POSIX
+  return remove(ToUTF8(FilePath).c_str());
+  #endif // _WIN32
+}
+
+/**
+ * Writes the whole file to a temporary file next to it, syncs it, then renames it over the file.
+ * So a crash or a failed write leaves the old file or the new file, never a part of the new file.
+ */
+template <typename T>
+static bool SaveFileAtomic(const std::basic_string<T>& FilePath, const CBuffer& data)
+{
+  std::basic_string<T> temp;
+
+  FILE* pFile = CreateTempFile(FilePath, temp);
+  if (pFile == nullptr)
+  {
+    return false;
+  }
+
+  bool result = data.GetSize() == 0 || fwrite(data.GetpData(), data.GetSize(), 1, pFile) == 1;
+  result &= SyncFile(pFile);
+  result &= fclose(pFile) == 0;
+  result = result && RenameFile(temp, FilePath);
+
+  if (!result)
+  {
+    RemoveFile(temp);
+  }
+
+  return result;
+}
+
+bool CINIDocument::Save(const std::string& FilePath) const
+{
+  CBuffer data;
+  this->Serialize(data);
+  return SaveFileAtomic(FilePath, data);
+}
+
+bool CINIDocument::Save(const std::wstring& FilePath) const
+{
+  CBuffer data;
+  this->Serialize(data);
+  return SaveFileAtomic(FilePath, data);
+}
+
+void CINIDocument::Serialize(std::string& Text) const
+{
+  CStringBuilderA result(m_Storage->Text.size() + m_Storage->Text.size() / 8);
+
+  for (const auto& section : m_Sections)
+  {
+    result << section->Header.Head << section->Header.Tail;
+
+    for (const auto& entry : section->Entries)
+    {
+      result << entry.Head << entry.Value << entry.Tail;
+    }
+  }
+
+  Text = result.Detach();
+}
+
+void CINIDocument::Serialize(CBuffer& Data) const
+{
+  std::string text;
+  this->Serialize(text);
+
+  Data.Resize(0);
+
+  if (m_Form == UF_UTF8)
+  {
+    if (m_BOM)
+    {
+      Data.Append(UTF8_BOM, sizeof(UTF8_BOM));
+    }
+
+    Data.Append(text.data(), text.size());
+    return;
+  }
+
+  const byte bom[] = { 0xFF, 0xFE };
+  const byte bomBE[] = { 0xFE, 0xFF };
+  Data.Append(m_Form == UF_UTF16LE ? bom : bomBE, 2);
+
+  const size_t size = GetTranscodedSize(text.data(), text.size(), UF_UTF8, m_Form, true).Written;
+  Data.Resize(2 + size, false);
+  Transcode(text.data(), text.size(), UF_UTF8, static_cast<byte*>(Data.GetpData()) + 2, size, m_Form, true);
+}
+
+const CINIDocument::TSection* CINIDocument::FindSection(const view_t& Section) const
+{
+  const auto it = m_Index.find(Section);
+  return it != m_Index.cend() ? m_Sections[it->second].get() : nullptr;
+}
+
+bool CINIDocument::HasSection(const view_t& Section) const
+{
+  return this->FindSection(Section) != nullptr;
+}
+
+bool CINIDocument::Read(const view_t& Section, const view_t& Key, view_t& Value) const
+{
+  const auto pSection = this->FindSection(Section);
+  if (pSection == nullptr)
+  {
+    return false;
+  }
+
+  const auto it = pSection->Keys.find(Key);
+  if (it == pSection->Keys.cend())
+  {
+    return false;
+  }
+
+  Value = pSection->Entries[it->second].Value;
+
+  return true;
+}
+
+std::vector<CINIDocument::view_t> CINIDocument::GetSectionNames() const
+{
+  std::vector<view_t> result;
+
+  for (size_t i = 1; i < m_Sections.size(); i++)
+  {
+    if (m_Index.find(m_Sections[i]->Name)->second == i) // The duplicated sections are hidden
+    {
+      result.push_back(m_Sections[i]->Name);
+    }
+  }
+
+  return result;
+}
+
+std::vector<CINIDocument::TKeyValue> CINIDocument::GetSection(const view_t& Section) const
+{
+  std::vector<TKeyValue> result;
+
+  const auto pSection = this->FindSection(Section);
+  if (pSection != nullptr)
+  {
+    for (const auto& entry : pSection->Entries)
+    {
+      if (!entry.Key.Empty())
+      {
+        result.push_back(TKeyValue(entry.Key, entry.Value));
+      }
+    }
+  }
+
+  return result;
+}
+
+void CINIDocument::Iterate(const FnEntry& fnEntry) const
+{
+  for (size_t i = 1; i < m_Sections.size(); i++)
+  {
+    const auto& section = *m_Sections[i];
+
+    if (m_Index.find(section.Name)->second != i)
+    {
+      continue; // The duplicated sections are not read
+    }
+
+    for (const auto& entry : section.Entries)
+    {
+      if (!entry.Key.Empty())
+      {
+        fnEntry(section.Name, entry.Key, entry.Value);
+      }
+    }
+  }
+}
+
+/**
+ * The line that is followed by a new line must end by a line break (the last line of a file may not).
+ */
+void CINIDocument::EnsureLineBreak(TEntry& entry)
+{
+  const view_t& last = !entry.Tail.Empty() ? entry.Tail : !entry.Value.Empty() ? entry.Value : entry.Head;
+  if (last.Empty() || last[last.Size() - 1] != '\n')
+  {
+    CStringBuilderA tail(entry.Tail.Size() + m_LineBreak.Size());
+    tail << entry.Tail << m_LineBreak;
+    entry.Tail = this->Store(tail.View());
+  }
+}
+
+CINIDocument::view_t CINIDocument::Store(const view_t& s)
+{
+  std::lock_guard<std::mutex> lock(m_Storage->Mutex);
+  return m_Storage->Arena.Store(s);
+}
+
+/**
+ * A section that is shared with a copy is copied before it is written, the copy keeps reading the old one.
+ */
+CINIDocument::TSection& CINIDocument::MutableSection(const size_t index)
+{
+  auto& section = m_Sections[index];
+  if (section.use_count() != 1)
+  {
+    section = std::make_shared<TSection>(*section);
+  }
+
+  return *section;
+}
+
+bool CINIDocument::Write(const view_t& Section, const view_t& Key, const view_t& Value)
+{
+  const view_t section = TrimBlanks(Section);
+  const view_t key = TrimBlanks(Key);
+
+  if (section.Empty() || key.Empty())
+  {
+    return false;
+  }
+
+  m_Modified = true;
+
+  auto it = m_Index.find(section);
+  if (it == m_Index.end())
+  {
+    // The previous line is the last line of the last section
+
+    auto& last = this->MutableSection(m_Sections.size() - 1);
+    if (!last.Entries.empty())
+    {
+      this->EnsureLineBreak(last.Entries.back());
+    }
+    else if (!last.Header.Head.Empty())
+    {
+      this->EnsureLineBreak(last.Header);
+    }
+
+    CStringBuilderA header(section.Size() + 4);
+    header << '[' << section << ']' << m_LineBreak;
+
+    TSection s;
+    s.Header.Head = this->Store(header.View());
+    s.Name = s.Header.Head.Substr(1, section.Size());
+    s.End = 0;
+
+    it = m_Index.insert(std::make_pair(s.Name, m_Sections.size())).first;
+    m_Sections.push_back(std::make_shared<TSection>(s));
+  }
+
+  auto& s = this->MutableSection(it->second);
+
+  const auto k = s.Keys.find(key);
+  if (k != s.Keys.end())
+  {
+    s.Entries[k->second].Value = this->Store(Value);
+    return true;
+  }
+
+  if (s.End != 0)
+  {
+    this->EnsureLineBreak(s.Entries[s.End - 1]);
+  }
+  else if (!s.Header.Head.Empty())
+  {
+    this->EnsureLineBreak(s.Header);
+  }
+
+  CStringBuilderA line(key.Size() + Value.Size() + 3);
+  line << key << '=' << Value << m_LineBreak;
+
+  const view_t text = this->Store(line.View());
+
+  TEntry entry;
+  entry.Head  = text.Substr(0, key.Size() + 1);
+  entry.Key   = text.Substr(0, key.Size());
+  entry.Value = text.Substr(key.Size() + 1, Value.Size());
+  entry.Tail  = text.Substr(key.Size() + 1 + Value.Size());
+
+  // Only the lines that are not keys follow the last key, so the indexes of the keys do not move
+
+  s.Entries.insert(s.Entries.begin() + s.End, entry);
+  s.Keys.insert(std::make_pair(entry.Key, s.End));
+  s.End++;
+
+  return true;
+}
+
+bool CINIDocument::IsModified() const
+{
+  return m_Modified;
+}
+
+eUnicodeForm CINIDocument::GetForm() const
+{
+  return m_Form;
+}
+
+bool CINIDocument::IsANSI() const
+{
+  return m_ANSI;
+}
+
+} // namespace vu
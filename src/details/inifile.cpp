@@ -10,13 +10,322 @@
 namespace vu
 {
 
-CINIFileA::CINIFileA() : CLastError()
+/**
+ * The values are read as the profile API reads them.
+ */
+
+static int ReadProfileInteger(const CStringViewA& Value, const int Default)
+{
+  const char* s = Value.Data();
+  const char* e = s + Value.Size();
+
+  if (s == e)
+  {
+    return Default;
+  }
+
+  bool negative = false;
+  if (*s == '-' || *s == '+')
+  {
+    negative = *s++ == '-';
+  }
+
+  uint base = 10;
+  if (e - s >= 2 && s[0] == '0' && (s[1] == 'x' || s[1] == 'X'))
+  {
+    base = 16;
+    s += 2;
+  }
+
+  uint result = 0;
+
+  for (; s < e; s++) // Stops at the first character that is not a digit
+  {
+    const char c = *s;
+    const uint d = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 : c >= 'A' && c <= 'F' ? c - 'A' + 10 : 16;
+    if (d >= base)
+    {
+      break;
+    }
+
+    result = result * base + d;
+  }
+
+  return negative ? -int(result) : int(result);
+}
+
+/**
+ * The structs are in the format of the profile API, the hexadecimal digits of the bytes and then of their checksum.
+ */
+
+static std::string StructToProfileString(const void* pStruct, const ulong ulSize)
+{
+  byte checksum = 0;
+  for (ulong i = 0; i < ulSize; i++)
+  {
+    checksum += static_cast<const byte*>(pStruct)[i];
+  }
+
+  return ToHexStringA(pStruct, ulSize) + ToHexStringA(&checksum, 1);
+}
+
+static std::unique_ptr<uchar[]> ProfileStringToStruct(const CStringViewA& Value, const ulong ulSize)
+{
+  CBuffer data;
+  if (!FromHexStringA(Value.ToString(), data) || data.GetSize() != size_t(ulSize) + 1)
+  {
+    return nullptr;
+  }
+
+  const auto p = static_cast<const byte*>(data.GetpData());
+
+  byte checksum = 0;
+  for (ulong i = 0; i < ulSize; i++)
+  {
+    checksum += p[i];
+  }
+
+  if (checksum != p[ulSize])
+  {
+    return nullptr;
+  }
+
+  std::unique_ptr<uchar[]> result(new uchar [ulSize]);
+  memcpy(result.get(), p, ulSize);
+
+  return result;
+}
+
+/**
+ * The text of a document is in the ANSI code page or in UTF-8 (see CINIDocument::IsANSI), the names
+ * and the values are converted between it and the strings of the calls as the profile API does.
+ */
+
+static std::string ToDocument(const CINIDocument& Document, const std::string& String)
+{
+  return Document.IsANSI() ? String : ToUTF8(ToStringW(String));
+}
+
+static std::string ToDocument(const CINIDocument& Document, const std::wstring& String)
+{
+  return Document.IsANSI() ? ToStringA(String) : ToUTF8(String);
+}
+
+static std::string FromDocumentA(const CINIDocument& Document, const CStringViewA& Text)
+{
+  return Document.IsANSI() ? Text.ToString() : ToStringA(FromUTF8(Text.ToString()));
+}
+
+static std::wstring FromDocumentW(const CINIDocument& Document, const CStringViewA& Text)
+{
+  return Document.IsANSI() ? ToStringW(Text.ToString()) : FromUTF8(Text.ToString());
+}
+
+static bool ReadValue(const CINIDocument& Document, const std::string& Section, const std::string& Key, CStringViewA& Value)
+{
+  if (Document.IsANSI())
+  {
+    return Document.Read(Section, Key, Value); // Read as they are, no copy
+  }
+
+  return Document.Read(ToDocument(Document, Section), ToDocument(Document, Key), Value);
+}
+
+static bool ReadValue(const CINIDocument& Document, const std::wstring& Section, const std::wstring& Key, CStringViewA& Value)
+{
+  return Document.Read(ToDocument(Document, Section), ToDocument(Document, Key), Value);
+}
+
+/**
+ * The changes between the documents, a section that is added or removed is followed by its keys.
+ */
+
+static void AddChange(
+  std::vector<TINIChangeA>& Changes,
+  const eINIChange Type,
+  const CStringViewA& Section,
+  const CStringViewA& Key,
+  const CStringViewA& OldValue,
+  const CStringViewA& NewValue
+)
+{
+  TINIChangeA change;
+  change.Type = Type;
+  change.Section  = Section.ToString();
+  change.Key      = Key.ToString();
+  change.OldValue = OldValue.ToString();
+  change.NewValue = NewValue.ToString();
+  Changes.push_back(change);
+}
+
+static void DiffSection(
+  const CINIDocument& Old,
+  const CINIDocument& New,
+  const CStringViewA& Section,
+  std::vector<TINIChangeA>& Changes
+)
+{
+  CStringViewA value;
+
+  for (const auto& e : Old.GetSection(Section))
+  {
+    if (!Old.Read(Section, e.first, value) || value.Data() != e.second.Data())
+    {
+      continue; // A duplicated key is read as its first entry, the others are not seen
+    }
+
+    if (!New.Read(Section, e.first, value))
+    {
+      AddChange(Changes, IC_REMOVED, Section, e.first, e.second, CStringViewA());
+    }
+    else if (value != e.second)
+    {
+      AddChange(Changes, IC_MODIFIED, Section, e.first, e.second, value);
+    }
+  }
+
+  for (const auto& e : New.GetSection(Section))
+  {
+    if (New.Read(Section, e.first, value) && value.Data() == e.second.Data() && !Old.Read(Section, e.first, value))
+    {
+      AddChange(Changes, IC_ADDED, Section, e.first, CStringViewA(), e.second);
+    }
+  }
+}
+
+static void DiffDocuments(const CINIDocument& Old, const CINIDocument& New, std::vector<TINIChangeA>& Changes)
+{
+  for (const auto& section : Old.GetSectionNames())
+  {
+    if (!New.HasSection(section))
+    {
+      AddChange(Changes, IC_REMOVED, section, CStringViewA(), CStringViewA(), CStringViewA());
+    }
+
+    DiffSection(Old, New, section, Changes);
+  }
+
+  for (const auto& section : New.GetSectionNames())
+  {
+    if (!Old.HasSection(section))
+    {
+      AddChange(Changes, IC_ADDED, section, CStringViewA(), CStringViewA(), CStringViewA());
+      DiffSection(Old, New, section, Changes);
+    }
+  }
+}
+
+/**
+ * A change is converted by the documents that it is read from, the names of an added key and a conflict
+ * are in the new one.
+ */
+
+static void FromDocument(const CINIDocument& Old, const CINIDocument& New, const TINIChangeA& Change, TINIChangeA& Result)
+{
+  const CINIDocument& names = Change.Type == IC_REMOVED || Change.Type == IC_MODIFIED ? Old : New;
+  const CINIDocument& old = Change.Type == IC_CONFLICT ? New : Old;
+
+  Result.Type     = Change.Type;
+  Result.Section  = FromDocumentA(names, Change.Section);
+  Result.Key      = FromDocumentA(names, Change.Key);
+  Result.OldValue = FromDocumentA(old, Change.OldValue);
+  Result.NewValue = FromDocumentA(New, Change.NewValue);
+}
+
+static void FromDocument(const CINIDocument& Old, const CINIDocument& New, const TINIChangeA& Change, TINIChangeW& Result)
+{
+  const CINIDocument& names = Change.Type == IC_REMOVED || Change.Type == IC_MODIFIED ? Old : New;
+  const CINIDocument& old = Change.Type == IC_CONFLICT ? New : Old;
+
+  Result.Type     = Change.Type;
+  Result.Section  = FromDocumentW(names, Change.Section);
+  Result.Key      = FromDocumentW(names, Change.Key);
+  Result.OldValue = FromDocumentW(old, Change.OldValue);
+  Result.NewValue = FromDocumentW(New, Change.NewValue);
+}
+
+/**
+ * Applies the local writes (the changes from the base to the local document) over the changed file.
+ * A key that is changed in the file also keeps its local value, it is reported as a conflict.
+ */
+
+static std::string Recode(const CINIDocument& From, const CINIDocument& To, const std::string& Text)
+{
+  return From.IsANSI() == To.IsANSI() ? Text : ToDocument(To, FromDocumentW(From, Text));
+}
+
+static void MergeDocuments(
+  const CINIDocument& Base,
+  const CINIDocument& Local,
+  CINIDocument& File,
+  std::vector<TINIChangeA>& Conflicts
+)
+{
+  std::vector<TINIChangeA> writes;
+  DiffDocuments(Base, Local, writes); // The keys are only added or modified by the writes
+
+  for (const auto& write : writes)
+  {
+    if (write.Key.empty() || write.Type == IC_REMOVED)
+    {
+      continue;
+    }
+
+    const std::string section = Recode(Local, File, write.Section);
+    const std::string key = Recode(Local, File, write.Key);
+    const std::string value = Recode(Local, File, write.NewValue);
+
+    CStringViewA current;
+    const bool found = File.Read(section, key, current);
+    const bool changed = write.Type == IC_ADDED ? found : !found || current != Recode(Local, File, write.OldValue);
+
+    if (changed && current != value)
+    {
+      AddChange(Conflicts, IC_CONFLICT, section, key, found ? current : CStringViewA(), value);
+    }
+
+    File.Write(section, key, value);
+  }
+}
+
+/**
+ * Reads the file again before it is saved, as the profile API does. A file that is changed since the base
+ * (e.g. by another process) gets the local writes replayed over it, so its new keys are not overwritten.
+ * Returns null when the file is missing or not changed.
+ */
+template <typename Path>
+static CINIDocument* ReloadChanged(const Path& FilePath, const CINIDocument& Base, const CINIDocument& Local)
+{
+  std::unique_ptr<CINIDocument> pFile(new CINIDocument);
+  if (!pFile->Load(FilePath))
+  {
+    return nullptr;
+  }
+
+  CBuffer base, file;
+  Base.Serialize(base);
+  pFile->Serialize(file);
+
+  if (base == file)
+  {
+    return nullptr;
+  }
+
+  std::vector<TINIChangeA> conflicts; // The local values are kept
+  MergeDocuments(Base, Local, *pFile, conflicts);
+
+  return pFile.release();
+}
+
+CINIFileA::CINIFileA()
+  : CLastError(), m_Document(new CINIDocument), m_Loaded(false), m_WriteBehind(false), m_Pending(false), m_Stop(false), m_FlushDelay(0)
 {
   m_Section  = "";
   m_FilePath = "";
 }
 
-CINIFileA::CINIFileA(const std::string& FilePath) : CLastError()
+CINIFileA::CINIFileA(const std::string& FilePath)
+  : CLastError(), m_Document(new CINIDocument), m_Loaded(false), m_WriteBehind(false), m_Pending(false), m_Stop(false), m_FlushDelay(0)
 {
   m_Section  = "";
   m_FilePath = FilePath;
@@ -24,6 +333,9 @@ CINIFileA::CINIFileA(const std::string& FilePath) : CLastError()
 
 CINIFileA::~CINIFileA()
 {
+  this->Unwatch();
+  this->StopFlusher();
+  this->Flush();
 }
 
 void CINIFileA::ValidFilePath()
@@ -39,7 +351,22 @@ void CINIFileA::ValidFilePath()
 
 void CINIFileA::SetCurrentFilePath(const std::string& FilePath)
 {
-  m_FilePath = FilePath;
+  const bool watching = m_Watcher.IsWatching();
+
+  this->Unwatch();
+  this->Flush();
+
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_FilePath = FilePath;
+    this->LoadDocument(); // The reads never see an empty document in between
+  }
+
+  if (watching)
+  {
+    const FnChanged fnChanged = m_fnChanged;
+    this->Watch(fnChanged);
+  }
 }
 
 void CINIFileA::SetCurrentSection(const std::string& Section)
@@ -47,153 +374,350 @@ void CINIFileA::SetCurrentSection(const std::string& Section)
   m_Section = Section;
 }
 
-// Long-Read
-
-std::vector<std::string> vuapi CINIFileA::ReadSectionNames(ulong ulMaxSize)
+/**
+ * The file is parsed at the first access, then all of the reads are served from memory.
+ */
+const CRCUPointerT<CINIDocument>& CINIFileA::Document()
 {
-  std::vector<std::string> l;
-  l.clear();
-
-  std::unique_ptr<char[]> p(new char [ulMaxSize]);
-  if (p == nullptr)
+  if (!m_Loaded)
   {
-    return l;
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (!m_Loaded)
+    {
+      this->LoadDocument();
+    }
   }
 
-  ZeroMemory(p.get(), ulMaxSize);
+  return m_Document;
+}
+
+bool vuapi CINIFileA::Reload()
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return this->LoadDocument();
+}
 
+/**
+ * Parses the file and swaps it in, the lock is held by the caller. The reads go on meanwhile.
+ */
+bool CINIFileA::LoadDocument()
+{
   this->ValidFilePath();
 
-  GetPrivateProfileSectionNamesA(p.get(), ulMaxSize, m_FilePath.c_str());
+  std::unique_ptr<CINIDocument> pDocument(new CINIDocument);
+
+  const bool result = pDocument->Load(m_FilePath);
+
+  m_Document.Update(pDocument.release());
+  m_Base.reset(new CINIDocument(*m_Document.Get()));
+  m_Pending = false; // The pending writes are dropped as the file is reloaded
+  m_Loaded = true;
+
+  return result;
+}
+
+bool CINIFileA::Update(const std::string& Section, const std::string& Key, const std::string& Value)
+{
+  this->Document();
+
+  std::unique_lock<std::mutex> lock(m_Mutex);
+
+  // The document is read by the other threads without lock, so it is written as a copy that is swapped in.
+  // The copy shares the sections that are not written with the document.
 
-  m_LastErrorCode = GetLastError();
+  std::unique_ptr<CINIDocument> pCopy(new CINIDocument(*m_Document.Get()));
 
-  for (char * s = p.get(); *s; s++)
+  if (!pCopy->Write(ToDocument(*pCopy, Section), ToDocument(*pCopy, Key), ToDocument(*pCopy, Value)))
   {
-    l.push_back(s); // l.push_back((new std::string(s))->c_str());
-    s += lstrlenA(s);
+    m_LastErrorCode = ERROR_INVALID_PARAMETER;
+    return false;
   }
 
-  return l;
+  m_Document.Update(pCopy.release());
+
+  m_Pending = true;
+
+  if (!m_WriteBehind)
+  {
+    return this->FlushPending();
+  }
+
+  if (m_FlushDelay != 0)
+  {
+    m_Signal.notify_one();
+  }
+
+  return true;
 }
 
-std::vector<std::string> vuapi CINIFileA::ReadSection(const std::string& Section, ulong ulMaxSize)
+/**
+ * Saves the pending writes over the current file, the lock is held by the caller.
+ */
+bool CINIFileA::FlushPending()
 {
-  std::vector<std::string> l;
-  l.clear();
+  if (!m_Pending)
+  {
+    return true;
+  }
 
-  std::unique_ptr<char[]> p(new char [ulMaxSize]);
-  if (p == nullptr)
+  CINIDocument* pFile = ReloadChanged(m_FilePath, *m_Base, *m_Document.Get());
+  if (pFile != nullptr)
   {
-    return l;
+    m_Document.Update(pFile);
   }
 
-  ZeroMemory(p.get(), ulMaxSize);
+  const bool result = m_Document.Get()->Save(m_FilePath);
+  if (result)
+  {
+    m_Base.reset(new CINIDocument(*m_Document.Get()));
+    m_Pending = false;
+  }
 
-  this->ValidFilePath();
+  m_LastErrorCode = result ? ERROR_SUCCESS : GetLastError();
+
+  return result;
+}
+
+bool vuapi CINIFileA::Flush()
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return this->FlushPending();
+}
+
+void vuapi CINIFileA::SetWriteBehind(const bool Enabled, const ulong Delay)
+{
+  this->StopFlusher();
 
-  GetPrivateProfileSectionA(Section.c_str(), p.get(), ulMaxSize, m_FilePath.c_str());
+  std::lock_guard<std::mutex> lock(m_Mutex);
 
-  m_LastErrorCode = GetLastError();
+  m_WriteBehind = Enabled;
+  m_FlushDelay  = Enabled ? Delay : 0;
 
-  for (char * s = p.get(); *s; s++)
+  if (!m_WriteBehind)
   {
-    l.push_back(s); // l.push_back((new std::string(s))->c_str());
-    s += lstrlenA(s);
+    this->FlushPending();
   }
+  else if (m_FlushDelay != 0)
+  {
+    m_Stop = false;
 
-  return l;
+    // A burst of writes is flushed once, at the delay after its first write
+
+    m_Flusher = std::thread([this]()
+    {
+      std::unique_lock<std::mutex> lock(m_Mutex);
+
+      while (!m_Stop)
+      {
+        m_Signal.wait(lock, [this]() { return m_Stop || m_Pending; });
+
+        if (!m_Stop && !m_Signal.wait_for(lock, std::chrono::milliseconds(m_FlushDelay), [this]() { return m_Stop; }))
+        {
+          this->FlushPending();
+        }
+      }
+    });
+  }
 }
 
-int vuapi CINIFileA::ReadInteger(const std::string& Section, const std::string& Key, int Default)
+void CINIFileA::StopFlusher()
 {
-  this->ValidFilePath();
-  uint result = GetPrivateProfileIntA(Section.c_str(), Key.c_str(), Default, m_FilePath.c_str());
-  m_LastErrorCode = GetLastError();
-  return result;
+  if (m_Flusher.joinable())
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      m_Stop = true;
+    }
+
+    m_Signal.notify_all();
+    m_Flusher.join();
+  }
 }
 
-bool vuapi CINIFileA::ReadBool(const std::string& Section, const std::string& Key, bool Default)
+bool vuapi CINIFileA::Watch(const FnChanged& fnChanged)
 {
-  this->ValidFilePath();
-  bool result = (GetPrivateProfileIntA(Section.c_str(), Key.c_str(), Default, m_FilePath.c_str()) == 1 ? true : false);
-  m_LastErrorCode = GetLastError();
-  return result;
+  this->Unwatch();
+
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    this->ValidFilePath();
+  }
+
+  m_fnChanged = fnChanged;
+
+  if (!m_Watcher.Start(m_FilePath, [this]() { this->OnFileChanged(); }))
+  {
+    m_LastErrorCode = GetLastError();
+    return false;
+  }
+
+  this->Document(); // The changes are diffed from the loaded file
+
+  return true;
 }
 
-float vuapi CINIFileA::ReadFloat(const std::string& Section, const std::string& Key, float Default)
+void vuapi CINIFileA::Unwatch()
 {
-  const std::string sDefault = NumberToStringA(Default);
-  char lpszResult[MAX_SIZE];
+  m_Watcher.Stop();
+}
 
-  ZeroMemory(lpszResult, sizeof(lpszResult));
+/**
+ * Called on the watcher thread, a file that can not be loaded (e.g. removed to be replaced) is skipped.
+ * The local writes that are not flushed are merged into the changed file, they are still pending.
+ */
+void CINIFileA::OnFileChanged()
+{
+  std::unique_ptr<CINIDocument> pDocument(new CINIDocument);
+  if (!pDocument->Load(m_FilePath))
+  {
+    return;
+  }
 
-  this->ValidFilePath();
+  std::vector<TINIChangeA> changes;
+
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    std::vector<TINIChangeA> conflicts;
+
+    std::unique_ptr<CINIDocument> pBase(new CINIDocument(*pDocument));
+
+    if (m_Pending)
+    {
+      MergeDocuments(*m_Base, *m_Document.Get(), *pDocument, conflicts);
+    }
+
+    m_Base = std::move(pBase);
+
+    DiffDocuments(*m_Document.Get(), *pDocument, changes);
+    changes.insert(changes.end(), conflicts.begin(), conflicts.end());
+
+    for (auto& change : changes)
+    {
+      FromDocument(*m_Document.Get(), *pDocument, TINIChangeA(change), change);
+    }
+
+    m_Document.Update(pDocument.release());
+  }
 
-  GetPrivateProfileStringA(Section.c_str(), Key.c_str(), sDefault.c_str(), lpszResult, MAX_SIZE, m_FilePath.c_str());
+  if (m_fnChanged)
+  {
+    for (const auto& change : changes)
+    {
+      m_fnChanged(change);
+    }
+  }
+}
+
+// Long-Read
+
+std::vector<std::string> vuapi CINIFileA::ReadSectionNames(ulong ulMaxSize)
+{
+  UNREFERENCED_PARAMETER(ulMaxSize);
 
-  m_LastErrorCode = GetLastError();
+  CDocumentGuard document(this->Document());
 
-  return (float)atof(lpszResult);
+  std::vector<std::string> l;
+
+  for (const auto& e : document->GetSectionNames())
+  {
+    l.push_back(FromDocumentA(*document, e));
+  }
+
+  return l;
 }
 
-std::string vuapi CINIFileA::ReadString(
-  const std::string& Section,
-  const std::string& Key,
-  const std::string& Default
-)
+std::vector<std::string> vuapi CINIFileA::ReadSection(const std::string& Section, ulong ulMaxSize)
 {
-  std::string s;
-  s.clear();
+  UNREFERENCED_PARAMETER(ulMaxSize);
 
-  std::unique_ptr<char[]> p(new char [MAX_SIZE]);
-  if (p == nullptr)
+  CDocumentGuard document(this->Document());
+
+  std::vector<std::string> l;
+
+  for (const auto& e : document->GetSection(ToDocument(*document, Section)))
   {
-    return s;
+    CStringBuilderA line(e.first.Size() + e.second.Size() + 1);
+    line << e.first << '=' << e.second;
+    l.push_back(FromDocumentA(*document, line.View()));
   }
 
-  ZeroMemory(p.get(), MAX_SIZE);
+  return l;
+}
 
-  this->ValidFilePath();
+int vuapi CINIFileA::ReadInteger(const std::string& Section, const std::string& Key, int Default)
+{
+  CDocumentGuard document(this->Document());
+
+  CStringViewA value;
+  if (!ReadValue(*document, Section, Key, value))
+  {
+    return Default;
+  }
+
+  return ReadProfileInteger(value, Default);
+}
 
-  ulong result = GetPrivateProfileStringA(
-    Section.c_str(),
-    Key.c_str(),
-    Default.c_str(),
-    p.get(),
-    MAX_SIZE,
-    m_FilePath.c_str()
-  );
+bool vuapi CINIFileA::ReadBool(const std::string& Section, const std::string& Key, bool Default)
+{
+  CDocumentGuard document(this->Document());
 
-  if (result == 0)
+  CStringViewA value;
+  if (!ReadValue(*document, Section, Key, value))
   {
-    m_LastErrorCode = GetLastError();
-    return s;
+    return Default;
   }
 
-  s.assign(p.get());
+  return ReadProfileInteger(value, Default) == 1;
+}
 
-  return s;
+float vuapi CINIFileA::ReadFloat(const std::string& Section, const std::string& Key, float Default)
+{
+  CDocumentGuard document(this->Document());
+
+  CStringViewA value;
+  if (!ReadValue(*document, Section, Key, value))
+  {
+    return Default;
+  }
+
+  return (float)atof(value.ToString().c_str());
 }
 
-std::unique_ptr<uchar[]> vuapi CINIFileA::ReadStruct(const std::string& Section, const std::string& Key, ulong ulSize)
+std::string vuapi CINIFileA::ReadString(
+  const std::string& Section,
+  const std::string& Key,
+  const std::string& Default
+)
 {
-  std::unique_ptr<uchar[]> p(new uchar [ulSize]);
-  if (p == nullptr)
+  CDocumentGuard document(this->Document());
+
+  CStringViewA value;
+  if (!ReadValue(*document, Section, Key, value))
   {
-    return nullptr;
+    return Default;
   }
 
-  ZeroMemory(p.get(), ulSize);
+  return FromDocumentA(*document, value);
+}
 
-  this->ValidFilePath();
+std::unique_ptr<uchar[]> vuapi CINIFileA::ReadStruct(const std::string& Section, const std::string& Key, ulong ulSize)
+{
+  CDocumentGuard document(this->Document());
 
-  if (GetPrivateProfileStructA(Section.c_str(), Key.c_str(), (void*)p.get(), ulSize, m_FilePath.c_str()) == 0)
+  CStringViewA value;
+  if (!ReadValue(*document, Section, Key, value))
   {
-    m_LastErrorCode = GetLastError();
+    m_LastErrorCode = ERROR_FILE_NOT_FOUND;
     return nullptr;
   }
 
+  auto p = ProfileStringToStruct(value, ulSize);
+  if (p == nullptr)
+  {
+    m_LastErrorCode = ERROR_INVALID_DATA;
+  }
+
   return p;
 }
 
@@ -233,45 +757,27 @@ std::unique_ptr<uchar[]> vuapi CINIFileA::ReadStruct(const std::string& Key, ulo
 
 bool vuapi CINIFileA::WriteInteger(const std::string& Section, const std::string& Key, int Value)
 {
-  this->ValidFilePath();
-  const std::string s = NumberToStringA(Value);
-  bool result = (WritePrivateProfileStringA(Section.c_str(), Key.c_str(), s.c_str(), m_FilePath.c_str()) != 0);
-  m_LastErrorCode = GetLastError();
-  return result;
+  return this->Update(Section, Key, NumberToStringA(Value));
 }
 
 bool vuapi CINIFileA::WriteBool(const std::string& Section, const std::string& Key, bool Value)
 {
-  this->ValidFilePath();
-  const std::string s(Value ? "1" : "0");
-  bool result = (WritePrivateProfileStringA(Section.c_str(), Key.c_str(), s.c_str(), m_FilePath.c_str()) != 0);
-  m_LastErrorCode = GetLastError();
-  return result;
+  return this->Update(Section, Key, Value ? "1" : "0");
 }
 
 bool vuapi CINIFileA::WriteFloat(const std::string& Section, const std::string& Key, float Value)
 {
-  this->ValidFilePath();
-  const std::string s = NumberToStringA(Value);
-  bool result = (WritePrivateProfileStringA(Section.c_str(), Key.c_str(), s.c_str(), m_FilePath.c_str()) != 0);
-  m_LastErrorCode = GetLastError();
-  return result;
+  return this->Update(Section, Key, NumberToStringA(Value));
 }
 
 bool vuapi CINIFileA::WriteString(const std::string& Section, const std::string& Key, const std::string& Value)
 {
-  this->ValidFilePath();
-  bool result = (WritePrivateProfileStringA(Section.c_str(), Key.c_str(), Value.c_str(), m_FilePath.c_str()) != 0);
-  m_LastErrorCode = GetLastError();
-  return result;
+  return this->Update(Section, Key, Value);
 }
 
 bool vuapi CINIFileA::WriteStruct(const std::string& Section, const std::string& Key, void* pStruct, ulong ulSize)
 {
-  this->ValidFilePath();
-  bool result = (WritePrivateProfileStructA(Section.c_str(), Key.c_str(), pStruct, ulSize, m_FilePath.c_str()) != 0);
-  m_LastErrorCode = GetLastError();
-  return result;
+  return this->Update(Section, Key, StructToProfileString(pStruct, ulSize));
 }
 
 // Short-Write
@@ -301,13 +807,15 @@ bool vuapi CINIFileA::WriteStruct(const std::string& Key, void* pStruct, ulong u
   return this->WriteStruct(m_Section, Key, pStruct, ulSize);
 }
 
-CINIFileW::CINIFileW() : CLastError()
+CINIFileW::CINIFileW()
+  : CLastError(), m_Document(new CINIDocument), m_Loaded(false), m_WriteBehind(false), m_Pending(false), m_Stop(false), m_FlushDelay(0)
 {
   m_Section  = L"";
   m_FilePath = L"";
 }
 
-CINIFileW::CINIFileW(const std::wstring& FilePath) : CLastError()
+CINIFileW::CINIFileW(const std::wstring& FilePath)
+  : CLastError(), m_Document(new CINIDocument), m_Loaded(false), m_WriteBehind(false), m_Pending(false), m_Stop(false), m_FlushDelay(0)
 {
   m_Section  = L"";
   m_FilePath = FilePath;
@@ -315,6 +823,9 @@ CINIFileW::CINIFileW(const std::wstring& FilePath) : CLastError()
 
 CINIFileW::~CINIFileW()
 {
+  this->Unwatch();
+  this->StopFlusher();
+  this->Flush();
 }
 
 void CINIFileW::ValidFilePath()
@@ -322,7 +833,7 @@ void CINIFileW::ValidFilePath()
   if (m_FilePath.empty())
   {
     std::wstring filePath = GetCurrentFilePathW();
-    std::wstring fileDir = ExtractFileDirectoryW(filePath, true);
+    std::wstring fileDir  = ExtractFileDirectoryW(filePath, true);
     std::wstring fileName = ExtractFileNameW(filePath, false);
     m_FilePath = fileDir + fileName + L".INI";
   }
@@ -330,7 +841,22 @@ void CINIFileW::ValidFilePath()
 
 void CINIFileW::SetCurrentFilePath(const std::wstring& FilePath)
 {
-  m_FilePath = FilePath;
+  const bool watching = m_Watcher.IsWatching();
+
+  this->Unwatch();
+  this->Flush();
+
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_FilePath = FilePath;
+    this->LoadDocument(); // The reads never see an empty document in between
+  }
+
+  if (watching)
+  {
+    const FnChanged fnChanged = m_fnChanged;
+    this->Watch(fnChanged);
+  }
 }
 
 void CINIFileW::SetCurrentSection(const std::wstring& Section)
@@ -338,165 +864,352 @@ void CINIFileW::SetCurrentSection(const std::wstring& Section)
   m_Section = Section;
 }
 
-// Long-Read
+/**
+ * The file is parsed at the first access, then all of the reads are served from memory.
+ */
+const CRCUPointerT<CINIDocument>& CINIFileW::Document()
+{
+  if (!m_Loaded)
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (!m_Loaded)
+    {
+      this->LoadDocument();
+    }
+  }
 
-std::vector<std::wstring> vuapi CINIFileW::ReadSectionNames(ulong ulMaxSize)
+  return m_Document;
+}
+
+bool vuapi CINIFileW::Reload()
 {
-  std::vector<std::wstring> l;
-  l.clear();
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return this->LoadDocument();
+}
 
-  std::unique_ptr<wchar[]> p(new wchar [ulMaxSize]);
-  if (p == nullptr)
+/**
+ * Parses the file and swaps it in, the lock is held by the caller. The reads go on meanwhile.
+ */
+bool CINIFileW::LoadDocument()
+{
+  this->ValidFilePath();
+
+  std::unique_ptr<CINIDocument> pDocument(new CINIDocument);
+
+  const bool result = pDocument->Load(m_FilePath);
+
+  m_Document.Update(pDocument.release());
+  m_Base.reset(new CINIDocument(*m_Document.Get()));
+  m_Pending = false; // The pending writes are dropped as the file is reloaded
+  m_Loaded = true;
+
+  return result;
+}
+
+bool CINIFileW::Update(const std::wstring& Section, const std::wstring& Key, const std::wstring& Value)
+{
+  this->Document();
+
+  std::unique_lock<std::mutex> lock(m_Mutex);
+
+  // The document is read by the other threads without lock, so it is written as a copy that is swapped in.
+  // The copy shares the sections that are not written with the document.
+
+  std::unique_ptr<CINIDocument> pCopy(new CINIDocument(*m_Document.Get()));
+
+  if (!pCopy->Write(ToDocument(*pCopy, Section), ToDocument(*pCopy, Key), ToDocument(*pCopy, Value)))
   {
-    return l;
+    m_LastErrorCode = ERROR_INVALID_PARAMETER;
+    return false;
   }
 
-  ZeroMemory(p.get(), 2*ulMaxSize);
+  m_Document.Update(pCopy.release());
 
-  this->ValidFilePath();
+  m_Pending = true;
 
-  GetPrivateProfileSectionNamesW(p.get(), 2*ulMaxSize, m_FilePath.c_str());
+  if (!m_WriteBehind)
+  {
+    return this->FlushPending();
+  }
 
-  m_LastErrorCode = GetLastError();
+  if (m_FlushDelay != 0)
+  {
+    m_Signal.notify_one();
+  }
 
-  for (wchar * s = p.get(); *s; s++)
+  return true;
+}
+
+/**
+ * Saves the pending writes over the current file, the lock is held by the caller.
+ */
+bool CINIFileW::FlushPending()
+{
+  if (!m_Pending)
   {
-    l.push_back(s); // l.push_back((new std::wstring(s))->c_str());
-    s += lstrlenW(s);
+    return true;
   }
 
-  return l;
+  CINIDocument* pFile = ReloadChanged(m_FilePath, *m_Base, *m_Document.Get());
+  if (pFile != nullptr)
+  {
+    m_Document.Update(pFile);
+  }
+
+  const bool result = m_Document.Get()->Save(m_FilePath);
+  if (result)
+  {
+    m_Base.reset(new CINIDocument(*m_Document.Get()));
+    m_Pending = false;
+  }
+
+  m_LastErrorCode = result ? ERROR_SUCCESS : GetLastError();
+
+  return result;
 }
 
-std::vector<std::wstring> vuapi CINIFileW::ReadSection(const std::wstring& Section, ulong ulMaxSize)
+bool vuapi CINIFileW::Flush()
 {
-  std::vector<std::wstring> l;
-  l.clear();
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return this->FlushPending();
+}
 
-  std::unique_ptr<wchar[]> p(new wchar [ulMaxSize]);
-  if (p == nullptr)
+void vuapi CINIFileW::SetWriteBehind(const bool Enabled, const ulong Delay)
+{
+  this->StopFlusher();
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+
+  m_WriteBehind = Enabled;
+  m_FlushDelay  = Enabled ? Delay : 0;
+
+  if (!m_WriteBehind)
   {
-    return l;
+    this->FlushPending();
   }
+  else if (m_FlushDelay != 0)
+  {
+    m_Stop = false;
 
-  ZeroMemory(p.get(), 2*ulMaxSize);
+    // A burst of writes is flushed once, at the delay after its first write
 
-  this->ValidFilePath();
+    m_Flusher = std::thread([this]()
+    {
+      std::unique_lock<std::mutex> lock(m_Mutex);
 
-  GetPrivateProfileSectionW(Section.c_str(), p.get(), 2*ulMaxSize, m_FilePath.c_str());
+      while (!m_Stop)
+      {
+        m_Signal.wait(lock, [this]() { return m_Stop || m_Pending; });
 
-  m_LastErrorCode = GetLastError();
+        if (!m_Stop && !m_Signal.wait_for(lock, std::chrono::milliseconds(m_FlushDelay), [this]() { return m_Stop; }))
+        {
+          this->FlushPending();
+        }
+      }
+    });
+  }
+}
 
-  for (wchar * s = p.get(); *s; s++)
+void CINIFileW::StopFlusher()
+{
+  if (m_Flusher.joinable())
   {
-    l.push_back(s); // l.push_back((new std::wstring(s))->c_str());
-    s += lstrlenW(s);
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      m_Stop = true;
+    }
+
+    m_Signal.notify_all();
+    m_Flusher.join();
   }
+}
 
-  return l;
+bool vuapi CINIFileW::Watch(const FnChanged& fnChanged)
+{
+  this->Unwatch();
+
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    this->ValidFilePath();
+  }
+
+  m_fnChanged = fnChanged;
+
+  if (!m_Watcher.Start(m_FilePath, [this]() { this->OnFileChanged(); }))
+  {
+    m_LastErrorCode = GetLastError();
+    return false;
+  }
+
+  this->Document(); // The changes are diffed from the loaded file
+
+  return true;
 }
 
-int vuapi CINIFileW::ReadInteger(const std::wstring& Section, const std::wstring& Key, int Default)
+void vuapi CINIFileW::Unwatch()
 {
-  this->ValidFilePath();
-  int result = GetPrivateProfileIntW(Section.c_str(), Key.c_str(), Default, m_FilePath.c_str());
-  m_LastErrorCode = GetLastError();
-  return result;
+  m_Watcher.Stop();
 }
 
-bool vuapi CINIFileW::ReadBool(const std::wstring& Section, const std::wstring& Key, bool Default)
+/**
+ * Called on the watcher thread, a file that can not be loaded (e.g. removed to be replaced) is skipped.
+ * The local writes that are not flushed are merged into the changed file, they are still pending.
+ */
+void CINIFileW::OnFileChanged()
 {
-  this->ValidFilePath();
-  bool result = (GetPrivateProfileIntW(Section.c_str(), Key.c_str(), Default, m_FilePath.c_str()) == 1 ? true : false);
-  m_LastErrorCode = GetLastError();
-  return result;
+  std::unique_ptr<CINIDocument> pDocument(new CINIDocument);
+  if (!pDocument->Load(m_FilePath))
+  {
+    return;
+  }
+
+  std::vector<TINIChangeW> changes;
+
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    std::vector<TINIChangeA> conflicts;
+
+    std::unique_ptr<CINIDocument> pBase(new CINIDocument(*pDocument));
+
+    if (m_Pending)
+    {
+      MergeDocuments(*m_Base, *m_Document.Get(), *pDocument, conflicts);
+    }
+
+    m_Base = std::move(pBase);
+
+    std::vector<TINIChangeA> texts;
+    DiffDocuments(*m_Document.Get(), *pDocument, texts);
+    texts.insert(texts.end(), conflicts.begin(), conflicts.end());
+
+    changes.resize(texts.size());
+    for (size_t i = 0; i < texts.size(); i++)
+    {
+      FromDocument(*m_Document.Get(), *pDocument, texts[i], changes[i]);
+    }
+
+    m_Document.Update(pDocument.release());
+  }
+
+  if (m_fnChanged)
+  {
+    for (const auto& change : changes)
+    {
+      m_fnChanged(change);
+    }
+  }
 }
 
-float vuapi CINIFileW::ReadFloat(const std::wstring& Section, const std::wstring& Key, float Default)
+// Long-Read
+
+std::vector<std::wstring> vuapi CINIFileW::ReadSectionNames(ulong ulMaxSize)
 {
-  this->ValidFilePath();
+  UNREFERENCED_PARAMETER(ulMaxSize);
 
-  const std::wstring sDefault = NumberToStringW(Default);
-  wchar lpwszResult[MAX_SIZE];
+  CDocumentGuard document(this->Document());
 
-  ZeroMemory(lpwszResult, sizeof(lpwszResult));
+  std::vector<std::wstring> l;
 
-  GetPrivateProfileStringW(
-    Section.c_str(),
-    Key.c_str(),
-    sDefault.c_str(),
-    lpwszResult,
-    sizeof(lpwszResult),
-    m_FilePath.c_str()
-  );
+  for (const auto& e : document->GetSectionNames())
+  {
+    l.push_back(FromDocumentW(*document, e));
+  }
 
-  m_LastErrorCode = GetLastError();
+  return l;
+}
 
-  const std::string s = ToStringA(lpwszResult);
+std::vector<std::wstring> vuapi CINIFileW::ReadSection(const std::wstring& Section, ulong ulMaxSize)
+{
+  UNREFERENCED_PARAMETER(ulMaxSize);
+
+  CDocumentGuard document(this->Document());
+
+  std::vector<std::wstring> l;
+
+  for (const auto& e : document->GetSection(ToDocument(*document, Section)))
+  {
+    CStringBuilderA line(e.first.Size() + e.second.Size() + 1);
+    line << e.first << '=' << e.second;
+    l.push_back(FromDocumentW(*document, line.View()));
+  }
 
-  return (float)atof(s.c_str());
+  return l;
 }
 
-std::wstring vuapi CINIFileW::ReadString(
-  const std::wstring& Section,
-  const std::wstring& Key,
-  const std::wstring& Default
-)
+int vuapi CINIFileW::ReadInteger(const std::wstring& Section, const std::wstring& Key, int Default)
 {
-  std::wstring s;
-  s.clear();
+  CDocumentGuard document(this->Document());
 
-  std::unique_ptr<wchar[]> p(new wchar [MAX_SIZE]);
-  if (p == nullptr)
+  CStringViewA value;
+  if (!ReadValue(*document, Section, Key, value))
   {
-    return s;
+    return Default;
   }
 
-  ZeroMemory(p.get(), 2*MAX_SIZE);
+  return ReadProfileInteger(value, Default);
+}
 
-  this->ValidFilePath();
+bool vuapi CINIFileW::ReadBool(const std::wstring& Section, const std::wstring& Key, bool Default)
+{
+  CDocumentGuard document(this->Document());
 
-  ulong result = GetPrivateProfileStringW(
-    Section.c_str(),
-    Key.c_str(),
-    Default.c_str(),
-    p.get(),
-    2 * MAX_SIZE,
-    m_FilePath.c_str()
-  );
-  if (result == 0)
+  CStringViewA value;
+  if (!ReadValue(*document, Section, Key, value))
   {
-    m_LastErrorCode = GetLastError();
-    return s;
+    return Default;
   }
 
-  s.assign(p.get());
+  return ReadProfileInteger(value, Default) == 1;
+}
 
-  return s;
+float vuapi CINIFileW::ReadFloat(const std::wstring& Section, const std::wstring& Key, float Default)
+{
+  CDocumentGuard document(this->Document());
+
+  CStringViewA value;
+  if (!ReadValue(*document, Section, Key, value))
+  {
+    return Default;
+  }
+
+  return (float)atof(value.ToString().c_str());
 }
 
-std::unique_ptr<uchar[]> vuapi CINIFileW::ReadStruct(
+std::wstring vuapi CINIFileW::ReadString(
   const std::wstring& Section,
   const std::wstring& Key,
-  ulong ulSize
+  const std::wstring& Default
 )
 {
-  std::unique_ptr<uchar[]> p(new uchar [ulSize]);
-  if (p == nullptr)
+  CDocumentGuard document(this->Document());
+
+  CStringViewA value;
+  if (!ReadValue(*document, Section, Key, value))
   {
-    return nullptr;
+    return Default;
   }
 
-  ZeroMemory(p.get(), ulSize);
+  return FromDocumentW(*document, value);
+}
 
-  this->ValidFilePath();
+std::unique_ptr<uchar[]> vuapi CINIFileW::ReadStruct(const std::wstring& Section, const std::wstring& Key, ulong ulSize)
+{
+  CDocumentGuard document(this->Document());
 
-  if (GetPrivateProfileStructW(Section.c_str(), Key.c_str(), (void*)p.get(), ulSize, m_FilePath.c_str()) == 0)
+  CStringViewA value;
+  if (!ReadValue(*document, Section, Key, value))
   {
-    m_LastErrorCode = GetLastError();
+    m_LastErrorCode = ERROR_FILE_NOT_FOUND;
     return nullptr;
   }
 
+  auto p = ProfileStringToStruct(value, ulSize);
+  if (p == nullptr)
+  {
+    m_LastErrorCode = ERROR_INVALID_DATA;
+  }
+
   return p;
 }
 
@@ -536,35 +1249,22 @@ std::unique_ptr<uchar[]> vuapi CINIFileW::ReadStruct(const std::wstring& Key, ul
 
 bool vuapi CINIFileW::WriteInteger(const std::wstring& Section, const std::wstring& Key, int Value)
 {
-  this->ValidFilePath();
-  const std::wstring s = NumberToStringW(Value);
-  bool result = (WritePrivateProfileStringW(Section.c_str(), Key.c_str(), s.c_str(), m_FilePath.c_str()) != 0);
-  m_LastErrorCode = GetLastError();
-  return result;
+  return this->Update(Section, Key, NumberToStringW(Value));
 }
 
 bool vuapi CINIFileW::WriteBool(const std::wstring& Section, const std::wstring& Key, bool Value)
 {
-  this->ValidFilePath();
-  const std::wstring s(Value ? L"1" : L"0");
-  return (WritePrivateProfileStringW(Section.c_str(), Key.c_str(), s.c_str(), m_FilePath.c_str()) != 0);
+  return this->Update(Section, Key, Value ? L"1" : L"0");
 }
 
 bool vuapi CINIFileW::WriteFloat(const std::wstring& Section, const std::wstring& Key, float Value)
 {
-  this->ValidFilePath();
-  const std::wstring s = NumberToStringW(Value);
-  bool result = (WritePrivateProfileStringW(Section.c_str(), Key.c_str(), s.c_str(), m_FilePath.c_str()) != 0);
-  m_LastErrorCode = GetLastError();
-  return result;
+  return this->Update(Section, Key, NumberToStringW(Value));
 }
 
 bool vuapi CINIFileW::WriteString(const std::wstring& Section, const std::wstring& Key, const std::wstring& Value)
 {
-  this->ValidFilePath();
-  bool result = (WritePrivateProfileStringW(Section.c_str(), Key.c_str(), Value.c_str(), m_FilePath.c_str()) != 0);
-  m_LastErrorCode = GetLastError();
-  return result;
+  return this->Update(Section, Key, Value);
 }
 
 bool vuapi CINIFileW::WriteStruct(
@@ -574,10 +1274,7 @@ bool vuapi CINIFileW::WriteStruct(
   ulong ulSize
 )
 {
-  this->ValidFilePath();
-  bool result = (WritePrivateProfileStructW(Section.c_str(), Key.c_str(), pStruct, ulSize, m_FilePath.c_str()) != 0);
-  m_LastErrorCode = GetLastError();
-  return result;
+  return this->Update(Section, Key, ToStringW(StructToProfileString(pStruct, ulSize)));
 }
 
 // Short-Write
@@ -607,4 +1304,4 @@ bool vuapi CINIFileW::WriteStruct(const std::wstring& Key, void* pStruct, ulong
   return this->WriteStruct(m_Section.c_str(), Key.c_str(), pStruct, ulSize);
 }
 
-} // namespace vu
\ No newline at end of file
+} // namespace vu
@@ -0,0 +1,461 @@
+/**
+ * @file   inischema.cpp
+ * @author Vic P.
+ * @brief  Implementation for INI Schema
+ */
+
+#include "Vutils.h"
+
+#include <limits>
+#include <climits>
+#include <algorithm>
+
+namespace vu
+{
+
+static const size_t NONE = size_t(-1);
+
+static const ulonglong FNV_BASIS = 14695981039346656037ULL;
+static const ulonglong FNV_PRIME = 1099511628211ULL;
+static const ulonglong GOLDEN = 0x9E3779B97F4A7C15ULL;
+
+static const ulong32 MAX_DISPLACEMENT = 1 << 16; // Then the table is built by another seed
+
+static char LowerASCII(const char c)
+{
+  return c >= 'A' && c <= 'Z' ? char(c + ('a' - 'A')) : c;
+}
+
+/**
+ * The names and the words are short, they are compared in place rather than by the vectors.
+ */
+static bool EqualsName(const CStringViewA& Name, const CStringViewA& Other)
+{
+  if (Name.Size() != Other.Size())
+  {
+    return false;
+  }
+
+  for (size_t i = 0; i < Name.Size(); i++)
+  {
+    if (LowerASCII(Name[i]) != LowerASCII(Other[i]))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * The names are hashed case-insensitively (ASCII) by FNV-1a, a key is hashed on the hash of its section.
+ */
+
+static ulonglong HashName(const CStringViewA& Name, ulonglong hash)
+{
+  for (const auto c : Name)
+  {
+    hash = (hash ^ byte(LowerASCII(c))) * FNV_PRIME;
+  }
+
+  return hash;
+}
+
+static ulonglong HashSection(const CStringViewA& Section, const ulonglong Seed)
+{
+  return HashName(Section, FNV_BASIS ^ Seed) * FNV_PRIME; // Separated from the key as by a null character
+}
+
+static ulonglong Mix(ulonglong h)
+{
+  h ^= h >> 33;
+  h *= 0xFF51AFD7ED558CCDULL;
+  h ^= h >> 33;
+  h *= 0xC4CEB9FE1A85EC53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+static size_t Slot(const ulonglong Hash, const ulong32 Displacement, const size_t Size)
+{
+  return size_t(Mix(Hash ^ (Displacement * GOLDEN)) % Size);
+}
+
+CINISchema::CINISchema() : m_Seed(0), m_Ready(false)
+{
+}
+
+CINISchema::~CINISchema()
+{
+}
+
+size_t CINISchema::GetCount() const
+{
+  return m_Keys.size();
+}
+
+bool CINISchema::Add(const CStringViewA& Section, const CStringViewA& Key)
+{
+  for (const auto& e : m_Keys)
+  {
+    if (EqualsName(e.Section, Section) && EqualsName(e.Key, Key))
+    {
+      return false;
+    }
+  }
+
+  TKey key;
+  key.Section = Section.ToString();
+  key.Key = Key.ToString();
+  key.Hash = 0;
+
+  m_Keys.push_back(key);
+  m_Ready = false;
+
+  return true;
+}
+
+void CINISchema::Build() const
+{
+  if (m_Ready)
+  {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+
+  if (m_Ready)
+  {
+    return;
+  }
+
+  for (ulonglong seed = 0; !this->Build(seed); seed++);
+
+  m_Ready = true;
+}
+
+/**
+ * Builds the perfect hash table by hash and displace (CHD). The keys are grouped in buckets, then
+ * from the biggest bucket, the displacement of a bucket is searched so all of its keys get free slots.
+ * A lookup is the hash of the key, its bucket, its displacement and its slot.
+ */
+bool CINISchema::Build(const ulonglong Seed) const
+{
+  const size_t n = m_Keys.size();
+
+  m_Seed = Seed;
+  m_Displacements.assign(n / 4 + 1, 0);
+  m_Slots.assign(n + n / 4 + 1, NONE);
+
+  std::vector<std::vector<size_t>> buckets(m_Displacements.size());
+
+  for (size_t i = 0; i < n; i++)
+  {
+    auto& key = m_Keys[i];
+    key.Hash = HashName(key.Key, HashSection(key.Section, Seed));
+    buckets[size_t(Mix(key.Hash) % buckets.size())].push_back(i);
+  }
+
+  std::vector<size_t> order(buckets.size());
+  for (size_t i = 0; i < order.size(); i++)
+  {
+    order[i] = i;
+  }
+
+  std::stable_sort(order.begin(), order.end(), [&](const size_t a, const size_t b)
+  {
+    return buckets[a].size() > buckets[b].size();
+  });
+
+  std::vector<size_t> slots;
+
+  for (const auto b : order)
+  {
+    const auto& bucket = buckets[b];
+    if (bucket.empty())
+    {
+      break;
+    }
+
+    ulong32 d = 0;
+
+    for (; d < MAX_DISPLACEMENT; d++)
+    {
+      slots.clear();
+
+      for (const auto i : bucket)
+      {
+        const size_t slot = Slot(m_Keys[i].Hash, d, m_Slots.size());
+        if (m_Slots[slot] != NONE || std::find(slots.cbegin(), slots.cend(), slot) != slots.cend())
+        {
+          break;
+        }
+
+        slots.push_back(slot);
+      }
+
+      if (slots.size() == bucket.size())
+      {
+        break;
+      }
+    }
+
+    if (d == MAX_DISPLACEMENT)
+    {
+      return false; // The keys of the bucket have the same hash
+    }
+
+    m_Displacements[b] = d;
+
+    for (size_t i = 0; i < bucket.size(); i++)
+    {
+      m_Slots[slots[i]] = bucket[i];
+    }
+  }
+
+  return true;
+}
+
+size_t CINISchema::Find(const ulonglong SectionHash, const CStringViewA& Section, const CStringViewA& Key) const
+{
+  const ulonglong hash = HashName(Key, SectionHash);
+
+  const ulong32 d = m_Displacements[size_t(Mix(hash) % m_Displacements.size())];
+
+  const size_t index = m_Slots[Slot(hash, d, m_Slots.size())];
+  if (index == NONE)
+  {
+    return NONE;
+  }
+
+  const auto& key = m_Keys[index];
+  if (key.Hash != hash || !EqualsName(key.Key, Key) || !EqualsName(key.Section, Section))
+  {
+    return NONE;
+  }
+
+  return index;
+}
+
+bool CINISchema::Load(const CINIDocument& Document, void* pObject, std::vector<TINIIssue>& Issues) const
+{
+  this->Build();
+
+  const size_t count = Issues.size();
+
+  std::vector<bool> found(m_Keys.size(), false);
+
+  const bool ansi = Document.IsANSI();
+
+  CStringViewA section;
+  ulonglong sectionHash = 0;
+
+  Document.Iterate([&](const CStringViewA& Section, const CStringViewA& Key, const CStringViewA& Value)
+  {
+    if (Section.Data() != section.Data() || Section.Size() != section.Size()) // The keys of a section are passed together
+    {
+      section = Section;
+      sectionHash = HashSection(Section, m_Seed);
+    }
+
+    const size_t index = this->Find(sectionHash, Section, Key);
+    if (index == NONE || found[index])
+    {
+      return;
+    }
+
+    found[index] = true;
+
+    if (!this->Assign(index, Value, ansi, pObject))
+    {
+      this->Reset(index, pObject);
+
+      TINIIssue issue;
+      issue.Type = II_INVALID;
+      issue.Section = m_Keys[index].Section;
+      issue.Key = m_Keys[index].Key;
+      issue.Value = Value.ToString();
+      Issues.push_back(issue);
+    }
+  });
+
+  for (size_t i = 0; i < m_Keys.size(); i++)
+  {
+    if (!found[i])
+    {
+      this->Reset(i, pObject);
+
+      TINIIssue issue;
+      issue.Type = II_MISSING;
+      issue.Section = m_Keys[i].Section;
+      issue.Key = m_Keys[i].Key;
+      Issues.push_back(issue);
+    }
+  }
+
+  return Issues.size() == count;
+}
+
+/**
+ * The parsers of the values.
+ */
+
+static bool ParseUnsigned(const CStringViewA& Text, uint64& Value, bool& Negative)
+{
+  const char* s = Text.Data();
+  const char* e = s + Text.Size();
+
+  Negative = false;
+  if (s != e && (*s == '-' || *s == '+'))
+  {
+    Negative = *s++ == '-';
+  }
+
+  uint base = 10;
+  if (e - s > 2 && s[0] == '0' && (s[1] == 'x' || s[1] == 'X'))
+  {
+    base = 16;
+    s += 2;
+  }
+
+  if (s == e)
+  {
+    return false;
+  }
+
+  uint64 result = 0;
+
+  for (; s < e; s++)
+  {
+    const char c = *s;
+    const uint d = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 : c >= 'A' && c <= 'F' ? c - 'A' + 10 : 16;
+    if (d >= base || result > (~uint64(0) - d) / base)
+    {
+      return false;
+    }
+
+    result = result * base + d;
+  }
+
+  Value = result;
+
+  return true;
+}
+
+template <typename T>
+static bool ParseInteger(const CStringViewA& Text, T& Value, const int64 Min, const uint64 Max)
+{
+  uint64 v = 0;
+  bool negative = false;
+
+  if (!ParseUnsigned(Text, v, negative))
+  {
+    return false;
+  }
+
+  if (negative ? (Min == 0 ? v != 0 : v > uint64(-(Min + 1)) + 1) : v > Max)
+  {
+    return false;
+  }
+
+  Value = negative ? T(0 - v) : T(v);
+
+  return true;
+}
+
+template <typename T>
+static bool ParseReal(const CStringViewA& Text, T& Value)
+{
+  char s[64];
+  if (Text.Empty() || Text.Size() >= sizeof(s))
+  {
+    return false;
+  }
+
+  memcpy(s, Text.Data(), Text.Size());
+  s[Text.Size()] = '\0';
+
+  char* e = nullptr;
+  const double v = strtod(s, &e);
+  if (e != s + Text.Size())
+  {
+    return false;
+  }
+
+  const double max = double(std::numeric_limits<T>::max());
+  if (v != v || v > max || v < -max) // NaN is not ordered, it passes the range check
+  {
+    return false;
+  }
+
+  Value = T(v);
+
+  return true;
+}
+
+bool CINISchema::Parse(const CStringViewA& Text, bool& Value)
+{
+  static const char* trues[]  = { "1", "true", "yes", "on" };
+  static const char* falses[] = { "0", "false", "no", "off" };
+
+  for (size_t i = 0; i < _countof(trues); i++)
+  {
+    if (EqualsName(Text, trues[i]))
+    {
+      Value = true;
+      return true;
+    }
+
+    if (EqualsName(Text, falses[i]))
+    {
+      Value = false;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool CINISchema::Parse(const CStringViewA& Text, int& Value)
+{
+  return ParseInteger(Text, Value, INT_MIN, INT_MAX);
+}
+
+bool CINISchema::Parse(const CStringViewA& Text, uint& Value)
+{
+  return ParseInteger(Text, Value, 0, UINT_MAX);
+}
+
+bool CINISchema::Parse(const CStringViewA& Text, int64& Value)
+{
+  return ParseInteger(Text, Value, LLONG_MIN, LLONG_MAX);
+}
+
+bool CINISchema::Parse(const CStringViewA& Text, uint64& Value)
+{
+  return ParseInteger(Text, Value, 0, ULLONG_MAX);
+}
+
+bool CINISchema::Parse(const CStringViewA& Text, float& Value)
+{
+  return ParseReal(Text, Value);
+}
+
+bool CINISchema::Parse(const CStringViewA& Text, double& Value)
+{
+  return ParseReal(Text, Value);
+}
+
+bool CINISchema::Parse(const CStringViewA& Text, const bool ANSI, std::string& Value)
+{
+  Value = ANSI ? Text.ToString() : ToStringA(FromUTF8(Text.ToString()));
+  return true;
+}
+
+bool CINISchema::Parse(const CStringViewA& Text, const bool ANSI, std::wstring& Value)
+{
+  Value = ANSI ? ToStringW(Text.ToString()) : FromUTF8(Text.ToString());
+  return true;
+}
+
+} // namespace vu
@@ -5,132 +5,189 @@
  */
 
 #include "Vutils.h"
+#include "simd.h"
+#include "scan.h"
+
+#include <algorithm>
 
 namespace vu
 {
 
-CBuffer::CBuffer() : m_pData(nullptr), m_Size(0)
+/**
+ * CBufferView
+ */
+
+CBufferView::CBufferView() : m_pBytes(nullptr), m_Size(0)
 {
-  this->Create(nullptr, 0);
 }
 
-CBuffer::CBuffer(const size_t size) : m_pData(nullptr), m_Size(0)
+CBufferView::CBufferView(const void* pData, const size_t size)
+  : m_pBytes(static_cast<const byte*>(pData)), m_Size(pData != nullptr ? size : 0)
 {
-  this->Create(nullptr, size);
 }
 
-CBuffer::CBuffer(const void* pData, const size_t size) : m_pData(nullptr), m_Size(0)
+CBufferView::CBufferView(const CBuffer& buffer) : m_pBytes(buffer.GetpBytes()), m_Size(buffer.GetSize())
 {
-  this->Replace(pData, size);
 }
 
-CBuffer::CBuffer(const CBuffer& right) : m_pData(nullptr), m_Size(0)
+bool CBufferView::operator==(const CBufferView& right) const
 {
-  *this = right;
+  if (m_Size != right.m_Size)
+  {
+    return false;
+  }
+
+  return m_Size == 0 || memcmp(m_pBytes, right.m_pBytes, m_Size) == 0;
 }
 
-CBuffer::~CBuffer()
+bool CBufferView::operator!=(const CBufferView& right) const
 {
-  this->Delete();
+  return !(*this == right);
 }
 
-const CBuffer& CBuffer::operator=(const CBuffer& right)
+const byte& CBufferView::operator[](const size_t offset) const
 {
-  if (*this != right)
+  if (m_Size == 0 || offset >= m_Size)
   {
-    if (this->Create(nullptr, right.m_Size))
-    {
-      if (right.m_pData != nullptr)
-      {
-        memcpy_s(m_pData, m_Size, right.m_pData, right.m_Size);
-      }
-    }
+    throw std::out_of_range(static_cast<const char*>("invalid size or offset"));
   }
 
-  return *this;
+  return m_pBytes[offset];
 }
 
-bool CBuffer::operator==(const CBuffer& right) const
+CBufferView CBufferView::operator()(int begin, int end) const
 {
-  if (m_Size != right.m_Size)
-  {
-    return false;
-  }
+  return this->Slice(begin, end);
+}
 
-  return memcmp(m_pData, right.m_pData, m_Size) == 0;
+const byte* CBufferView::GetpBytes() const
+{
+  return m_Size != 0 ? m_pBytes : nullptr;
 }
 
-bool CBuffer::operator!=(const CBuffer& right) const
+const void* CBufferView::GetpData() const
 {
-  return !(*this == right);
+  return this->GetpBytes();
 }
 
-byte& CBuffer::operator[](const size_t offset)
+size_t CBufferView::GetSize() const
 {
-  if (m_pData == nullptr)
-  {
-    throw std::runtime_error(static_cast<const char*>("invalid pointer"));
-  }
+  return m_Size;
+}
 
-  if (m_Size == 0 || offset >= m_Size)
+bool CBufferView::Empty() const
+{
+  return m_Size == 0;
+}
+
+size_t CBufferView::Find(const void* pdata, const size_t size) const
+{
+  return SIMDFind(m_pBytes, m_Size, pdata, size);
+}
+
+size_t CBufferView::Find(const CBufferView& view) const
+{
+  return this->Find(view.m_pBytes, view.m_Size);
+}
+
+size_t CBufferView::FindNext(const void* pdata, const size_t size, const size_t offset) const
+{
+  if (offset >= m_Size)
   {
-    throw std::out_of_range(static_cast<const char*>("invalid size or offset"));
+    return -1;
   }
 
-  return static_cast<byte*>(m_pData)[offset];
+  const size_t result = SIMDFind(m_pBytes + offset, m_Size - offset, pdata, size);
+  return result != -1 ? offset + result : result;
 }
 
-CBuffer CBuffer::operator()(int begin, int end) const
+size_t CBufferView::FindNext(const CBufferView& view, const size_t offset) const
 {
-  return this->Slice(begin, end);
+  return this->FindNext(view.m_pBytes, view.m_Size, offset);
 }
 
-size_t CBuffer::Find(const void* pdata, const size_t size) const
+size_t CBufferView::RFind(const void* pdata, const size_t size) const
 {
-  size_t result = -1;
+  return SIMDRFind(m_pBytes, m_Size, pdata, size);
+}
 
-  if (m_pData == nullptr || m_Size == 0 || pdata == nullptr || size == 0 || m_Size < size)
-  {
-    return result;
-  }
+size_t CBufferView::RFind(const CBufferView& view) const
+{
+  return this->RFind(view.m_pBytes, view.m_Size);
+}
+
+std::vector<size_t> CBufferView::FindAll(const void* pdata, const size_t size) const
+{
+  std::vector<size_t> result;
 
-  const auto pbytes = this->GetpBytes();
+  // The occurrences may overlap, each one is searched from the byte after the previous one
 
-  for (size_t i = 0; i <= m_Size - size; i++)
+  for (size_t offset = this->Find(pdata, size); offset != -1; offset = this->FindNext(pdata, size, offset + 1))
   {
-    if (memcmp(reinterpret_cast<const void*>(pbytes + i), pdata, size) == 0)
-    {
-      result = i;
-      break;
-    }
+    result.push_back(offset);
   }
 
   return result;
 }
 
-bool CBuffer::Match(const void* pdata, const size_t size) const
+std::vector<size_t> CBufferView::FindAll(const CBufferView& view) const
+{
+  return this->FindAll(view.m_pBytes, view.m_Size);
+}
+
+size_t CBufferView::FindParallel(const CBufferView& view, const size_t nthreads) const
+{
+  const auto fnFind = [&](const byte* ptr, const size_t size) -> size_t
+  {
+    return SIMDFind(ptr, size, view.m_pBytes, view.m_Size);
+  };
+
+  return ParallelFind(m_pBytes, m_Size, view.m_Size, fnFind, nthreads);
+}
+
+std::vector<size_t> CBufferView::FindAllParallel(const CBufferView& view, const size_t nthreads) const
+{
+  const auto fnFind = [&](const byte* ptr, const size_t size) -> size_t
+  {
+    return SIMDFind(ptr, size, view.m_pBytes, view.m_Size);
+  };
+
+  return ParallelFindAll(m_pBytes, m_Size, view.m_Size, fnFind, nthreads);
+}
+
+bool CBufferView::Match(const void* pdata, const size_t size) const
 {
   return this->Find(pdata, size) != -1;
 }
 
-CBuffer CBuffer::Till(const void* pdata, const size_t size) const
+bool CBufferView::Match(const CBufferView& view) const
+{
+  return this->Match(view.m_pBytes, view.m_Size);
+}
+
+CBufferView CBufferView::Till(const void* pdata, const size_t size) const
 {
-  CBuffer result;
+  CBufferView result;
 
   size_t offset = this->Find(pdata, size);
-  if (offset > 0)
+  if (offset != -1 && offset > 0)
   {
-    result.Create(m_pData, offset);
+    result = CBufferView(m_pBytes, offset);
   }
 
   return result;
 }
 
-CBuffer CBuffer::Slice(int begin, int end) const
+CBufferView CBufferView::Till(const CBufferView& view) const
 {
-  CBuffer result;
+  return this->Till(view.m_pBytes, view.m_Size);
+}
 
-  if (m_pData == nullptr || m_Size == 0)
+CBufferView CBufferView::Slice(int begin, int end) const
+{
+  CBufferView result;
+
+  if (m_Size == 0)
   {
     return result;
   }
@@ -157,19 +214,224 @@ CBuffer CBuffer::Slice(int begin, int end) const
     return result;
   }
 
-  result.Create(this->GetpBytes() + begin, size);
+  result = CBufferView(m_pBytes + begin, size);
 
   return result;
 }
 
+CBuffer CBufferView::ToBuffer() const
+{
+  return CBuffer(m_pBytes, m_Size);
+}
+
+std::string CBufferView::ToStringA() const
+{
+  return std::string(reinterpret_cast<const char*>(m_pBytes), m_Size / sizeof(char));
+}
+
+std::wstring CBufferView::ToStringW() const
+{
+  return std::wstring(reinterpret_cast<const wchar*>(m_pBytes), m_Size / sizeof(wchar));
+}
+
+/**
+ * CBuffer
+ */
+
+CBuffer::CBuffer() : m_pAllocator(nullptr), m_pData(m_Small), m_Size(0), m_Capacity(SMALL_SIZE)
+{
+}
+
+CBuffer::CBuffer(const size_t size, const bool initialize, CAllocator* pAllocator)
+  : m_pAllocator(pAllocator), m_pData(m_Small), m_Size(0), m_Capacity(SMALL_SIZE)
+{
+  this->Create(nullptr, size, initialize);
+}
+
+CBuffer::CBuffer(const void* pData, const size_t size) : m_pAllocator(nullptr), m_pData(m_Small), m_Size(0), m_Capacity(SMALL_SIZE)
+{
+  this->Replace(pData, size);
+}
+
+CBuffer::CBuffer(const CBuffer& right) : m_pAllocator(right.m_pAllocator), m_pData(m_Small), m_Size(0), m_Capacity(SMALL_SIZE)
+{
+  *this = right;
+}
+
+CBuffer::CBuffer(CBuffer&& right) : m_pAllocator(right.m_pAllocator), m_pData(m_Small), m_Size(0), m_Capacity(SMALL_SIZE)
+{
+  *this = std::move(right);
+}
+
+CBuffer::~CBuffer()
+{
+  this->Delete();
+}
+
+const CBuffer& CBuffer::operator=(const CBuffer& right)
+{
+  if (this != &right)
+  {
+    this->Create(right.m_pData, right.m_Size);
+  }
+
+  return *this;
+}
+
+const CBuffer& CBuffer::operator=(CBuffer&& right)
+{
+  if (this == &right)
+  {
+    return *this;
+  }
+
+  if (right.m_pData == right.m_Small || right.m_pAllocator != m_pAllocator)
+  {
+    // The inline storage cannot be stolen, but it is small enough to copy
+    // A block of another allocator cannot be stolen either, it must be released by its owner
+
+    this->Create(right.m_pData, right.m_Size);
+  }
+  else
+  {
+    this->Delete();
+
+    m_pData = right.m_pData;
+    m_Size  = right.m_Size;
+    m_Capacity = right.m_Capacity;
+
+    right.m_pData = right.m_Small;
+    right.m_Capacity = SMALL_SIZE;
+  }
+
+  right.m_Size = 0;
+
+  return *this;
+}
+
+bool CBuffer::operator==(const CBuffer& right) const
+{
+  if (m_Size != right.m_Size)
+  {
+    return false;
+  }
+
+  return memcmp(m_pData, right.m_pData, m_Size) == 0;
+}
+
+bool CBuffer::operator!=(const CBuffer& right) const
+{
+  return !(*this == right);
+}
+
+byte& CBuffer::operator[](const size_t offset)
+{
+  if (m_Size == 0 || offset >= m_Size)
+  {
+    throw std::out_of_range(static_cast<const char*>("invalid size or offset"));
+  }
+
+  return static_cast<byte*>(m_pData)[offset];
+}
+
+CBuffer CBuffer::operator()(int begin, int end) const
+{
+  return this->Slice(begin, end);
+}
+
+size_t CBuffer::Find(const void* pdata, const size_t size) const
+{
+  return this->View().Find(pdata, size);
+}
+
+size_t CBuffer::Find(const CBufferView& view) const
+{
+  return this->View().Find(view);
+}
+
+size_t CBuffer::FindNext(const void* pdata, const size_t size, const size_t offset) const
+{
+  return this->View().FindNext(pdata, size, offset);
+}
+
+size_t CBuffer::FindNext(const CBufferView& view, const size_t offset) const
+{
+  return this->View().FindNext(view, offset);
+}
+
+size_t CBuffer::RFind(const void* pdata, const size_t size) const
+{
+  return this->View().RFind(pdata, size);
+}
+
+size_t CBuffer::RFind(const CBufferView& view) const
+{
+  return this->View().RFind(view);
+}
+
+std::vector<size_t> CBuffer::FindAll(const void* pdata, const size_t size) const
+{
+  return this->View().FindAll(pdata, size);
+}
+
+std::vector<size_t> CBuffer::FindAll(const CBufferView& view) const
+{
+  return this->View().FindAll(view);
+}
+
+size_t CBuffer::FindParallel(const CBufferView& view, const size_t nthreads) const
+{
+  return this->View().FindParallel(view, nthreads);
+}
+
+std::vector<size_t> CBuffer::FindAllParallel(const CBufferView& view, const size_t nthreads) const
+{
+  return this->View().FindAllParallel(view, nthreads);
+}
+
+bool CBuffer::Match(const void* pdata, const size_t size) const
+{
+  return this->View().Match(pdata, size);
+}
+
+bool CBuffer::Match(const CBufferView& view) const
+{
+  return this->View().Match(view);
+}
+
+CBuffer CBuffer::Till(const void* pdata, const size_t size) const
+{
+  return this->View().Till(pdata, size).ToBuffer();
+}
+
+CBuffer CBuffer::Till(const CBufferView& view) const
+{
+  return this->View().Till(view).ToBuffer();
+}
+
+CBuffer CBuffer::Slice(int begin, int end) const
+{
+  return this->View(begin, end).ToBuffer();
+}
+
+CBufferView CBuffer::View() const
+{
+  return CBufferView(*this);
+}
+
+CBufferView CBuffer::View(int begin, int end) const
+{
+  return this->View().Slice(begin, end);
+}
+
 byte* CBuffer::GetpBytes() const
 {
-  return static_cast<byte*>(m_pData);
+  return static_cast<byte*>(this->GetpData());
 }
 
 void* CBuffer::GetpData() const
 {
-  return m_pData;
+  return m_Size != 0 ? m_pData : nullptr;
 }
 
 size_t CBuffer::GetSize() const
@@ -177,53 +439,122 @@ size_t CBuffer::GetSize() const
   return m_Size;
 }
 
-bool CBuffer::Create(void* ptr, const size_t size, const bool clean)
+size_t CBuffer::GetCapacity() const
+{
+  return m_Capacity;
+}
+
+CAllocator* CBuffer::GetAllocator() const
+{
+  return m_pAllocator;
+}
+
+CAllocator& CBuffer::Allocator() const
+{
+  return m_pAllocator != nullptr ? *m_pAllocator : CHeapAllocator::Instance();
+}
+
+bool CBuffer::Create(const void* ptr, const size_t size, const bool initialize)
 {
-  if (clean || size == 0)
+  if (size > m_Capacity)
   {
-    this->Delete();
+    m_Size = 0; // The content will be replaced, so nothing to keep while reallocating
+    this->Reallocate(size);
   }
 
-  if (size == 0)
+  if (ptr == nullptr)
   {
-    return false;
+    if (initialize)
+    {
+      memset(m_pData, 0, size);
+    }
+  }
+  else if (ptr != m_pData)
+  {
+    memmove(m_pData, ptr, size); // The source might be a part of this buffer
+  }
+
+  m_Size = size;
+
+  return true;
+}
+
+bool CBuffer::Reallocate(const size_t capacity)
+{
+  assert(capacity >= m_Size);
+
+  const bool small = m_pData == m_Small;
+
+  if (capacity <= SMALL_SIZE)
+  {
+    if (!small)
+    {
+      memcpy_s(m_Small, SMALL_SIZE, m_pData, m_Size);
+      this->Allocator().Free(m_pData, m_Capacity);
+      m_pData = m_Small;
+    }
+
+    m_Capacity = SMALL_SIZE;
+
+    return true;
   }
 
-  if (clean)
+  auto& allocator = this->Allocator();
+
+  void* ptr = nullptr;
+
+  if (small)
   {
-    m_pData = std::calloc(m_Size = size, 1);
+    ptr = allocator.Allocate(capacity);
+    if (ptr != nullptr && m_Size != 0)
+    {
+      memcpy_s(ptr, capacity, m_Small, m_Size);
+    }
   }
   else
   {
-    m_pData = std::realloc(ptr, m_Size = size);
+    ptr = allocator.Reallocate(m_pData, m_Capacity, capacity);
   }
 
-  if (m_pData == nullptr)
+  if (ptr == nullptr)
   {
     throw std::bad_alloc();
   }
 
-  if (ptr == nullptr)
+  m_pData = ptr;
+  m_Capacity = capacity;
+
+  return true;
+}
+
+bool CBuffer::Grow(const size_t size)
+{
+  if (size <= m_Capacity)
   {
-    memset(m_pData, 0, m_Size);
+    return true;
   }
-  else if (clean)
+
+  // Grow geometrically, so a sequence of appends costs amortized O(1) per byte
+
+  size_t capacity = m_Capacity + m_Capacity / 2;
+  if (capacity < size)
   {
-    memcpy_s(m_pData, m_Size, ptr, size);
+    capacity = size;
   }
 
-  return true;
+  return this->Reallocate(capacity);
 }
 
 bool CBuffer::Delete()
 {
-  if (m_pData != nullptr)
+  if (m_pData != m_Small)
   {
-    std::free(m_pData);
+    this->Allocator().Free(m_pData, m_Capacity);
   }
 
-  m_pData = nullptr;
+  m_pData = m_Small;
   m_Size  = 0;
+  m_Capacity = SMALL_SIZE;
 
   return true;
 }
@@ -235,43 +566,62 @@ void CBuffer::Reset()
 
 void CBuffer::Fill(const byte v)
 {
-  if (m_pData != nullptr && m_Size != 0)
+  if (m_Size != 0)
   {
     memset(m_pData, v, m_Size);
   }
 }
 
-bool CBuffer::Resize(const size_t size)
+bool CBuffer::Resize(const size_t size, const bool initialize)
 {
-  if (size == m_Size)
+  if (size > m_Size)
+  {
+    this->Grow(size);
+
+    if (initialize)
+    {
+      memset(static_cast<byte*>(m_pData) + m_Size, 0, size - m_Size);
+    }
+  }
+
+  m_Size = size;
+
+  return true;
+}
+
+bool CBuffer::Reserve(const size_t size)
+{
+  if (size <= m_Capacity)
   {
     return true;
   }
 
-  return this->Create(m_pData, size, false);
+  return this->Reallocate(size);
 }
 
-bool CBuffer::Replace(const void* pData, const size_t size)
+bool CBuffer::ShrinkToFit()
 {
-  if (this->Create(nullptr, size))
+  if (m_Capacity == m_Size || m_pData == m_Small)
   {
-    if (pData != nullptr)
-    {
-      memcpy_s(m_pData, m_Size, pData, size);
-    }
+    return true;
   }
 
-  return true;
+  return this->Reallocate(m_Size);
 }
 
-bool CBuffer::Replace(const CBuffer& right)
+bool CBuffer::Replace(const void* pData, const size_t size)
 {
-  return this->Replace(right.GetpData(), right.GetSize());
+  return this->Create(pData, size);
+}
+
+bool CBuffer::Replace(const CBufferView& view)
+{
+  return this->Replace(view.GetpData(), view.GetSize());
 }
 
 bool CBuffer::Empty() const
 {
-  return m_pData == nullptr || m_Size == 0;
+  return m_Size == 0;
 }
 
 bool CBuffer::Append(const void* pData, const size_t size)
@@ -281,28 +631,42 @@ bool CBuffer::Append(const void* pData, const size_t size)
     return false;
   }
 
+  // The source might be a part of this buffer that moves while growing
+
+  auto ptr = static_cast<const byte*>(pData);
+  const auto pbytes = static_cast<const byte*>(m_pData);
+  const bool inside = ptr >= pbytes && ptr < pbytes + m_Size;
+  const size_t offset = inside ? size_t(ptr - pbytes) : 0;
+
   const size_t PrevSize = m_Size;
 
-  this->Resize(m_Size + size);
+  this->Grow(m_Size + size);
 
-  memcpy_s(this->GetpBytes() + PrevSize, size, pData, size);
+  if (inside)
+  {
+    ptr = static_cast<const byte*>(m_pData) + offset;
+  }
+
+  memcpy_s(static_cast<byte*>(m_pData) + PrevSize, m_Capacity - PrevSize, ptr, size);
+
+  m_Size += size;
 
   return true;
 }
 
-bool CBuffer::Append(const CBuffer& right)
+bool CBuffer::Append(const CBufferView& view)
 {
-  return this->Append(right.GetpData(), right.GetSize());
+  return this->Append(view.GetpData(), view.GetSize());
 }
 
 std::string CBuffer::ToStringA() const
 {
-  return std::string(reinterpret_cast<const char*>(m_pData), m_Size / sizeof(char));
+  return this->View().ToStringA();
 }
 
 std::wstring CBuffer::ToStringW() const
 {
-  return std::wstring(reinterpret_cast<const wchar*>(m_pData), m_Size / sizeof(wchar));
+  return this->View().ToStringW();
 }
 
 bool CBuffer::SaveAsFile(const std::string& filePath)
@@ -314,9 +678,20 @@ bool CBuffer::SaveAsFile(const std::string& filePath)
 
   bool result = true;
 
+  #ifdef _WIN32
   CFileSystemA file(filePath, vu::FM_CREATEALWAY);
   result &= file.Write(m_pData, ulong(m_Size));
   result &= file.Close();
+  #else  // POSIX
+  FILE* pFile = fopen(filePath.c_str(), "wb");
+  if (pFile == nullptr)
+  {
+    return false;
+  }
+
+  result &= m_Size == 0 || fwrite(m_pData, m_Size, 1, pFile) == 1;
+  result &= fclose(pFile) == 0;
+  #endif // _WIN32
 
   return result;
 }
@@ -327,4 +702,259 @@ bool CBuffer::SaveAsFile(const std::wstring& filePath)
   return this->SaveAsFile(s);
 }
 
+/**
+ * CChainBuffer
+ */
+
+CChainBuffer::CChainBuffer(const size_t segmentsize, CAllocator* pAllocator)
+  : m_SegmentSize(segmentsize != 0 ? segmentsize : DEFAULT_SEGMENT_SIZE)
+  , m_pAllocator(pAllocator), m_Offset(0), m_Used(0), m_Size(0)
+{
+}
+
+CChainBuffer::CChainBuffer(const CChainBuffer& right)
+  : m_SegmentSize(right.m_SegmentSize), m_pAllocator(right.m_pAllocator), m_Offset(0), m_Used(0), m_Size(0)
+{
+  *this = right;
+}
+
+CChainBuffer::CChainBuffer(CChainBuffer&& right)
+  : m_SegmentSize(right.m_SegmentSize), m_pAllocator(right.m_pAllocator), m_Offset(0), m_Used(0), m_Size(0)
+{
+  *this = std::move(right);
+}
+
+CChainBuffer::~CChainBuffer()
+{
+}
+
+const CChainBuffer& CChainBuffer::operator=(const CChainBuffer& right)
+{
+  if (this != &right)
+  {
+    this->Reset();
+
+    // Copies the data only, so the copy is as compact as possible
+
+    for (const auto& block : right.GetBlocks())
+    {
+      this->Append(block.Address, block.Size);
+    }
+  }
+
+  return *this;
+}
+
+const CChainBuffer& CChainBuffer::operator=(CChainBuffer&& right)
+{
+  if (this != &right)
+  {
+    m_SegmentSize = right.m_SegmentSize;
+    m_pAllocator  = right.m_pAllocator;
+    m_Segments    = std::move(right.m_Segments);
+    m_Offset = right.m_Offset;
+    m_Used   = right.m_Used;
+    m_Size   = right.m_Size;
+
+    right.Reset();
+  }
+
+  return *this;
+}
+
+size_t CChainBuffer::GetSize() const
+{
+  return m_Size;
+}
+
+size_t CChainBuffer::GetCount() const
+{
+  return m_Segments.size();
+}
+
+size_t CChainBuffer::GetSegmentSize() const
+{
+  return m_SegmentSize;
+}
+
+bool CChainBuffer::Empty() const
+{
+  return m_Size == 0;
+}
+
+void CChainBuffer::Reset()
+{
+  m_Segments.clear();
+  m_Offset = 0;
+  m_Used = 0;
+  m_Size = 0;
+}
+
+void CChainBuffer::Append(const void* ptr, const size_t size)
+{
+  if (ptr == nullptr)
+  {
+    return;
+  }
+
+  auto pBytes = static_cast<const byte*>(ptr);
+
+  size_t remain = size;
+  while (remain != 0)
+  {
+    size_t available = 0;
+    auto pTail = this->Prepare(available);
+
+    const size_t n = std::min(available, remain);
+    memcpy(pTail, pBytes, n);
+    this->Commit(n);
+
+    pBytes += n;
+    remain -= n;
+  }
+}
+
+void CChainBuffer::Append(const CBufferView& data)
+{
+  this->Append(data.GetpData(), data.GetSize());
+}
+
+byte* CChainBuffer::Prepare(size_t& size)
+{
+  if (m_Segments.empty() || m_Used == m_Segments.back().GetSize())
+  {
+    m_Segments.push_back(CBuffer(m_SegmentSize, false, m_pAllocator));
+    m_Used = 0;
+  }
+
+  auto& segment = m_Segments.back();
+
+  size = segment.GetSize() - m_Used;
+
+  return segment.GetpBytes() + m_Used;
+}
+
+void CChainBuffer::Commit(const size_t size)
+{
+  if (size == 0 || m_Segments.empty())
+  {
+    return;
+  }
+
+  assert(m_Used + size <= m_Segments.back().GetSize());
+
+  m_Used += size;
+  m_Size += size;
+}
+
+void CChainBuffer::Consume(const size_t size)
+{
+  size_t remain = std::min(size, m_Size);
+
+  while (remain != 0)
+  {
+    const size_t end = m_Segments.size() == 1 ? m_Used : m_Segments.front().GetSize();
+    const size_t available = end - m_Offset;
+    if (remain < available)
+    {
+      m_Offset += remain;
+      m_Size -= remain;
+      break;
+    }
+
+    m_Segments.pop_front();
+    m_Offset = 0;
+    m_Size -= available;
+    remain -= available;
+  }
+
+  if (m_Size == 0)
+  {
+    this->Reset();
+  }
+}
+
+std::vector<TBlock> CChainBuffer::GetBlocks() const
+{
+  std::vector<TBlock> result;
+  result.reserve(m_Segments.size());
+
+  for (size_t i = 0; i < m_Segments.size(); i++)
+  {
+    const size_t begin = i == 0 ? m_Offset : 0;
+    const size_t end = i == m_Segments.size() - 1 ? m_Used : m_Segments[i].GetSize();
+    if (end > begin)
+    {
+      TBlock block;
+      block.Address = m_Segments[i].GetpBytes() + begin;
+      block.Size = end - begin;
+      result.push_back(block);
+    }
+  }
+
+  return result;
+}
+
+size_t CChainBuffer::CopyTo(void* ptr, const size_t size, const size_t offset) const
+{
+  if (ptr == nullptr || offset >= m_Size)
+  {
+    return 0;
+  }
+
+  auto pBytes = static_cast<byte*>(ptr);
+
+  size_t skip = offset;
+  size_t copied = 0;
+
+  for (const auto& block : this->GetBlocks())
+  {
+    if (copied == size)
+    {
+      break;
+    }
+
+    if (skip >= block.Size)
+    {
+      skip -= block.Size;
+      continue;
+    }
+
+    const size_t n = std::min(size_t(block.Size - skip), size - copied);
+    memcpy(pBytes + copied, static_cast<const byte*>(block.Address) + skip, n);
+
+    copied += n;
+    skip = 0;
+  }
+
+  return copied;
+}
+
+CBuffer CChainBuffer::ToBuffer() const
+{
+  CBuffer result(m_Size, false, m_pAllocator);
+  this->CopyTo(result.GetpData(), result.GetSize());
+  return result;
+}
+
+CBufferView CChainBuffer::Linearize()
+{
+  if (m_Segments.size() > 1 || m_Offset != 0)
+  {
+    auto buffer = this->ToBuffer();
+
+    m_Segments.clear();
+    m_Segments.push_back(std::move(buffer));
+    m_Offset = 0;
+    m_Used = m_Size;
+  }
+
+  if (m_Segments.empty())
+  {
+    return CBufferView();
+  }
+
+  return CBufferView(m_Segments.front().GetpBytes(), m_Used);
+}
+
 } // namespace vu
\ No newline at end of file
@@ -5,11 +5,16 @@
  */
 
 #include "Vutils.h"
+
+#ifdef _WIN32
 #include "lazy.h"
+#endif // _WIN32
 
 namespace vu
 {
 
+#ifdef _WIN32
+
 bool vuapi IsAdministrator()
 {
   BOOL IsMember = FALSE;
@@ -169,30 +174,9 @@ std::wstring vuapi GetEnviromentW(const std::wstring EnvName)
   return s;
 }
 
-typedef std::vector<std::pair<bool, byte>> TPattern;
+#endif // _WIN32
 
-const TPattern ToPattern(const std::string& Buffer)
-{
-  TPattern result;
-
-  const auto l = vu::SplitStringA(Buffer, " ");
-  for (const auto& e : l)
-  {
-    auto v = TPattern::value_type(false, 0x00);
-
-    if (e.length() == 2 && isxdigit(e[0]) && isxdigit(e[1]))
-    {
-      v.first  = true;
-      v.second = (byte)strtoul(e.c_str(), nullptr, 16);
-    }
-
-    result.emplace_back(v);
-  }
-
-  return result;
-}
-
-std::pair<bool, size_t> FindPatternA(const CBuffer& Buffer, const std::string& Pattern)
+std::pair<bool, size_t> FindPatternA(const CBufferView& Buffer, const std::string& Pattern)
 {
   std::pair<bool, size_t> result(false, 0);
 
@@ -201,13 +185,13 @@ std::pair<bool, size_t> FindPatternA(const CBuffer& Buffer, const std::string& P
     return result;
   }
 
-  const auto Pointer = static_cast<const byte*>(Buffer.GetpData());
+  const auto Pointer = Buffer.GetpBytes();
   const size_t Size = Buffer.GetSize();
 
   return FindPatternA(Pointer, Size, Pattern);
 }
 
-std::pair<bool, size_t> FindPatternW(const CBuffer& Buffer, const std::wstring& Pattern)
+std::pair<bool, size_t> FindPatternW(const CBufferView& Buffer, const std::wstring& Pattern)
 {
   const auto s = ToStringA(Pattern);
   return FindPatternA(Buffer, s);
@@ -222,32 +206,16 @@ std::pair<bool, size_t> FindPatternA(const void* Pointer, const size_t Size, con
     return result;
   }
 
-  const auto pattern = ToPattern(Pattern);
-  if (pattern.empty())
+  const CBytePattern pattern(Pattern);
+  if (pattern.Empty())
   {
     return result;
   }
 
-  const auto pointer = static_cast<const byte*>(Pointer);
-  const size_t size = Size;
-
-  for (size_t i = 0; i < size; ++i)
+  const size_t offset = pattern.Find(Pointer, Size);
+  if (offset != -1)
   {
-    size_t j = 0;
-
-    for (j = 0; j < pattern.size(); ++j)
-    {
-      if (pattern[j].first && pattern[j].second != pointer[i + j])
-      {
-        break;
-      }
-    }
-
-    if (j == pattern.size())
-    {
-      result = std::make_pair(true, i);
-      break;
-    }
+    result = std::make_pair(true, offset);
   }
 
   return result;
@@ -0,0 +1,700 @@
+/**
+ * @file   pattern.cpp
+ * @author Vic P.
+ * @brief  Implementation for Byte Pattern
+ */
+
+#include "Vutils.h"
+#include "simd.h"
+#include "scan.h"
+
+#include <algorithm>
+
+namespace vu
+{
+
+/**
+ * The most common bytes in x86/x64 binaries, from the most common one.
+ * A byte that is not listed is considered rare and makes a better anchor.
+ */
+static const byte COMMON_BYTES[] =
+{
+  0x00, 0xFF, 0xCC, 0x48, 0x8B, 0x89, 0x24, 0x4C, 0x44, 0xE8, 0x0F, 0x01, 0x90, 0x83, 0x85, 0xC0,
+  0x08, 0x10, 0x20, 0x40, 0xC3, 0x74, 0x75, 0x45, 0x8D, 0x41, 0x49, 0x02, 0x04, 0x03, 0x33, 0xE9,
+};
+
+static size_t Commonness(const byte v)
+{
+  for (size_t i = 0; i < lengthof(COMMON_BYTES); i++)
+  {
+    if (COMMON_BYTES[i] == v)
+    {
+      return lengthof(COMMON_BYTES) - i;
+    }
+  }
+
+  return 0;
+}
+
+static size_t CountBits(byte v)
+{
+  size_t result = 0;
+
+  for (; v != 0; v &= v - 1)
+  {
+    result++;
+  }
+
+  return result;
+}
+
+static bool ParseNibble(const char c, byte& value, byte& mask)
+{
+  if (c == '?' || c == '*')
+  {
+    value = 0x0;
+    mask  = 0x0;
+  }
+  else if (isxdigit(byte(c)))
+  {
+    value = byte(isdigit(byte(c)) ? c - '0' : (tolower(byte(c)) - 'a' + 10));
+    mask  = 0xF;
+  }
+  else
+  {
+    return false;
+  }
+
+  return true;
+}
+
+CBytePattern::CBytePattern() : m_Size(0)
+{
+  m_Anchors[0] = m_Anchors[1] = 0;
+}
+
+CBytePattern::CBytePattern(const std::string& pattern) : m_Size(0)
+{
+  m_Anchors[0] = m_Anchors[1] = 0;
+  this->Parse(pattern);
+}
+
+CBytePattern::CBytePattern(const std::wstring& pattern) : m_Size(0)
+{
+  m_Anchors[0] = m_Anchors[1] = 0;
+  this->Parse(pattern);
+}
+
+CBytePattern::~CBytePattern()
+{
+}
+
+/**
+ * The pattern is a list of bytes separated by spaces.
+ * Each byte is 2 hex digits, a nibble can be a wildcard ('?' or '*') e.g. "4?" or "?F".
+ * A single '?' or '*' is a whole byte wildcard.
+ */
+bool CBytePattern::Parse(const std::string& pattern)
+{
+  m_Size = 0;
+  m_Anchors[0] = m_Anchors[1] = 0;
+  m_Values.clear();
+  m_Masks.clear();
+
+  for (size_t i = 0; i < pattern.size();)
+  {
+    if (isspace(byte(pattern[i])))
+    {
+      i++;
+      continue;
+    }
+
+    size_t n = 0;
+    while (i + n < pattern.size() && !isspace(byte(pattern[i + n])))
+    {
+      n++;
+    }
+
+    byte hv = 0, hm = 0, lv = 0, lm = 0;
+
+    if (n == 1 && (pattern[i] == '?' || pattern[i] == '*'))
+    {
+      // a whole byte wildcard
+    }
+    else if (n != 2 || !ParseNibble(pattern[i], hv, hm) || !ParseNibble(pattern[i + 1], lv, lm))
+    {
+      m_Values.clear();
+      m_Masks.clear();
+      return false;
+    }
+
+    m_Values.push_back(byte((hv << 4) | lv));
+    m_Masks.push_back(byte((hm << 4) | lm));
+
+    i += n;
+  }
+
+  m_Size = m_Values.size();
+
+  // Pads the arrays, so the SIMD routines can load them 16 bytes at a time
+
+  const size_t padded = VU_ALIGN_UP(m_Size, 16);
+  m_Values.resize(padded, 0);
+  m_Masks.resize(padded, 0);
+
+  this->SelectAnchors();
+
+  return m_Size != 0;
+}
+
+bool CBytePattern::Parse(const std::wstring& pattern)
+{
+  const auto s = ToStringA(pattern);
+  return this->Parse(s);
+}
+
+/**
+ * Selects the two most selective bytes (the most masked bits then the rarest value)
+ * that the SIMD routines compare at every position before verifying the whole pattern.
+ */
+void CBytePattern::SelectAnchors()
+{
+  const auto fnBetter = [&](const size_t i, const size_t j) -> bool
+  {
+    const auto bi = CountBits(m_Masks[i]), bj = CountBits(m_Masks[j]);
+    if (bi != bj)
+    {
+      return bi > bj;
+    }
+
+    return Commonness(m_Values[i]) < Commonness(m_Values[j]);
+  };
+
+  size_t first = 0;
+  for (size_t i = 1; i < m_Size; i++)
+  {
+    if (fnBetter(i, first))
+    {
+      first = i;
+    }
+  }
+
+  size_t second = first;
+  for (size_t i = 0; i < m_Size; i++)
+  {
+    if (i != first && (second == first || fnBetter(i, second)))
+    {
+      second = i;
+    }
+  }
+
+  m_Anchors[0] = first;
+  m_Anchors[1] = second;
+}
+
+bool CBytePattern::Empty() const
+{
+  return m_Size == 0;
+}
+
+size_t CBytePattern::GetSize() const
+{
+  return m_Size;
+}
+
+const std::vector<byte>& CBytePattern::GetValues() const
+{
+  return m_Values;
+}
+
+const std::vector<byte>& CBytePattern::GetMasks() const
+{
+  return m_Masks;
+}
+
+bool CBytePattern::Match(const void* ptr, const size_t size) const
+{
+  if (ptr == nullptr || m_Size == 0 || size < m_Size)
+  {
+    return false;
+  }
+
+  const auto pbytes = static_cast<const byte*>(ptr);
+
+  for (size_t i = 0; i < m_Size; i++)
+  {
+    if ((pbytes[i] & m_Masks[i]) != m_Values[i])
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+size_t CBytePattern::Find(const void* ptr, const size_t size) const
+{
+  if (m_Size == 0)
+  {
+    return -1;
+  }
+
+  return SIMDFindMasked(ptr, size, &m_Values[0], &m_Masks[0], m_Size, m_Anchors);
+}
+
+size_t CBytePattern::Find(const CBufferView& buffer) const
+{
+  return this->Find(buffer.GetpData(), buffer.GetSize());
+}
+
+size_t CBytePattern::FindNext(const CBufferView& buffer, const size_t offset) const
+{
+  if (offset >= buffer.GetSize())
+  {
+    return -1;
+  }
+
+  const size_t result = this->Find(buffer.GetpBytes() + offset, buffer.GetSize() - offset);
+  return result != -1 ? offset + result : result;
+}
+
+std::vector<size_t> CBytePattern::FindAll(const CBufferView& buffer) const
+{
+  std::vector<size_t> result;
+
+  for (size_t offset = this->Find(buffer); offset != -1; offset = this->FindNext(buffer, offset + 1))
+  {
+    result.push_back(offset);
+  }
+
+  return result;
+}
+
+size_t CBytePattern::FindParallel(const CBufferView& buffer, const size_t nthreads) const
+{
+  const auto fnFind = [&](const byte* ptr, const size_t size) -> size_t
+  {
+    return this->Find(ptr, size);
+  };
+
+  return ParallelFind(buffer.GetpData(), buffer.GetSize(), m_Size, fnFind, nthreads);
+}
+
+std::vector<size_t> CBytePattern::FindAllParallel(const CBufferView& buffer, const size_t nthreads) const
+{
+  const auto fnFind = [&](const byte* ptr, const size_t size) -> size_t
+  {
+    return this->Find(ptr, size);
+  };
+
+  return ParallelFindAll(buffer.GetpData(), buffer.GetSize(), m_Size, fnFind, nthreads);
+}
+
+bool CBytePattern::ScanStream(const FnStreamRead fnRead, const FnFound fnFound, const size_t blocksize) const
+{
+  if (m_Size == 0 || fnFound == nullptr)
+  {
+    return false;
+  }
+
+  // The window keeps the last m_Size - 1 bytes, so any match in it was not complete in the previous one
+  // (a match never fits in the carried bytes alone, they are not checked)
+
+  return StreamScan(fnRead, m_Size - 1, blocksize, [&](
+    const byte* ptr, const size_t size, const size_t /* carried */, const ulonglong base) -> bool
+  {
+    const CBufferView window(ptr, size);
+
+    for (size_t offset = this->Find(window); offset != -1; offset = this->FindNext(window, offset + 1))
+    {
+      if (!fnFound(base + offset))
+      {
+        return false;
+      }
+    }
+
+    return true;
+  });
+}
+
+bool CBytePattern::ScanFile(const std::string& filePath, const FnFound fnFound, const size_t blocksize) const
+{
+  #ifdef _WIN32
+  CFileSystemA file(filePath, FM_OPENEXISTING, FG_READ, FS_READ);
+  if (!file.IsReady())
+  {
+    return false;
+  }
+
+  return this->ScanStream(FileStreamReader(file), fnFound, blocksize);
+  #else  // POSIX
+  FILE* pFile = fopen(filePath.c_str(), "rb");
+  if (pFile == nullptr)
+  {
+    return false;
+  }
+
+  const bool result = this->ScanStream(FileStreamReader(pFile), fnFound, blocksize);
+  fclose(pFile);
+
+  return result;
+  #endif // _WIN32
+}
+
+bool CBytePattern::ScanFile(const std::wstring& filePath, const FnFound fnFound, const size_t blocksize) const
+{
+  #ifdef _WIN32
+  CFileSystemW file(filePath, FM_OPENEXISTING, FG_READ, FS_READ);
+  if (!file.IsReady())
+  {
+    return false;
+  }
+
+  return this->ScanStream(FileStreamReader(file), fnFound, blocksize);
+  #else  // POSIX
+  return this->ScanFile(ToUTF8(filePath), fnFound, blocksize);
+  #endif // _WIN32
+}
+
+/**
+ * CPatternSet
+ */
+
+static const uint32 NO_STATE = uint32(-1);
+
+CPatternSet::CPatternSet() : m_Built(false)
+{
+}
+
+CPatternSet::~CPatternSet()
+{
+}
+
+size_t CPatternSet::Add(const std::string& pattern)
+{
+  return this->Add(CBytePattern(pattern));
+}
+
+size_t CPatternSet::Add(const std::wstring& pattern)
+{
+  return this->Add(CBytePattern(pattern));
+}
+
+size_t CPatternSet::Add(const CBytePattern& pattern)
+{
+  if (pattern.Empty())
+  {
+    return -1;
+  }
+
+  m_Built = false;
+  m_Patterns.push_back(pattern);
+
+  return m_Patterns.size() - 1;
+}
+
+void CPatternSet::Clear()
+{
+  m_Built = false;
+  m_Patterns.clear();
+  m_Fragments.clear();
+  m_Unanchored.clear();
+  m_Delta.clear();
+  m_Outputs.clear();
+  m_OutputIndex.clear();
+}
+
+size_t CPatternSet::GetCount() const
+{
+  return m_Patterns.size();
+}
+
+const CBytePattern& CPatternSet::GetPattern(const size_t id) const
+{
+  return m_Patterns.at(id);
+}
+
+bool CPatternSet::Build()
+{
+  m_Built = false;
+  m_Fragments.clear();
+  m_Unanchored.clear();
+  m_Outputs.clear();
+  m_OutputIndex.clear();
+
+  if (m_Patterns.empty())
+  {
+    return false;
+  }
+
+  // Builds the trie of the longest concrete fragment of each pattern
+
+  std::vector<std::vector<uint32>> outputs(1);
+  m_Delta.assign(256, NO_STATE);
+
+  for (size_t id = 0; id < m_Patterns.size(); id++)
+  {
+    const auto& values = m_Patterns[id].GetValues();
+    const auto& masks  = m_Patterns[id].GetMasks();
+
+    TFragment fragment = { 0, 0 };
+
+    for (size_t i = 0, n = 0; i < m_Patterns[id].GetSize(); i++)
+    {
+      n = masks[i] == 0xFF ? n + 1 : 0;
+      if (n > fragment.Size)
+      {
+        fragment.Offset = i + 1 - n;
+        fragment.Size = n;
+      }
+    }
+
+    m_Fragments.push_back(fragment);
+
+    if (fragment.Size == 0)
+    {
+      m_Unanchored.push_back(id);
+      continue;
+    }
+
+    uint32 state = 0;
+
+    for (size_t i = fragment.Offset; i < fragment.Offset + fragment.Size; i++)
+    {
+      auto& next = m_Delta[state * 256 + values[i]];
+      if (next == NO_STATE)
+      {
+        next = uint32(outputs.size());
+        outputs.resize(outputs.size() + 1);
+        m_Delta.resize(m_Delta.size() + 256, NO_STATE);
+      }
+
+      state = m_Delta[state * 256 + values[i]];
+    }
+
+    outputs[state].push_back(uint32(id));
+  }
+
+  // Completes the transitions with the failure links (breadth-first), so the scan never backtracks
+
+  std::vector<uint32> failures(outputs.size(), 0);
+  std::vector<uint32> queue;
+  queue.reserve(outputs.size());
+
+  for (size_t v = 0; v < 256; v++)
+  {
+    auto& next = m_Delta[v];
+    if (next == NO_STATE)
+    {
+      next = 0;
+    }
+    else
+    {
+      queue.push_back(next);
+    }
+  }
+
+  for (size_t i = 0; i < queue.size(); i++)
+  {
+    const uint32 state = queue[i];
+    const uint32 failure = failures[state];
+
+    // The fragments that end at the failure state also end here
+
+    outputs[state].insert(outputs[state].end(), outputs[failure].cbegin(), outputs[failure].cend());
+
+    for (size_t v = 0; v < 256; v++)
+    {
+      auto& next = m_Delta[state * 256 + v];
+      if (next == NO_STATE)
+      {
+        next = m_Delta[failure * 256 + v];
+      }
+      else
+      {
+        failures[next] = m_Delta[failure * 256 + v];
+        queue.push_back(next);
+      }
+    }
+  }
+
+  m_OutputIndex.reserve(outputs.size() + 1);
+  for (const auto& e : outputs)
+  {
+    m_OutputIndex.push_back(uint32(m_Outputs.size()));
+    m_Outputs.insert(m_Outputs.end(), e.cbegin(), e.cend());
+  }
+  m_OutputIndex.push_back(uint32(m_Outputs.size()));
+
+  m_Built = true;
+
+  return true;
+}
+
+bool CPatternSet::Verify(
+  const byte* ptr, const size_t size, const size_t end, const size_t id, const FnMatch& fnMatch) const
+{
+  const auto& fragment = m_Fragments[id];
+  const auto& pattern  = m_Patterns[id];
+
+  if (end < fragment.Offset + fragment.Size)
+  {
+    return true;
+  }
+
+  const size_t offset = end - fragment.Size - fragment.Offset;
+  if (!pattern.Match(ptr + offset, size - offset))
+  {
+    return true;
+  }
+
+  return fnMatch(id, offset);
+}
+
+bool CPatternSet::Scan(const void* ptr, const size_t size, const FnMatch fnMatch) const
+{
+  if (!m_Built || ptr == nullptr || size == 0 || fnMatch == nullptr)
+  {
+    return false;
+  }
+
+  const auto pbytes = static_cast<const byte*>(ptr);
+
+  uint32 state = 0;
+
+  for (size_t i = 0; i < size; i++)
+  {
+    state = m_Delta[state * 256 + pbytes[i]];
+
+    for (uint32 j = m_OutputIndex[state]; j < m_OutputIndex[state + 1]; j++)
+    {
+      if (!this->Verify(pbytes, size, i + 1, m_Outputs[j], fnMatch))
+      {
+        return true;
+      }
+    }
+  }
+
+  for (const auto id : m_Unanchored)
+  {
+    const auto& pattern = m_Patterns[id];
+    const CBufferView buffer(ptr, size);
+
+    for (size_t offset = pattern.Find(buffer); offset != -1; offset = pattern.FindNext(buffer, offset + 1))
+    {
+      if (!fnMatch(id, offset))
+      {
+        return true;
+      }
+    }
+  }
+
+  return true;
+}
+
+bool CPatternSet::Scan(const CBufferView& buffer, const FnMatch fnMatch) const
+{
+  return this->Scan(buffer.GetpData(), buffer.GetSize(), fnMatch);
+}
+
+std::vector<TPatternMatch> CPatternSet::Scan(const void* ptr, const size_t size) const
+{
+  std::vector<TPatternMatch> result;
+
+  this->Scan(ptr, size, [&](const size_t id, const size_t offset) -> bool
+  {
+    const TPatternMatch match = { id, offset };
+    result.push_back(match);
+    return true;
+  });
+
+  // The fragments are found by their ends, so sorts the matches by their starts
+
+  std::sort(result.begin(), result.end(), [](const TPatternMatch& left, const TPatternMatch& right) -> bool
+  {
+    return left.Offset != right.Offset ? left.Offset < right.Offset : left.ID < right.ID;
+  });
+
+  return result;
+}
+
+std::vector<TPatternMatch> CPatternSet::Scan(const CBufferView& buffer) const
+{
+  return this->Scan(buffer.GetpData(), buffer.GetSize());
+}
+
+bool CPatternSet::ScanStream(const FnStreamRead fnRead, const FnStreamMatch fnMatch, const size_t blocksize) const
+{
+  if (!m_Built || fnMatch == nullptr)
+  {
+    return false;
+  }
+
+  size_t length = 0;
+  for (const auto& e : m_Patterns)
+  {
+    length = std::max(length, e.GetSize());
+  }
+
+  // The window keeps the last length - 1 bytes (of the longest pattern),
+  // so a match was already reported by the previous window if it ends in the carried bytes
+
+  return StreamScan(fnRead, length - 1, blocksize, [&](
+    const byte* ptr, const size_t size, const size_t carried, const ulonglong base) -> bool
+  {
+    bool next = true;
+
+    this->Scan(ptr, size, [&](const size_t id, const size_t offset) -> bool
+    {
+      if (offset + m_Patterns[id].GetSize() <= carried)
+      {
+        return true;
+      }
+
+      return next = fnMatch(id, base + offset);
+    });
+
+    return next;
+  });
+}
+
+bool CPatternSet::ScanFile(const std::string& filePath, const FnStreamMatch fnMatch, const size_t blocksize) const
+{
+  #ifdef _WIN32
+  CFileSystemA file(filePath, FM_OPENEXISTING, FG_READ, FS_READ);
+  if (!file.IsReady())
+  {
+    return false;
+  }
+
+  return this->ScanStream(FileStreamReader(file), fnMatch, blocksize);
+  #else  // POSIX
+  FILE* pFile = fopen(filePath.c_str(), "rb");
+  if (pFile == nullptr)
+  {
+    return false;
+  }
+
+  const bool result = this->ScanStream(FileStreamReader(pFile), fnMatch, blocksize);
+  fclose(pFile);
+
+  return result;
+  #endif // _WIN32
+}
+
+bool CPatternSet::ScanFile(const std::wstring& filePath, const FnStreamMatch fnMatch, const size_t blocksize) const
+{
+  #ifdef _WIN32
+  CFileSystemW file(filePath, FM_OPENEXISTING, FG_READ, FS_READ);
+  if (!file.IsReady())
+  {
+    return false;
+  }
+
+  return this->ScanStream(FileStreamReader(file), fnMatch, blocksize);
+  #else  // POSIX
+  return this->ScanFile(ToUTF8(filePath), fnMatch, blocksize);
+  #endif // _WIN32
+}
+
+} // namespace vu
@@ -6,7 +6,7 @@
 
 #include "Vutils.h"
 
-#include <cassert>
+#include <cstring>
 
 namespace vu
 {
@@ -29,6 +29,7 @@ CPEFileTX<T>::CPEFileTX()
   m_Initialized = false;
 
   m_pBase = nullptr;
+  m_Size  = 0;
   m_pDosHeader = nullptr;
   m_pPEHeader  = nullptr;
   m_SectionHeaders.clear();
@@ -50,12 +51,154 @@ CPEFileTX<T>::CPEFileTX()
 template<typename T>
 CPEFileTX<T>::~CPEFileTX() {};
 
+template<typename T>
+void CPEFileTX<T>::Reset()
+{
+  m_Initialized = false;
+
+  m_pBase = nullptr;
+  m_Size  = 0;
+  m_pDosHeader = nullptr;
+  m_pPEHeader  = nullptr;
+
+  m_ExIDDs.clear();
+  m_SectionHeaders.clear();
+  m_ImportDescriptors.clear();
+  m_ImportModules.clear();
+  m_ImportFunctions.clear();
+  m_RelocationEntries.clear();
+}
+
+template<typename T>
+VUResult vuapi CPEFileTX<T>::Parse(const void* pData, const size_t Size)
+{
+  this->Reset();
+
+  m_pBase = const_cast<void*>(pData);
+  m_Size  = pData != nullptr ? Size : 0;
+
+  if (m_Size == 0)
+  {
+    m_LastErrorCode = ERROR_INVALID_PARAMETER;
+    return 4;
+  }
+
+  m_LastErrorCode = ERROR_BAD_EXE_FORMAT;
+
+  m_pDosHeader = (PDOSHeader)this->Pointer(0, sizeof(TDOSHeader));
+  if (m_pDosHeader == nullptr || m_pDosHeader->e_magic != IMAGE_DOS_SIGNATURE || m_pDosHeader->e_lfanew < 0)
+  {
+    return 5;
+  }
+
+  m_pPEHeader = (TPEHeaderT<T>*)this->Pointer(T(m_pDosHeader->e_lfanew), sizeof(TPEHeaderT<T>));
+  if (m_pPEHeader == nullptr || m_pPEHeader->Signature != IMAGE_NT_SIGNATURE)
+  {
+    return 6;
+  }
+
+  if (sizeof(T) == sizeof(pe32))
+  {
+    if (m_pPEHeader->OptHeader.Magic != IMAGE_NT_OPTIONAL_HDR32_MAGIC)
+    {
+      return 7; // Used wrong type data for the current PE file
+    }
+  }
+  else if (sizeof(T) == sizeof(pe64))
+  {
+    if (m_pPEHeader->OptHeader.Magic != IMAGE_NT_OPTIONAL_HDR64_MAGIC)
+    {
+      return 7; // Used wrong type data for the current PE file
+    }
+  }
+  else
+  {
+    return 8; // The curent type data was not supported
+  }
+
+  // The section headers follow the optional header by its size in the file header
+
+  const T offset = T(m_pDosHeader->e_lfanew) + T(offsetof(TPEHeaderT<T>, OptHeader)) +
+    T(m_pPEHeader->FileHeader.SizeOfOptionalHeader);
+  if (this->Pointer(offset, m_pPEHeader->FileHeader.NumberOfSections * sizeof(TSectionHeader)) == nullptr)
+  {
+    return 9;
+  }
+
+  m_Initialized = true;
+  m_LastErrorCode = ERROR_SUCCESS;
+
+  return VU_OK;
+}
+
+template<typename T>
+VUResult vuapi CPEFileTX<T>::Parse(const CBuffer& Buffer)
+{
+  return this->Parse(Buffer.GetpData(), Buffer.GetSize());
+}
+
+/**
+ * The data at an offset, or null if it is not entirely in the image.
+ */
+template<typename T>
+const void* CPEFileTX<T>::Pointer(const T Offset, const size_t Size)
+{
+  if (Offset == T(-1) || ulonglong(Offset) > ulonglong(m_Size) || ulonglong(Size) > ulonglong(m_Size) - ulonglong(Offset))
+  {
+    return nullptr;
+  }
+
+  return static_cast<const byte*>(m_pBase) + size_t(Offset);
+}
+
+/**
+ * A null-terminated string at an offset, it must end in the image.
+ */
+template<typename T>
+bool CPEFileTX<T>::ReadString(const T Offset, std::string& String)
+{
+  const auto p = static_cast<const char*>(this->Pointer(Offset, 0));
+  if (p == nullptr)
+  {
+    return false;
+  }
+
+  const auto e = static_cast<const char*>(memchr(p, 0, m_Size - size_t(Offset)));
+  if (e == nullptr)
+  {
+    return false;
+  }
+
+  String.assign(p, e);
+
+  return true;
+}
+
+template<typename T>
+const TDataDirectory* CPEFileTX<T>::GetDataDirectory(const ulong Index)
+{
+  if (Index >= MAX_IDD || Index >= m_pPEHeader->OptHeader.NumberOfRvaAndSizes)
+  {
+    return nullptr;
+  }
+
+  const auto pIDD = &m_pPEHeader->OptHeader.DataDirectory[Index];
+
+  return pIDD->VirtualAddress != 0 && pIDD->Size != 0 ? pIDD : nullptr;
+}
+
 template<typename T>
 void* vuapi CPEFileTX<T>::GetpBase()
 {
   return m_pBase;
 }
 
+template<typename T>
+size_t vuapi CPEFileTX<T>::GetSize()
+{
+  return m_Size;
+}
+
 template<typename T>
 TPEHeaderT<T>* vuapi CPEFileTX<T>::GetpPEHeader()
 {
@@ -72,7 +215,8 @@ const std::vector<PSectionHeader>& vuapi CPEFileTX<T>::GetSetionHeaders(bool InC
 {
   if (!m_Initialized)
   {
-    assert(0);
+    m_LastErrorCode = ERROR_NOT_READY;
+    return m_SectionHeaders;
   }
 
   if (InCache && !m_SectionHeaders.empty())
@@ -82,13 +226,18 @@ const std::vector<PSectionHeader>& vuapi CPEFileTX<T>::GetSetionHeaders(bool InC
 
   m_SectionHeaders.clear();
 
-  vu::PSectionHeader pSH = (PSectionHeader)((ulong64)m_pPEHeader + sizeof(vu::TNTHeaderT<T>));
+  // The section headers are checked in the image by the parsing
+
+  const T offset = T(m_pDosHeader->e_lfanew) + T(offsetof(TPEHeaderT<T>, OptHeader)) +
+    T(m_pPEHeader->FileHeader.SizeOfOptionalHeader);
+
+  auto pSH = (PSectionHeader)this->Pointer(offset, m_pPEHeader->FileHeader.NumberOfSections * sizeof(TSectionHeader));
   if (pSH == nullptr)
   {
+    m_LastErrorCode = ERROR_BAD_EXE_FORMAT;
     return m_SectionHeaders;
   }
 
-  m_SectionHeaders.clear();
   for (int i = 0; i < m_pPEHeader->FileHeader.NumberOfSections; i++)
   {
     m_SectionHeaders.push_back(pSH);
@@ -119,7 +268,8 @@ const std::vector<TRelocationEntryT<T>> vuapi CPEFileTX<T>::GetRelocationEntries
 {
   if (!m_Initialized)
   {
-    assert(0);
+    m_LastErrorCode = ERROR_NOT_READY;
+    return m_RelocationEntries;
   }
 
   if (InCache && !m_RelocationEntries.empty())
@@ -127,30 +277,58 @@ const std::vector<TRelocationEntryT<T>> vuapi CPEFileTX<T>::GetRelocationEntries
     return m_RelocationEntries;
   }
 
-  auto IDD = this->GetpPEHeader()->OptHeader.Relocation;
+  m_RelocationEntries.clear();
+
+  const auto pIDD = this->GetDataDirectory(IMAGE_DIRECTORY_ENTRY_BASERELOC);
+  if (pIDD == nullptr)
+  {
+    return m_RelocationEntries;
+  }
+
+  const T offset = this->RVA2Offset(pIDD->VirtualAddress);
+  if (offset == T(-1))
+  {
+    m_LastErrorCode = ERROR_BAD_EXE_FORMAT;
+    return m_RelocationEntries;
+  }
 
-  for (DWORD Size = 0; Size < IDD.Size; )
+  for (ulonglong Size = 0; Size < pIDD->Size; )
   {
-    auto ptr = PUCHAR(reinterpret_cast<ulong64>(this->GetpBase()) + this->RVA2Offset(IDD.VirtualAddress) + Size);
-    assert(ptr != nullptr);
+    auto pIBR = PIMAGE_BASE_RELOCATION(this->Pointer(T(offset + Size), sizeof(IMAGE_BASE_RELOCATION)));
+    if (pIBR == nullptr || pIBR->SizeOfBlock < sizeof(IMAGE_BASE_RELOCATION))
+    {
+      m_LastErrorCode = ERROR_BAD_EXE_FORMAT;
+      break;
+    }
 
-    auto pIBR = PIMAGE_BASE_RELOCATION(ptr);
-    assert(pIBR != nullptr);
+    const auto pEntries = PIMAGE_BASE_RELOCATION_ENTRY(this->Pointer(
+      T(offset + Size + sizeof(IMAGE_BASE_RELOCATION)), pIBR->SizeOfBlock - sizeof(IMAGE_BASE_RELOCATION)));
+    if (pEntries == nullptr)
+    {
+      m_LastErrorCode = ERROR_BAD_EXE_FORMAT;
+      break;
+    }
 
-    auto nEntries = COUNT_RELOCATION_ENTRY(ptr);
-    ptr += sizeof(IMAGE_BASE_RELOCATION);
+    const auto nEntries = COUNT_RELOCATION_ENTRY(pIBR);
 
     for (DWORD idx = 0; idx < nEntries; idx++)
     {
-      const auto pEntry = PIMAGE_BASE_RELOCATION_ENTRY(ptr + idx * sizeof(IMAGE_BASE_RELOCATION_ENTRY));
-      assert(pEntry);
+      const auto pEntry = &pEntries[idx];
 
-      TRelocationEntryT<T> Entry = { 0 };
+      TRelocationEntryT<T> Entry = {};
+      Entry.Type = pEntry->Type;
       Entry.RVA = pIBR->VirtualAddress + pEntry->Offset;
-      auto Offset = this->RVA2Offset(Entry.RVA);
-      // Entry.Offset = this->RVA2Offset(Entry.RVA);
       // Entry.VA = this->GetpPEHeader()->OptHeader.ImageBase + Entry.RVA;
-      Entry.Value = *reinterpret_cast<T*>(reinterpret_cast<ulong64>(this->GetpBase()) + Offset);
+
+      const void* pValue = this->Pointer(this->RVA2Offset(Entry.RVA), sizeof(T));
+      if (pValue != nullptr)
+      {
+        memcpy(&Entry.Value, pValue, sizeof(T));
+      }
+      else if (pEntry->Type != IMAGE_REL_BASED_ABSOLUTE) // The padding entries are not relocated
+      {
+        m_LastErrorCode = ERROR_BAD_EXE_FORMAT;
+      }
 
       m_RelocationEntries.push_back(std::move(Entry));
     }
@@ -166,7 +344,8 @@ const std::vector<TExIID>& vuapi CPEFileTX<T>::GetExIIDs(bool InCache)
 {
   if (!m_Initialized)
   {
-    assert(0);
+    m_LastErrorCode = ERROR_NOT_READY;
+    return m_ExIDDs;
   }
 
   if (InCache && !m_ExIDDs.empty())
@@ -176,27 +355,42 @@ const std::vector<TExIID>& vuapi CPEFileTX<T>::GetExIIDs(bool InCache)
 
   m_ExIDDs.clear();
 
-  T ulIIDOffset = this->RVA2Offset(m_pPEHeader->OptHeader.Import.VirtualAddress);
-  if (ulIIDOffset == T(-1))
+  const auto pIDD = this->GetDataDirectory(IMAGE_DIRECTORY_ENTRY_IMPORT);
+  if (pIDD == nullptr)
   {
     return m_ExIDDs;
   }
 
-  auto pIID = (PImportDescriptor)((ulong64)m_pBase + ulIIDOffset);
-  if (pIID == nullptr)
+  T ulIIDOffset = this->RVA2Offset(pIDD->VirtualAddress);
+  if (ulIIDOffset == T(-1))
   {
+    m_LastErrorCode = ERROR_BAD_EXE_FORMAT;
     return m_ExIDDs;
   }
 
-  m_ExIDDs.clear();
-
-  for (int i = 0; pIID->FirstThunk != 0; i++, pIID++)
+  for (ulong i = 0;; i++, ulIIDOffset += sizeof(TImportDescriptor))
   {
+    auto pIID = (PImportDescriptor)this->Pointer(ulIIDOffset, sizeof(TImportDescriptor));
+    if (pIID == nullptr)
+    {
+      m_LastErrorCode = ERROR_BAD_EXE_FORMAT; // Not terminated in the image
+      break;
+    }
+
+    if (pIID->FirstThunk == 0)
+    {
+      break;
+    }
+
     TExIID ExIID;
     ExIID.IIDID = i;
-    ExIID.Name = (char*)((ulong64)m_pBase + this->RVA2Offset(pIID->Name));;
     ExIID.pIID = pIID;
 
+    if (!this->ReadString(this->RVA2Offset(pIID->Name), ExIID.Name))
+    {
+      m_LastErrorCode = ERROR_BAD_EXE_FORMAT;
+    }
+
     m_ExIDDs.push_back(std::move(ExIID));
   }
 
@@ -208,7 +402,8 @@ const std::vector<PImportDescriptor>& vuapi CPEFileTX<T>::GetImportDescriptors(b
 {
   if (!m_Initialized)
   {
-    assert(0);
+    m_LastErrorCode = ERROR_NOT_READY;
+    return m_ImportDescriptors;
   }
 
   if (InCache && !m_ImportDescriptors.empty())
@@ -233,7 +428,8 @@ const std::vector<TImportModule> vuapi CPEFileTX<T>::GetImportModules(bool InCac
 {
   if (!m_Initialized)
   {
-    assert(0);
+    m_LastErrorCode = ERROR_NOT_READY;
+    return m_ImportModules;
   }
 
   if (InCache && !m_ImportModules.empty())
@@ -263,7 +459,8 @@ const std::vector<TImportFunctionT<T>> vuapi CPEFileTX<T>::GetImportFunctions(bo
 {
   if (!m_Initialized)
   {
-    assert(0);
+    m_LastErrorCode = ERROR_NOT_READY;
+    return m_ImportFunctions;
   }
 
   if (InCache && !m_ImportFunctions.empty())
@@ -275,14 +472,28 @@ const std::vector<TImportFunctionT<T>> vuapi CPEFileTX<T>::GetImportFunctions(bo
 
   m_ImportFunctions.clear();
 
-  TThunkDataT<T>* pThunkData = nullptr;
-  TImportFunctionT<T> funcInfo;
   for (const auto& e: m_ExIDDs)
   {
     T ulOffset = this->RVA2Offset(e.pIID->FirstThunk);
-    if (ulOffset == -1 || (pThunkData = (TThunkDataT<T>*)((ulong64)m_pBase + ulOffset)) == nullptr) continue;
-    do
+
+    for (;; ulOffset += sizeof(TThunkDataT<T>))
     {
+      auto pThunkData = (const TThunkDataT<T>*)this->Pointer(ulOffset, sizeof(TThunkDataT<T>));
+      if (pThunkData == nullptr)
+      {
+        m_LastErrorCode = ERROR_BAD_EXE_FORMAT; // Not terminated in the image
+        break;
+      }
+
+      if (pThunkData->u1.AddressOfData == 0)
+      {
+        break;
+      }
+
+      TImportFunctionT<T> funcInfo;
+      funcInfo.IIDID = e.IIDID;
+      funcInfo.RVA = pThunkData->u1.AddressOfData;
+
       if ((pThunkData->u1.AddressOfData & m_OrdinalFlag) == m_OrdinalFlag)   // Imported by ordinal
       {
         funcInfo.Name = "";
@@ -291,23 +502,20 @@ const std::vector<TImportFunctionT<T>> vuapi CPEFileTX<T>::GetImportFunctions(bo
       }
       else   // Imported by name
       {
-        ulOffset = this->RVA2Offset(pThunkData->u1.AddressOfData);
-        PImportByName p = (PImportByName)((ulong64)m_pBase + ulOffset);
-        if (ulOffset != -1 && p != nullptr)
+        const T ulNameOffset = this->RVA2Offset(pThunkData->u1.AddressOfData);
+        auto p = (PImportByName)this->Pointer(ulNameOffset, sizeof(p->Hint));
+        if (p == nullptr || !this->ReadString(ulNameOffset + sizeof(p->Hint), funcInfo.Name))
         {
-          funcInfo.Hint = p->Hint;
-          funcInfo.Ordinal = T(-1);
-          funcInfo.Name = (char*)p->Name;
+          m_LastErrorCode = ERROR_BAD_EXE_FORMAT;
+          continue;
         }
+
+        funcInfo.Hint = p->Hint;
+        funcInfo.Ordinal = T(-1);
       }
 
-      funcInfo.IIDID = e.IIDID;
-      funcInfo.RVA = pThunkData->u1.AddressOfData;
       m_ImportFunctions.push_back(funcInfo);
-
-      pThunkData++;
     }
-    while (pThunkData->u1.AddressOfData != 0);
   }
 
   return m_ImportFunctions;
@@ -318,19 +526,17 @@ const TImportModule* vuapi CPEFileTX<T>::FindImportModule(const std::string& Mod
 {
   if (!m_Initialized)
   {
-    assert(0);
+    m_LastErrorCode = ERROR_NOT_READY;
+    return nullptr;
   }
 
   this->GetImportModules(InCache);
 
   const TImportModule* result = nullptr;
 
-  auto s1 = UpperStringA(ModuleName);
-
   for (const auto& e: m_ImportModules)
   {
-    auto s2 = UpperStringA(e.Name);
-    if (s1 == s2)
+    if (EqualsIgnoreCaseA(ModuleName, e.Name))
     {
       result = &e;
       break;
@@ -349,7 +555,8 @@ const TImportFunctionT<T>* vuapi CPEFileTX<T>::FindImportFunction(
 {
   if (!m_Initialized)
   {
-    assert(0);
+    m_LastErrorCode = ERROR_NOT_READY;
+    return nullptr;
   }
 
   const TImportFunctionT<T>* result = nullptr;
@@ -390,9 +597,9 @@ const TImportFunctionT<T>* vuapi CPEFileTX<T>::FindImportFunction(
 template<typename T>
 const TImportFunctionT<T>* vuapi CPEFileTX<T>::FindImportFunction(
   const std::string& FunctionName,
-  bool InCache)
+  bool /* InCache */)
 {
-  TImportFunctionT<T> o = {0};
+  TImportFunctionT<T> o = {};
   o.Name = FunctionName;
   return this->FindImportFunction(o, eImportedFunctionFindMethod::IFFM_NAME);
 }
@@ -400,9 +607,9 @@ const TImportFunctionT<T>* vuapi CPEFileTX<T>::FindImportFunction(
 template<typename T>
 const TImportFunctionT<T>* vuapi CPEFileTX<T>::FindImportFunction(
   const ushort FunctionHint,
-  bool InCache)
+  bool /* InCache */)
 {
-  TImportFunctionT<T> o = {0};
+  TImportFunctionT<T> o = {};
   o.Hint = FunctionHint;
   return this->FindImportFunction(o, eImportedFunctionFindMethod::IFFM_HINT);
 }
@@ -412,7 +619,8 @@ T vuapi CPEFileTX<T>::RVA2Offset(T RVA, bool InCache)
 {
   if (!m_Initialized)
   {
-    assert(0);
+    m_LastErrorCode = ERROR_NOT_READY;
+    return T(-1);
   }
 
   if (!InCache || m_SectionHeaders.empty())
@@ -428,7 +636,7 @@ T vuapi CPEFileTX<T>::RVA2Offset(T RVA, bool InCache)
   const auto& theLastSection = *m_SectionHeaders.rbegin();
 
   std::pair<T, T> range(T(0), T(theLastSection->VirtualAddress) + T(theLastSection->Misc.VirtualSize));
-  if (RVA < range.first || RVA > range.second)
+  if (RVA < range.first || RVA >= range.second)
   {
     return T(-1);
   }
@@ -439,6 +647,11 @@ T vuapi CPEFileTX<T>::RVA2Offset(T RVA, bool InCache)
   {
     if ((RVA >= e->VirtualAddress) && (RVA < (e->VirtualAddress + e->Misc.VirtualSize)))
     {
+      if (RVA - e->VirtualAddress >= e->SizeOfRawData)
+      {
+        return T(-1); // Not in the file, e.g. the uninitialized data
+      }
+
       result  = e->PointerToRawData;
       result += (RVA - e->VirtualAddress);
       break;
@@ -453,7 +666,8 @@ T vuapi CPEFileTX<T>::Offset2RVA(T Offset, bool InCache)
 {
   if (!m_Initialized)
   {
-    assert(0);
+    m_LastErrorCode = ERROR_NOT_READY;
+    return T(-1);
   }
 
   if (!InCache || m_SectionHeaders.empty())
@@ -469,7 +683,7 @@ T vuapi CPEFileTX<T>::Offset2RVA(T Offset, bool InCache)
   const auto& theLastSection = *m_SectionHeaders.rbegin();
 
   std::pair<T, T> range(T(0), T(theLastSection->PointerToRawData) + T(theLastSection->SizeOfRawData));
-  if (Offset < range.first || Offset > range.second)
+  if (Offset < range.first || Offset >= range.second)
   {
     return T(-1);
   }
@@ -489,43 +703,81 @@ T vuapi CPEFileTX<T>::Offset2RVA(T Offset, bool InCache)
   return result;
 }
 
+#ifndef _WIN32
+
+/**
+ * There is no file mapping, the file is read into a buffer.
+ */
+static VUResult ReadFileData(const std::string& FilePath, CBuffer& Data)
+{
+  FILE* f = fopen(FilePath.c_str(), "rb");
+  if (f == nullptr)
+  {
+    return 2;
+  }
+
+  VUResult result = 3;
+
+  if (fseek(f, 0, SEEK_END) == 0)
+  {
+    const long size = ftell(f);
+    if (size > 0 && fseek(f, 0, SEEK_SET) == 0 && Data.Resize(size_t(size)))
+    {
+      if (fread(Data.GetpData(), 1, size_t(size), f) == size_t(size))
+      {
+        result = VU_OK;
+      }
+    }
+  }
+
+  fclose(f);
+
+  return result;
+}
+
+#endif // _WIN32
+
 template class CPEFileTA<ulong32>;
 template class CPEFileTA<ulong64>;
 
 template<typename T>
 CPEFileTA<T>::CPEFileTA(const std::string& PEFilePath)
 {
-  CPEFileTX<T>::m_Initialized = false;
-
-  CPEFileTX<T>::m_pBase = nullptr;
-  CPEFileTX<T>::m_pDosHeader = nullptr;
-  CPEFileTX<T>::m_pPEHeader  = nullptr;
-
   m_FilePath = PEFilePath;
 }
 
 template<typename T>
 CPEFileTA<T>::~CPEFileTA()
 {
-  if (CPEFileTX<T>::m_Initialized)
-  {
-    m_FileMap.Close();
-  }
+  #ifdef _WIN32
+  m_FileMap.Close();
+  #endif // _WIN32
 }
 
 template<typename T>
 VUResult vuapi CPEFileTA<T>::Parse(const std::string& PEFilePath)
 {
+  if (!PEFilePath.empty())
+  {
+    m_FilePath = PEFilePath;
+  }
+
   if (m_FilePath.empty())
   {
     return 1;
   }
 
+  this->Reset(); // The previous data is released by the reading, nothing may point into it
+
+  #ifdef _WIN32
+
   if (!IsFileExistsA(m_FilePath))
   {
     return 2;
   }
 
+  m_FileMap.Close();
+
   if (m_FileMap.CreateWithinFile(
     m_FilePath, 0, 0,
     eFSGenericFlags::FG_READ,
@@ -537,46 +789,26 @@ VUResult vuapi CPEFileTA<T>::Parse(const std::string& PEFilePath)
     return 3;
   }
 
-  CPEFileTX<T>::m_pBase = m_FileMap.View(eFMDesiredAccess::DA_READ);
-  if (CPEFileTX<T>::m_pBase == nullptr)
+  const void* pBase = m_FileMap.View(eFMDesiredAccess::DA_READ);
+  const ulong size = m_FileMap.GetFileSize();
+  if (pBase == nullptr || size == INVALID_FILE_SIZE)
   {
     return 4;
   }
 
-  CPEFileTX<T>::m_pDosHeader = (PDOSHeader)CPEFileTX<T>::m_pBase;
-  if (CPEFileTX<T>::m_pDosHeader == nullptr)
-  {
-    return 5;
-  }
+  return CPEFileTX<T>::Parse(pBase, size_t(size));
 
-  CPEFileTX<T>::m_pPEHeader = (TPEHeaderT<T>*)((ulong64)CPEFileTX<T>::m_pBase + CPEFileTX<T>::m_pDosHeader->e_lfanew);
-  if (CPEFileTX<T>::m_pPEHeader == nullptr)
-  {
-    return 6;
-  }
+  #else // POSIX
 
-  if (sizeof(T) == sizeof(pe32))
+  const auto result = ReadFileData(m_FilePath, m_Data);
+  if (result != VU_OK)
   {
-    if (CPEFileTX<T>::m_pPEHeader->OptHeader.Magic != IMAGE_NT_OPTIONAL_HDR32_MAGIC)
-    {
-      return 7; // Used wrong type data for the current PE file
-    }
-  }
-  else if (sizeof(T) == sizeof(pe64))
-  {
-    if (CPEFileTX<T>::m_pPEHeader->OptHeader.Magic != IMAGE_NT_OPTIONAL_HDR64_MAGIC)
-    {
-      return 7; // Used wrong type data for the current PE file
-    }
-  }
-  else
-  {
-    return 8; // The curent type data was not supported
+    return result;
   }
 
-  CPEFileTX<T>::m_Initialized = true;
+  return CPEFileTX<T>::Parse(m_Data);
 
-  return VU_OK;
+  #endif // _WIN32
 }
 
 template class CPEFileTW<ulong32>;
@@ -585,22 +817,15 @@ template class CPEFileTW<ulong64>;
 template<typename T>
 CPEFileTW<T>::CPEFileTW(const std::wstring& PEFilePath)
 {
-  CPEFileTX<T>::m_Initialized = false;
-
-  CPEFileTX<T>::m_pBase = nullptr;
-  CPEFileTX<T>::m_pDosHeader = nullptr;
-  CPEFileTX<T>::m_pPEHeader  = nullptr;
-
   m_FilePath = PEFilePath;
 }
 
 template<typename T>
 CPEFileTW<T>::~CPEFileTW()
 {
-  if (CPEFileTX<T>::m_Initialized)
-  {
-    m_FileMap.Close();
-  }
+  #ifdef _WIN32
+  m_FileMap.Close();
+  #endif // _WIN32
 }
 
 template<typename T>
@@ -611,11 +836,17 @@ VUResult vuapi CPEFileTW<T>::Parse()
     return 1;
   }
 
+  this->Reset(); // The previous data is released by the reading, nothing may point into it
+
+  #ifdef _WIN32
+
   if (!IsFileExistsW(m_FilePath))
   {
     return 2;
   }
 
+  m_FileMap.Close();
+
   if (m_FileMap.CreateWithinFile(m_FilePath, 0, 0,
     eFSGenericFlags::FG_READ,
     eFSShareFlags::FS_READ,
@@ -626,46 +857,26 @@ VUResult vuapi CPEFileTW<T>::Parse()
     return 3;
   }
 
-  CPEFileTX<T>::m_pBase = m_FileMap.View(eFMDesiredAccess::DA_READ);
-  if (CPEFileTX<T>::m_pBase == nullptr)
+  const void* pBase = m_FileMap.View(eFMDesiredAccess::DA_READ);
+  const ulong size = m_FileMap.GetFileSize();
+  if (pBase == nullptr || size == INVALID_FILE_SIZE)
   {
     return 4;
   }
 
-  CPEFileTX<T>::m_pDosHeader = (PDOSHeader)CPEFileTX<T>::m_pBase;
-  if (CPEFileTX<T>::m_pDosHeader == nullptr)
-  {
-    return 5;
-  }
+  return CPEFileTX<T>::Parse(pBase, size_t(size));
 
-  CPEFileTX<T>::m_pPEHeader = (TPEHeaderT<T>*)((ulong64)CPEFileTX<T>::m_pBase + CPEFileTX<T>::m_pDosHeader->e_lfanew);
-  if (CPEFileTX<T>::m_pPEHeader == nullptr)
-  {
-    return 6;
-  }
+  #else // POSIX
 
-  if (sizeof(T) == sizeof(pe32))
+  const auto result = ReadFileData(ToUTF8(m_FilePath), m_Data);
+  if (result != VU_OK)
   {
-    if (CPEFileTX<T>::m_pPEHeader->OptHeader.Magic != IMAGE_NT_OPTIONAL_HDR32_MAGIC)
-    {
-      return 7; // Used wrong type data for the current PE file
-    }
-  }
-  else if (sizeof(T) == sizeof(pe64))
-  {
-    if (CPEFileTX<T>::m_pPEHeader->OptHeader.Magic != IMAGE_NT_OPTIONAL_HDR64_MAGIC)
-    {
-      return 7; // Used wrong type data for the current PE file
-    }
-  }
-  else
-  {
-    return 8; // The curent type data was not supported
+    return result;
   }
 
-  CPEFileTX<T>::m_Initialized = true;
+  return CPEFileTX<T>::Parse(m_Data);
 
-  return VU_OK;
+  #endif // _WIN32
 }
 
-} // namespace vu
\ No newline at end of file
+} // namespace vu
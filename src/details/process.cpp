@@ -299,16 +299,12 @@ std::vector<ulong> vuapi NameToPIDA(const std::string& ProcessName, ulong ulMaxP
 
   vu::ulong nProcesses = cbNeeded / sizeof(ulong);
 
-  std::string s1 = LowerStringA(ProcessName), s2;
-
   ulong ulPID;
   for (vu::ulong i = 0; i < nProcesses; i++)
   {
     ulPID = pProcesses.get()[i];
 
-    s2.clear();
-    s2 = LowerStringA(vu::PIDToNameA(ulPID));
-    if (s1 == s2)
+    if (EqualsIgnoreCaseA(ProcessName, vu::PIDToNameA(ulPID)))
     {
       l.push_back(ulPID);
     }
@@ -347,16 +343,12 @@ std::vector<ulong> vuapi NameToPIDW(const std::wstring& ProcessName, ulong ulMax
 
   vu::ulong nProcesses = cbNeeded / sizeof(ulong);
 
-  std::wstring s1 = LowerStringW(ProcessName), s2;
-
   ulong ulPID;
   for (vu::ulong i = 0; i < nProcesses; i++)
   {
     ulPID = pProcesses.get()[i];
 
-    s2.clear();
-    s2 = LowerStringW(vu::PIDToNameW(ulPID));
-    if (s1 == s2)
+    if (EqualsIgnoreCaseW(ProcessName, vu::PIDToNameW(ulPID)))
     {
       l.push_back(ulPID);
     }
@@ -482,17 +474,13 @@ HMODULE vuapi Remote64GetModuleHandleA(const ulong ulPID, const std::string& Mod
     return result;
   }
 
-  auto targetName = LowerStringA(ModuleName);
-  targetName = TrimStringA(targetName);
-
-  std::string iterName("");
+  const auto targetName = TrimStringA(ModuleName);
 
   char moduleName[MAX_PATH] = {0};
   for (ulong i = 0; i < nModules; i++)
   {
     pfnGetModuleBaseNameA(hProcess, hModules[i], moduleName, sizeof(ModuleName));
-    iterName = LowerStringA(moduleName);
-    if (iterName == targetName)
+    if (EqualsIgnoreCaseA(moduleName, targetName))
     {
       result = hModules[i];
       break;
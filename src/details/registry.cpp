@@ -102,16 +102,7 @@ CRegistryA::~CRegistryA()
 
 ulong vuapi CRegistryA::GetSizeOfMultiString(const char* lpcszMultiString)
 {
-  ulong ulLength = 0;
-
-  while (*lpcszMultiString)
-  {
-    ulong crLength = lstrlenA(lpcszMultiString) + sizeof(char);
-    ulLength += crLength;
-    lpcszMultiString = lpcszMultiString + crLength;
-  }
-
-  return ulLength;
+  return ulong(CMultiStringA(lpcszMultiString).GetSize());
 }
 
 ulong vuapi CRegistryA::GetDataSize(const std::string& ValueName, ulong ulType)
@@ -385,8 +376,13 @@ bool vuapi CRegistryA::WriteMultiString(const std::string& ValueName, const char
 
 bool vuapi CRegistryA::WriteMultiString(const std::string& ValueName, const std::vector<std::string>& Value)
 {
-  auto p = ListToMultiStringA(Value);
-  return this->WriteMultiString(ValueName, p.get());
+  CBuffer buffer;
+  if (!ListToMultiStringA(Value, buffer))
+  {
+    return false;
+  }
+
+  return this->WriteMultiString(ValueName, static_cast<const char*>(buffer.GetpData()));
 }
 
 bool vuapi CRegistryA::WriteExpandString(const std::string& ValueName, const std::string& Value)
@@ -559,9 +555,7 @@ std::vector<std::string> vuapi CRegistryA::ReadMultiString(
     return Default;
   }
 
-  std::vector<std::string> l = MultiStringToListA(p.get());
-
-  return l;
+  return CMultiStringA(p.get(), ulReturn / sizeof(char)).ToList();
 }
 
 std::string vuapi CRegistryA::ReadExpandString(const std::string& ValueName, const std::string& Default)
@@ -660,16 +654,7 @@ CRegistryW::~CRegistryW()
 
 ulong vuapi CRegistryW::GetSizeOfMultiString(const wchar* lpcwszMultiString)
 {
-  ulong ulLength = 0;
-
-  while (*lpcwszMultiString)
-  {
-    ulong crLength = sizeof(wchar)*(lstrlenW(lpcwszMultiString) + 1);
-    ulLength += crLength;
-    lpcwszMultiString = lpcwszMultiString + crLength / 2;
-  }
-
-  return ulLength;
+  return ulong(CMultiStringW(lpcwszMultiString).GetSize() * sizeof(wchar));
 }
 
 ulong vuapi CRegistryW::GetDataSize(const std::wstring& ValueName, ulong ulType)
@@ -943,8 +928,13 @@ bool vuapi CRegistryW::WriteMultiString(const std::wstring& ValueName, const wch
 
 bool vuapi CRegistryW::WriteMultiString(const std::wstring& ValueName, const std::vector<std::wstring> Value)
 {
-  auto p = ListToMultiStringW(Value);
-  return this->WriteMultiString(ValueName, p.get());
+  CBuffer buffer;
+  if (!ListToMultiStringW(Value, buffer))
+  {
+    return false;
+  }
+
+  return this->WriteMultiString(ValueName, static_cast<const wchar*>(buffer.GetpData()));
 }
 
 bool vuapi CRegistryW::WriteExpandString(const std::wstring& ValueName, const std::wstring& Value)
@@ -1117,9 +1107,7 @@ std::vector<std::wstring> vuapi CRegistryW::ReadMultiString(
     return Default;
   }
 
-  std::vector<std::wstring> l = MultiStringToListW(p.get());
-
-  return l;
+  return CMultiStringW(p.get(), ulReturn / sizeof(wchar)).ToList();
 }
 
 std::wstring vuapi CRegistryW::ReadExpandString(const std::wstring& ValueName, const std::wstring& Default)
@@ -0,0 +1,476 @@
+/**
+ * @file   ringbuffer.cpp
+ * @author Vic P.
+ * @brief  Implementation for Ring Buffer
+ */
+
+#include "Vutils.h"
+
+#include <new>
+#include <atomic>
+#include <algorithm>
+
+namespace vu
+{
+
+/**
+ * The layout of the memory of a ring, the indices are on their own cache lines.
+ *
+ *   [0 * CACHE_LINE_SIZE] The header
+ *   [1 * CACHE_LINE_SIZE] The head index, the next record to pop
+ *   [2 * CACHE_LINE_SIZE] The tail index, the next record to push
+ *   [3 * CACHE_LINE_SIZE] The records (SPSC) or the cells of sequence + record (MPMC)
+ */
+
+typedef std::atomic<size_t> TRingIndex;
+
+struct TRingHeader
+{
+  size_t Magic;
+  size_t Capacity;
+  size_t RecordSize;
+  size_t Mode;
+};
+
+static const size_t RING_MAGIC = 0x42525556; // VURB
+static const size_t RING_HEAD_OFFSET    = 1 * CRingBuffer::CACHE_LINE_SIZE;
+static const size_t RING_TAIL_OFFSET    = 2 * CRingBuffer::CACHE_LINE_SIZE;
+static const size_t RING_RECORDS_OFFSET = 3 * CRingBuffer::CACHE_LINE_SIZE;
+
+static size_t RingCellSize(const size_t recordsize, const eRingBufferMode mode)
+{
+  if (mode == RB_SPSC)
+  {
+    return recordsize;
+  }
+
+  return VU_ALIGN_UP(sizeof(TRingIndex) + recordsize, sizeof(TRingIndex));
+}
+
+static size_t RingCapacity(const size_t capacity)
+{
+  size_t result = 2;
+
+  while (result < capacity)
+  {
+    result <<= 1;
+  }
+
+  return result;
+}
+
+static TRingIndex& RingIndex(byte* pMemory, const size_t offset)
+{
+  return *reinterpret_cast<TRingIndex*>(pMemory + offset);
+}
+
+CRingBuffer::CRingBuffer()
+  : m_pMemory(nullptr), m_pRecords(nullptr)
+  , m_Capacity(0), m_Mask(0), m_RecordSize(0), m_CellSize(0), m_Mode(RB_SPSC)
+  , m_CachedHead(0), m_CachedTail(0)
+{
+}
+
+CRingBuffer::CRingBuffer(const size_t capacity, const size_t recordsize, const eRingBufferMode mode)
+  : m_pMemory(nullptr), m_pRecords(nullptr)
+  , m_Capacity(0), m_Mask(0), m_RecordSize(0), m_CellSize(0), m_Mode(RB_SPSC)
+  , m_CachedHead(0), m_CachedTail(0)
+{
+  this->Create(capacity, recordsize, mode);
+}
+
+CRingBuffer::~CRingBuffer()
+{
+  this->Close();
+}
+
+size_t CRingBuffer::GetMemorySize(const size_t capacity, const size_t recordsize, const eRingBufferMode mode)
+{
+  return RING_RECORDS_OFFSET + RingCapacity(capacity) * RingCellSize(recordsize, mode);
+}
+
+bool CRingBuffer::Create(const size_t capacity, const size_t recordsize, const eRingBufferMode mode)
+{
+  this->Close();
+
+  if (capacity == 0 || recordsize == 0)
+  {
+    return false;
+  }
+
+  const size_t size = GetMemorySize(capacity, recordsize, mode);
+
+  m_Storage.Resize(size + CACHE_LINE_SIZE, false);
+
+  auto ptr = reinterpret_cast<byte*>(VU_ALIGN_UP(size_t(m_Storage.GetpBytes()), CACHE_LINE_SIZE));
+
+  return this->Create(ptr, size, recordsize, mode);
+}
+
+bool CRingBuffer::Create(void* ptr, const size_t size, const size_t recordsize, const eRingBufferMode mode)
+{
+  if (m_pMemory != nullptr)
+  {
+    this->Close(); // Also releases the own memory, so it is never the given memory
+  }
+
+  if (ptr == nullptr || size_t(ptr) % sizeof(TRingIndex) != 0 || recordsize == 0)
+  {
+    return false;
+  }
+
+  if (size < RING_RECORDS_OFFSET)
+  {
+    return false;
+  }
+
+  // The biggest power of two records that fits the memory
+
+  const size_t cellsize = RingCellSize(recordsize, mode);
+  const size_t cells = (size - RING_RECORDS_OFFSET) / cellsize;
+
+  size_t capacity = 2;
+  while (capacity * 2 <= cells)
+  {
+    capacity <<= 1;
+  }
+
+  if (capacity > cells)
+  {
+    return false;
+  }
+
+  auto pMemory = static_cast<byte*>(ptr);
+
+  auto pHeader = reinterpret_cast<TRingHeader*>(pMemory);
+  pHeader->Magic = 0;
+  pHeader->Capacity = capacity;
+  pHeader->RecordSize = recordsize;
+  pHeader->Mode = mode;
+
+  new (pMemory + RING_HEAD_OFFSET) TRingIndex(0);
+  new (pMemory + RING_TAIL_OFFSET) TRingIndex(0);
+
+  if (mode == RB_MPMC)
+  {
+    // The sequence of a cell tells the round that it is waiting for, a push or a pop
+
+    for (size_t i = 0; i < capacity; i++)
+    {
+      new (pMemory + RING_RECORDS_OFFSET + i * cellsize) TRingIndex(i);
+    }
+  }
+
+  // Publishes the ring, the other side does not open it until the header is complete
+
+  std::atomic_thread_fence(std::memory_order_release);
+  pHeader->Magic = RING_MAGIC;
+
+  return this->Attach(pMemory);
+}
+
+bool CRingBuffer::Open(void* ptr, const size_t size)
+{
+  this->Close();
+
+  if (ptr == nullptr || size_t(ptr) % sizeof(TRingIndex) != 0 || size < RING_RECORDS_OFFSET)
+  {
+    return false;
+  }
+
+  auto pHeader = static_cast<const TRingHeader*>(ptr);
+
+  if (pHeader->Magic != RING_MAGIC)
+  {
+    return false;
+  }
+
+  std::atomic_thread_fence(std::memory_order_acquire);
+
+  const auto capacity = pHeader->Capacity;
+  const auto recordsize = pHeader->RecordSize;
+  const auto mode = eRingBufferMode(pHeader->Mode);
+
+  if (capacity < 2 || (capacity & (capacity - 1)) != 0 || recordsize == 0)
+  {
+    return false;
+  }
+
+  if (mode != RB_SPSC && mode != RB_MPMC)
+  {
+    return false;
+  }
+
+  if (GetMemorySize(capacity, recordsize, mode) > size)
+  {
+    return false;
+  }
+
+  return this->Attach(static_cast<byte*>(ptr));
+}
+
+bool CRingBuffer::Attach(byte* ptr)
+{
+  auto pHeader = reinterpret_cast<const TRingHeader*>(ptr);
+
+  m_pMemory    = ptr;
+  m_pRecords   = ptr + RING_RECORDS_OFFSET;
+  m_Capacity   = pHeader->Capacity;
+  m_Mask       = m_Capacity - 1;
+  m_RecordSize = pHeader->RecordSize;
+  m_Mode       = eRingBufferMode(pHeader->Mode);
+  m_CellSize   = RingCellSize(m_RecordSize, m_Mode);
+
+  m_CachedHead = RingIndex(m_pMemory, RING_HEAD_OFFSET).load(std::memory_order_acquire);
+  m_CachedTail = RingIndex(m_pMemory, RING_TAIL_OFFSET).load(std::memory_order_acquire);
+
+  return true;
+}
+
+void CRingBuffer::Close()
+{
+  m_pMemory  = nullptr;
+  m_pRecords = nullptr;
+  m_Capacity = 0;
+  m_Mask = 0;
+  m_RecordSize = 0;
+  m_CellSize = 0;
+  m_Mode = RB_SPSC;
+  m_CachedHead = 0;
+  m_CachedTail = 0;
+
+  m_Storage.Reset();
+}
+
+bool CRingBuffer::Ready() const
+{
+  return m_pMemory != nullptr;
+}
+
+size_t CRingBuffer::GetCapacity() const
+{
+  return m_Capacity;
+}
+
+size_t CRingBuffer::GetRecordSize() const
+{
+  return m_RecordSize;
+}
+
+eRingBufferMode CRingBuffer::GetMode() const
+{
+  return m_Mode;
+}
+
+size_t CRingBuffer::GetCount() const
+{
+  if (!this->Ready())
+  {
+    return 0;
+  }
+
+  const size_t head = RingIndex(m_pMemory, RING_HEAD_OFFSET).load(std::memory_order_acquire);
+  const size_t tail = RingIndex(m_pMemory, RING_TAIL_OFFSET).load(std::memory_order_acquire);
+
+  const size_t count = tail - head;
+
+  return count <= m_Capacity ? count : 0; // The indices were read at different times
+}
+
+bool CRingBuffer::Empty() const
+{
+  return this->GetCount() == 0;
+}
+
+bool CRingBuffer::Push(const void* record)
+{
+  return this->Push(record, 1) == 1;
+}
+
+bool CRingBuffer::Pop(void* record)
+{
+  return this->Pop(record, 1) == 1;
+}
+
+size_t CRingBuffer::Push(const void* records, const size_t count)
+{
+  if (!this->Ready() || records == nullptr || count == 0)
+  {
+    return 0;
+  }
+
+  auto ptr = static_cast<const byte*>(records);
+
+  return m_Mode == RB_SPSC ? this->PushSPSC(ptr, count) : this->PushMPMC(ptr, count);
+}
+
+size_t CRingBuffer::Pop(void* records, const size_t count)
+{
+  if (!this->Ready() || records == nullptr || count == 0)
+  {
+    return 0;
+  }
+
+  auto ptr = static_cast<byte*>(records);
+
+  return m_Mode == RB_SPSC ? this->PopSPSC(ptr, count) : this->PopMPMC(ptr, count);
+}
+
+/**
+ * SPSC - Each index is written by one side only, a batch is published by a single store.
+ */
+
+size_t CRingBuffer::PushSPSC(const byte* records, const size_t count)
+{
+  auto& tail = RingIndex(m_pMemory, RING_TAIL_OFFSET);
+  auto& head = RingIndex(m_pMemory, RING_HEAD_OFFSET);
+
+  const size_t t = tail.load(std::memory_order_relaxed);
+
+  size_t available = m_Capacity - (t - m_CachedHead);
+  if (available < count)
+  {
+    m_CachedHead = head.load(std::memory_order_acquire);
+    available = m_Capacity - (t - m_CachedHead);
+  }
+
+  const size_t n = std::min(count, available);
+  if (n == 0)
+  {
+    return 0;
+  }
+
+  const size_t index = t & m_Mask;
+  const size_t first = std::min(n, m_Capacity - index);
+
+  memcpy(m_pRecords + index * m_RecordSize, records, first * m_RecordSize);
+  memcpy(m_pRecords, records + first * m_RecordSize, (n - first) * m_RecordSize);
+
+  tail.store(t + n, std::memory_order_release);
+
+  return n;
+}
+
+size_t CRingBuffer::PopSPSC(byte* records, const size_t count)
+{
+  auto& head = RingIndex(m_pMemory, RING_HEAD_OFFSET);
+  auto& tail = RingIndex(m_pMemory, RING_TAIL_OFFSET);
+
+  const size_t h = head.load(std::memory_order_relaxed);
+
+  size_t available = m_CachedTail - h;
+  if (available < count)
+  {
+    m_CachedTail = tail.load(std::memory_order_acquire);
+    available = m_CachedTail - h;
+  }
+
+  const size_t n = std::min(count, available);
+  if (n == 0)
+  {
+    return 0;
+  }
+
+  const size_t index = h & m_Mask;
+  const size_t first = std::min(n, m_Capacity - index);
+
+  memcpy(records, m_pRecords + index * m_RecordSize, first * m_RecordSize);
+  memcpy(records + first * m_RecordSize, m_pRecords, (n - first) * m_RecordSize);
+
+  head.store(h + n, std::memory_order_release);
+
+  return n;
+}
+
+/**
+ * MPMC - Dmitry Vyukov's bounded queue, a record is claimed by a CAS on the index then its cell
+ * is released by its sequence, so a slow thread never blocks the cells that are claimed by the others.
+ */
+
+size_t CRingBuffer::PushMPMC(const byte* records, const size_t count)
+{
+  auto& tail = RingIndex(m_pMemory, RING_TAIL_OFFSET);
+
+  size_t n = 0;
+
+  for (; n < count; n++)
+  {
+    byte* pCell = nullptr;
+    size_t pos = tail.load(std::memory_order_relaxed);
+
+    for (;;)
+    {
+      pCell = m_pRecords + (pos & m_Mask) * m_CellSize;
+
+      const size_t seq = reinterpret_cast<TRingIndex*>(pCell)->load(std::memory_order_acquire);
+      const intptr_t diff = intptr_t(seq) - intptr_t(pos);
+
+      if (diff == 0)
+      {
+        if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        {
+          break;
+        }
+      }
+      else if (diff < 0)
+      {
+        return n; // Full
+      }
+      else
+      {
+        pos = tail.load(std::memory_order_relaxed);
+      }
+    }
+
+    memcpy(pCell + sizeof(TRingIndex), records + n * m_RecordSize, m_RecordSize);
+
+    reinterpret_cast<TRingIndex*>(pCell)->store(pos + 1, std::memory_order_release);
+  }
+
+  return n;
+}
+
+size_t CRingBuffer::PopMPMC(byte* records, const size_t count)
+{
+  auto& head = RingIndex(m_pMemory, RING_HEAD_OFFSET);
+
+  size_t n = 0;
+
+  for (; n < count; n++)
+  {
+    byte* pCell = nullptr;
+    size_t pos = head.load(std::memory_order_relaxed);
+
+    for (;;)
+    {
+      pCell = m_pRecords + (pos & m_Mask) * m_CellSize;
+
+      const size_t seq = reinterpret_cast<TRingIndex*>(pCell)->load(std::memory_order_acquire);
+      const intptr_t diff = intptr_t(seq) - intptr_t(pos + 1);
+
+      if (diff == 0)
+      {
+        if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        {
+          break;
+        }
+      }
+      else if (diff < 0)
+      {
+        return n; // Empty
+      }
+      else
+      {
+        pos = head.load(std::memory_order_relaxed);
+      }
+    }
+
+    memcpy(records + n * m_RecordSize, pCell + sizeof(TRingIndex), m_RecordSize);
+
+    reinterpret_cast<TRingIndex*>(pCell)->store(pos + m_Mask + 1, std::memory_order_release);
+  }
+
+  return n;
+}
+
+} // namespace vu
@@ -0,0 +1,217 @@
+/**
+ * @file   scan.cpp
+ * @author Vic P.
+ * @brief  Implementation for Parallel Scanning
+ */
+
+#include "Vutils.h"
+#include "scan.h"
+
+#include <atomic>
+#include <algorithm>
+
+namespace vu
+{
+
+/**
+ * The number of positions scanned by a task, it keeps a chunk in the cache of a core.
+ */
+static const size_t SCAN_CHUNK_SIZE = 1 * MiB;
+
+static size_t GetThreadCount(size_t nthreads)
+{
+  if (nthreads == size_t(MAX_NTHREADS) || nthreads == 0)
+  {
+    nthreads = std::thread::hardware_concurrency();
+  }
+
+  return nthreads != 0 ? nthreads : 1;
+}
+
+/**
+ * Finds all occurrences that start in the first 'positions' bytes of a memory block.
+ */
+static void FindAll(
+  const byte* ptr, const size_t positions, const size_t length, const FnFind& fnFind,
+  const size_t base, std::vector<size_t>& result)
+{
+  const size_t size = positions + length - 1;
+
+  for (size_t offset = fnFind(ptr, size); offset != size_t(-1);)
+  {
+    result.push_back(base + offset);
+
+    if (offset + 1 >= positions)
+    {
+      break;
+    }
+
+    const size_t next = fnFind(ptr + offset + 1, size - offset - 1);
+    if (next == size_t(-1))
+    {
+      break;
+    }
+
+    offset += 1 + next;
+  }
+}
+
+size_t vuapi ParallelFind(
+  const void* ptr, const size_t size, const size_t length, const FnFind& fnFind, size_t nthreads)
+{
+  if (ptr == nullptr || length == 0 || size < length || fnFind == nullptr)
+  {
+    return -1;
+  }
+
+  const auto pbytes = static_cast<const byte*>(ptr);
+  const size_t positions = size - length + 1;
+
+  nthreads = GetThreadCount(nthreads);
+  if (nthreads == 1 || positions <= SCAN_CHUNK_SIZE)
+  {
+    return fnFind(pbytes, size);
+  }
+
+  std::atomic<size_t> result(size_t(-1));
+
+  CThreadPool pool(nthreads);
+
+  for (size_t begin = 0; begin < positions; begin += SCAN_CHUNK_SIZE)
+  {
+    pool.AddTask([=, &result, &fnFind]()
+    {
+      // Skips the chunks after an earlier match, the chunks are queued in order
+
+      if (result.load() < begin)
+      {
+        return;
+      }
+
+      const size_t count = std::min(SCAN_CHUNK_SIZE, positions - begin);
+
+      const size_t offset = fnFind(pbytes + begin, count + length - 1);
+      if (offset == size_t(-1))
+      {
+        return;
+      }
+
+      const size_t found = begin + offset;
+
+      size_t prev = result.load();
+      while (found < prev && !result.compare_exchange_weak(prev, found));
+    });
+  }
+
+  pool.Launch();
+
+  return result.load();
+}
+
+std::vector<size_t> vuapi ParallelFindAll(
+  const void* ptr, const size_t size, const size_t length, const FnFind& fnFind, size_t nthreads)
+{
+  std::vector<size_t> result;
+
+  if (ptr == nullptr || length == 0 || size < length || fnFind == nullptr)
+  {
+    return result;
+  }
+
+  const auto pbytes = static_cast<const byte*>(ptr);
+  const size_t positions = size - length + 1;
+
+  nthreads = GetThreadCount(nthreads);
+  if (nthreads == 1 || positions <= SCAN_CHUNK_SIZE)
+  {
+    FindAll(pbytes, positions, length, fnFind, 0, result);
+    return result;
+  }
+
+  // Each chunk has its own result list, so they are merged in order without sorting
+
+  std::vector<std::vector<size_t>> chunks((positions + SCAN_CHUNK_SIZE - 1) / SCAN_CHUNK_SIZE);
+
+  CThreadPool pool(nthreads);
+
+  for (size_t i = 0; i < chunks.size(); i++)
+  {
+    pool.AddTask([=, &chunks, &fnFind]()
+    {
+      const size_t begin = i * SCAN_CHUNK_SIZE;
+      const size_t count = std::min(SCAN_CHUNK_SIZE, positions - begin);
+      FindAll(pbytes + begin, count, length, fnFind, begin, chunks[i]);
+    });
+  }
+
+  pool.Launch();
+
+  for (const auto& e : chunks)
+  {
+    result.insert(result.end(), e.cbegin(), e.cend());
+  }
+
+  return result;
+}
+
+bool vuapi StreamScan(
+  const FnStreamRead& fnRead, const size_t overlap, const size_t blocksize, const FnScanWindow& fnScan)
+{
+  if (fnRead == nullptr || fnScan == nullptr || blocksize == 0)
+  {
+    return false;
+  }
+
+  std::vector<byte> window(overlap + blocksize);
+
+  size_t carried = 0;
+  ulonglong base = 0;
+
+  for (;;)
+  {
+    const size_t n = fnRead(&window[carried], blocksize);
+    if (n == 0 || n > blocksize)
+    {
+      break;
+    }
+
+    const size_t size = carried + n;
+
+    if (!fnScan(&window[0], size, carried, base))
+    {
+      break;
+    }
+
+    const size_t keep = std::min(overlap, size);
+    memmove(&window[0], &window[size - keep], keep);
+
+    base += size - keep;
+    carried = keep;
+  }
+
+  return true;
+}
+
+#ifdef _WIN32
+
+FnStreamRead vuapi FileStreamReader(CFileSystemX& file)
+{
+  return [&file](void* ptr, const size_t size) -> size_t
+  {
+    return file.Read(ptr, ulong(size)) ? size_t(file.GetReadSize()) : 0;
+  };
+}
+
+#else  // POSIX
+
+FnStreamRead vuapi FileStreamReader(FILE* file)
+{
+  return [file](void* ptr, const size_t size) -> size_t
+  {
+    return fread(ptr, 1, size, file);
+  };
+}
+
+#endif // _WIN32
+
+} // namespace vu
@@ -0,0 +1,57 @@
+/**
+ * @file   scan.h
+ * @author Vic P.
+ * @brief  Header for Parallel Scanning
+ */
+
+#pragma once
+
+#include "Vutils.h"
+
+namespace vu
+{
+
+/**
+ * Finds the first occurrence in a memory block.
+ * @return  The offset of the occurrence or -1 if not found.
+ */
+typedef std::function<size_t(const byte* ptr, const size_t size)> FnFind;
+
+/**
+ * Splits a memory block into chunks that overlap by the pattern length - 1 bytes,
+ * then scans them on a thread pool. The results are the same as scanning the whole block at once.
+ * @param[in] length The pattern length.
+ * @param[in] fnFind The finder, it is called concurrently from the worker threads.
+ */
+size_t vuapi ParallelFind(
+  const void* ptr, const size_t size, const size_t length, const FnFind& fnFind, size_t nthreads);
+
+std::vector<size_t> vuapi ParallelFindAll(
+  const void* ptr, const size_t size, const size_t length, const FnFind& fnFind, size_t nthreads);
+
+/**
+ * Scans a window of a stream.
+ * @param[in] carried The number of bytes at the beginning of the window that were carried over from the previous one.
+ * @param[in] base    The offset of the window in the stream.
+ * @return  False to stop.
+ */
+typedef std::function<bool(const byte* ptr, const size_t size, const size_t carried, const ulonglong base)> FnScanWindow;
+
+/**
+ * Reads a stream block by block into a window. The last 'overlap' bytes of a window are carried over
+ * to the beginning of the next one, so an occurrence that spans two blocks is still found.
+ * @return  False if the arguments are invalid.
+ */
+bool vuapi StreamScan(
+  const FnStreamRead& fnRead, const size_t overlap, const size_t blocksize, const FnScanWindow& fnScan);
+
+/**
+ * Reads a file sequentially, for StreamScan.
+ */
+#ifdef _WIN32
+FnStreamRead vuapi FileStreamReader(CFileSystemX& file);
+#else  // POSIX
+FnStreamRead vuapi FileStreamReader(FILE* file);
+#endif // _WIN32
+
+} // namespace vu
@@ -383,10 +383,9 @@ CServiceManagerA::TServices CServiceManagerA::GetDependencies(
 
     m_LastErrorCode = GetLastError();
 
-    const auto dependencies = MultiStringToListA(ptr->lpDependencies);
-    for (const auto& dependency : dependencies)
+    for (const auto& dependency : CMultiStringA(ptr->lpDependencies))
     {
-      auto pService = this->Query(dependency);
+      auto pService = this->Query(dependency.ToString());
       if (pService != nullptr)
       {
         if (states & pService->ServiceStatusProcess.dwCurrentState)
@@ -854,10 +853,9 @@ CServiceManagerW::TServices CServiceManagerW::GetDependencies(
 
     m_LastErrorCode = GetLastError();
 
-    const auto dependencies = MultiStringToListW(ptr->lpDependencies);
-    for (const auto& dependency : dependencies)
+    for (const auto& dependency : CMultiStringW(ptr->lpDependencies))
     {
-      auto pService = this->Query(dependency);
+      auto pService = this->Query(dependency.ToString());
       if (pService != nullptr)
       {
         if (states & pService->ServiceStatusProcess.dwCurrentState)
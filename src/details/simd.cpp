@@ -0,0 +1,1577 @@
+/**
+ * @file   simd.cpp
+ * @author Vic P.
+ * @brief  Implementation for SIMD Routines
+ */
+
+#include "simd.h"
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define VU_SIMD_X86
+#endif
+
+#ifdef VU_SIMD_X86
+#ifdef _MSC_VER
+#include <intrin.h>
+#else  // __GNUC__
+#include <cpuid.h>
+#endif // _MSC_VER
+#include <emmintrin.h>
+#include <immintrin.h>
+#endif // VU_SIMD_X86
+
+/**
+ * GCC/MinGW only emits the instructions of a function that is explicitly marked for that instruction set.
+ * MSVC always emits them, so the instruction set is checked at run-time before calling these functions.
+ */
+#if defined(__GNUC__)
+#define VU_TARGET(isa) __attribute__((target(isa)))
+#else  // _MSC_VER
+#define VU_TARGET(isa)
+#endif // __GNUC__
+
+namespace vu
+{
+
+/**
+ * The needle length from which Horspool skipping beats the first/last byte filter.
+ */
+static const size_t HORSPOOL_MIN_LENGTH = 32;
+
+/**
+ * CPU Detection
+ */
+
+#ifdef VU_SIMD_X86
+
+static void CPUID(int info[4], const int leaf, const int subleaf = 0)
+{
+  #ifdef _MSC_VER
+  __cpuidex(info, leaf, subleaf);
+  #else  // __GNUC__
+  __cpuid_count(leaf, subleaf, info[0], info[1], info[2], info[3]);
+  #endif // _MSC_VER
+}
+
+static ulonglong XGETBV(const uint index)
+{
+  #ifdef _MSC_VER
+  return _xgetbv(index);
+  #else  // __GNUC__
+  uint eax = 0, edx = 0;
+  __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(index));
+  return (ulonglong(edx) << 32) | eax;
+  #endif // _MSC_VER
+}
+
+static uint LowestBit(const uint mask)
+{
+  #ifdef _MSC_VER
+  ulong index = 0;
+  _BitScanForward(&index, mask);
+  return uint(index);
+  #else  // __GNUC__
+  return uint(__builtin_ctz(mask));
+  #endif // _MSC_VER
+}
+
+static uint HighestBit(const uint mask)
+{
+  #ifdef _MSC_VER
+  ulong index = 0;
+  _BitScanReverse(&index, mask);
+  return uint(index);
+  #else  // __GNUC__
+  return uint(31 - __builtin_clz(mask));
+  #endif // _MSC_VER
+}
+
+#endif // VU_SIMD_X86
+
+static eSIMDLevel DetectSIMDLevel()
+{
+  eSIMDLevel result = SL_NONE;
+
+  #ifdef VU_SIMD_X86
+
+  int info[4] = { 0 };
+
+  CPUID(info, 0);
+  const int MaxLeaf = info[0];
+  if (MaxLeaf < 1)
+  {
+    return result;
+  }
+
+  CPUID(info, 1);
+
+  if ((info[3] & (1 << 26)) != 0) // EDX.SSE2
+  {
+    result = SL_SSE2;
+  }
+
+  const bool OSXSAVE = (info[2] & (1 << 27)) != 0;
+  const bool AVX     = (info[2] & (1 << 28)) != 0;
+
+  // The OS must save the YMM registers on context switches (XCR0.SSE & XCR0.AVX)
+
+  if (MaxLeaf >= 7 && OSXSAVE && AVX && (XGETBV(0) & 0x06) == 0x06)
+  {
+    CPUID(info, 7);
+    if ((info[1] & (1 << 5)) != 0) // EBX.AVX2
+    {
+      result = SL_AVX2;
+    }
+  }
+
+  #endif // VU_SIMD_X86
+
+  return result;
+}
+
+static const eSIMDLevel g_SIMDLevel = DetectSIMDLevel();
+
+eSIMDLevel vuapi GetSIMDLevel()
+{
+  return g_SIMDLevel;
+}
+
+/**
+ * Scalar
+ */
+
+static size_t FindByte(const byte* s, const size_t n, const byte v)
+{
+  const auto ptr = static_cast<const byte*>(memchr(s, v, n));
+  return ptr != nullptr ? size_t(ptr - s) : size_t(-1);
+}
+
+static size_t RFindByte(const byte* s, const size_t n, const byte v)
+{
+  for (size_t i = n; i-- > 0;)
+  {
+    if (s[i] == v)
+    {
+      return i;
+    }
+  }
+
+  return -1;
+}
+
+// Requires 2 <= m <= n
+
+static size_t FindScalar(const byte* s, const size_t n, const byte* p, const size_t m)
+{
+  const byte* ptr  = s;
+  const byte* last = s + (n - m);
+
+  while (ptr <= last)
+  {
+    ptr = static_cast<const byte*>(memchr(ptr, p[0], size_t(last - ptr) + 1));
+    if (ptr == nullptr)
+    {
+      break;
+    }
+
+    if (ptr[m - 1] == p[m - 1] && memcmp(ptr + 1, p + 1, m - 2) == 0)
+    {
+      return size_t(ptr - s);
+    }
+
+    ptr++;
+  }
+
+  return -1;
+}
+
+static size_t RFindScalar(const byte* s, const size_t n, const byte* p, const size_t m)
+{
+  for (size_t i = n - m + 1; i-- > 0;)
+  {
+    if (s[i] == p[0] && s[i + m - 1] == p[m - 1] && memcmp(s + i + 1, p + 1, m - 2) == 0)
+    {
+      return i;
+    }
+  }
+
+  return -1;
+}
+
+/**
+ * Boyer-Moore-Horspool for long needles
+ */
+
+static size_t FindHorspool(const byte* s, const size_t n, const byte* p, const size_t m)
+{
+  size_t skip[256];
+  for (size_t i = 0; i < 256; i++)
+  {
+    skip[i] = m;
+  }
+
+  for (size_t i = 0; i < m - 1; i++)
+  {
+    skip[p[i]] = m - 1 - i;
+  }
+
+  const byte tail = p[m - 1];
+
+  for (size_t i = 0; i <= n - m;)
+  {
+    const byte v = s[i + m - 1];
+    if (v == tail && memcmp(s + i, p, m - 1) == 0)
+    {
+      return i;
+    }
+
+    i += skip[v];
+  }
+
+  return -1;
+}
+
+static size_t RFindHorspool(const byte* s, const size_t n, const byte* p, const size_t m)
+{
+  size_t skip[256];
+  for (size_t i = 0; i < 256; i++)
+  {
+    skip[i] = m;
+  }
+
+  for (size_t i = m - 1; i > 0; i--)
+  {
+    skip[p[i]] = i;
+  }
+
+  const byte head = p[0];
+
+  for (size_t i = n - m;;)
+  {
+    const byte v = s[i];
+    if (v == head && memcmp(s + i + 1, p + 1, m - 1) == 0)
+    {
+      return i;
+    }
+
+    if (i < skip[v])
+    {
+      break;
+    }
+
+    i -= skip[v];
+  }
+
+  return -1;
+}
+
+/**
+ * First/last byte filter
+ * Compares a block of candidate positions against both the first and the last byte of the needle at once,
+ * then verifies the middle bytes only at the positions where both matched.
+ */
+
+#ifdef VU_SIMD_X86
+
+// Requires 2 <= m <= n
+
+VU_TARGET("sse2")
+static size_t FindSSE2(const byte* s, const size_t n, const byte* p, const size_t m)
+{
+  const __m128i first = _mm_set1_epi8(char(p[0]));
+  const __m128i last  = _mm_set1_epi8(char(p[m - 1]));
+
+  const size_t positions = n - m + 1;
+
+  size_t i = 0;
+
+  for (; i + 16 <= positions; i += 16)
+  {
+    const __m128i bf = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+    const __m128i bl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i + m - 1));
+
+    uint mask = uint(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(bf, first), _mm_cmpeq_epi8(bl, last))));
+    while (mask != 0)
+    {
+      const uint bit = LowestBit(mask);
+      if (memcmp(s + i + bit + 1, p + 1, m - 2) == 0)
+      {
+        return i + bit;
+      }
+
+      mask &= mask - 1;
+    }
+  }
+
+  const size_t result = FindScalar(s + i, n - i, p, m);
+  return result != -1 ? i + result : result;
+}
+
+VU_TARGET("sse2")
+static size_t RFindSSE2(const byte* s, const size_t n, const byte* p, const size_t m)
+{
+  const __m128i first = _mm_set1_epi8(char(p[0]));
+  const __m128i last  = _mm_set1_epi8(char(p[m - 1]));
+
+  size_t i = n - m + 1;
+
+  while (i >= 16)
+  {
+    i -= 16;
+
+    const __m128i bf = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+    const __m128i bl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i + m - 1));
+
+    uint mask = uint(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(bf, first), _mm_cmpeq_epi8(bl, last))));
+    while (mask != 0)
+    {
+      const uint bit = HighestBit(mask);
+      if (memcmp(s + i + bit + 1, p + 1, m - 2) == 0)
+      {
+        return i + bit;
+      }
+
+      mask &= ~(1U << bit);
+    }
+  }
+
+  return i != 0 ? RFindScalar(s, i + m - 1, p, m) : size_t(-1);
+}
+
+VU_TARGET("avx2")
+static size_t FindAVX2(const byte* s, const size_t n, const byte* p, const size_t m)
+{
+  const __m256i first = _mm256_set1_epi8(char(p[0]));
+  const __m256i last  = _mm256_set1_epi8(char(p[m - 1]));
+
+  const size_t positions = n - m + 1;
+
+  size_t i = 0;
+
+  for (; i + 32 <= positions; i += 32)
+  {
+    const __m256i bf = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+    const __m256i bl = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i + m - 1));
+
+    uint mask = uint(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(bf, first), _mm256_cmpeq_epi8(bl, last))));
+    while (mask != 0)
+    {
+      const uint bit = LowestBit(mask);
+      if (memcmp(s + i + bit + 1, p + 1, m - 2) == 0)
+      {
+        return i + bit;
+      }
+
+      mask &= mask - 1;
+    }
+  }
+
+  const size_t result = FindSSE2(s + i, n - i, p, m);
+  return result != -1 ? i + result : result;
+}
+
+VU_TARGET("avx2")
+static size_t RFindAVX2(const byte* s, const size_t n, const byte* p, const size_t m)
+{
+  const __m256i first = _mm256_set1_epi8(char(p[0]));
+  const __m256i last  = _mm256_set1_epi8(char(p[m - 1]));
+
+  size_t i = n - m + 1;
+
+  while (i >= 32)
+  {
+    i -= 32;
+
+    const __m256i bf = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+    const __m256i bl = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i + m - 1));
+
+    uint mask = uint(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(bf, first), _mm256_cmpeq_epi8(bl, last))));
+    while (mask != 0)
+    {
+      const uint bit = HighestBit(mask);
+      if (memcmp(s + i + bit + 1, p + 1, m - 2) == 0)
+      {
+        return i + bit;
+      }
+
+      mask &= ~(1U << bit);
+    }
+  }
+
+  return i != 0 ? RFindSSE2(s, i + m - 1, p, m) : size_t(-1);
+}
+
+#endif // VU_SIMD_X86
+
+/**
+ * Masked pattern
+ * Filters the candidate positions by the two anchor bytes, then verifies the whole pattern.
+ */
+
+static bool MatchMasked(const byte* s, const byte* values, const byte* masks, const size_t length)
+{
+  for (size_t i = 0; i < length; i++)
+  {
+    if ((s[i] & masks[i]) != values[i])
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static size_t FindMaskedScalar(
+  const byte* s, const size_t n,
+  const byte* values, const byte* masks, const size_t m,
+  const size_t anchors[2])
+{
+  const size_t a = anchors[0];
+
+  for (size_t i = 0; i <= n - m; i++)
+  {
+    if ((s[i + a] & masks[a]) == values[a] && MatchMasked(s + i, values, masks, m))
+    {
+      return i;
+    }
+  }
+
+  return -1;
+}
+
+#ifdef VU_SIMD_X86
+
+// Verifies 16 bytes at a time while the padded pattern fits in the remaining data
+
+VU_TARGET("sse2")
+static bool MatchMaskedSSE2(const byte* s, const size_t n, const byte* values, const byte* masks, const size_t m)
+{
+  size_t i = 0;
+
+  for (; i < m && i + 16 <= n; i += 16)
+  {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+    const __m128i k = _mm_loadu_si128(reinterpret_cast<const __m128i*>(masks + i));
+    const __m128i e = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(v, k), e)) != 0xFFFF)
+    {
+      return false;
+    }
+  }
+
+  return i >= m || MatchMasked(s + i, values + i, masks + i, m - i);
+}
+
+VU_TARGET("sse2")
+static size_t FindMaskedSSE2(
+  const byte* s, const size_t n,
+  const byte* values, const byte* masks, const size_t m,
+  const size_t anchors[2])
+{
+  const size_t a1 = anchors[0], a2 = anchors[1];
+
+  const __m128i v1 = _mm_set1_epi8(char(values[a1]));
+  const __m128i k1 = _mm_set1_epi8(char(masks[a1]));
+  const __m128i v2 = _mm_set1_epi8(char(values[a2]));
+  const __m128i k2 = _mm_set1_epi8(char(masks[a2]));
+
+  const size_t positions = n - m + 1;
+
+  size_t i = 0;
+
+  for (; i + 16 <= positions; i += 16)
+  {
+    const __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i + a1));
+    const __m128i b2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i + a2));
+
+    uint mask = uint(_mm_movemask_epi8(_mm_and_si128(
+      _mm_cmpeq_epi8(_mm_and_si128(b1, k1), v1),
+      _mm_cmpeq_epi8(_mm_and_si128(b2, k2), v2))));
+    while (mask != 0)
+    {
+      const uint bit = LowestBit(mask);
+      if (MatchMaskedSSE2(s + i + bit, n - i - bit, values, masks, m))
+      {
+        return i + bit;
+      }
+
+      mask &= mask - 1;
+    }
+  }
+
+  for (; i < positions; i++)
+  {
+    if (MatchMaskedSSE2(s + i, n - i, values, masks, m))
+    {
+      return i;
+    }
+  }
+
+  return -1;
+}
+
+VU_TARGET("avx2")
+static size_t FindMaskedAVX2(
+  const byte* s, const size_t n,
+  const byte* values, const byte* masks, const size_t m,
+  const size_t anchors[2])
+{
+  const size_t a1 = anchors[0], a2 = anchors[1];
+
+  const __m256i v1 = _mm256_set1_epi8(char(values[a1]));
+  const __m256i k1 = _mm256_set1_epi8(char(masks[a1]));
+  const __m256i v2 = _mm256_set1_epi8(char(values[a2]));
+  const __m256i k2 = _mm256_set1_epi8(char(masks[a2]));
+
+  const size_t positions = n - m + 1;
+
+  size_t i = 0;
+
+  for (; i + 32 <= positions; i += 32)
+  {
+    const __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i + a1));
+    const __m256i b2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i + a2));
+
+    uint mask = uint(_mm256_movemask_epi8(_mm256_and_si256(
+      _mm256_cmpeq_epi8(_mm256_and_si256(b1, k1), v1),
+      _mm256_cmpeq_epi8(_mm256_and_si256(b2, k2), v2))));
+    while (mask != 0)
+    {
+      const uint bit = LowestBit(mask);
+      if (MatchMaskedSSE2(s + i + bit, n - i - bit, values, masks, m))
+      {
+        return i + bit;
+      }
+
+      mask &= mask - 1;
+    }
+  }
+
+  const size_t result = FindMaskedSSE2(s + i, n - i, values, masks, m, anchors);
+  return result != -1 ? i + result : result;
+}
+
+#endif // VU_SIMD_X86
+
+/**
+ * ASCII case
+ * A letter of the source case is selected by a signed range compare, the characters above 0x7F
+ * (0x7FFF for the wide characters) are negative so they are never selected, then its 0x20 bit is flipped.
+ */
+
+template <typename T>
+static T LowerASCII(const T c)
+{
+  return c >= T('A') && c <= T('Z') ? T(c + 0x20) : c;
+}
+
+template <typename T>
+static void ChangeCaseScalar(T* s, const size_t n, const bool upper)
+{
+  const T lo = upper ? T('a') : T('A');
+  const T hi = upper ? T('z') : T('Z');
+
+  for (size_t i = 0; i < n; i++)
+  {
+    if (s[i] >= lo && s[i] <= hi)
+    {
+      s[i] ^= 0x20;
+    }
+  }
+}
+
+template <typename T>
+static int CompareIgnoreCaseScalar(const T* a, const T* b, const size_t n)
+{
+  for (size_t i = 0; i < n; i++)
+  {
+    const T x = LowerASCII(a[i]);
+    const T y = LowerASCII(b[i]);
+    if (x != y)
+    {
+      return x < y ? -1 : 1;
+    }
+  }
+
+  return 0;
+}
+
+static void ChangeCaseScalar(void* s, const size_t n, const size_t width, const bool upper)
+{
+  switch (width)
+  {
+  case 1:
+    ChangeCaseScalar(static_cast<byte*>(s), n, upper);
+    break;
+  case 2:
+    ChangeCaseScalar(static_cast<ushort*>(s), n, upper);
+    break;
+  case 4:
+    ChangeCaseScalar(static_cast<uint32*>(s), n, upper);
+    break;
+  default:
+    assert(0 && "invalid character width");
+    break;
+  }
+}
+
+static int CompareIgnoreCaseScalar(const void* a, const void* b, const size_t n, const size_t width)
+{
+  switch (width)
+  {
+  case 1:
+    return CompareIgnoreCaseScalar(static_cast<const byte*>(a), static_cast<const byte*>(b), n);
+  case 2:
+    return CompareIgnoreCaseScalar(static_cast<const ushort*>(a), static_cast<const ushort*>(b), n);
+  case 4:
+    return CompareIgnoreCaseScalar(static_cast<const uint32*>(a), static_cast<const uint32*>(b), n);
+  default:
+    assert(0 && "invalid character width");
+    break;
+  }
+
+  return 0;
+}
+
+#ifdef VU_SIMD_X86
+
+VU_TARGET("sse2")
+static __m128i CaseMaskSSE2(const __m128i v, const __m128i lo, const __m128i hi, const size_t width)
+{
+  if (width == 1)
+  {
+    return _mm_and_si128(_mm_cmpgt_epi8(v, lo), _mm_cmplt_epi8(v, hi));
+  }
+
+  return _mm_and_si128(_mm_cmpgt_epi16(v, lo), _mm_cmplt_epi16(v, hi));
+}
+
+VU_TARGET("sse2")
+static __m128i Set1SSE2(const int v, const size_t width)
+{
+  return width == 1 ? _mm_set1_epi8(char(v)) : _mm_set1_epi16(short(v));
+}
+
+VU_TARGET("sse2")
+static size_t ChangeCaseSSE2(byte* s, const size_t n, const size_t width, const bool upper)
+{
+  const __m128i lo  = Set1SSE2(upper ? 'a' - 1 : 'A' - 1, width);
+  const __m128i hi  = Set1SSE2(upper ? 'z' + 1 : 'Z' + 1, width);
+  const __m128i bit = Set1SSE2(0x20, width);
+
+  size_t i = 0;
+
+  for (; i + 16 <= n; i += 16)
+  {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+    v = _mm_xor_si128(v, _mm_and_si128(CaseMaskSSE2(v, lo, hi, width), bit));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(s + i), v);
+  }
+
+  return i;
+}
+
+VU_TARGET("sse2")
+static __m128i LowerSSE2(const __m128i v, const __m128i lo, const __m128i hi, const __m128i bit, const size_t width)
+{
+  return _mm_or_si128(v, _mm_and_si128(CaseMaskSSE2(v, lo, hi, width), bit));
+}
+
+/**
+ * Compares 16 bytes at a time, returns the number of equal bytes before the first mismatched vector.
+ */
+VU_TARGET("sse2")
+static size_t EqualPrefixSSE2(const byte* a, const byte* b, const size_t n, const size_t width)
+{
+  const __m128i lo  = Set1SSE2('A' - 1, width);
+  const __m128i hi  = Set1SSE2('Z' + 1, width);
+  const __m128i bit = Set1SSE2(0x20, width);
+
+  size_t i = 0;
+
+  for (; i + 16 <= n; i += 16)
+  {
+    const __m128i x = LowerSSE2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)), lo, hi, bit, width);
+    const __m128i y = LowerSSE2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)), lo, hi, bit, width);
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) != 0xFFFF)
+    {
+      break;
+    }
+  }
+
+  return i;
+}
+
+VU_TARGET("avx2")
+static __m256i CaseMaskAVX2(const __m256i v, const __m256i lo, const __m256i hi, const size_t width)
+{
+  if (width == 1)
+  {
+    return _mm256_and_si256(_mm256_cmpgt_epi8(v, lo), _mm256_cmpgt_epi8(hi, v));
+  }
+
+  return _mm256_and_si256(_mm256_cmpgt_epi16(v, lo), _mm256_cmpgt_epi16(hi, v));
+}
+
+VU_TARGET("avx2")
+static __m256i Set1AVX2(const int v, const size_t width)
+{
+  return width == 1 ? _mm256_set1_epi8(char(v)) : _mm256_set1_epi16(short(v));
+}
+
+VU_TARGET("avx2")
+static size_t ChangeCaseAVX2(byte* s, const size_t n, const size_t width, const bool upper)
+{
+  const __m256i lo  = Set1AVX2(upper ? 'a' - 1 : 'A' - 1, width);
+  const __m256i hi  = Set1AVX2(upper ? 'z' + 1 : 'Z' + 1, width);
+  const __m256i bit = Set1AVX2(0x20, width);
+
+  size_t i = 0;
+
+  for (; i + 32 <= n; i += 32)
+  {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+    v = _mm256_xor_si256(v, _mm256_and_si256(CaseMaskAVX2(v, lo, hi, width), bit));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(s + i), v);
+  }
+
+  return i + ChangeCaseSSE2(s + i, n - i, width, upper);
+}
+
+VU_TARGET("avx2")
+static __m256i LowerAVX2(const __m256i v, const __m256i lo, const __m256i hi, const __m256i bit, const size_t width)
+{
+  return _mm256_or_si256(v, _mm256_and_si256(CaseMaskAVX2(v, lo, hi, width), bit));
+}
+
+VU_TARGET("avx2")
+static size_t EqualPrefixAVX2(const byte* a, const byte* b, const size_t n, const size_t width)
+{
+  const __m256i lo  = Set1AVX2('A' - 1, width);
+  const __m256i hi  = Set1AVX2('Z' + 1, width);
+  const __m256i bit = Set1AVX2(0x20, width);
+
+  size_t i = 0;
+
+  for (; i + 32 <= n; i += 32)
+  {
+    const __m256i x = LowerAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)), lo, hi, bit, width);
+    const __m256i y = LowerAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)), lo, hi, bit, width);
+    if (uint(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y))) != 0xFFFFFFFF)
+    {
+      break;
+    }
+  }
+
+  return i + EqualPrefixSSE2(a + i, b + i, n - i, width);
+}
+
+#endif // VU_SIMD_X86
+
+/**
+ * ASCII runs
+ * A character is ASCII if it is zero after masking its low 7 bits out, the characters are narrowed
+ * by the saturated packs, they never saturate as every character is below 0x80.
+ */
+
+template <typename T>
+static size_t ASCIIPrefixScalar(const T* s, const size_t n)
+{
+  size_t i = 0;
+
+  for (; i < n && s[i] < 0x80; i++);
+
+  return i;
+}
+
+static size_t ASCIIPrefixScalar(const void* s, const size_t n, const size_t width)
+{
+  switch (width)
+  {
+  case 1:
+    return ASCIIPrefixScalar(static_cast<const byte*>(s), n);
+  case 2:
+    return ASCIIPrefixScalar(static_cast<const ushort*>(s), n);
+  case 4:
+    return ASCIIPrefixScalar(static_cast<const uint32*>(s), n);
+  default:
+    assert(0 && "invalid character width");
+    break;
+  }
+
+  return 0;
+}
+
+template <typename S, typename D>
+static void CopyASCIIScalar(const S* s, const size_t n, D* d)
+{
+  for (size_t i = 0; i < n; i++)
+  {
+    d[i] = D(s[i]);
+  }
+}
+
+template <typename S>
+static void CopyASCIIScalar(const S* s, const size_t n, void* d, const size_t to)
+{
+  switch (to)
+  {
+  case 1:
+    CopyASCIIScalar(s, n, static_cast<byte*>(d));
+    break;
+  case 2:
+    CopyASCIIScalar(s, n, static_cast<ushort*>(d));
+    break;
+  case 4:
+    CopyASCIIScalar(s, n, static_cast<uint32*>(d));
+    break;
+  default:
+    assert(0 && "invalid character width");
+    break;
+  }
+}
+
+static void CopyASCIIScalar(const void* s, const size_t n, const size_t from, void* d, const size_t to)
+{
+  switch (from)
+  {
+  case 1:
+    CopyASCIIScalar(static_cast<const byte*>(s), n, d, to);
+    break;
+  case 2:
+    CopyASCIIScalar(static_cast<const ushort*>(s), n, d, to);
+    break;
+  case 4:
+    CopyASCIIScalar(static_cast<const uint32*>(s), n, d, to);
+    break;
+  default:
+    assert(0 && "invalid character width");
+    break;
+  }
+}
+
+#ifdef VU_SIMD_X86
+
+VU_TARGET("sse2")
+static __m128i ASCIIMaskSSE2(const size_t width)
+{
+  switch (width)
+  {
+  case 1:
+    return _mm_set1_epi8(char(0x80));
+  case 2:
+    return _mm_set1_epi16(short(0xFF80));
+  default:
+    return _mm_set1_epi32(int(0xFFFFFF80));
+  }
+}
+
+/**
+ * Checks 16 bytes at a time, returns the number of bytes before the first vector that has a non-ASCII character.
+ */
+VU_TARGET("sse2")
+static size_t ASCIIPrefixSSE2(const byte* s, const size_t n, const size_t width)
+{
+  const __m128i mask = ASCIIMaskSSE2(width);
+
+  size_t i = 0;
+
+  for (; i + 16 <= n; i += 16)
+  {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(v, mask), _mm_setzero_si128())) != 0xFFFF)
+    {
+      break;
+    }
+  }
+
+  return i;
+}
+
+/**
+ * Converts 16 characters at a time between the byte and the wider characters, returns the number of converted characters.
+ */
+VU_TARGET("sse2")
+static size_t CopyASCIISSE2(const byte* s, const size_t n, const size_t from, byte* d, const size_t to)
+{
+  const __m128i zero = _mm_setzero_si128();
+
+  size_t i = 0;
+
+  if (from == 1 && to == 2)
+  {
+    for (; i + 16 <= n; i += 16)
+    {
+      const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(d + 2 * i), _mm_unpacklo_epi8(v, zero));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(d + 2 * i + 16), _mm_unpackhi_epi8(v, zero));
+    }
+  }
+  else if (from == 2 && to == 1)
+  {
+    for (; i + 16 <= n; i += 16)
+    {
+      const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 2 * i));
+      const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 2 * i + 16));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(d + i), _mm_packus_epi16(a, b));
+    }
+  }
+  else if (from == 1 && to == 4)
+  {
+    for (; i + 16 <= n; i += 16)
+    {
+      const __m128i v  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+      const __m128i lo = _mm_unpacklo_epi8(v, zero);
+      const __m128i hi = _mm_unpackhi_epi8(v, zero);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(d + 4 * i), _mm_unpacklo_epi16(lo, zero));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(d + 4 * i + 16), _mm_unpackhi_epi16(lo, zero));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(d + 4 * i + 32), _mm_unpacklo_epi16(hi, zero));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(d + 4 * i + 48), _mm_unpackhi_epi16(hi, zero));
+    }
+  }
+  else if (from == 4 && to == 1)
+  {
+    for (; i + 16 <= n; i += 16)
+    {
+      const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 4 * i));
+      const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 4 * i + 16));
+      const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 4 * i + 32));
+      const __m128i e = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 4 * i + 48));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(d + i), _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, e)));
+    }
+  }
+
+  return i;
+}
+
+VU_TARGET("avx2")
+static size_t ASCIIPrefixAVX2(const byte* s, const size_t n, const size_t width)
+{
+  const __m256i mask = _mm256_broadcastsi128_si256(ASCIIMaskSSE2(width));
+
+  size_t i = 0;
+
+  for (; i + 32 <= n; i += 32)
+  {
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+    if (!_mm256_testz_si256(v, mask))
+    {
+      break;
+    }
+  }
+
+  return i + ASCIIPrefixSSE2(s + i, n - i, width);
+}
+
+#endif // VU_SIMD_X86
+
+/**
+ * Zero bytes
+ * A zero byte is counted by subtracting its compare mask (-1) from a byte counter, the counters are
+ * summed up by the even/odd lanes every 255 vectors, before they can wrap around.
+ */
+
+static void CountZerosScalar(const byte* s, const size_t n, size_t counts[2])
+{
+  for (size_t i = 0; i < n; i++)
+  {
+    counts[i & 1] += s[i] == 0 ? 1 : 0;
+  }
+}
+
+#ifdef VU_SIMD_X86
+
+VU_TARGET("sse2")
+static void SumZerosSSE2(const __m128i acc, size_t counts[2])
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i even = _mm_sad_epu8(_mm_and_si128(acc, _mm_set1_epi16(0x00FF)), zero);
+  const __m128i odd  = _mm_sad_epu8(_mm_srli_epi16(acc, 8), zero);
+  counts[0] += size_t(_mm_cvtsi128_si32(even)) + size_t(_mm_extract_epi16(even, 4));
+  counts[1] += size_t(_mm_cvtsi128_si32(odd)) + size_t(_mm_extract_epi16(odd, 4));
+}
+
+VU_TARGET("sse2")
+static size_t CountZerosSSE2(const byte* s, const size_t n, size_t counts[2])
+{
+  const __m128i zero = _mm_setzero_si128();
+  const size_t last = n & ~size_t(15);
+
+  size_t i = 0;
+
+  while (i < last)
+  {
+    const size_t end = last - i > 255 * 16 ? i + 255 * 16 : last;
+
+    __m128i acc = zero;
+    for (; i < end; i += 16)
+    {
+      const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+      acc = _mm_sub_epi8(acc, _mm_cmpeq_epi8(v, zero));
+    }
+
+    SumZerosSSE2(acc, counts);
+  }
+
+  return i;
+}
+
+VU_TARGET("avx2")
+static size_t CountZerosAVX2(const byte* s, const size_t n, size_t counts[2])
+{
+  const __m256i zero = _mm256_setzero_si256();
+  const size_t last = n & ~size_t(31);
+
+  size_t i = 0;
+
+  while (i < last)
+  {
+    const size_t end = last - i > 255 * 32 ? i + 255 * 32 : last;
+
+    __m256i acc = zero;
+    for (; i < end; i += 32)
+    {
+      const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+      acc = _mm256_sub_epi8(acc, _mm256_cmpeq_epi8(v, zero));
+    }
+
+    // The lanes start at the even offsets, so the two halves are summed as one
+
+    SumZerosSSE2(_mm256_castsi256_si128(acc), counts);
+    SumZerosSSE2(_mm256_extracti128_si256(acc, 1), counts);
+  }
+
+  return i + CountZerosSSE2(s + i, n - i, counts);
+}
+
+#endif // VU_SIMD_X86
+
+/**
+ * Hexadecimal
+ * A nibble is converted to its digit by adding '0' and the gap between '9' and the first letter
+ * if it is above 9. A digit is decoded by the unsigned range checks of c - '0' and (c | 0x20) - 'a'.
+ */
+
+static const char HEX_DIGITS_LOWER[] = "0123456789abcdef";
+static const char HEX_DIGITS_UPPER[] = "0123456789ABCDEF";
+
+static void EncodeHexScalar(const byte* s, const size_t n, char* d, const bool upper)
+{
+  const char* digits = upper ? HEX_DIGITS_UPPER : HEX_DIGITS_LOWER;
+
+  for (size_t i = 0; i < n; i++)
+  {
+    d[2 * i + 0] = digits[s[i] >> 4];
+    d[2 * i + 1] = digits[s[i] & 0x0F];
+  }
+}
+
+static int HexValue(const byte c)
+{
+  if (uint(c - '0') < 10)
+  {
+    return c - '0';
+  }
+
+  if (uint((c | 0x20) - 'a') < 6)
+  {
+    return (c | 0x20) - 'a' + 10;
+  }
+
+  return -1;
+}
+
+static size_t DecodeHexScalar(const char* t, const size_t n, byte* d)
+{
+  for (size_t i = 0; i < n; i++)
+  {
+    const int hi = HexValue(byte(t[2 * i + 0]));
+    const int lo = HexValue(byte(t[2 * i + 1]));
+    if (hi < 0 || lo < 0)
+    {
+      return i;
+    }
+
+    d[i] = byte((hi << 4) | lo);
+  }
+
+  return n;
+}
+
+#ifdef VU_SIMD_X86
+
+VU_TARGET("sse2")
+static __m128i HexDigitsSSE2(const __m128i nibbles, const __m128i gap)
+{
+  const __m128i above = _mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9));
+  return _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), _mm_and_si128(above, gap));
+}
+
+VU_TARGET("sse2")
+static size_t EncodeHexSSE2(const byte* s, const size_t n, char* d, const bool upper)
+{
+  const __m128i mask = _mm_set1_epi8(0x0F);
+  const __m128i gap  = _mm_set1_epi8(char((upper ? 'A' : 'a') - '9' - 1));
+
+  size_t i = 0;
+
+  for (; i + 16 <= n; i += 16)
+  {
+    const __m128i v  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+    const __m128i hi = HexDigitsSSE2(_mm_and_si128(_mm_srli_epi16(v, 4), mask), gap);
+    const __m128i lo = HexDigitsSSE2(_mm_and_si128(v, mask), gap);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(d + 2 * i), _mm_unpacklo_epi8(hi, lo));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(d + 2 * i + 16), _mm_unpackhi_epi8(hi, lo));
+  }
+
+  return i;
+}
+
+VU_TARGET("sse2")
+static __m128i HexValuesSSE2(const __m128i c, __m128i& valid)
+{
+  const __m128i digit  = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+  const __m128i letter = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+  const __m128i isdigit  = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+  const __m128i isletter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+  valid = _mm_or_si128(isdigit, isletter);
+  return _mm_or_si128(
+    _mm_and_si128(isdigit, digit),
+    _mm_and_si128(isletter, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+}
+
+/**
+ * A pair of digits is a 16-bit lane with its high nibble in the low byte.
+ */
+VU_TARGET("sse2")
+static __m128i HexPairsSSE2(const __m128i v)
+{
+  return _mm_or_si128(_mm_slli_epi16(_mm_and_si128(v, _mm_set1_epi16(0x00FF)), 4), _mm_srli_epi16(v, 8));
+}
+
+VU_TARGET("sse2")
+static size_t DecodeHexSSE2(const char* t, const size_t n, byte* d)
+{
+  size_t i = 0;
+
+  for (; i + 16 <= n; i += 16)
+  {
+    __m128i va, vb;
+    const __m128i a = HexValuesSSE2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(t + 2 * i)), va);
+    const __m128i b = HexValuesSSE2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(t + 2 * i + 16)), vb);
+    if (_mm_movemask_epi8(_mm_and_si128(va, vb)) != 0xFFFF)
+    {
+      break; // The scalar finds the invalid pair
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(d + i), _mm_packus_epi16(HexPairsSSE2(a), HexPairsSSE2(b)));
+  }
+
+  return i;
+}
+
+VU_TARGET("avx2")
+static __m256i HexDigitsAVX2(const __m256i nibbles, const __m256i gap)
+{
+  const __m256i above = _mm256_cmpgt_epi8(nibbles, _mm256_set1_epi8(9));
+  return _mm256_add_epi8(_mm256_add_epi8(nibbles, _mm256_set1_epi8('0')), _mm256_and_si256(above, gap));
+}
+
+VU_TARGET("avx2")
+static size_t EncodeHexAVX2(const byte* s, const size_t n, char* d, const bool upper)
+{
+  const __m256i mask = _mm256_set1_epi8(0x0F);
+  const __m256i gap  = _mm256_set1_epi8(char((upper ? 'A' : 'a') - '9' - 1));
+
+  size_t i = 0;
+
+  for (; i + 32 <= n; i += 32)
+  {
+    const __m256i v  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+    const __m256i hi = HexDigitsAVX2(_mm256_and_si256(_mm256_srli_epi16(v, 4), mask), gap);
+    const __m256i lo = HexDigitsAVX2(_mm256_and_si256(v, mask), gap);
+
+    // The unpacks work within the 128-bit lanes, so the halves are put back in order
+
+    const __m256i a = _mm256_unpacklo_epi8(hi, lo);
+    const __m256i b = _mm256_unpackhi_epi8(hi, lo);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + 2 * i), _mm256_permute2x128_si256(a, b, 0x20));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + 2 * i + 32), _mm256_permute2x128_si256(a, b, 0x31));
+  }
+
+  return i + EncodeHexSSE2(s + i, n - i, d + 2 * i, upper);
+}
+
+VU_TARGET("avx2")
+static __m256i HexValuesAVX2(const __m256i c, __m256i& valid)
+{
+  const __m256i digit  = _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+  const __m256i letter = _mm256_sub_epi8(_mm256_or_si256(c, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+  const __m256i isdigit  = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+  const __m256i isletter = _mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(5)), letter);
+  valid = _mm256_or_si256(isdigit, isletter);
+  return _mm256_or_si256(
+    _mm256_and_si256(isdigit, digit),
+    _mm256_and_si256(isletter, _mm256_add_epi8(letter, _mm256_set1_epi8(10))));
+}
+
+VU_TARGET("avx2")
+static __m256i HexPairsAVX2(const __m256i v)
+{
+  return _mm256_or_si256(
+    _mm256_slli_epi16(_mm256_and_si256(v, _mm256_set1_epi16(0x00FF)), 4), _mm256_srli_epi16(v, 8));
+}
+
+VU_TARGET("avx2")
+static size_t DecodeHexAVX2(const char* t, const size_t n, byte* d)
+{
+  size_t i = 0;
+
+  for (; i + 32 <= n; i += 32)
+  {
+    __m256i va, vb;
+    const __m256i a = HexValuesAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(t + 2 * i)), va);
+    const __m256i b = HexValuesAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(t + 2 * i + 32)), vb);
+    if (_mm256_movemask_epi8(_mm256_and_si256(va, vb)) != -1)
+    {
+      break;
+    }
+
+    // The pack works within the 128-bit lanes, so the 64-bit quarters are put back in order
+
+    const __m256i v = _mm256_packus_epi16(HexPairsAVX2(a), HexPairsAVX2(b));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + i), _mm256_permute4x64_epi64(v, 0xD8));
+  }
+
+  return i + DecodeHexSSE2(t + 2 * i, n - i, d + i);
+}
+
+#endif // VU_SIMD_X86
+
+/**
+ * Dispatchers
+ */
+
+size_t vuapi SIMDFind(
+  const void* data, const size_t size,
+  const void* pattern, const size_t length,
+  const eSIMDLevel level)
+{
+  if (data == nullptr || pattern == nullptr || length == 0 || size < length)
+  {
+    return -1;
+  }
+
+  const auto s = static_cast<const byte*>(data);
+  const auto p = static_cast<const byte*>(pattern);
+
+  if (length == 1)
+  {
+    return FindByte(s, size, p[0]);
+  }
+
+  if (length >= HORSPOOL_MIN_LENGTH)
+  {
+    return FindHorspool(s, size, p, length);
+  }
+
+  #ifdef VU_SIMD_X86
+  switch (level)
+  {
+  case SL_AVX2:
+    return FindAVX2(s, size, p, length);
+  case SL_SSE2:
+    return FindSSE2(s, size, p, length);
+  default:
+    break;
+  }
+  #endif // VU_SIMD_X86
+
+  return FindScalar(s, size, p, length);
+}
+
+size_t vuapi SIMDRFind(
+  const void* data, const size_t size,
+  const void* pattern, const size_t length,
+  const eSIMDLevel level)
+{
+  if (data == nullptr || pattern == nullptr || length == 0 || size < length)
+  {
+    return -1;
+  }
+
+  const auto s = static_cast<const byte*>(data);
+  const auto p = static_cast<const byte*>(pattern);
+
+  if (length == 1)
+  {
+    return RFindByte(s, size, p[0]);
+  }
+
+  if (length >= HORSPOOL_MIN_LENGTH)
+  {
+    return RFindHorspool(s, size, p, length);
+  }
+
+  #ifdef VU_SIMD_X86
+  switch (level)
+  {
+  case SL_AVX2:
+    return RFindAVX2(s, size, p, length);
+  case SL_SSE2:
+    return RFindSSE2(s, size, p, length);
+  default:
+    break;
+  }
+  #endif // VU_SIMD_X86
+
+  return RFindScalar(s, size, p, length);
+}
+
+size_t vuapi SIMDFindMasked(
+  const void* data, const size_t size,
+  const byte* values, const byte* masks, const size_t length,
+  const size_t anchors[2],
+  const eSIMDLevel level)
+{
+  if (data == nullptr || values == nullptr || masks == nullptr || length == 0 || size < length)
+  {
+    return -1;
+  }
+
+  const auto s = static_cast<const byte*>(data);
+
+  #ifdef VU_SIMD_X86
+  switch (level)
+  {
+  case SL_AVX2:
+    return FindMaskedAVX2(s, size, values, masks, length, anchors);
+  case SL_SSE2:
+    return FindMaskedSSE2(s, size, values, masks, length, anchors);
+  default:
+    break;
+  }
+  #endif // VU_SIMD_X86
+
+  return FindMaskedScalar(s, size, values, masks, length, anchors);
+}
+
+void vuapi SIMDChangeCase(
+  void* data, const size_t count, const size_t width, const bool upper,
+  const eSIMDLevel level)
+{
+  if (data == nullptr || count == 0)
+  {
+    return;
+  }
+
+  size_t done = 0; // The characters that are converted by the vectors
+
+  #ifdef VU_SIMD_X86
+  if (width <= 2)
+  {
+    const auto s = static_cast<byte*>(data);
+    switch (level)
+    {
+    case SL_AVX2:
+      done = ChangeCaseAVX2(s, count * width, width, upper) / width;
+      break;
+    case SL_SSE2:
+      done = ChangeCaseSSE2(s, count * width, width, upper) / width;
+      break;
+    default:
+      break;
+    }
+  }
+  #endif // VU_SIMD_X86
+
+  ChangeCaseScalar(static_cast<byte*>(data) + done * width, count - done, width, upper);
+}
+
+int vuapi SIMDCompareIgnoreCase(
+  const void* left, const void* right, const size_t count, const size_t width,
+  const eSIMDLevel level)
+{
+  if (left == nullptr || right == nullptr || count == 0)
+  {
+    return 0;
+  }
+
+  size_t done = 0; // The characters that are equal in the vectors
+
+  #ifdef VU_SIMD_X86
+  if (width <= 2)
+  {
+    const auto a = static_cast<const byte*>(left);
+    const auto b = static_cast<const byte*>(right);
+    switch (level)
+    {
+    case SL_AVX2:
+      done = EqualPrefixAVX2(a, b, count * width, width) / width;
+      break;
+    case SL_SSE2:
+      done = EqualPrefixSSE2(a, b, count * width, width) / width;
+      break;
+    default:
+      break;
+    }
+  }
+  #endif // VU_SIMD_X86
+
+  return CompareIgnoreCaseScalar(
+    static_cast<const byte*>(left) + done * width,
+    static_cast<const byte*>(right) + done * width,
+    count - done, width);
+}
+
+size_t vuapi SIMDASCIIPrefix(
+  const void* data, const size_t count, const size_t width,
+  const eSIMDLevel level)
+{
+  if (data == nullptr || count == 0)
+  {
+    return 0;
+  }
+
+  size_t done = 0; // The characters that are checked by the vectors
+
+  #ifdef VU_SIMD_X86
+  const auto s = static_cast<const byte*>(data);
+  switch (level)
+  {
+  case SL_AVX2:
+    done = ASCIIPrefixAVX2(s, count * width, width) / width;
+    break;
+  case SL_SSE2:
+    done = ASCIIPrefixSSE2(s, count * width, width) / width;
+    break;
+  default:
+    break;
+  }
+  #endif // VU_SIMD_X86
+
+  return done + ASCIIPrefixScalar(static_cast<const byte*>(data) + done * width, count - done, width);
+}
+
+void vuapi SIMDCopyASCII(
+  const void* source, const size_t count, const size_t from,
+  void* target, const size_t to,
+  const eSIMDLevel level)
+{
+  if (source == nullptr || target == nullptr || count == 0)
+  {
+    return;
+  }
+
+  if (from == to)
+  {
+    memcpy(target, source, count * from);
+    return;
+  }
+
+  size_t done = 0; // The characters that are converted by the vectors
+
+  #ifdef VU_SIMD_X86
+  // The packs and the unpacks work within the 128-bit lanes, so AVX2 takes the SSE2 path
+  if (level != SL_NONE)
+  {
+    done = CopyASCIISSE2(static_cast<const byte*>(source), count, from, static_cast<byte*>(target), to);
+  }
+  #endif // VU_SIMD_X86
+
+  CopyASCIIScalar(
+    static_cast<const byte*>(source) + done * from, count - done, from,
+    static_cast<byte*>(target) + done * to, to);
+}
+
+void vuapi SIMDCountZeros(
+  const void* data, const size_t size, size_t counts[2],
+  const eSIMDLevel level)
+{
+  if (data == nullptr || size == 0)
+  {
+    return;
+  }
+
+  const auto s = static_cast<const byte*>(data);
+
+  size_t done = 0; // The bytes that are counted by the vectors, it is always even
+
+  #ifdef VU_SIMD_X86
+  switch (level)
+  {
+  case SL_AVX2:
+    done = CountZerosAVX2(s, size, counts);
+    break;
+  case SL_SSE2:
+    done = CountZerosSSE2(s, size, counts);
+    break;
+  default:
+    break;
+  }
+  #endif // VU_SIMD_X86
+
+  CountZerosScalar(s + done, size - done, counts);
+}
+
+void vuapi SIMDEncodeHex(
+  const void* data, const size_t size, char* text, const bool upper,
+  const eSIMDLevel level)
+{
+  if (data == nullptr || text == nullptr || size == 0)
+  {
+    return;
+  }
+
+  const auto s = static_cast<const byte*>(data);
+
+  size_t done = 0; // The bytes that are encoded by the vectors
+
+  #ifdef VU_SIMD_X86
+  switch (level)
+  {
+  case SL_AVX2:
+    done = EncodeHexAVX2(s, size, text, upper);
+    break;
+  case SL_SSE2:
+    done = EncodeHexSSE2(s, size, text, upper);
+    break;
+  default:
+    break;
+  }
+  #endif // VU_SIMD_X86
+
+  EncodeHexScalar(s + done, size - done, text + 2 * done, upper);
+}
+
+size_t vuapi SIMDDecodeHex(
+  const char* text, const size_t count, void* data,
+  const eSIMDLevel level)
+{
+  if (text == nullptr || data == nullptr || count == 0)
+  {
+    return 0;
+  }
+
+  const auto d = static_cast<byte*>(data);
+
+  size_t done = 0; // The bytes that are decoded by the vectors
+
+  #ifdef VU_SIMD_X86
+  switch (level)
+  {
+  case SL_AVX2:
+    done = DecodeHexAVX2(text, count, d);
+    break;
+  case SL_SSE2:
+    done = DecodeHexSSE2(text, count, d);
+    break;
+  default:
+    break;
+  }
+  #endif // VU_SIMD_X86
+
+  return done + DecodeHexScalar(text + 2 * done, count - done, d + done);
+}
+
+} // namespace vu
@@ -0,0 +1,124 @@
+/**
+ * @file   simd.h
+ * @author Vic P.
+ * @brief  Header for SIMD Routines
+ */
+
+#pragma once
+
+#include "Vutils.h"
+
+namespace vu
+{
+
+typedef enum _SIMD_LEVEL
+{
+  SL_NONE = 0, // Scalar
+  SL_SSE2 = 1,
+  SL_AVX2 = 2,
+} eSIMDLevel;
+
+/**
+ * Gets the highest instruction set supported by both CPU and OS.
+ */
+eSIMDLevel vuapi GetSIMDLevel();
+
+/**
+ * Finds the first/last occurrence of a sequence of bytes in a memory block.
+ * @param[in] level The instruction set to use, it must be supported by the running CPU.
+ * @return  The offset of the occurrence or -1 if not found.
+ */
+size_t vuapi SIMDFind(
+  const void* data, const size_t size,
+  const void* pattern, const size_t length,
+  const eSIMDLevel level = GetSIMDLevel()
+);
+
+size_t vuapi SIMDRFind(
+  const void* data, const size_t size,
+  const void* pattern, const size_t length,
+  const eSIMDLevel level = GetSIMDLevel()
+);
+
+/**
+ * Finds the first occurrence of a masked byte pattern, the byte i matches if (data & masks[i]) == values[i].
+ * @param[in] values  The pattern values (already masked), padded with zeros to a multiple of 16 bytes.
+ * @param[in] masks   The pattern masks, padded with zeros to a multiple of 16 bytes.
+ * @param[in] anchors The indexes of the two most selective bytes, used to filter the candidate positions.
+ * @return  The offset of the occurrence or -1 if not found.
+ */
+size_t vuapi SIMDFindMasked(
+  const void* data, const size_t size,
+  const byte* values, const byte* masks, const size_t length,
+  const size_t anchors[2],
+  const eSIMDLevel level = GetSIMDLevel()
+);
+
+/**
+ * Converts the ASCII letters of a string in place, the other characters are kept as they are.
+ * @param[in] width The size of a character in bytes, 1, 2 or 4.
+ */
+void vuapi SIMDChangeCase(
+  void* data, const size_t count, const size_t width, const bool upper,
+  const eSIMDLevel level = GetSIMDLevel()
+);
+
+/**
+ * Compares two strings of the same length ignoring the case of the ASCII letters.
+ * @param[in] width The size of a character in bytes, 1, 2 or 4.
+ * @return  <0, 0 or >0 as the first mismatched characters (lower-cased) compare, like memcmp.
+ */
+int vuapi SIMDCompareIgnoreCase(
+  const void* left, const void* right, const size_t count, const size_t width,
+  const eSIMDLevel level = GetSIMDLevel()
+);
+
+/**
+ * Gets the number of the leading ASCII characters (below 0x80) of a string.
+ * @param[in] width The size of a character in bytes, 1, 2 or 4 (little-endian).
+ */
+size_t vuapi SIMDASCIIPrefix(
+  const void* data, const size_t count, const size_t width,
+  const eSIMDLevel level = GetSIMDLevel()
+);
+
+/**
+ * Copies ASCII characters to another character width, e.g. widens UTF-8 to UTF-16LE.
+ * @param[in] from  The size of a source character in bytes, 1, 2 or 4 (little-endian).
+ * @param[in] to    The size of a target character in bytes, 1, 2 or 4 (little-endian).
+ */
+void vuapi SIMDCopyASCII(
+  const void* source, const size_t count, const size_t from,
+  void* target, const size_t to,
+  const eSIMDLevel level = GetSIMDLevel()
+);
+
+/**
+ * Counts the zero bytes at the even and at the odd offsets of a memory block.
+ * @param[out] counts The counts are added to counts[0] (the even offsets) and counts[1] (the odd offsets).
+ */
+void vuapi SIMDCountZeros(
+  const void* data, const size_t size, size_t counts[2],
+  const eSIMDLevel level = GetSIMDLevel()
+);
+
+/**
+ * Encodes the bytes as the hexadecimal digits, 2 characters per byte and the high nibble first.
+ * @param[out] text The buffer of 2 * size characters, no null character is written.
+ */
+void vuapi SIMDEncodeHex(
+  const void* data, const size_t size, char* text, const bool upper,
+  const eSIMDLevel level = GetSIMDLevel()
+);
+
+/**
+ * Decodes the pairs of hexadecimal digits (of either case) into the bytes.
+ * @param[in] count The number of the bytes to decode, the text has 2 * count characters.
+ * @return  The number of the decoded bytes, it is less than count if a pair is invalid.
+ */
+size_t vuapi SIMDDecodeHex(
+  const char* text, const size_t count, void* data,
+  const eSIMDLevel level = GetSIMDLevel()
+);
+
+} // namespace vu
@@ -6,6 +6,8 @@
 
 #include "Vutils.h"
 
+#include <algorithm>
+
 #ifdef VU_SOCKET_ENABLED
 #if defined(_MSC_VER) || defined(__BCPLUSPLUS__)
 #pragma comment(lib, "ws2_32.lib")
@@ -24,6 +26,19 @@ namespace vu
 
 const size_t VU_DEF_BLOCK_SIZE = KiB;
 
+/**
+ * Moves the received data into a buffer at once, it is sized a single time instead of growing per block.
+ */
+static void AppendChain(CBuffer& buffer, const CChainBuffer& chain)
+{
+  buffer.Reserve(buffer.GetSize() + chain.GetSize());
+
+  for (const auto& block : chain.GetBlocks())
+  {
+    buffer.Append(block.Address, block.Size);
+  }
+}
+
 CSocket::CSocket(
   const AddressFamily af,
   const Type type,
@@ -306,6 +321,39 @@ IResult vuapi CSocket::Send(const CBuffer& data, const Flags flags)
   return this->Send((const char*)data.GetpData(), int(data.GetSize()), flags);
 }
 
+IResult vuapi CSocket::Send(const CChainBuffer& data, const Flags flags)
+{
+  if (!this->Available())
+  {
+    return SOCKET_ERROR;
+  }
+
+  if (data.Empty())
+  {
+    return 0;
+  }
+
+  // Gathers all segments in a single call, so the chain is never copied into a contiguous buffer
+
+  const auto blocks = data.GetBlocks();
+
+  std::vector<WSABUF> buffers(blocks.size());
+  for (size_t i = 0; i < blocks.size(); i++)
+  {
+    buffers[i].buf = static_cast<char*>(blocks[i].Address);
+    buffers[i].len = ULONG(blocks[i].Size);
+  }
+
+  DWORD sent = 0;
+  if (WSASend(m_Socket, &buffers[0], DWORD(buffers.size()), &sent, flags, nullptr, nullptr) == SOCKET_ERROR)
+  {
+    m_LastErrorCode = GetLastError();
+    return SOCKET_ERROR;
+  }
+
+  return IResult(sent);
+}
+
 IResult vuapi CSocket::Recv(char* lpData, int size, const Flags flags)
 {
   if (!this->Available())
@@ -340,29 +388,35 @@ IResult vuapi CSocket::Recv(CBuffer& Data, const Flags flags)
 
 IResult vuapi CSocket::Recvall(CBuffer& Data, const Flags flags)
 {
-  CBuffer buffer;
+  CChainBuffer chain;
+  this->Recvall(chain, flags);
+
+  AppendChain(Data, chain);
+
+  return IResult(Data.GetSize());
+}
+
+IResult vuapi CSocket::Recvall(CChainBuffer& Data, const Flags flags)
+{
+  IResult z = 0;
 
   do
   {
-    buffer.Resize(VU_DEF_BLOCK_SIZE);
-    IResult z = this->Recv(buffer, flags);
-    if (z <= 0)
+    size_t size = 0;
+    auto ptr = Data.Prepare(size);
+    size = std::min(size, VU_DEF_BLOCK_SIZE);
+
+    z = this->Recv((char*)ptr, int(size), flags);
+    if (z > 0)
     {
-      buffer.Reset();
+      Data.Commit(z);
     }
-    else
+
+    if (z < int(size))
     {
-      if (z < static_cast<int>(buffer.GetSize()))
-      {
-        buffer.Resize(z);
-      }
-      Data.Append(buffer);
-      if (z < VU_DEF_BLOCK_SIZE)
-      {
-        buffer.Reset();
-      }
+      break;
     }
-  } while (!buffer.Empty());
+  } while (z > 0);
 
   return IResult(Data.GetSize());
 }
@@ -430,29 +484,35 @@ IResult vuapi CSocket::RecvFrom(char* lpData, int size, const TSocket& socket)
 
 IResult vuapi CSocket::RecvallFrom(CBuffer& Data, const TSocket& socket)
 {
-  CBuffer buffer;
+  CChainBuffer chain;
+  this->RecvallFrom(chain, socket);
+
+  AppendChain(Data, chain);
+
+  return IResult(Data.GetSize());
+}
+
+IResult vuapi CSocket::RecvallFrom(CChainBuffer& Data, const TSocket& socket)
+{
+  IResult z = 0;
 
   do
   {
-    buffer.Resize(VU_DEF_BLOCK_SIZE);
-    IResult z = this->RecvFrom(buffer, socket);
-    if (z <= 0)
+    size_t size = 0;
+    auto ptr = Data.Prepare(size);
+    size = std::min(size, VU_DEF_BLOCK_SIZE);
+
+    z = this->RecvFrom((char*)ptr, int(size), socket);
+    if (z > 0)
     {
-      buffer.Reset();
+      Data.Commit(z);
     }
-    else
+
+    if (z < int(size))
     {
-      if (z < static_cast<int>(buffer.GetSize()))
-      {
-        buffer.Resize(z);
-      }
-      Data.Append(buffer);
-      if (z < VU_DEF_BLOCK_SIZE)
-      {
-        buffer.Reset();
-      }
+      break;
     }
-  } while (!buffer.Empty());
+  } while (z > 0);
 
   return IResult(Data.GetSize());
 }
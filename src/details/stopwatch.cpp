@@ -67,28 +67,22 @@ const vu::CStopWatch::TDuration CStopWatch::Total()
 
 void MessageLoggingA(const std::string& id, const CStopWatch::TDuration& duration)
 {
-  vu::MsgA(id + "%.3fs", duration.second);
+  vu::MsgA("%s%.3fs", id, duration.second);
 }
 
 void ConsoleLoggingA(const std::string& id, const CStopWatch::TDuration& duration)
 {
-  char s[KB] = { 0 };
-  memset(s, 0, sizeof(s));
-  sprintf_s(s, lengthof(s), "%.3fs", duration.second);
-  std::cout << id << s << std::endl;
+  std::cout << vu::FormatA("%s%.3fs", id, duration.second) << std::endl;
 }
 
 void MessageLoggingW(const std::wstring& id, const CStopWatch::TDuration& duration)
 {
-  vu::MsgW(id + L"%.3fs", duration.second);
+  vu::MsgW(L"%s%.3fs", id, duration.second);
 }
 
 void ConsoleLoggingW(const std::wstring& id, const CStopWatch::TDuration& duration)
 {
-  wchar_t s[KB] = { 0 };
-  memset(s, 0, sizeof(s));
-  swprintf_s(s, lengthof(s), L"%.3fs", duration.second);
-  std::wcout << id << s << std::endl;
+  std::wcout << vu::FormatW(L"%s%.3fs", id, duration.second) << std::endl;
 }
 
 /**
@@ -5,9 +5,15 @@
  */
 
 #include "strfmt.h"
+
+#ifdef _WIN32
 #include "lazy.h"
+#endif // _WIN32
 
 #include <math.h>
+#include <cerrno>
+#include <cfloat>
+#include <limits>
 
 namespace vu
 {
@@ -22,20 +28,28 @@ namespace vu
 const std::string  VU_TITLE_BOXA =  "Vutils";
 const std::wstring VU_TITLE_BOXW = L"Vutils";
 
+#ifndef va_copy
+#define va_copy(d, s) ((d) = (s))
+#endif // va_copy
+
 int vuapi GetFormatLengthVLA(const std::string Format, va_list args)
 {
   int N = -1;
 
+  #ifdef _WIN32
   if (InitMiscRoutine() != VU_OK)
   {
     return N;
   }
+  #endif // _WIN32
 
   #ifdef _MSC_VER
   N = _vscprintf(Format.c_str(), args) + 1;
-  #else
+  #elif defined(_WIN32)
   N = pfn_vscprintf(Format.c_str(), args) + 1;
-  #endif
+  #else  // POSIX
+  N = vsnprintf(nullptr, 0, Format.c_str(), args) + 1;
+  #endif // _MSC_VER
 
   return N;
 }
@@ -44,16 +58,28 @@ int vuapi GetFormatLengthVLW(const std::wstring Format, va_list args)
 {
   int N = -1;
 
+  #ifdef _WIN32
   if (InitMiscRoutine() != VU_OK)
   {
     return N;
   }
+  #endif // _WIN32
 
   #ifdef _MSC_VER
   N = _vscwprintf(Format.c_str(), args) + 1;
-  #else
+  #elif defined(_WIN32)
   N = pfn_vscwprintf(Format.c_str(), args) + 1;
-  #endif
+  #else  // POSIX, vswprintf does not measure so it is tried with a buffer that is doubled until it fits
+  for (std::vector<wchar> buffer(256); buffer.size() <= 16 * MB && N < 0; buffer.resize(2 * buffer.size()))
+  {
+    va_list copy;
+    va_copy(copy, args);
+    N = vswprintf(buffer.data(), buffer.size(), Format.c_str(), copy);
+    va_end(copy);
+  }
+
+  N = N < 0 ? -1 : N + 1;
+  #endif // _MSC_VER
 
   return N;
 }
@@ -82,32 +108,55 @@ int vuapi GetFormatLengthW(const std::wstring Format, ...)
   return N;
 }
 
+/**
+ * The C variadic formatting, it formats into a stack buffer first and only measures the length
+ * (the second pass) when the result overflows the buffer.
+ * VS2012 has no va_copy, its va_list is a plain pointer so it is copied by assignment.
+ */
+
+static const size_t FORMAT_STACK_SIZE = 512;
+
 std::string vuapi FormatVLA(const std::string Format, va_list args)
 {
   std::string s;
-  s.clear();
 
-  auto N = GetFormatLengthVLA(Format, args);
-  if (N <= 0)
+  char buffer[FORMAT_STACK_SIZE];
+
+  va_list copy;
+  va_copy(copy, args);
+
+  #if defined(_MSC_VER) || !defined(_WIN32)
+  int N = vsnprintf(buffer, sizeof(buffer), Format.c_str(), copy);
+  #else
+  int N = InitMiscRoutine() == VU_OK ? pfn_vsnprintf(buffer, sizeof(buffer), Format.c_str(), copy) : -1;
+  #endif
+
+  va_end(copy);
+
+  if (N >= 0 && size_t(N) < sizeof(buffer))
   {
+    s.assign(buffer, N);
     return s;
   }
 
-  std::unique_ptr<char[]> p(new char [N]);
-  if (p == nullptr)
+  va_copy(copy, args);
+  N = GetFormatLengthVLA(Format, copy);
+  va_end(copy);
+
+  if (N <= 0)
   {
     return s;
   }
 
-  ZeroMemory(p.get(), N);
+  s.resize(N);
 
-  #ifdef _MSC_VER
-  vsnprintf(p.get(), N, Format.c_str(), args);
+  #if defined(_MSC_VER) || !defined(_WIN32)
+  vsnprintf(&s[0], N, Format.c_str(), args);
   #else
-  pfn_vsnprintf(p.get(), N, Format.c_str(), args);
+  pfn_vsnprintf(&s[0], N, Format.c_str(), args);
   #endif
 
-  s.assign(p.get());
+  s.resize(N - 1); // The terminating null character
 
   return s;
 }
@@ -115,512 +164,1517 @@ std::string vuapi FormatVLA(const std::string Format, va_list args)
 std::wstring vuapi FormatVLW(const std::wstring Format, va_list args)
 {
   std::wstring s;
-  s.clear();
 
-  auto N = GetFormatLengthVLW(Format, args);
-  if (N <= 0)
+  wchar buffer[FORMAT_STACK_SIZE];
+
+  va_list copy;
+  va_copy(copy, args);
+  #ifdef _WIN32
+  int N = _vsnwprintf(buffer, lengthof(buffer), Format.c_str(), copy);
+  #else  // POSIX
+  int N = vswprintf(buffer, lengthof(buffer), Format.c_str(), copy);
+  #endif // _WIN32
+  va_end(copy);
+
+  if (N >= 0 && size_t(N) < lengthof(buffer))
   {
+    s.assign(buffer, N);
     return s;
   }
 
-  std::unique_ptr<wchar[]> p(new wchar [N]);
-  if (p == nullptr)
+  va_copy(copy, args);
+  N = GetFormatLengthVLW(Format, copy);
+  va_end(copy);
+
+  if (N <= 0)
   {
     return s;
   }
 
-  ZeroMemory(p.get(), 2*N);
+  s.resize(N);
 
-  #ifdef _MSC_VER
-  vswprintf(p.get(), Format.c_str(), args);
-  #else
-  pfn_vswprintf(p.get(), N, Format.c_str(), args);
-  #endif
+  #ifdef _WIN32
+  _vsnwprintf(&s[0], N, Format.c_str(), args);
+  #else  // POSIX
+  vswprintf(&s[0], N, Format.c_str(), args);
+  #endif // _WIN32
 
-  s.assign(p.get());
+  s.resize(N - 1); // The terminating null character
 
   return s;
 }
 
-std::string vuapi FormatA(const std::string Format, ...)
-{
-  va_list args;
-  va_start(args, Format);
-
-  auto s = FormatVLA(Format, args);
-
-  va_end(args);
-
-  return s;
-}
+/**
+ * Type-safe Format
+ * A conversion is parsed as printf does, then its argument is written by its own type.
+ * The integers are converted by the digit tables (like to_chars), the floating-points are
+ * converted by the C run-time one at a time with the parsed conversion.
+ */
 
-std::wstring vuapi FormatW(const std::wstring Format, ...)
+template <typename T>
+class CFormatWriterT
 {
-  va_list args;
-  va_start(args, Format);
-
-  auto s = FormatVLW(Format, args);
+public:
+  CFormatWriterT() : m_Size(0)
+  {
+  }
 
-  va_end(args);
+  void Write(const T* s, const size_t n)
+  {
+    if (m_Heap.empty() && m_Size + n <= lengthof(m_Stack))
+    {
+      std::char_traits<T>::copy(m_Stack + m_Size, s, n);
+      m_Size += n;
+      return;
+    }
 
-  return s;
-}
+    if (m_Heap.empty())
+    {
+      m_Heap.reserve(2 * (m_Size + n));
+      m_Heap.assign(m_Stack, m_Size);
+    }
 
-void vuapi MsgA(const std::string Format, ...)
-{
-  va_list args;
-  va_start(args, Format);
+    m_Heap.append(s, n);
+  }
 
-  auto s = FormatVLA(Format, args);
+  template <typename C>
+  void Write(const C* s, const size_t n)
+  {
+    for (size_t i = 0; i < n; i++)
+    {
+      this->Put(T(s[i]));
+    }
+  }
 
-  va_end(args);
+  void Put(const T c)
+  {
+    this->Write(&c, 1);
+  }
 
-  OutputDebugStringA(s.c_str());
-}
+  void Fill(const T c, const size_t n)
+  {
+    for (size_t i = 0; i < n; i++)
+    {
+      this->Put(c);
+    }
+  }
 
-void vuapi MsgW(const std::wstring Format, ...)
-{
-  va_list args;
-  va_start(args, Format);
+  const T* Data() const
+  {
+    return m_Heap.empty() ? m_Stack : m_Heap.data();
+  }
 
-  auto s = FormatVLW(Format, args);
+  size_t Size() const
+  {
+    return m_Heap.empty() ? m_Size : m_Heap.size();
+  }
 
-  va_end(args);
+private:
+  T m_Stack[FORMAT_STACK_SIZE];
+  size_t m_Size;
+  std::basic_string<T> m_Heap; // The result after it overflows the stack buffer
+};
 
-  OutputDebugStringW(s.c_str());
-}
+typedef struct _FORMAT_SPEC
+{
+  bool Left;
+  bool Plus;
+  bool Space;
+  bool Alt;
+  bool Zero;
+  int  Width;
+  int  Precision; // -1 if not specified
+  char Conversion;
+} TFormatSpec;
+
+static const char DIGITS_LOWER[] = "0123456789abcdef";
+static const char DIGITS_UPPER[] = "0123456789ABCDEF";
+
+static const char DIGITS_PAIRS[] =
+  "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+  "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+  "8081828384858687888990919293949596979899";
 
-int vuapi BoxA(const std::string Format, ...)
+/**
+ * Converts an integer backward from the end of a buffer, the decimals are done two digits at a time.
+ * @return  The number of the written digits.
+ */
+static size_t UIntToChars(ulonglong v, const uint base, const bool upper, char* end)
 {
-  va_list args;
-  va_start(args, Format);
+  char* p = end;
 
-  auto s = FormatVLA(Format, args);
+  if (base == 10)
+  {
+    while (v >= 100)
+    {
+      const auto i = size_t(v % 100) * 2;
+      v /= 100;
+      *--p = DIGITS_PAIRS[i + 1];
+      *--p = DIGITS_PAIRS[i];
+    }
 
-  va_end(args);
+    if (v >= 10)
+    {
+      const auto i = size_t(v) * 2;
+      *--p = DIGITS_PAIRS[i + 1];
+      *--p = DIGITS_PAIRS[i];
+    }
+    else
+    {
+      *--p = char('0' + v);
+    }
+  }
+  else
+  {
+    const char* digits = upper ? DIGITS_UPPER : DIGITS_LOWER;
+    do
+    {
+      *--p = digits[v % base];
+      v /= base;
+    } while (v != 0);
+  }
 
-  return MessageBoxA(GetActiveWindow(), s.c_str(), VU_TITLE_BOXA.c_str(), MB_ICONINFORMATION);
+  return size_t(end - p);
 }
 
-int vuapi BoxW(const std::wstring Format, ...)
+template <typename T>
+static bool IsOneOf(const T c, const char* set)
 {
-  va_list args;
-  va_start(args, Format);
-
-  auto s = FormatVLW(Format, args);
-
-  va_end(args);
-
-  return MessageBoxW(GetActiveWindow(), s.c_str(), VU_TITLE_BOXW.c_str(), MB_ICONINFORMATION);
+  return c > 0 && c < 0x80 && strchr(set, int(c)) != nullptr;
 }
 
-int vuapi BoxA(HWND hWnd, const std::string Format, ...)
+template <typename T>
+static void WritePadded(CFormatWriterT<T>& writer, const TFormatSpec& spec, const T* s, const size_t n)
 {
-  va_list args;
-  va_start(args, Format);
+  const size_t width = spec.Width > 0 ? size_t(spec.Width) : 0;
+  const size_t padding = width > n ? width - n : 0;
 
-  auto s = FormatVLA(Format, args);
+  if (!spec.Left)
+  {
+    writer.Fill(T(' '), padding);
+  }
 
-  va_end(args);
+  writer.Write(s, n);
 
-  return MessageBoxA(hWnd, s.c_str(), VU_TITLE_BOXA.c_str(), MB_ICONINFORMATION);
+  if (spec.Left)
+  {
+    writer.Fill(T(' '), padding);
+  }
 }
 
-int vuapi BoxW(HWND hWnd, const std::wstring Format, ...)
+template <typename T>
+static void WriteInteger(CFormatWriterT<T>& writer, const TFormatSpec& spec, const bool negative, const ulonglong magnitude)
 {
-  va_list args;
-  va_start(args, Format);
-
-  auto s = FormatVLW(Format, args);
-
-  va_end(args);
+  uint base = 10;
+  switch (spec.Conversion)
+  {
+  case 'x':
+  case 'X':
+  case 'p':
+    base = 16;
+    break;
+  case 'o':
+    base = 8;
+    break;
+  default:
+    break;
+  }
 
-  return MessageBoxW(hWnd, s.c_str(), VU_TITLE_BOXW.c_str(), MB_ICONINFORMATION);
-}
+  char digits[64];
+  char* end = digits + sizeof(digits);
+  size_t ndigits = spec.Precision == 0 && magnitude == 0 ? 0 : UIntToChars(magnitude, base, spec.Conversion != 'x', end);
 
-int vuapi BoxA(HWND hWnd, uint uType, const std::string& Caption, const std::string Format, ...)
-{
-  va_list args;
-  va_start(args, Format);
+  char prefix[2];
+  size_t nprefix = 0;
 
-  auto s = FormatVLA(Format, args);
+  if (negative)
+  {
+    prefix[nprefix++] = '-';
+  }
+  else if (spec.Conversion == 'd' || spec.Conversion == 'i')
+  {
+    if (spec.Plus)
+    {
+      prefix[nprefix++] = '+';
+    }
+    else if (spec.Space)
+    {
+      prefix[nprefix++] = ' ';
+    }
+  }
 
-  va_end(args);
+  if (spec.Alt && base == 16 && magnitude != 0 && spec.Conversion != 'p')
+  {
+    prefix[nprefix++] = '0';
+    prefix[nprefix++] = spec.Conversion;
+  }
 
-  return MessageBoxA(hWnd, s.c_str(), Caption.c_str(), uType);
-}
+  size_t precision = spec.Precision > 0 ? size_t(spec.Precision) : 0;
 
-int vuapi BoxW(HWND hWnd, uint uType, const std::wstring& Caption, const std::wstring Format, ...)
-{
-  va_list args;
-  va_start(args, Format);
+  if (spec.Conversion == 'p')
+  {
+    precision = 2 * sizeof(void*); // As the C run-time of MSVC, the upper-case hexadecimal without prefix
+  }
 
-  auto s = FormatVLW(Format, args);
+  if (spec.Alt && base == 8 && precision <= ndigits && (magnitude != 0 || ndigits == 0)) // A leading zero
+  {
+    precision = ndigits + 1;
+  }
 
-  va_end(args);
+  const size_t zeros = precision > ndigits ? precision - ndigits : 0;
+  const size_t length = nprefix + zeros + ndigits;
+  const size_t width = spec.Width > 0 ? size_t(spec.Width) : 0;
+  const size_t padding = width > length ? width - length : 0;
 
-  return MessageBoxW(hWnd, s.c_str(), Caption.c_str(), uType);
+  if (spec.Left)
+  {
+    writer.Write(prefix, nprefix);
+    writer.Fill(T('0'), zeros);
+    writer.Write(end - ndigits, ndigits);
+    writer.Fill(T(' '), padding);
+  }
+  else if (spec.Zero && spec.Precision < 0)
+  {
+    writer.Write(prefix, nprefix);
+    writer.Fill(T('0'), zeros + padding);
+    writer.Write(end - ndigits, ndigits);
+  }
+  else
+  {
+    writer.Fill(T(' '), padding);
+    writer.Write(prefix, nprefix);
+    writer.Fill(T('0'), zeros);
+    writer.Write(end - ndigits, ndigits);
+  }
 }
 
-std::string vuapi LastErrorA(ulong ulErrorCode)
+template <typename T>
+static void WriteFloat(CFormatWriterT<T>& writer, const TFormatSpec& spec, const double v)
 {
-  if (ulErrorCode == -1)
+  // Rebuilds the conversion for the C run-time, the widest %f of a double has 309 integral digits
+
+  char format[32];
+  size_t n = 0;
+
+  format[n++] = '%';
+  if (spec.Left)  format[n++] = '-';
+  if (spec.Plus)  format[n++] = '+';
+  if (spec.Space) format[n++] = ' ';
+  if (spec.Alt)   format[n++] = '#';
+  if (spec.Zero)  format[n++] = '0';
+  format[n++] = '*';
+  if (spec.Precision >= 0) // Without a precision, %a writes the exact value
   {
-    ulErrorCode = ::GetLastError();
+    format[n++] = '.';
+    format[n++] = '*';
   }
+  format[n++] = IsOneOf(spec.Conversion, "fFeEgGaA") ? spec.Conversion : 'g';
+  format[n] = '\0';
 
-  char* lpszErrorMessage = nullptr;
+  const int width = spec.Width > 0 ? spec.Width : 0;
+  const int precision = spec.Precision >= 0 ? spec.Precision : 6;
 
-  FormatMessageA(
-    FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_ALLOCATE_BUFFER,
-    NULL,
-    ulErrorCode,
-    LANG_USER_DEFAULT,
-    (char*)&lpszErrorMessage,
-    0,
-    NULL
-  );
+  const size_t size = 320 + size_t(width) + size_t(precision);
 
-  std::string s(lpszErrorMessage);
-  s = TrimStringA(s);
+  char stack[FORMAT_STACK_SIZE];
+  std::unique_ptr<char[]> heap(size > sizeof(stack) ? new char[size] : nullptr);
 
-  return s;
-}
+  char* buffer = heap != nullptr ? heap.get() : stack;
 
-std::wstring vuapi LastErrorW(ulong ulErrorCode)
-{
-  if (ulErrorCode == -1)
+  #ifdef _MSC_VER
+  const int length = spec.Precision >= 0
+    ? _snprintf(buffer, size, format, width, precision, v)
+    : _snprintf(buffer, size, format, width, v);
+  #else  // __GNUC__
+  const int length = spec.Precision >= 0
+    ? snprintf(buffer, size, format, width, precision, v)
+    : snprintf(buffer, size, format, width, v);
+  #endif // _MSC_VER
+
+  if (length > 0)
   {
-    ulErrorCode = ::GetLastError();
+    writer.Write(buffer, std::min(size_t(length), size));
   }
+}
 
-  wchar* lpwszErrorMessage = nullptr;
-
-  FormatMessageW(
-    FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_ALLOCATE_BUFFER,
-    NULL,
-    ulErrorCode,
-    LANG_USER_DEFAULT,
-    (wchar*)&lpwszErrorMessage,
-    0,
-    NULL
-  );
-
-  std::wstring s(lpwszErrorMessage);
-  s = TrimStringW(s);
+/**
+ * A string of the other character type is converted as ToStringA/W do.
+ */
+static void ConvertString(const CFormatArg& arg, std::string& result)
+{
+  result = ToStringA(std::wstring(arg.Value.StringW, arg.Length));
+}
 
-  return s;
+static void ConvertString(const CFormatArg& arg, std::wstring& result)
+{
+  result = ToStringW(std::string(arg.Value.StringA, arg.Length));
 }
 
-std::string vuapi GetFormatStringForNumber(std::string TypeID)
+template <typename T>
+static void WriteString(CFormatWriterT<T>& writer, const TFormatSpec& spec, const CFormatArg& arg)
 {
-  /* MinGW
-    i -> int
-    l -> long
-    x -> long long
-    j -> unsigned
-    m -> unsigned long
-    y -> unsigned long long
-    f -> float
-    d -> double
-    e -> long double
-  */
+  std::basic_string<T> converted;
 
-  std::string fs = "";
+  const T* s = static_cast<const T*>(arg.Value.Pointer);
+  size_t n = arg.Length;
 
-  if (TypeID == "i")
-  {
-    fs = "%d";
-  }
-  else if (TypeID == "l")
-  {
-    fs = "%ld";
-  }
-  else if (TypeID == "x")
+  if ((arg.Type == FA_STRING_A) != (sizeof(T) == sizeof(char)))
   {
-    fs = "lld";
+    ConvertString(arg, converted);
+    s = converted.data();
+    n = converted.size();
   }
-  else if (TypeID == "j")
+
+  if (spec.Precision >= 0 && size_t(spec.Precision) < n)
   {
-    fs = "%u";
+    n = size_t(spec.Precision);
   }
-  else if (TypeID == "m")
+
+  WritePadded(writer, spec, s, n);
+}
+
+template <typename T>
+static void WriteArg(CFormatWriterT<T>& writer, TFormatSpec spec, const CFormatArg& arg)
+{
+  const bool integral = IsOneOf(spec.Conversion, "diuoxXp");
+  const bool floating = IsOneOf(spec.Conversion, "fFeEgGaA");
+
+  switch (arg.Type)
   {
-    fs = "%lu";
+  case FA_BOOL:
+    if (integral)
+    {
+      WriteInteger(writer, spec, false, arg.Value.UInt);
+    }
+    else
+    {
+      const char* s = arg.Value.Int != 0 ? "true" : "false";
+      const T text[] = { T(s[0]), T(s[1]), T(s[2]), T(s[3]), T(s[4]) };
+      WritePadded(writer, spec, text, arg.Value.Int != 0 ? 4 : 5);
+    }
+    break;
+
+  case FA_CHAR:
+    if (integral)
+    {
+      WriteInteger(writer, spec, false, arg.Value.UInt);
+    }
+    else
+    {
+      const T c = T(arg.Value.UInt);
+      WritePadded(writer, spec, &c, 1);
+    }
+    break;
+
+  case FA_INT:
+  case FA_UINT:
+    if (spec.Conversion == 'c')
+    {
+      const T c = T(arg.Value.UInt);
+      WritePadded(writer, spec, &c, 1);
+    }
+    else if (floating)
+    {
+      WriteFloat(writer, spec, arg.Type == FA_INT ? double(arg.Value.Int) : double(arg.Value.UInt));
+    }
+    else
+    {
+      if (!integral)
+      {
+        spec.Conversion = 'd';
+      }
+
+      // A negative value of %u/%x/%o is written as the unsigned of its size, as printf does
+
+      const bool negative = arg.Type == FA_INT && arg.Value.Int < 0 && (spec.Conversion == 'd' || spec.Conversion == 'i');
+      ulonglong magnitude = negative ? ulonglong(0) - arg.Value.UInt : arg.Value.UInt;
+      if (!negative && arg.Length < sizeof(ulonglong))
+      {
+        magnitude &= (ulonglong(1) << (8 * arg.Length)) - 1;
+      }
+      WriteInteger(writer, spec, negative, magnitude);
+    }
+    break;
+
+  case FA_FLOAT:
+    if (!floating)
+    {
+      spec.Conversion = 'g';
+      if (integral && spec.Precision < 0)
+      {
+        spec.Precision = 6;
+      }
+    }
+    WriteFloat(writer, spec, arg.Value.Float);
+    break;
+
+  case FA_POINTER:
+    if (!integral)
+    {
+      spec.Conversion = 'p';
+    }
+    WriteInteger(writer, spec, false, ulonglong(size_t(arg.Value.Pointer)));
+    break;
+
+  case FA_STRING_A:
+  case FA_STRING_W:
+    if (arg.Value.Pointer == nullptr)
+    {
+      const T text[] = { T('('), T('n'), T('u'), T('l'), T('l'), T(')') };
+      WritePadded(writer, spec, text, lengthof(text));
+    }
+    else
+    {
+      WriteString(writer, spec, arg);
+    }
+    break;
+
+  default:
+    break;
+  }
+}
+
+template <typename T>
+static void FormatArgsT(CFormatWriterT<T>& writer, const T* f, const size_t n, const CFormatArg* pArgs, const size_t nArgs)
+{
+  size_t next = 0; // The next argument
+
+  for (size_t i = 0; i < n;)
+  {
+    // The literal text until the next conversion
+
+    const T* p = std::char_traits<T>::find(f + i, n - i, T('%'));
+    const size_t literal = p != nullptr ? size_t(p - f) : n;
+    writer.Write(f + i, literal - i);
+
+    if (p == nullptr)
+    {
+      break;
+    }
+
+    const size_t start = literal;
+    i = literal + 1;
+
+    if (i < n && f[i] == T('%'))
+    {
+      writer.Put(T('%'));
+      i++;
+      continue;
+    }
+
+    TFormatSpec spec = { false, false, false, false, false, 0, -1, 0 };
+
+    for (bool flag = true; flag && i < n; )
+    {
+      switch (f[i])
+      {
+      case T('-'): spec.Left  = true; i++; break;
+      case T('+'): spec.Plus  = true; i++; break;
+      case T(' '): spec.Space = true; i++; break;
+      case T('#'): spec.Alt   = true; i++; break;
+      case T('0'): spec.Zero  = true; i++; break;
+      default: flag = false; break;
+      }
+    }
+
+    // The width and the precision, '*' takes them from the arguments
+
+    const auto number = [&](int& value) -> bool
+    {
+      if (i < n && f[i] == T('*'))
+      {
+        i++;
+        if (next >= nArgs || (pArgs[next].Type != FA_INT && pArgs[next].Type != FA_UINT))
+        {
+          return false;
+        }
+        value = int(pArgs[next++].Value.Int);
+        return true;
+      }
+
+      value = 0;
+      for (; i < n && f[i] >= T('0') && f[i] <= T('9'); i++)
+      {
+        value = value * 10 + int(f[i] - T('0'));
+      }
+
+      return true;
+    };
+
+    bool valid = number(spec.Width);
+    if (spec.Width < 0)
+    {
+      spec.Left = true;
+      spec.Width = -spec.Width;
+    }
+
+    if (valid && i < n && f[i] == T('.'))
+    {
+      i++;
+      valid = number(spec.Precision);
+      if (spec.Precision < 0)
+      {
+        spec.Precision = -1;
+      }
+    }
+
+    // The length modifiers are skipped, the size of a value is known by its argument
+
+    while (i < n && IsOneOf(f[i], "hlLqjztwI0123456789"))
+    {
+      i++;
+    }
+
+    if (i == n)
+    {
+      writer.Write(f + start, n - start);
+      break;
+    }
+
+    const T conversion = f[i++];
+
+    // A conversion without its argument is written as it is, so a mismatch is visible
+
+    if (!valid || next >= nArgs || !IsOneOf(conversion, "diuoxXcsSpfFeEgGaAC"))
+    {
+      writer.Write(f + start, i - start);
+      continue;
+    }
+
+    spec.Conversion = char(conversion);
+
+    WriteArg(writer, spec, pArgs[next++]);
+  }
+}
+
+std::string vuapi FormatArgsA(const std::string& Format, const CFormatArg* pArgs, const size_t nArgs)
+{
+  CFormatWriterT<char> writer;
+  FormatArgsT(writer, Format.data(), Format.size(), pArgs, nArgs);
+  return std::string(writer.Data(), writer.Size());
+}
+
+std::wstring vuapi FormatArgsW(const std::wstring& Format, const CFormatArg* pArgs, const size_t nArgs)
+{
+  CFormatWriterT<wchar> writer;
+  FormatArgsT(writer, Format.data(), Format.size(), pArgs, nArgs);
+  return std::wstring(writer.Data(), writer.Size());
+}
+
+void vuapi AppendFormatArgsA(std::string& Result, const std::string& Format, const CFormatArg* pArgs, const size_t nArgs)
+{
+  CFormatWriterT<char> writer;
+  FormatArgsT(writer, Format.data(), Format.size(), pArgs, nArgs);
+  Result.append(writer.Data(), writer.Size());
+}
+
+void vuapi AppendFormatArgsW(std::wstring& Result, const std::wstring& Format, const CFormatArg* pArgs, const size_t nArgs)
+{
+  CFormatWriterT<wchar> writer;
+  FormatArgsT(writer, Format.data(), Format.size(), pArgs, nArgs);
+  Result.append(writer.Data(), writer.Size());
+}
+
+void vuapi AppendFormatArgsA(CBuffer& Result, const std::string& Format, const CFormatArg* pArgs, const size_t nArgs)
+{
+  CFormatWriterT<char> writer;
+  FormatArgsT(writer, Format.data(), Format.size(), pArgs, nArgs);
+  Result.Append(writer.Data(), writer.Size() * sizeof(char));
+}
+
+void vuapi AppendFormatArgsW(CBuffer& Result, const std::wstring& Format, const CFormatArg* pArgs, const size_t nArgs)
+{
+  CFormatWriterT<wchar> writer;
+  FormatArgsT(writer, Format.data(), Format.size(), pArgs, nArgs);
+  Result.Append(writer.Data(), writer.Size() * sizeof(wchar));
+}
+
+std::string vuapi FormatA(const std::string Format, ...)
+{
+  va_list args;
+  va_start(args, Format);
+
+  auto s = FormatVLA(Format, args);
+
+  va_end(args);
+
+  return s;
+}
+
+std::wstring vuapi FormatW(const std::wstring Format, ...)
+{
+  va_list args;
+  va_start(args, Format);
+
+  auto s = FormatVLW(Format, args);
+
+  va_end(args);
+
+  return s;
+}
+
+void vuapi MsgA(const std::string Format, ...)
+{
+  va_list args;
+  va_start(args, Format);
+
+  auto s = FormatVLA(Format, args);
+
+  va_end(args);
+
+  OutputDebugStringA(s.c_str());
+}
+
+void vuapi MsgW(const std::wstring Format, ...)
+{
+  va_list args;
+  va_start(args, Format);
+
+  auto s = FormatVLW(Format, args);
+
+  va_end(args);
+
+  OutputDebugStringW(s.c_str());
+}
+
+#ifdef _WIN32
+
+int vuapi BoxA(const std::string Format, ...)
+{
+  va_list args;
+  va_start(args, Format);
+
+  auto s = FormatVLA(Format, args);
+
+  va_end(args);
+
+  return MessageBoxA(GetActiveWindow(), s.c_str(), VU_TITLE_BOXA.c_str(), MB_ICONINFORMATION);
+}
+
+int vuapi BoxW(const std::wstring Format, ...)
+{
+  va_list args;
+  va_start(args, Format);
+
+  auto s = FormatVLW(Format, args);
+
+  va_end(args);
+
+  return MessageBoxW(GetActiveWindow(), s.c_str(), VU_TITLE_BOXW.c_str(), MB_ICONINFORMATION);
+}
+
+int vuapi BoxA(HWND hWnd, const std::string Format, ...)
+{
+  va_list args;
+  va_start(args, Format);
+
+  auto s = FormatVLA(Format, args);
+
+  va_end(args);
+
+  return MessageBoxA(hWnd, s.c_str(), VU_TITLE_BOXA.c_str(), MB_ICONINFORMATION);
+}
+
+int vuapi BoxW(HWND hWnd, const std::wstring Format, ...)
+{
+  va_list args;
+  va_start(args, Format);
+
+  auto s = FormatVLW(Format, args);
+
+  va_end(args);
+
+  return MessageBoxW(hWnd, s.c_str(), VU_TITLE_BOXW.c_str(), MB_ICONINFORMATION);
+}
+
+int vuapi BoxA(HWND hWnd, uint uType, const std::string& Caption, const std::string Format, ...)
+{
+  va_list args;
+  va_start(args, Format);
+
+  auto s = FormatVLA(Format, args);
+
+  va_end(args);
+
+  return MessageBoxA(hWnd, s.c_str(), Caption.c_str(), uType);
+}
+
+int vuapi BoxW(HWND hWnd, uint uType, const std::wstring& Caption, const std::wstring Format, ...)
+{
+  va_list args;
+  va_start(args, Format);
+
+  auto s = FormatVLW(Format, args);
+
+  va_end(args);
+
+  return MessageBoxW(hWnd, s.c_str(), Caption.c_str(), uType);
+}
+
+#endif // _WIN32
+
+std::string vuapi LastErrorA(ulong ulErrorCode)
+{
+  if (ulErrorCode == -1)
+  {
+    ulErrorCode = ::GetLastError();
+  }
+
+  #ifndef _WIN32
+  return strerror(int(ulErrorCode)); // POSIX, the last error is errno
+  #else  // _WIN32
+  char* lpszErrorMessage = nullptr;
+
+  FormatMessageA(
+    FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_ALLOCATE_BUFFER,
+    NULL,
+    ulErrorCode,
+    LANG_USER_DEFAULT,
+    (char*)&lpszErrorMessage,
+    0,
+    NULL
+  );
+
+  std::string s(lpszErrorMessage);
+  s = TrimStringA(s);
+
+  return s;
+  #endif // _WIN32
+}
+
+std::wstring vuapi LastErrorW(ulong ulErrorCode)
+{
+  if (ulErrorCode == -1)
+  {
+    ulErrorCode = ::GetLastError();
+  }
+
+  #ifndef _WIN32
+  return ToStringW(strerror(int(ulErrorCode))); // POSIX, the last error is errno
+  #else  // _WIN32
+  wchar* lpwszErrorMessage = nullptr;
+
+  FormatMessageW(
+    FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_ALLOCATE_BUFFER,
+    NULL,
+    ulErrorCode,
+    LANG_USER_DEFAULT,
+    (wchar*)&lpwszErrorMessage,
+    0,
+    NULL
+  );
+
+  std::wstring s(lpwszErrorMessage);
+  s = TrimStringW(s);
+
+  return s;
+  #endif // _WIN32
+}
+
+std::string vuapi GetFormatStringForNumber(std::string TypeID)
+{
+  /* MinGW
+    i -> int
+    l -> long
+    x -> long long
+    j -> unsigned
+    m -> unsigned long
+    y -> unsigned long long
+    f -> float
+    d -> double
+    e -> long double
+  */
+
+  std::string fs = "";
+
+  if (TypeID == "i")
+  {
+    fs = "%d";
+  }
+  else if (TypeID == "l")
+  {
+    fs = "%ld";
+  }
+  else if (TypeID == "x")
+  {
+    fs = "lld";
+  }
+  else if (TypeID == "j")
+  {
+    fs = "%u";
+  }
+  else if (TypeID == "m")
+  {
+    fs = "%lu";
+  }
+  else if (TypeID == "y")
+  {
+    fs = "%llu";
+  }
+  else if (TypeID == "f")
+  {
+    fs = "%f";
+  }
+  else if (TypeID == "d")
+  {
+    fs = "%e";
+  }
+  else if (TypeID == "e")
+  {
+    fs = "%Le";
+  }
+  else
+  {
+    fs = "";
+  }
+
+  return fs;
+}
+
+std::string vuapi DateTimeToStringA(const time_t t)
+{
+  std::string s = FormatDateTimeA(t, "%H:%M:%S %d/%m/%Y");
+  return s;
+}
+
+std::wstring vuapi DateTimeToStringW(const time_t t)
+{
+  std::wstring s = FormatDateTimeW(t, L"%H:%M:%S %d/%m/%Y");
+  return s;
+}
+
+/**
+ * Formats into a stack buffer first, then doubles a heap buffer while it does not fit.
+ * The strftime family returns zero for both an overflow and an empty result, so it stops at a limit.
+ */
+template <typename T, typename Fn>
+static std::basic_string<T> FormatDateTimeT(const time_t t, const std::basic_string<T>& Format, Fn fn)
+{
+  std::basic_string<T> s;
+
+  if (Format.empty())
+  {
+    return s;
+  }
+
+  tm lt = {0};
+
+  #if defined(_MSC_VER) && (_MSC_VER > 1200) // Above VC++ 6.0
+  localtime_s(&lt, &t);
+  #else
+  memcpy((void*)&lt, localtime(&t), sizeof(tm));
+  #endif
+
+  T buffer[MAX_SIZE];
+
+  size_t n = fn(buffer, lengthof(buffer), Format.c_str(), &lt);
+  if (n != 0)
+  {
+    s.assign(buffer, n);
+    return s;
+  }
+
+  for (size_t size = 2 * lengthof(buffer); size <= 256 * lengthof(buffer); size *= 2)
+  {
+    std::vector<T> heap(size);
+    n = fn(&heap[0], size, Format.c_str(), &lt);
+    if (n != 0)
+    {
+      s.assign(&heap[0], n);
+      break;
+    }
+  }
+
+  return s;
+}
+
+std::string vuapi FormatDateTimeA(const time_t t, const std::string Format)
+{
+  return FormatDateTimeT<char>(t, Format, strftime);
+}
+
+std::wstring vuapi FormatDateTimeW(const time_t t, const std::wstring Format)
+{
+  return FormatDateTimeT<wchar>(t, Format, wcsftime);
+}
+
+std::string vuapi FormatBytesA(long long Bytes, eStdByte Std, int Digits)
+{
+  std::string result = "";
+
+  if (Bytes < 0 || Digits < 0)
+  {
+    return result;
+  }
+
+  const auto bytes  = (long double)Bytes;
+  const auto thestd = (long double)Std;
+
+  // Max positive number of long long is 2*63 ~ 9{18}.
+  // So log(9{18}, 1000-1024) ~ 6-7 array index.
+  static const char* SIUnits[]  = { "B", "KB", "MB", "GB", "TB", "PB", "EB" };
+  static const char* IECUnits[] = { "B", "KiB", "MiB", "GiB", "TiB", "PiB", "EiB" };
+  static const auto  Units = Std == eStdByte::IEC ? IECUnits : SIUnits;
+
+  const auto log2l = [](long double v) -> long double
+  {
+    const long double LOG2E = 1.44269504088896340736;
+    return logl(v) * LOG2E;
+  };
+
+  const auto logn = [&](long double v, long double n) -> long double
+  {
+    return log2l(v) / log2l(n);
+  };
+
+  int idx = 0;
+
+  if (Bytes > 0)
+  {
+    idx = (int)logn(bytes, thestd);
+
+    result = FormatA("%.*f %s", Digits, double(bytes / powl(thestd, idx)), Units[idx]);
   }
-  else if (TypeID == "y")
+
+  return result;
+}
+
+std::wstring vuapi FormatBytesW(long long Bytes, eStdByte Std, int Digits)
+{
+  return ToStringW(FormatBytesA(Bytes, Std, Digits));
+}
+
+/**
+ * CFundamental
+ * The numbers are parsed from the text as from_chars does, without the streams and the locale.
+ * A decimal of at most 19 digits and a power of ten within 10^22 is exact in a double, so it is
+ * converted by one multiplication or division, the others are left to strtod.
+ */
+
+static const int PARSED_INTEGER = 1;
+static const int PARSED_DOUBLE  = 2;
+
+template <typename T>
+static bool IsBlank(const T c)
+{
+  return c == T(' ') || c == T('\t') || c == T('\r') || c == T('\n') || c == T('\v') || c == T('\f');
+}
+
+template <typename T>
+static void TrimBlanks(const T*& s, const T*& e)
+{
+  while (s < e && IsBlank(*s))
   {
-    fs = "%llu";
+    s++;
   }
-  else if (TypeID == "f")
+
+  while (e > s && IsBlank(e[-1]))
   {
-    fs = "%f";
+    e--;
   }
-  else if (TypeID == "d")
+}
+
+template <typename T>
+static int DigitValue(const T c)
+{
+  if (c >= T('0') && c <= T('9'))
   {
-    fs = "%e";
+    return int(c - T('0'));
   }
-  else if (TypeID == "e")
+
+  if (c >= T('a') && c <= T('f'))
   {
-    fs = "%Le";
+    return int(c - T('a')) + 10;
   }
-  else
+
+  if (c >= T('A') && c <= T('F'))
   {
-    fs = "";
+    return int(c - T('A')) + 10;
   }
 
-  return fs;
+  return -1;
 }
 
-std::string vuapi DateTimeToStringA(const time_t t)
+template <typename T>
+static eParseStatus ParseInteger(const T* s, const T* e, long long& value)
 {
-  std::string s = FormatDateTimeA(t, "%H:%M:%S %d/%m/%Y");
-  return s;
-}
+  TrimBlanks(s, e);
 
-std::wstring vuapi DateTimeToStringW(const time_t t)
-{
-  std::wstring s = FormatDateTimeW(t, L"%H:%M:%S %d/%m/%Y");
-  return s;
-}
+  bool negative = false;
+  if (s < e && (*s == T('-') || *s == T('+')))
+  {
+    negative = *s++ == T('-');
+  }
 
-std::string vuapi FormatDateTimeA(const time_t t, const std::string Format)
-{
-  std::string s;
-  s.clear();
+  uint base = 10;
+  bool digits = false;
 
-  std::unique_ptr<char[]> p(new char [MAXBYTE]);
-  if (p == nullptr)
+  if (e - s >= 2 && s[0] == T('0') && (s[1] == T('x') || s[1] == T('X')))
   {
-    return s;
+    base = 16;
+    s += 2;
   }
 
-  tm lt = {0};
+  const ulonglong limit = negative
+    ? ulonglong(std::numeric_limits<long long>::max()) + 1
+    : ulonglong(std::numeric_limits<long long>::max());
 
-  ZeroMemory(p.get(), MAX_SIZE);
+  ulonglong magnitude = 0;
+  eParseStatus status = PS_OK;
 
-  #if defined(_MSC_VER) && (_MSC_VER > 1200) // Above VC++ 6.0
-  localtime_s(&lt, &t);
-  #else
-  memcpy((void*)&lt, localtime(&t), sizeof(tm));
-  #endif
+  for (; s < e; s++)
+  {
+    const int d = DigitValue(*s);
+    if (d < 0 || uint(d) >= base)
+    {
+      break;
+    }
+
+    digits = true;
 
-  strftime(p.get(), MAX_SIZE, Format.c_str(), &lt);
+    if (magnitude > (limit - d) / base)
+    {
+      status = PS_OVERFLOW;
+      magnitude = limit;
+    }
+    else if (status == PS_OK)
+    {
+      magnitude = magnitude * base + d;
+    }
+  }
+
+  if (!digits)
+  {
+    status = PS_EMPTY;
+  }
+  else if (status == PS_OK && s != e)
+  {
+    status = PS_INVALID;
+  }
 
-  s.assign(p.get());
+  value = negative && magnitude != 0 ? -(long long)(magnitude - 1) - 1 : (long long)magnitude;
 
-  return s;
+  return status;
 }
 
-std::wstring vuapi FormatDateTimeW(const time_t t, const std::wstring Format)
+static double StringToDouble(const char* s, char** e)
 {
-  std::wstring s;
-  s.clear();
+  return strtod(s, e);
+}
+
+static double StringToDouble(const wchar* s, wchar** e)
+{
+  return wcstod(s, e);
+}
 
-  std::unique_ptr<wchar[]> p(new wchar [MAXBYTE]);
-  if (p == nullptr) return s;
+template <typename T>
+static eParseStatus ParseDouble(const std::basic_string<T>& text, double& value)
+{
+  static const double POWERS[] =
+  {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+  };
 
-  tm lt = {0};
+  value = 0.;
 
-  ZeroMemory(p.get(), 2*MAXBYTE);
+  const T* s = text.data();
+  const T* e = s + text.size();
+  TrimBlanks(s, e);
 
-  #if defined(_MSC_VER) && (_MSC_VER > 1200) // Above VC++ 6.0
-  localtime_s(&lt, &t);
-  #else
-  memcpy((void*)&lt, localtime(&t), sizeof(tm));
-  #endif
+  if (s == e)
+  {
+    return PS_EMPTY;
+  }
 
-  wcsftime(p.get(), 2*MAXBYTE, Format.c_str(), &lt);
+  // The fast path, [sign] digits [. digits] [e [sign] digits]
 
-  s.assign(p.get());
+  const T* p = s;
 
-  return s;
-}
+  const bool negative = *p == T('-');
+  if (*p == T('-') || *p == T('+'))
+  {
+    p++;
+  }
 
-void vuapi HexDump(const void* Data, int Size)
-{
-  const int DEFAULT_DUMP_COLUMN = 16;
+  ulonglong mantissa = 0;
+  int ndigits = 0, scale = 0;
+  bool any = false;
 
-  int i = 0;
-  uchar Buffer[DEFAULT_DUMP_COLUMN + 1], *pData = (uchar*)Data;
+  for (; p < e && *p >= T('0') && *p <= T('9'); p++, any = true)
+  {
+    if (mantissa != 0 || *p != T('0'))
+    {
+      mantissa = mantissa * 10 + (*p - T('0'));
+      ndigits++;
+    }
+  }
 
-  for (int i = 0; i < Size; i++)
+  if (p < e && *p == T('.'))
   {
-    if (i % DEFAULT_DUMP_COLUMN == 0)
+    for (p++; p < e && *p >= T('0') && *p <= T('9'); p++, any = true)
     {
-      if (i != 0)
+      if (mantissa != 0 || *p != T('0'))
       {
-        printf("  %s\n", Buffer);
+        mantissa = mantissa * 10 + (*p - T('0'));
+        ndigits++;
       }
-
-      printf("  %04x ", i);
+      scale--;
     }
+  }
 
-    if (i % DEFAULT_DUMP_COLUMN == 8) printf(" ");
-
-    printf(" %02x", pData[i]);
+  if (any && p < e && (*p == T('e') || *p == T('E')))
+  {
+    const T* q = p + 1;
+    const bool minus = q < e && *q == T('-');
+    if (q < e && (*q == T('-') || *q == T('+')))
+    {
+      q++;
+    }
 
-    if (pData[i] < 0x20 || pData[i] > 0x7E)
+    int exponent = 0;
+    const T* first = q;
+    for (; q < e && *q >= T('0') && *q <= T('9') && exponent < 10000; q++)
     {
-      Buffer[i % DEFAULT_DUMP_COLUMN] = '.';
+      exponent = exponent * 10 + (*q - T('0'));
     }
-    else
+
+    if (q != first)
     {
-      Buffer[i % DEFAULT_DUMP_COLUMN] = pData[i];
+      scale += minus ? -exponent : exponent;
+      p = q;
     }
+  }
+
+  if (any && p == e && ndigits <= 19 && mantissa <= (ulonglong(1) << 53) && scale >= -22 && scale <= 22)
+  {
+    value = double(mantissa);
+    value = scale < 0 ? value / POWERS[-scale] : value * POWERS[scale];
+    value = negative ? -value : value;
+    return PS_OK;
+  }
+
+  // The others (the long mantissas, the big exponents, the hexadecimal, the inf and the nan)
+
+  T* end = nullptr;
+
+  errno = 0;
+  value = StringToDouble(s, &end);
 
-    Buffer[(i % DEFAULT_DUMP_COLUMN) + 1] = '\0';
+  if (end == s)
+  {
+    return PS_EMPTY;
   }
 
-  while (i % DEFAULT_DUMP_COLUMN != 0)
+  if (errno == ERANGE && (value == HUGE_VAL || value == -HUGE_VAL))
   {
-    printf("   ");
-    i++;
+    return PS_OVERFLOW;
   }
 
-  printf("  %s\n", Buffer);
+  return end == e ? PS_OK : PS_INVALID;
 }
 
-std::string vuapi FormatBytesA(long long Bytes, eStdByte Std, int Digits)
+static bool EqualsWord(const char* s, const char* e, const char* word)
 {
-  std::string result = "";
+  return CompareIgnoreCaseA(CStringViewA(s, e - s), CStringViewA(word)) == 0;
+}
 
-  if (Bytes < 0 || Digits < 0)
+static bool EqualsWord(const wchar* s, const wchar* e, const char* word)
+{
+  const size_t n = strlen(word);
+  if (size_t(e - s) != n)
   {
-    return result;
+    return false;
   }
 
-  const auto bytes  = (long double)Bytes;
-  const auto thestd = (long double)Std;
+  for (size_t i = 0; i < n; i++)
+  {
+    if (s[i] >= 0x80 || tolower(int(s[i])) != word[i])
+    {
+      return false;
+    }
+  }
 
-  // Max positive number of long long is 2*63 ~ 9{18}.
-  // So log(9{18}, 1000-1024) ~ 6-7 array index.
-  static const char* SIUnits[]  = { "B", "KB", "MB", "GB", "TB", "PB", "EB" };
-  static const char* IECUnits[] = { "B", "KiB", "MiB", "GiB", "TiB", "PiB", "EiB" };
-  static const auto  Units = Std == eStdByte::IEC ? IECUnits : SIUnits;
+  return true;
+}
 
-  const auto log2l = [](long double v) -> long double
-  {
-    const long double M_LOG2E = 1.44269504088896340736;
-    return logl(v) * M_LOG2E;
-  };
+template <typename T>
+static bool ParseBoolean(const std::basic_string<T>& text, bool& value)
+{
+  static const char* WORDS[][2] = { { "true", "false" }, { "yes", "no" }, { "on", "off" } };
 
-  const auto logn = [&](long double v, long double n) -> long double
+  const T* s = text.data();
+  const T* e = s + text.size();
+  TrimBlanks(s, e);
+
+  for (size_t i = 0; i < lengthof(WORDS); i++)
   {
-    return log2l(v) / log2l(n);
-  };
+    for (size_t j = 0; j < 2; j++)
+    {
+      if (EqualsWord(s, e, WORDS[i][j]))
+      {
+        value = j == 0;
+        return true;
+      }
+    }
+  }
 
-  int idx = 0;
+  return false;
+}
 
-  if (Bytes > 0)
+template <typename Int>
+static Int NarrowInteger(const long long v, eParseStatus& status)
+{
+  if (v < (long long)std::numeric_limits<Int>::min())
   {
-    idx = (int)logn(bytes, thestd);
+    status = PS_OVERFLOW;
+    return std::numeric_limits<Int>::min();
+  }
+
+  if (v > (long long)std::numeric_limits<Int>::max())
+  {
+    status = PS_OVERFLOW;
+    return std::numeric_limits<Int>::max();
+  }
 
-    std::string fmt = "%0.";
-    fmt += std::to_string(Digits);
-    fmt += "f %s";
+  return Int(v);
+}
 
-    result = FormatA(fmt, float(bytes / powl(thestd, idx)), Units[idx]);
+static float NarrowFloat(const double v, eParseStatus& status)
+{
+  if (v > FLT_MAX || v < -FLT_MAX)
+  {
+    if (status == PS_OK && v != HUGE_VAL && v != -HUGE_VAL)
+    {
+      status = PS_OVERFLOW;
+    }
   }
 
-  return result;
+  return float(v);
 }
 
-std::wstring vuapi FormatBytesW(long long Bytes, eStdByte Std, int Digits)
+template <typename T>
+static void AppendArg(std::basic_string<T>& text, const CFormatArg& arg)
 {
-  return ToStringW(FormatBytesA(Bytes, Std, Digits));
+  // As the default conversions of the streams, e.g. %g for the floating-points and 1/0 for the booleans
+
+  const TFormatSpec spec = { false, false, false, false, false, 0, -1, arg.Type == FA_BOOL ? 'd' : 's' };
+
+  CFormatWriterT<T> writer;
+  WriteArg(writer, spec, arg);
+  text.append(writer.Data(), writer.Size());
 }
 
-/**
- * CFundamental
- */
+static void SetStatus(eParseStatus* pStatus, const eParseStatus status)
+{
+  if (pStatus != nullptr)
+  {
+    *pStatus = status;
+  }
+}
 
-CFundamentalA::CFundamentalA()
+CFundamentalA::CFundamentalA() : m_Parsed(0)
+{
+}
+
+CFundamentalA::CFundamentalA(const std::string& text) : m_Data(text), m_Parsed(0)
 {
-  m_Data.clear();
 }
 
 CFundamentalA::~CFundamentalA()
 {
 }
 
-std::stringstream& CFundamentalA::Data()
+const std::string& CFundamentalA::Data() const
 {
   return m_Data;
 }
 
+void CFundamentalA::Assign(const std::string& text)
+{
+  m_Data = text;
+  m_Parsed = 0;
+}
+
+void CFundamentalA::Clear()
+{
+  m_Data.clear();
+  m_Parsed = 0;
+}
+
+void CFundamentalA::Append(const CFormatArg& arg)
+{
+  AppendArg(m_Data, arg);
+  m_Parsed = 0;
+}
+
 std::string CFundamentalA::String() const
 {
-  return m_Data.str();
+  return m_Data;
+}
+
+long long CFundamentalA::LongLong(eParseStatus* pStatus) const
+{
+  if ((m_Parsed & PARSED_INTEGER) == 0)
+  {
+    m_IntegerStatus = ParseInteger(m_Data.data(), m_Data.data() + m_Data.size(), m_Integer);
+    m_Parsed |= PARSED_INTEGER;
+  }
+
+  SetStatus(pStatus, m_IntegerStatus);
+
+  return m_Integer;
 }
 
-bool CFundamentalA::Boolean() const
+int CFundamentalA::Integer(eParseStatus* pStatus) const
 {
-  return Integer() != 0;
+  eParseStatus status = PS_OK;
+  const auto result = NarrowInteger<int>(this->LongLong(&status), status);
+  SetStatus(pStatus, status);
+  return result;
 }
 
-int CFundamentalA::Integer() const
+long CFundamentalA::Long(eParseStatus* pStatus) const
 {
-  return atoi(m_Data.str().c_str());
+  eParseStatus status = PS_OK;
+  const auto result = NarrowInteger<long>(this->LongLong(&status), status);
+  SetStatus(pStatus, status);
+  return result;
 }
 
-long CFundamentalA::Long() const
+bool CFundamentalA::Boolean(eParseStatus* pStatus) const
 {
-  return atol(m_Data.str().c_str());
+  bool result = false;
+  if (ParseBoolean(m_Data, result))
+  {
+    SetStatus(pStatus, PS_OK);
+    return result;
+  }
+
+  return this->LongLong(pStatus) != 0;
 }
 
-float CFundamentalA::Float() const
+double CFundamentalA::Double(eParseStatus* pStatus) const
 {
-  return float(Double());
+  if ((m_Parsed & PARSED_DOUBLE) == 0)
+  {
+    m_DoubleStatus = ParseDouble(m_Data, m_Double);
+    m_Parsed |= PARSED_DOUBLE;
+  }
+
+  SetStatus(pStatus, m_DoubleStatus);
+
+  return m_Double;
 }
 
-double CFundamentalA::Double() const
+float CFundamentalA::Float(eParseStatus* pStatus) const
 {
-  return atof(m_Data.str().c_str());
+  eParseStatus status = PS_OK;
+  const auto result = NarrowFloat(this->Double(&status), status);
+  SetStatus(pStatus, status);
+  return result;
 }
 
-CFundamentalW::CFundamentalW()
+CFundamentalW::CFundamentalW() : m_Parsed(0)
+{
+}
+
+CFundamentalW::CFundamentalW(const std::wstring& text) : m_Data(text), m_Parsed(0)
 {
-  m_Data.clear();
 }
 
 CFundamentalW::~CFundamentalW()
 {
 }
 
-std::wstringstream& CFundamentalW::Data()
+const std::wstring& CFundamentalW::Data() const
 {
   return m_Data;
 }
 
+void CFundamentalW::Assign(const std::wstring& text)
+{
+  m_Data = text;
+  m_Parsed = 0;
+}
+
+void CFundamentalW::Clear()
+{
+  m_Data.clear();
+  m_Parsed = 0;
+}
+
+void CFundamentalW::Append(const CFormatArg& arg)
+{
+  AppendArg(m_Data, arg);
+  m_Parsed = 0;
+}
+
 std::wstring CFundamentalW::String() const
 {
-  return m_Data.str();
+  return m_Data;
+}
+
+long long CFundamentalW::LongLong(eParseStatus* pStatus) const
+{
+  if ((m_Parsed & PARSED_INTEGER) == 0)
+  {
+    m_IntegerStatus = ParseInteger(m_Data.data(), m_Data.data() + m_Data.size(), m_Integer);
+    m_Parsed |= PARSED_INTEGER;
+  }
+
+  SetStatus(pStatus, m_IntegerStatus);
+
+  return m_Integer;
 }
 
-bool CFundamentalW::Boolean() const
+int CFundamentalW::Integer(eParseStatus* pStatus) const
 {
-  return Integer() != 0;
+  eParseStatus status = PS_OK;
+  const auto result = NarrowInteger<int>(this->LongLong(&status), status);
+  SetStatus(pStatus, status);
+  return result;
 }
 
-int CFundamentalW::Integer() const
+long CFundamentalW::Long(eParseStatus* pStatus) const
 {
-  return atoi(ToStringA(m_Data.str()).c_str());
+  eParseStatus status = PS_OK;
+  const auto result = NarrowInteger<long>(this->LongLong(&status), status);
+  SetStatus(pStatus, status);
+  return result;
 }
 
-long CFundamentalW::Long() const
+bool CFundamentalW::Boolean(eParseStatus* pStatus) const
 {
-  return atol(ToStringA(m_Data.str()).c_str());
+  bool result = false;
+  if (ParseBoolean(m_Data, result))
+  {
+    SetStatus(pStatus, PS_OK);
+    return result;
+  }
+
+  return this->LongLong(pStatus) != 0;
 }
 
-float CFundamentalW::Float() const
+double CFundamentalW::Double(eParseStatus* pStatus) const
 {
-  return float(Double());
+  if ((m_Parsed & PARSED_DOUBLE) == 0)
+  {
+    m_DoubleStatus = ParseDouble(m_Data, m_Double);
+    m_Parsed |= PARSED_DOUBLE;
+  }
+
+  SetStatus(pStatus, m_DoubleStatus);
+
+  return m_Double;
 }
 
-double CFundamentalW::Double() const
+float CFundamentalW::Float(eParseStatus* pStatus) const
 {
-  return atof(ToStringA(m_Data.str()).c_str());
+  eParseStatus status = PS_OK;
+  const auto result = NarrowFloat(this->Double(&status), status);
+  SetStatus(pStatus, status);
+  return result;
 }
 
 #ifdef _MSC_VER
@@ -5,8 +5,8 @@
  */
 
 #include "Vutils.h"
+#include "simd.h"
 
-#include <csignal>
 #include <algorithm>
 
 namespace vu
@@ -20,62 +20,251 @@ namespace vu
 #pragma warning(disable: 26812)
 #endif // _MSC_VER
 
-#ifndef CHAR_BIT
-#define CHAR_BIT      8    // number of bits in a char
-#define SCHAR_MIN   (-128) // minimum signed char value
-#define SCHAR_MAX     127  // maximum signed char value
-#define UCHAR_MAX     255  // maximum unsigned char value
-#endif
+/**
+ * CEncodingDetector
+ */
+
+/**
+ * The zero bytes on the dominant parity are UTF-16 if they are at least 1/10 of the code units
+ * and 9/10 of the zero bytes, a text without that parity may have a few stray zero bytes (1/1000).
+ */
+static const size_t UTF16_MIN_ZEROS_RATIO  = 10;
+static const size_t UTF16_MIN_PARITY_RATIO = 9;
+static const size_t TEXT_MAX_ZEROS_RATIO   = 1000;
+
+static eEncodingType DetermineBOM(const byte* p, const size_t n)
+{
+  if (n >= 4 && p[0] == 0xFF && p[1] == 0xFE && p[2] == 0x00 && p[3] == 0x00)
+  {
+    return eEncodingType::ET_UTF32_LE_BOM;
+  }
+
+  if (n >= 4 && p[0] == 0x00 && p[1] == 0x00 && p[2] == 0xFE && p[3] == 0xFF)
+  {
+    return eEncodingType::ET_UTF32_BE_BOM;
+  }
+
+  if (n >= 3 && p[0] == 0xEF && p[1] == 0xBB && p[2] == 0xBF)
+  {
+    return eEncodingType::ET_UTF8_BOM;
+  }
 
-eEncodingType vuapi DetermineEncodingType(const void* Data, const size_t size)
+  if (n >= 2 && p[0] == 0xFF && p[1] == 0xFE)
+  {
+    return eEncodingType::ET_UTF16_LE_BOM;
+  }
+
+  if (n >= 2 && p[0] == 0xFE && p[1] == 0xFF)
+  {
+    return eEncodingType::ET_UTF16_BE_BOM;
+  }
+
+  return eEncodingType::ET_UNKNOWN;
+}
+
+CEncodingDetector::CEncodingDetector(const size_t limit) : m_Limit(limit)
 {
-  if (Data == nullptr || size == 0) return eEncodingType::ET_UNKNOWN;
+  this->Reset();
+}
 
-  auto p = (uchar*)Data;
+CEncodingDetector::~CEncodingDetector()
+{
+}
+
+void CEncodingDetector::Reset()
+{
+  m_Scanned = 0;
+  m_BOM = eEncodingType::ET_UNKNOWN;
+  memset(m_Head, 0, sizeof(m_Head));
+  m_Zeros[0] = m_Zeros[1] = 0;
+  m_Sequences = 0;
+  m_Invalids = 0;
+  m_Pending = 0;
+  m_Lo = 0x80;
+  m_Hi = 0xBF;
+}
 
-  if (size == 1)
+bool CEncodingDetector::Update(const void* data, const size_t size)
+{
+  if (m_BOM != eEncodingType::ET_UNKNOWN || (m_Limit != 0 && m_Scanned >= m_Limit))
   {
-    /* UTF-8 */
-    if (p[0] >= SCHAR_MIN && p[0] <= SCHAR_MAX) return eEncodingType::ET_UTF8_BOM;
+    return false;
   }
 
-  signal(SIGSEGV, [](int signal)
+  if (data == nullptr || size == 0)
   {
-    throw signal;
-  });
+    return true;
+  }
+
+  const auto p = static_cast<const byte*>(data);
+  const auto n = m_Limit != 0 ? std::min(size, m_Limit - m_Scanned) : size;
+
+  const size_t offset = m_Scanned;
 
-  try
+  for (size_t i = offset; i < sizeof(m_Head) && i - offset < n; i++)
   {
-    /* UTF-8 BOM */
-    if (p[0] == 0xEF && p[1] == 0xBB && p[2] == 0xBF) return eEncodingType::ET_UTF8_BOM;
+    m_Head[i] = p[i - offset];
+  }
+
+  // The parity of the counts is relative to the block, so they are swapped for a block at an odd offset
 
-    /* UTF-32 LE BOM */
-    if (p[0] == 0xFF && p[1] == 0xFE && p[2] == 0x00 && p[3] == 0x00) return eEncodingType::ET_UTF32_LE_BOM;
+  size_t zeros[2] = { 0, 0 };
+  SIMDCountZeros(p, n, zeros);
+  m_Zeros[offset & 1] += zeros[0];
+  m_Zeros[(offset & 1) ^ 1] += zeros[1];
 
-    /* UTF-32 BE BOM */
-    if (p[0] == 0x00 && p[1] == 0x00 && p[2] == 0xFE && p[3] == 0xFF) return eEncodingType::ET_UTF32_BE_BOM;
+  this->Validate(p, n);
 
-    /* UTF-16 LE BOM */
-    if (p[0] == 0xFF && p[1] == 0xFE) return eEncodingType::ET_UTF16_LE_BOM;
+  m_Scanned += n;
 
-    /* UTF-16 BE BOM */
-    if (p[0] == 0xFE && p[1] == 0xFF) return eEncodingType::ET_UTF16_BE_BOM;
+  if (offset < sizeof(m_Head) && m_Scanned >= sizeof(m_Head))
+  {
+    m_BOM = DetermineBOM(m_Head, sizeof(m_Head));
+  }
+
+  return m_BOM == eEncodingType::ET_UNKNOWN && (m_Limit == 0 || m_Scanned < m_Limit);
+}
+
+/**
+ * Validates a block as UTF-8, a sequence may continue from the previous block.
+ * The ASCII runs are skipped by the vectors, the other bytes are checked by their ranges
+ * like the decoder of the transcoder (no overlong, surrogate or out of range sequence).
+ */
+void CEncodingDetector::Validate(const byte* p, const size_t n)
+{
+  for (size_t i = 0; i < n;)
+  {
+    if (m_Pending != 0)
+    {
+      const byte b = p[i];
+      if (b < m_Lo || b > m_Hi)
+      {
+        m_Invalids++;
+        m_Pending = 0; // The byte is checked again as a leading byte
+        continue;
+      }
+
+      i++;
+      m_Lo = 0x80;
+      m_Hi = 0xBF;
+
+      if (--m_Pending == 0)
+      {
+        m_Sequences++;
+      }
+
+      continue;
+    }
 
-    /* UTF-16 LE */
-    if ((p[0] >= SCHAR_MIN && p[0] <= SCHAR_MAX) && p[1] == 0x00) return eEncodingType::ET_UTF16_LE;
+    i += SIMDASCIIPrefix(p + i, n - i, sizeof(byte));
+    if (i == n)
+    {
+      break;
+    }
 
-    /* UTF-16 BE */
-    if ((p[1] >= SCHAR_MIN && p[1] <= SCHAR_MAX) && p[0] == 0x00) return eEncodingType::ET_UTF16_BE;
+    const byte b = p[i++];
 
-    /* UTF-8 */
-    if ((p[0] >= SCHAR_MIN && p[0] <= SCHAR_MAX) && (p[1] >= SCHAR_MIN && p[1] <= SCHAR_MAX)) return eEncodingType::ET_UTF8;
+    if (b >= 0xC2 && b <= 0xDF)
+    {
+      m_Pending = 1;
+    }
+    else if (b >= 0xE0 && b <= 0xEF)
+    {
+      m_Pending = 2;
+      m_Lo = b == 0xE0 ? 0xA0 : 0x80;
+      m_Hi = b == 0xED ? 0x9F : 0xBF;
+    }
+    else if (b >= 0xF0 && b <= 0xF4)
+    {
+      m_Pending = 3;
+      m_Lo = b == 0xF0 ? 0x90 : 0x80;
+      m_Hi = b == 0xF4 ? 0x8F : 0xBF;
+    }
+    else
+    {
+      m_Invalids++;
+    }
   }
-  catch (int)
+}
+
+eEncodingType CEncodingDetector::Classify(float& confidence) const
+{
+  confidence = 0.F;
+
+  if (m_Scanned == 0)
   {
     return eEncodingType::ET_UNKNOWN;
   }
 
-  return eEncodingType::ET_UNKNOWN;
+  auto result = m_BOM;
+  if (result == eEncodingType::ET_UNKNOWN)
+  {
+    result = DetermineBOM(m_Head, std::min(m_Scanned, sizeof(m_Head)));
+  }
+
+  if (result != eEncodingType::ET_UNKNOWN)
+  {
+    confidence = 1.F;
+    return result;
+  }
+
+  const size_t zeros = m_Zeros[0] + m_Zeros[1];
+  if (zeros != 0)
+  {
+    const size_t units = m_Scanned / 2;
+    const bool le = m_Zeros[1] >= m_Zeros[0];
+    const size_t dominant = le ? m_Zeros[1] : m_Zeros[0];
+    const size_t other = zeros - dominant;
+
+    if (dominant * UTF16_MIN_ZEROS_RATIO >= units && dominant > other * UTF16_MIN_PARITY_RATIO)
+    {
+      confidence = float(dominant - other) / float(zeros);
+      return le ? eEncodingType::ET_UTF16_LE : eEncodingType::ET_UTF16_BE;
+    }
+
+    if (zeros * TEXT_MAX_ZEROS_RATIO > m_Scanned)
+    {
+      return eEncodingType::ET_UNKNOWN; // A binary or an UTF-32 text without BOM
+    }
+  }
+
+  // ANSI or UTF-8, it is as likely UTF-8 as its multi-byte sequences are valid (an ASCII text is both)
+
+  const size_t sequences = m_Sequences + m_Invalids;
+  confidence = sequences == 0 ? 1.F : float(m_Sequences) / float(sequences);
+
+  return eEncodingType::ET_UTF8;
+}
+
+size_t CEncodingDetector::GetScannedSize() const
+{
+  return m_Scanned;
+}
+
+eEncodingType CEncodingDetector::GetEncoding() const
+{
+  float confidence = 0.F;
+  return this->Classify(confidence);
+}
+
+float CEncodingDetector::GetConfidence() const
+{
+  float confidence = 0.F;
+  this->Classify(confidence);
+  return confidence;
+}
+
+eEncodingType vuapi DetermineEncodingType(const void* Data, const size_t size, float* pConfidence)
+{
+  CEncodingDetector detector;
+  detector.Update(Data, size);
+
+  if (pConfidence != nullptr)
+  {
+    *pConfidence = detector.GetConfidence();
+  }
+
+  return detector.GetEncoding();
 }
 
 /* ------------------------------------------------ String Working ------------------------------------------------- */
@@ -83,83 +272,166 @@ eEncodingType vuapi DetermineEncodingType(const void* Data, const size_t size)
 std::string vuapi LowerStringA(const std::string& String)
 {
   std::string s(String);
-  std::transform(s.begin(), s.end(), s.begin(), tolower);
+  LowerStringInPlaceA(s);
   return s;
 }
 
 std::wstring vuapi LowerStringW(const std::wstring& String)
 {
   std::wstring s(String);
-  std::transform(s.begin(), s.end(), s.begin(), tolower);
+  LowerStringInPlaceW(s);
   return s;
 }
 
 std::string vuapi UpperStringA(const std::string& String)
 {
   std::string s(String);
-  std::transform(s.begin(), s.end(), s.begin(), toupper);
+  UpperStringInPlaceA(s);
   return s;
 }
 
 std::wstring vuapi UpperStringW(const std::wstring& String)
 {
   std::wstring s(String);
-  std::transform(s.begin(), s.end(), s.begin(), toupper);
+  UpperStringInPlaceW(s);
   return s;
 }
 
+void vuapi LowerStringInPlaceA(std::string& String)
+{
+  if (!String.empty())
+  {
+    SIMDChangeCase(&String[0], String.length(), sizeof(char), false);
+  }
+}
+
+void vuapi LowerStringInPlaceW(std::wstring& String)
+{
+  if (!String.empty())
+  {
+    SIMDChangeCase(&String[0], String.length(), sizeof(wchar), false);
+  }
+}
+
+void vuapi UpperStringInPlaceA(std::string& String)
+{
+  if (!String.empty())
+  {
+    SIMDChangeCase(&String[0], String.length(), sizeof(char), true);
+  }
+}
+
+void vuapi UpperStringInPlaceW(std::wstring& String)
+{
+  if (!String.empty())
+  {
+    SIMDChangeCase(&String[0], String.length(), sizeof(wchar), true);
+  }
+}
+
+template <typename T>
+static int CompareIgnoreCaseT(const CStringViewT<T>& Left, const CStringViewT<T>& Right)
+{
+  const size_t n = std::min(Left.Size(), Right.Size());
+
+  int result = SIMDCompareIgnoreCase(Left.Data(), Right.Data(), n, sizeof(T));
+  if (result == 0 && Left.Size() != Right.Size())
+  {
+    result = Left.Size() < Right.Size() ? -1 : 1;
+  }
+
+  return result;
+}
+
+int vuapi CompareIgnoreCaseA(const CStringViewA& Left, const CStringViewA& Right)
+{
+  return CompareIgnoreCaseT(Left, Right);
+}
+
+int vuapi CompareIgnoreCaseW(const CStringViewW& Left, const CStringViewW& Right)
+{
+  return CompareIgnoreCaseT(Left, Right);
+}
+
+bool vuapi EqualsIgnoreCaseA(const CStringViewA& Left, const CStringViewA& Right)
+{
+  return Left.Size() == Right.Size() && CompareIgnoreCaseT(Left, Right) == 0;
+}
+
+bool vuapi EqualsIgnoreCaseW(const CStringViewW& Left, const CStringViewW& Right)
+{
+  return Left.Size() == Right.Size() && CompareIgnoreCaseT(Left, Right) == 0;
+}
+
+/**
+ * ASCII is the same in every ANSI code page, so an ASCII string is only narrowed/widened by the vectors.
+ * The others are sized by the first call of the code page conversion then converted by the second one.
+ */
+
 std::string vuapi ToStringA(const std::wstring& String)
 {
   std::string s;
-  s.clear();
 
   if (String.empty())
   {
     return s;
   }
 
-  int N = (int)String.length() + 1;
-
-  std::unique_ptr<char[]> p(new char [N]);
-  if (p == nullptr)
+  if (SIMDASCIIPrefix(String.data(), String.size(), sizeof(wchar)) == String.size())
   {
+    s.resize(String.size());
+    SIMDCopyASCII(String.data(), String.size(), sizeof(wchar), &s[0], sizeof(char));
     return s;
   }
 
-  ZeroMemory(p.get(), N);
+  #ifdef _WIN32
+  const int N = WideCharToMultiByte(CP_ACP, WC_COMPOSITECHECK, String.data(), int(String.size()), NULL, 0, NULL, NULL);
+  if (N <= 0)
+  {
+    return s;
+  }
 
-  WideCharToMultiByte(CP_ACP, WC_COMPOSITECHECK, String.c_str(), -1, p.get(), N, NULL, NULL);
+  s.resize(N);
 
-  s.assign(p.get());
+  WideCharToMultiByte(CP_ACP, WC_COMPOSITECHECK, String.data(), int(String.size()), &s[0], N, NULL, NULL);
 
   return s;
+  #else  // POSIX, the narrow strings are UTF-8
+  return ToUTF8(String);
+  #endif // _WIN32
 }
 
 std::wstring vuapi ToStringW(const std::string& String)
 {
   std::wstring s;
-  s.clear();
 
   if (String.empty())
   {
     return s;
   }
 
-  int N = (int)String.length() + 1;
-
-  std::unique_ptr<wchar[]> p(new wchar [N]);
-  if (p == nullptr)
+  if (SIMDASCIIPrefix(String.data(), String.size(), sizeof(char)) == String.size())
   {
-    s.clear();
+    s.resize(String.size());
+    SIMDCopyASCII(String.data(), String.size(), sizeof(char), &s[0], sizeof(wchar));
+    return s;
   }
 
-  ZeroMemory(p.get(), 2*N);
+  #ifdef _WIN32
+  const int N = MultiByteToWideChar(CP_ACP, 0, String.data(), int(String.size()), NULL, 0);
+  if (N <= 0)
+  {
+    return s;
+  }
 
-  MultiByteToWideChar(CP_ACP, 0, String.c_str(), -1, p.get(), 2*N);
+  s.resize(N);
 
-  s.assign(p.get());
+  MultiByteToWideChar(CP_ACP, 0, String.data(), int(String.size()), &s[0], N);
 
   return s;
+  #else  // POSIX, the narrow strings are UTF-8
+  return FromUTF8(String);
+  #endif // _WIN32
 }
 
 template <class std_string_t>
@@ -169,30 +441,15 @@ std::vector<std_string_t> SplitStringT(
   bool  remempty
 )
 {
-  std::vector<std_string_t> l;
-  l.clear();
-
-  if (String.empty())
-  {
-    return l;
-  }
+  typedef typename std_string_t::value_type char_t;
 
-  std_string_t s(String), sep(Seperate), sub;
-  ulongptr start, end;
+  std::vector<std_string_t> l;
 
-  start = 0;
-  end = s.find(sep);
-  while (end != std_string_t::npos)
+  for (const auto& e : CSplitStringT<char_t>(String, Seperate, remempty))
   {
-    sub = s.substr(start, end - start);
-    if (!sub.empty() || !remempty) l.push_back(std_string_t(sub.c_str()));
-    start = end + sep.length();
-    end = s.find(sep, start);
+    l.push_back(std_string_t(e.Data(), e.Size()));
   }
 
-  sub = s.substr(start, end);
-  if (!sub.empty() || !remempty) l.push_back(std_string_t(sub.c_str()));
-
   return l;
 }
 
@@ -216,92 +473,72 @@ std::vector<std::wstring> vuapi SplitStringW(
 
 std::vector<std::string> vuapi MultiStringToListA(const char* lpcszMultiString)
 {
-  std::vector<std::string> l;
-  l.clear();
-
-  while (*lpcszMultiString)
-  {
-    l.push_back(std::string(lpcszMultiString));
-    lpcszMultiString += (lstrlenA(lpcszMultiString) + 1);
-  }
-
-  return l;
+  return CMultiStringA(lpcszMultiString).ToList();
 }
 
 std::vector<std::wstring> vuapi MultiStringToListW(const wchar* lpcwszMultiString)
 {
-  std::vector<std::wstring> l;
-  l.clear();
+  return CMultiStringW(lpcwszMultiString).ToList();
+}
 
-  while (*lpcwszMultiString)
-  {
-    l.push_back(std::wstring(lpcwszMultiString));
-    lpcwszMultiString += (lstrlenW(lpcwszMultiString) + 1);
-  }
+template <typename T>
+std::unique_ptr<T[]> ListToMultiStringT(const std::vector<std::basic_string<T>>& StringList)
+{
+  const size_t size = CMultiStringT<T>::Encode(StringList, nullptr, 0);
 
-  return l;
+  std::unique_ptr<T[]> p(new T[size]);
+  CMultiStringT<T>::Encode(StringList, p.get(), size);
+
+  return p;
 }
 
-std::unique_ptr<char[]> vuapi ListToMultiStringA(const std::vector<std::string>& StringList)
+template <typename T>
+bool ListToMultiStringT(const std::vector<std::basic_string<T>>& StringList, CBuffer& Buffer)
 {
-  size_t ulLength = 0;
-  for (std::string e : StringList)
-  {
-    ulLength += (e.length() + 1);
-  }
+  const size_t size = CMultiStringT<T>::Encode(StringList, nullptr, 0);
 
-  ulLength += 1; // End of multi-string.
-
-  std::unique_ptr<char[]> p(new char [ulLength]);
-  if (p == nullptr)
+  if (!Buffer.Resize(size * sizeof(T), false))
   {
-    return nullptr;
+    return false;
   }
 
-  ZeroMemory(p.get(), ulLength);
+  CMultiStringT<T>::Encode(StringList, static_cast<T*>(Buffer.GetpData()), size);
 
-  size_t iCrLength = 0;
-  char * pP = p.get();
-  for (std::string e : StringList)
-  {
-    iCrLength = e.length() + 1;
-    lstrcpynA(pP, e.c_str(), (int)iCrLength);
-    pP += iCrLength;
-  }
+  return true;
+}
 
-  return p;
+std::unique_ptr<char[]> vuapi ListToMultiStringA(const std::vector<std::string>& StringList)
+{
+  return ListToMultiStringT<char>(StringList);
 }
 
 std::unique_ptr<wchar[]> vuapi ListToMultiStringW(const std::vector<std::wstring>& StringList)
 {
-  size_t ulLength = 0;
-  for (std::wstring e : StringList)
-  {
-    ulLength += (e.length() + 1);
-  }
-
-  ulLength += 1; // End of multi-string.
+  return ListToMultiStringT<wchar>(StringList);
+}
 
-  std::unique_ptr<wchar[]> p(new wchar [ulLength]);
-  if (p == nullptr)
-  {
-    return nullptr;
-  }
+size_t vuapi ListToMultiStringA(const std::vector<std::string>& StringList, char* pBuffer, const size_t Count)
+{
+  return CMultiStringA::Encode(StringList, pBuffer, Count);
+}
 
-  ZeroMemory(p.get(), 2*ulLength);
+size_t vuapi ListToMultiStringW(const std::vector<std::wstring>& StringList, wchar* pBuffer, const size_t Count)
+{
+  return CMultiStringW::Encode(StringList, pBuffer, Count);
+}
 
-  size_t iCrLength = 0;
-  wchar * pP = p.get();
-  for (std::wstring e : StringList)
-  {
-    iCrLength = e.length() + 1;
-    lstrcpynW(pP, e.c_str(), (int)iCrLength);
-    pP += iCrLength;
-  }
+bool vuapi ListToMultiStringA(const std::vector<std::string>& StringList, CBuffer& Buffer)
+{
+  return ListToMultiStringT<char>(StringList, Buffer);
+}
 
-  return p;
+bool vuapi ListToMultiStringW(const std::vector<std::wstring>& StringList, CBuffer& Buffer)
+{
+  return ListToMultiStringT<wchar>(StringList, Buffer);
 }
 
+#ifdef _WIN32
+
 std::string vuapi LoadRSStringA(const UINT uID, const std::string& ModuleName)
 {
   std::string result = "";
@@ -338,60 +575,116 @@ std::wstring vuapi LoadRSStringW(const UINT uID, const std::wstring& ModuleName)
   return result;
 }
 
-template <class std_string_t>
-std_string_t TrimStringT(
-  const std_string_t& String,
-  const eTrimType& TrimType,
-  const std_string_t& TrimChars
+#endif // _WIN32
+
+template <typename T>
+void TrimStringT(
+  CStringBuilderT<T>& Result,
+  const CStringViewT<T>& String,
+  const eTrimType TrimType,
+  const CStringViewT<T>& TrimChars
 )
 {
-  std_string_t s = String;
+  const T* s = String.Data();
+  const T* e = s + String.Size();
 
-  switch (TrimType)
+  const auto trimmed = [&](const T c) -> bool
   {
-  case eTrimType::TS_LEFT:
-    s.erase(0, s.find_first_not_of(TrimChars));
-    break;
-
-  case eTrimType::TS_RIGHT:
-    s.erase(s.find_last_not_of(TrimChars) + 1);
-    break;
+    return std::char_traits<T>::find(TrimChars.Data(), TrimChars.Size(), c) != nullptr;
+  };
 
-  case eTrimType::TS_BOTH:
-    s.erase(0, s.find_first_not_of(TrimChars));
-    s.erase(s.find_last_not_of(TrimChars) + 1);
-    break;
+  if (TrimType == eTrimType::TS_LEFT || TrimType == eTrimType::TS_BOTH)
+  {
+    while (s < e && trimmed(*s))
+    {
+      s++;
+    }
+  }
 
-  default:
-    break;
+  if (TrimType == eTrimType::TS_RIGHT || TrimType == eTrimType::TS_BOTH)
+  {
+    while (e > s && trimmed(e[-1]))
+    {
+      e--;
+    }
   }
 
-  return s;
+  Result.Append(CStringViewT<T>(s, e - s));
+}
+
+void vuapi TrimStringA(
+  CStringBuilderA& Result,
+  const CStringViewA& String,
+  const eTrimType TrimType,
+  const CStringViewA& TrimChars)
+{
+  TrimStringT(Result, String, TrimType, TrimChars);
+}
+
+void vuapi TrimStringW(
+  CStringBuilderW& Result,
+  const CStringViewW& String,
+  const eTrimType TrimType,
+  const CStringViewW& TrimChars)
+{
+  TrimStringT(Result, String, TrimType, TrimChars);
 }
 
 std::string vuapi TrimStringA(const std::string& String, const eTrimType& TrimType, const std::string& TrimChars)
 {
-  return TrimStringT<std::string>(String, TrimType, TrimChars);
+  CStringBuilderA result(String.size());
+  TrimStringT<char>(result, String, TrimType, TrimChars);
+  return result.Detach();
 }
 
 std::wstring vuapi TrimStringW(const std::wstring& String, const eTrimType& TrimType, const std::wstring& TrimChars)
 {
-  return TrimStringT<std::wstring>(String, TrimType, TrimChars);
+  CStringBuilderW result(String.size());
+  TrimStringT<wchar>(result, String, TrimType, TrimChars);
+  return result.Detach();
 }
 
+/**
+ * Counts the matches to size the result exactly, then copies every segment of the text and
+ * every replacement once, the old erase/insert per match moved the whole tail for each match.
+ */
 template <class std_string_t>
 std_string_t ReplaceT(const std_string_t& Text, const std_string_t& From, const std_string_t& To)
 {
-  std_string_t result = Text;
+  typedef CStringViewT<typename std_string_t::value_type> view_t;
+
+  const view_t text(Text), from(From);
+
+  if (from.Empty())
+  {
+    return Text;
+  }
+
+  size_t count = 0;
+  for (size_t i = text.Find(from); i != view_t::npos; i = text.Find(from, i + from.Size()))
+  {
+    count++;
+  }
+
+  if (count == 0)
+  {
+    return Text;
+  }
+
+  std_string_t result;
+  result.reserve(Text.size() - count * From.size() + count * To.size());
+
+  size_t last = 0;
 
-  size_t start = 0;
-  while ((start = result.find(From, start)) != std_string_t::npos)
+  for (size_t i = text.Find(from); i != view_t::npos; i = text.Find(from, last))
   {
-    result.erase(start, From.length());
-    result.insert(start, To);
-    start += To.length();
+    result.append(Text, last, i - last);
+    result.append(To);
+    last = i + from.Size();
   }
 
+  result.append(Text, last, std_string_t::npos);
+
   return result;
 }
 
@@ -405,6 +698,29 @@ std::wstring vuapi ReplaceW(const std::wstring& Text, const std::wstring& From,
   return ReplaceT<std::wstring>(Text, From, To);
 }
 
+template <class std_string_t>
+std_string_t ReplaceManyT(const std_string_t& Text, const std::vector<std::pair<std_string_t, std_string_t>>& Pairs)
+{
+  CReplaceTableT<typename std_string_t::value_type> table;
+
+  for (const auto& e : Pairs)
+  {
+    table.Add(e.first, e.second);
+  }
+
+  return table.Apply(Text);
+}
+
+std::string vuapi ReplaceManyA(const std::string& Text, const std::vector<std::pair<std::string, std::string>>& Pairs)
+{
+  return ReplaceManyT<std::string>(Text, Pairs);
+}
+
+std::wstring vuapi ReplaceManyW(const std::wstring& Text, const std::vector<std::pair<std::wstring, std::wstring>>& Pairs)
+{
+  return ReplaceManyT<std::wstring>(Text, Pairs);
+}
+
 bool vuapi StartsWithA(const std::string& Text, const std::string& With)
 {
   return Text.length() >= With.length() && memcmp(Text.c_str(), With.c_str(), With.length()) == 0;
@@ -0,0 +1,398 @@
+/**
+ * @file   utf.cpp
+ * @author Vic P.
+ * @brief  Implementation for Unicode Transcoding
+ */
+
+#include "Vutils.h"
+#include "simd.h"
+
+#include <algorithm>
+
+namespace vu
+{
+
+static const uint32 REPLACEMENT_CHARACTER = 0xFFFD;
+
+/**
+ * Units
+ */
+
+static size_t UnitSize(const eUnicodeForm form)
+{
+  switch (form)
+  {
+  case UF_UTF8:
+    return 1;
+  case UF_UTF16LE:
+  case UF_UTF16BE:
+    return 2;
+  default:
+    return 4;
+  }
+}
+
+/**
+ * The forms that store ASCII as a zero-extended byte, their ASCII runs are copied by the vectors.
+ */
+static bool IsASCIIWidened(const eUnicodeForm form)
+{
+  return form == UF_UTF8 || form == UF_UTF16LE || form == UF_UTF32LE;
+}
+
+static uint32 Load16(const byte* s, const bool be)
+{
+  return be ? (uint32(s[0]) << 8) | s[1] : (uint32(s[1]) << 8) | s[0];
+}
+
+static uint32 Load32(const byte* s, const bool be)
+{
+  return be
+    ? (uint32(s[0]) << 24) | (uint32(s[1]) << 16) | (uint32(s[2]) << 8) | s[3]
+    : (uint32(s[3]) << 24) | (uint32(s[2]) << 16) | (uint32(s[1]) << 8) | s[0];
+}
+
+static void Store16(byte* d, const uint32 v, const bool be)
+{
+  d[be ? 0 : 1] = byte(v >> 8);
+  d[be ? 1 : 0] = byte(v);
+}
+
+static void Store32(byte* d, const uint32 v, const bool be)
+{
+  for (int i = 0; i < 4; i++)
+  {
+    d[be ? 3 - i : i] = byte(v >> (8 * i));
+  }
+}
+
+/**
+ * Decoders
+ * A decoder returns the number of bytes of the sequence at the front of the source.
+ * For an ill-formed sequence, it returns the length of its maximal valid prefix (at least one unit)
+ * with the status set, so the replacement resumes at the next possible sequence.
+ */
+
+static size_t DecodeUTF8(const byte* s, const size_t n, uint32& cp, eTranscodeStatus& status)
+{
+  const byte b0 = s[0];
+  if (b0 < 0x80)
+  {
+    cp = b0;
+    return 1;
+  }
+
+  // The range of the second byte excludes the overlongs, the surrogates and the code points above U+10FFFF
+
+  size_t length = 0;
+  byte lo = 0x80, hi = 0xBF;
+
+  if (b0 >= 0xC2 && b0 <= 0xDF)
+  {
+    length = 2;
+    cp = b0 & 0x1F;
+  }
+  else if (b0 >= 0xE0 && b0 <= 0xEF)
+  {
+    length = 3;
+    cp = b0 & 0x0F;
+    lo = b0 == 0xE0 ? 0xA0 : 0x80;
+    hi = b0 == 0xED ? 0x9F : 0xBF;
+  }
+  else if (b0 >= 0xF0 && b0 <= 0xF4)
+  {
+    length = 4;
+    cp = b0 & 0x07;
+    lo = b0 == 0xF0 ? 0x90 : 0x80;
+    hi = b0 == 0xF4 ? 0x8F : 0xBF;
+  }
+  else
+  {
+    status = TC_INVALID;
+    return 1;
+  }
+
+  for (size_t i = 1; i < length; i++)
+  {
+    if (i == n)
+    {
+      status = TC_TRUNCATED;
+      return i;
+    }
+
+    const byte b = s[i];
+    if (b < lo || b > hi)
+    {
+      status = TC_INVALID;
+      return i;
+    }
+
+    cp = (cp << 6) | (b & 0x3F);
+    lo = 0x80;
+    hi = 0xBF;
+  }
+
+  return length;
+}
+
+static size_t DecodeUTF16(const byte* s, const size_t n, const bool be, uint32& cp, eTranscodeStatus& status)
+{
+  if (n < 2)
+  {
+    status = TC_TRUNCATED;
+    return n;
+  }
+
+  const uint32 u = Load16(s, be);
+  if (u < 0xD800 || u > 0xDFFF)
+  {
+    cp = u;
+    return 2;
+  }
+
+  if (u >= 0xDC00) // A lone low surrogate
+  {
+    status = TC_INVALID;
+    return 2;
+  }
+
+  if (n < 4)
+  {
+    status = TC_TRUNCATED;
+    return n;
+  }
+
+  const uint32 v = Load16(s + 2, be);
+  if (v < 0xDC00 || v > 0xDFFF) // A high surrogate without its low surrogate
+  {
+    status = TC_INVALID;
+    return 2;
+  }
+
+  cp = 0x10000 + ((u - 0xD800) << 10) + (v - 0xDC00);
+
+  return 4;
+}
+
+static size_t DecodeUTF32(const byte* s, const size_t n, const bool be, uint32& cp, eTranscodeStatus& status)
+{
+  if (n < 4)
+  {
+    status = TC_TRUNCATED;
+    return n;
+  }
+
+  cp = Load32(s, be);
+  if (cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF))
+  {
+    status = TC_INVALID;
+  }
+
+  return 4;
+}
+
+static size_t Decode(const byte* s, const size_t n, const eUnicodeForm form, uint32& cp, eTranscodeStatus& status)
+{
+  switch (form)
+  {
+  case UF_UTF8:
+    return DecodeUTF8(s, n, cp, status);
+  case UF_UTF16LE:
+  case UF_UTF16BE:
+    return DecodeUTF16(s, n, form == UF_UTF16BE, cp, status);
+  default:
+    return DecodeUTF32(s, n, form == UF_UTF32BE, cp, status);
+  }
+}
+
+/**
+ * Encoders
+ */
+
+static size_t EncodedSize(const uint32 cp, const eUnicodeForm form)
+{
+  switch (form)
+  {
+  case UF_UTF8:
+    return cp < 0x80 ? 1 : cp < 0x800 ? 2 : cp < 0x10000 ? 3 : 4;
+  case UF_UTF16LE:
+  case UF_UTF16BE:
+    return cp < 0x10000 ? 2 : 4;
+  default:
+    return 4;
+  }
+}
+
+static void Encode(const uint32 cp, const eUnicodeForm form, byte* d)
+{
+  switch (form)
+  {
+  case UF_UTF8:
+    if (cp < 0x80)
+    {
+      d[0] = byte(cp);
+    }
+    else if (cp < 0x800)
+    {
+      d[0] = byte(0xC0 | (cp >> 6));
+      d[1] = byte(0x80 | (cp & 0x3F));
+    }
+    else if (cp < 0x10000)
+    {
+      d[0] = byte(0xE0 | (cp >> 12));
+      d[1] = byte(0x80 | ((cp >> 6) & 0x3F));
+      d[2] = byte(0x80 | (cp & 0x3F));
+    }
+    else
+    {
+      d[0] = byte(0xF0 | (cp >> 18));
+      d[1] = byte(0x80 | ((cp >> 12) & 0x3F));
+      d[2] = byte(0x80 | ((cp >> 6) & 0x3F));
+      d[3] = byte(0x80 | (cp & 0x3F));
+    }
+    break;
+
+  case UF_UTF16LE:
+  case UF_UTF16BE:
+    if (cp < 0x10000)
+    {
+      Store16(d, cp, form == UF_UTF16BE);
+    }
+    else
+    {
+      Store16(d, 0xD800 + ((cp - 0x10000) >> 10), form == UF_UTF16BE);
+      Store16(d + 2, 0xDC00 + ((cp - 0x10000) & 0x3FF), form == UF_UTF16BE);
+    }
+    break;
+
+  default:
+    Store32(d, cp, form == UF_UTF32BE);
+    break;
+  }
+}
+
+/**
+ * Transcoding
+ */
+
+TTranscodeResult vuapi Transcode(
+  const void* source, const size_t size, const eUnicodeForm from,
+  void* target, const size_t capacity, const eUnicodeForm to,
+  const bool replace)
+{
+  TTranscodeResult result = { TC_OK, 0, 0 };
+
+  if (source == nullptr || size == 0)
+  {
+    return result;
+  }
+
+  const auto s = static_cast<const byte*>(source);
+  const auto d = static_cast<byte*>(target);
+
+  const size_t sw = UnitSize(from);
+  const size_t dw = UnitSize(to);
+  const bool ascii = IsASCIIWidened(from) && IsASCIIWidened(to);
+
+  size_t i = 0, w = 0;
+
+  while (i < size)
+  {
+    // The ASCII runs are checked and copied by the vectors, the others are done a code point at a time
+
+    if (ascii && s[i] < 0x80)
+    {
+      size_t n = SIMDASCIIPrefix(s + i, (size - i) / sw, sw);
+      if (d != nullptr)
+      {
+        n = std::min(n, (capacity - w) / dw);
+        SIMDCopyASCII(s + i, n, sw, d + w, dw);
+      }
+
+      if (n != 0)
+      {
+        i += n * sw;
+        w += n * dw;
+        continue;
+      }
+    }
+
+    uint32 cp = 0;
+    eTranscodeStatus status = TC_OK;
+
+    const size_t length = Decode(s + i, size - i, from, cp, status);
+    if (status != TC_OK)
+    {
+      if (!replace)
+      {
+        result.Status = status;
+        break;
+      }
+
+      cp = REPLACEMENT_CHARACTER;
+    }
+
+    const size_t n = EncodedSize(cp, to);
+    if (d != nullptr)
+    {
+      if (w + n > capacity)
+      {
+        result.Status = TC_OVERFLOW;
+        break;
+      }
+
+      Encode(cp, to, d + w);
+    }
+
+    i += length;
+    w += n;
+  }
+
+  result.Read = i;
+  result.Written = w;
+
+  return result;
+}
+
+TTranscodeResult vuapi GetTranscodedSize(
+  const void* source, const size_t size, const eUnicodeForm from,
+  const eUnicodeForm to,
+  const bool replace)
+{
+  return Transcode(source, size, from, nullptr, 0, to, replace);
+}
+
+/**
+ * The wide strings are UTF-16 on Windows and UTF-32 on the others.
+ */
+static const eUnicodeForm UF_WIDE = sizeof(wchar) == 2 ? UF_UTF16LE : UF_UTF32LE;
+
+std::string vuapi ToUTF8(const std::wstring& String)
+{
+  std::string result;
+
+  const size_t size = String.size() * sizeof(wchar);
+
+  result.resize(GetTranscodedSize(String.data(), size, UF_WIDE, UF_UTF8, true).Written);
+  if (!result.empty())
+  {
+    Transcode(String.data(), size, UF_WIDE, &result[0], result.size(), UF_UTF8, true);
+  }
+
+  return result;
+}
+
+std::wstring vuapi FromUTF8(const std::string& String)
+{
+  std::wstring result;
+
+  result.resize(GetTranscodedSize(String.data(), String.size(), UF_UTF8, UF_WIDE, true).Written / sizeof(wchar));
+  if (!result.empty())
+  {
+    Transcode(String.data(), String.size(), UF_UTF8, &result[0], result.size() * sizeof(wchar), UF_WIDE, true);
+  }
+
+  return result;
+}
+
+} // namespace vu
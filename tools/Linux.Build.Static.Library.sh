@@ -0,0 +1,69 @@
+#!/bin/sh
+
+# Builds the portable part of Vutils (see the conditions at the top of Vutils.h) for Linux.
+
+set -e
+
+VU_NAME=Vutils
+VU_DIR=$(cd "$(dirname "$0")/.." && pwd)
+VU_3RD=$VU_DIR/3rdparty
+VU_LIB=$VU_DIR/lib
+VU_SRC=$VU_DIR/src
+VU_SRC_DETAILS=$VU_SRC/details
+VU_INCLUDE=$VU_DIR/include
+VU_OBJ=$(mktemp -d)
+
+CXX=${CXX:-g++}
+CXXFLAGS=${CXXFLAGS:--O2}
+
+echo "*** $VU_NAME static library for Linux ***"
+
+echo
+
+mkdir -p "$VU_LIB"
+
+VU_SRC_DETAILS_CPP="
+  allocator
+  codec
+  filedir
+  filewatch
+  inidoc
+  inifile
+  inischema
+  math
+  mbuffer
+  misc
+  pattern
+  pefile
+  ringbuffer
+  scan
+  simd
+  stopwatch
+  strfmt
+  string
+  threadpool
+  utf
+"
+
+echo "[+] Compiling  -> OK"
+
+for e in $VU_SRC_DETAILS_CPP; do
+  $CXX -c -std=c++11 $CXXFLAGS -I"$VU_INCLUDE" -o "$VU_OBJ/$e.o" "$VU_SRC_DETAILS/$e.cpp"
+done
+
+$CXX -c -std=c++11 $CXXFLAGS -I"$VU_INCLUDE" -o "$VU_OBJ/$VU_NAME.o" "$VU_SRC/$VU_NAME.cpp"
+$CXX -c -std=c++11 $CXXFLAGS -I"$VU_3RD/TP11/include" -o "$VU_OBJ/Pool.o" "$VU_3RD/TP11/src/Pool.cpp"
+$CXX -c -std=c++11 $CXXFLAGS -I"$VU_3RD/TP11/include" -o "$VU_OBJ/Worker.o" "$VU_3RD/TP11/src/Worker.cpp"
+
+echo "[+] Linking    -> OK"
+
+rm -f "$VU_LIB/lib$VU_NAME.a"
+ar rcs "$VU_LIB/lib$VU_NAME.a" "$VU_OBJ"/*.o
+
+echo "[+] Cleaning   -> OK"
+
+rm -rf "$VU_OBJ"
+
+echo "[+] Building   -> OK"
+
+echo